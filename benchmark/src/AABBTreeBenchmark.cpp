@@ -35,6 +35,13 @@
 #include "Model/World.h"
 
 #include <vecmath/bbox.h>
+#include <vecmath/ray.h>
+#include <vecmath/vec.h>
+
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
 
 namespace TrenchBroom {
     using AABB = AABBTree<double, 3, Model::Node*>;
@@ -61,8 +68,26 @@ namespace TrenchBroom {
         }
     };
 
-    TEST(AABBTreeBenchmark, benchBuildTree) {
+    class NodeCollector : public Model::NodeVisitor {
+    private:
+        std::vector<Model::Node*> m_nodes;
+    public:
+        const std::vector<Model::Node*>& nodes() const {
+            return m_nodes;
+        }
+    private:
+        void doVisit(Model::World* world) override {}
+        void doVisit(Model::Layer* layer) override {}
+        void doVisit(Model::Group* group) override {}
+        void doVisit(Model::Entity* entity) override {
+            m_nodes.push_back(entity);
+        }
+        void doVisit(Model::Brush* brush) override {
+            m_nodes.push_back(brush);
+        }
+    };
 
+    static std::unique_ptr<Model::World> loadWorld() {
         const auto mapPath = IO::Disk::getCurrentWorkingDir() + IO::Path("fixture/benchmark/AABBTree/ne_ruins.map");
         const auto file = IO::Disk::openFile(mapPath);
         auto fileReader = file->reader().buffer();
@@ -71,7 +96,43 @@ namespace TrenchBroom {
         IO::WorldReader worldReader(std::begin(fileReader), std::end(fileReader));
 
         const vm::bbox3 worldBounds(8192);
-        auto world = worldReader.read(Model::MapFormat::Standard, worldBounds, status);
+        return worldReader.read(Model::MapFormat::Standard, worldBounds, status);
+    }
+
+    static std::vector<Model::Node*> collectNodes(Model::World& world) {
+        NodeCollector collector;
+        world.acceptAndRecurse(collector);
+        return collector.nodes();
+    }
+
+    static std::vector<vm::ray3> makeRays(const BOX& bounds, const size_t count) {
+        // cast rays from the corners of the bounds through points on a grid in the center plane
+        std::vector<vm::ray3> result;
+        result.reserve(count);
+
+        const auto center = bounds.center();
+        const auto size = bounds.size();
+        for (size_t i = 0; i < count; ++i) {
+            const auto origin = i % 2 == 0 ? bounds.min : bounds.max;
+            const auto u = static_cast<double>((i * 7u) % 97u) / 97.0 - 0.5;
+            const auto v = static_cast<double>((i * 13u) % 89u) / 89.0 - 0.5;
+            const auto target = center + vm::vec3(u * size.x(), v * size.y(), 0.0);
+            result.push_back(vm::ray3(origin, vm::normalize(target - origin)));
+        }
+        return result;
+    }
+
+    template <typename Tree>
+    static size_t castRays(const Tree& tree, const std::vector<vm::ray3>& rays) {
+        size_t hits = 0;
+        for (const auto& ray : rays) {
+            hits += tree.findIntersectors(ray).size();
+        }
+        return hits;
+    }
+
+    TEST(AABBTreeBenchmark, benchBuildTree) {
+        auto world = loadWorld();
 
         std::vector<AABB> trees(100);
         timeLambda([&world, &trees]() {
@@ -80,5 +141,139 @@ namespace TrenchBroom {
                 world->acceptAndRecurse(builder);
             }
         }, "Add objects to AABB tree");
+
+        const auto nodes = collectNodes(*world);
+        timeLambda([&nodes, &trees]() {
+            for (auto& tree : trees) {
+                tree.clearAndBuild(nodes, [](const Model::Node* node) { return node->bounds(); });
+            }
+        }, "Build AABB tree using SAH");
+    }
+
+    TEST(AABBTreeBenchmark, benchRayQueries) {
+        auto world = loadWorld();
+        const auto nodes = collectNodes(*world);
+
+        AABB insertedTree;
+        TreeBuilder builder(insertedTree);
+        world->acceptAndRecurse(builder);
+
+        AABB builtTree;
+        builtTree.clearAndBuild(nodes, [](const Model::Node* node) { return node->bounds(); });
+
+        const auto rays = makeRays(builtTree.bounds(), 10000);
+
+        size_t insertedHits = 0;
+        timeLambda([&]() { insertedHits = castRays(insertedTree, rays); }, "Ray queries on incrementally built AABB tree");
+
+        size_t builtHits = 0;
+        timeLambda([&]() { builtHits = castRays(builtTree, rays); }, "Ray queries on SAH built AABB tree");
+
+        ASSERT_EQ(insertedHits, builtHits);
+    }
+
+    template <typename Tree>
+    static size_t findContainers(const Tree& tree, const std::vector<vm::vec3>& points) {
+        size_t hits = 0;
+        for (const auto& point : points) {
+            hits += tree.findContainers(point).size();
+        }
+        return hits;
+    }
+
+    TEST(AABBTreeBenchmark, benchFlatTreeQueries) {
+        auto world = loadWorld();
+        const auto nodes = collectNodes(*world);
+
+        AABB tree;
+        tree.clearAndBuild(nodes, [](const Model::Node* node) { return node->bounds(); });
+
+        AABB::FlatTree flatTree;
+        timeLambda([&]() {
+            for (size_t i = 0; i < 100; ++i) {
+                tree.flatten(flatTree);
+            }
+        }, "Flatten AABB tree");
+
+        const auto rays = makeRays(tree.bounds(), 10000);
+
+        size_t treeHits = 0;
+        timeLambda([&]() { treeHits = castRays(tree, rays); }, "Ray queries on AABB tree");
+
+        size_t flatTreeHits = 0;
+        timeLambda([&]() { flatTreeHits = castRays(flatTree, rays); }, "Ray queries on flat AABB tree");
+
+        // the flat tree may find a few more nodes whose bounds touch the rays
+        ASSERT_LE(treeHits, flatTreeHits);
+
+        std::vector<vm::vec3> points;
+        for (const auto* node : nodes) {
+            points.push_back(node->bounds().center());
+        }
+
+        size_t treeContainers = 0;
+        timeLambda([&]() { treeContainers = findContainers(tree, points); }, "Point queries on AABB tree");
+
+        size_t flatTreeContainers = 0;
+        timeLambda([&]() { flatTreeContainers = findContainers(flatTree, points); }, "Point queries on flat AABB tree");
+
+        ASSERT_LE(treeContainers, flatTreeContainers);
+    }
+
+    TEST(AABBTreeBenchmark, benchUpdateTree) {
+        auto world = loadWorld();
+        const auto nodes = collectNodes(*world);
+
+        const std::vector<std::pair<vm::vec3, std::string>> moves({
+            { vm::vec3(4.0, 4.0, 0.0), "(small moves)" },
+            { vm::vec3(1024.0, 0.0, 0.0), "(large moves)" }
+        });
+
+        for (const auto& [delta, description] : moves) {
+            AABB::UpdateList updates;
+            AABB::UpdateList inverseUpdates;
+            for (auto* node : nodes) {
+                const auto oldBounds = node->bounds();
+                const auto newBounds = oldBounds.translate(delta);
+                updates.push_back(AABB::Update{ oldBounds, newBounds, node });
+                inverseUpdates.push_back(AABB::Update{ newBounds, oldBounds, node });
+            }
+
+            AABB tree;
+            tree.clearAndBuild(nodes, [](const Model::Node* node) { return node->bounds(); });
+
+            timeLambda([&]() {
+                for (size_t i = 0; i < 10; ++i) {
+                    for (const auto& update : updates) {
+                        tree.remove(update.oldBounds, update.data);
+                        tree.insert(update.newBounds, update.data);
+                    }
+                    for (const auto& update : inverseUpdates) {
+                        tree.remove(update.oldBounds, update.data);
+                        tree.insert(update.newBounds, update.data);
+                    }
+                }
+            }, "Remove and insert nodes " + description);
+
+            tree.clearAndBuild(nodes, [](const Model::Node* node) { return node->bounds(); });
+            timeLambda([&]() {
+                for (size_t i = 0; i < 10; ++i) {
+                    for (const auto& update : updates) {
+                        tree.update(update.oldBounds, update.newBounds, update.data);
+                    }
+                    for (const auto& update : inverseUpdates) {
+                        tree.update(update.oldBounds, update.newBounds, update.data);
+                    }
+                }
+            }, "Update nodes individually " + description);
+
+            tree.clearAndBuild(nodes, [](const Model::Node* node) { return node->bounds(); });
+            timeLambda([&]() {
+                for (size_t i = 0; i < 10; ++i) {
+                    tree.update(updates);
+                    tree.update(inverseUpdates);
+                }
+            }, "Update nodes in batches " + description);
+        }
     }
 }
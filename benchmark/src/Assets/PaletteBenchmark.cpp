@@ -0,0 +1,84 @@
+/*
+ Copyright (C) 2010-2019 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+
+#include "BenchmarkUtils.h"
+
+#include "Color.h"
+#include "Assets/Palette.h"
+#include "IO/Reader.h"
+
+#include <memory>
+#include <random>
+#include <vector>
+
+namespace TrenchBroom {
+    namespace Assets {
+        static const size_t PixelCount = 128 * 128;
+        static const size_t ImageCount = 4096;
+
+        TEST(PaletteBenchmark, indexedToRgba) {
+            std::mt19937 random(1);
+            std::uniform_int_distribution<int> byte(0, 255);
+
+            auto paletteData = std::make_unique<unsigned char[]>(768);
+            for (size_t i = 0; i < 768; ++i) {
+                paletteData[i] = static_cast<unsigned char>(byte(random));
+            }
+            const auto* rawPaletteData = paletteData.get();
+            const Palette palette(768, std::move(paletteData));
+
+            std::vector<char> indices(PixelCount);
+            for (auto& index : indices) {
+                index = static_cast<char>(byte(random));
+            }
+
+            Buffer<unsigned char> rgbaImage(4 * PixelCount);
+            Color averageColor;
+
+            // the per pixel conversion the palette used to do, for comparison
+            timeLambda([&]() {
+                for (size_t n = 0; n < ImageCount; ++n) {
+                    auto reader = IO::Reader::from(indices.data(), indices.data() + PixelCount);
+                    double avg[3] = { 0.0, 0.0, 0.0 };
+                    for (size_t i = 0; i < PixelCount; ++i) {
+                        const size_t index = reader.readSize<unsigned char>();
+                        for (size_t j = 0; j < 3; ++j) {
+                            const unsigned char c = rawPaletteData[index * 3 + j];
+                            rgbaImage[i * 4 + j] = c;
+                            avg[j] += static_cast<double>(c);
+                        }
+                        rgbaImage[i * 4 + 3] = (index == 255) ? 0x00 : 0xFF;
+                    }
+                    for (size_t j = 0; j < 3; ++j) {
+                        averageColor[j] = static_cast<float>(avg[j] / PixelCount / 0xFF);
+                    }
+                }
+            }, "Convert indexed images pixel by pixel");
+
+            timeLambda([&]() {
+                for (size_t n = 0; n < ImageCount; ++n) {
+                    auto reader = IO::Reader::from(indices.data(), indices.data() + PixelCount);
+                    palette.indexedToRgba(reader, PixelCount, rgbaImage, PaletteTransparency::Index255Transparent, averageColor);
+                }
+            }, "Convert indexed images with the palette table");
+        }
+    }
+}
@@ -30,14 +30,16 @@
 #endif
 
 // the noinline is so you can see the timeLambda when profiling
+// returns the elapsed time in seconds
 template<class L>
-TB_NOINLINE static void timeLambda(L&& lambda, const std::string& message) {
+TB_NOINLINE static double timeLambda(L&& lambda, const std::string& message) {
     const auto start = std::chrono::high_resolution_clock::now();
     lambda();
     const auto end = std::chrono::high_resolution_clock::now();
 
-    printf("Time elapsed for '%s': %fms\n", message.c_str(),
-           std::chrono::duration<double>(end - start).count() * 1000.0);
+    const auto seconds = std::chrono::duration<double>(end - start).count();
+    printf("Time elapsed for '%s': %fms\n", message.c_str(), seconds * 1000.0);
+    return seconds;
 }
 
 
@@ -0,0 +1,79 @@
+/*
+ Copyright (C) 2010-2019 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+
+#include "BenchmarkUtils.h"
+
+#include "Logger.h"
+#include "IO/DiskIO.h"
+#include "IO/File.h"
+#include "IO/MapCache.h"
+#include "IO/Path.h"
+#include "IO/Reader.h"
+#include "IO/TestParserStatus.h"
+#include "IO/WorldReader.h"
+#include "Model/World.h"
+
+#include <vecmath/bbox.h>
+
+#include <cstdio>
+#include <fstream>
+
+namespace TrenchBroom {
+    namespace IO {
+        TEST(MapCacheBenchmark, benchReadMapCache) {
+            const auto fixturePath = Disk::getCurrentWorkingDir() + Path("fixture/benchmark/AABBTree/ne_ruins.map");
+            const auto file = Disk::openFile(fixturePath);
+            auto fileReader = file->reader().buffer();
+
+            // work on a copy of the map so that the cache file is not written into the fixture directory
+            const auto mapPath = Disk::getCurrentWorkingDir() + Path("map_cache_benchmark.map");
+            {
+                std::ofstream stream(mapPath.asString(), std::ios::out | std::ios::binary | std::ios::trunc);
+                stream.write(std::begin(fileReader), static_cast<std::streamsize>(fileReader.size()));
+            }
+
+            const vm::bbox3 worldBounds(8192);
+
+            TestParserStatus status;
+            WorldReader worldReader(std::begin(fileReader), std::end(fileReader));
+            auto world = worldReader.readInParallel(Model::MapFormat::Standard, worldBounds, status);
+
+            timeLambda([&]() {
+                MapCache::write(*world, worldBounds, mapPath);
+            }, "Write map cache");
+
+            timeLambda([&]() {
+                TestParserStatus parserStatus;
+                WorldReader reader(std::begin(fileReader), std::end(fileReader));
+                auto result = reader.readInParallel(Model::MapFormat::Standard, worldBounds, parserStatus);
+            }, "Read map in parallel");
+
+            timeLambda([&]() {
+                NullLogger logger;
+                auto result = MapCache::read(Model::MapFormat::Standard, worldBounds, mapPath, logger);
+                ASSERT_TRUE(result != nullptr);
+            }, "Read map cache");
+
+            std::remove(MapCache::cachePath(mapPath).asString().c_str());
+            std::remove(mapPath.asString().c_str());
+        }
+    }
+}
@@ -0,0 +1,95 @@
+/*
+ Copyright (C) 2010-2019 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+
+#include "BenchmarkUtils.h"
+
+#include "IO/NodeWriter.h"
+#include "Model/Brush.h"
+#include "Model/BrushBuilder.h"
+#include "Model/Entity.h"
+#include "Model/Layer.h"
+#include "Model/MapFormat.h"
+#include "Model/World.h"
+
+#include <vecmath/mat.h>
+#include <vecmath/mat_ext.h>
+
+#include <cstdio>
+#include <string>
+
+namespace TrenchBroom {
+    namespace IO {
+        static constexpr size_t NumBrushes = 170'000;
+        static constexpr size_t NumEntities = 1'000;
+
+        static void benchWriteMap(const Model::MapFormat format, const String& formatName) {
+            const vm::bbox3 worldBounds(8192.0);
+            Model::World world(format, worldBounds);
+            Model::BrushBuilder builder(&world, worldBounds);
+
+            Model::EntityList entities;
+            for (size_t i = 0; i < NumEntities; ++i) {
+                auto* entity = world.createEntity();
+                entity->addOrUpdateAttribute("classname", "func_detail");
+                entities.push_back(entity);
+            }
+
+            // rotate every other brush so that half of the face points are not integers
+            const auto rotation = vm::rotationMatrix(vm::vec3::pos_z, vm::toRadians(15.0));
+            for (size_t i = 0; i < NumBrushes; ++i) {
+                auto* brush = builder.createCube(64.0, "texture" + std::to_string(i % 256));
+                brush->transform(vm::translationMatrix(vm::vec3(static_cast<FloatType>(i % 64) * 64.0, 0.0, 0.0)), false, worldBounds);
+                if (i % 2 == 1) {
+                    brush->transform(rotation, false, worldBounds);
+                }
+
+                if (i % 4 == 0) {
+                    entities[(i / 4) % NumEntities]->addChild(brush);
+                } else {
+                    world.defaultLayer()->addChild(brush);
+                }
+            }
+
+            for (auto* entity : entities) {
+                world.defaultLayer()->addChild(entity);
+            }
+
+            timeLambda([&]() {
+                auto* stream = std::tmpfile();
+                ASSERT_TRUE(stream != nullptr);
+
+                {
+                    NodeWriter writer(world, stream);
+                    writer.writeMap();
+                }
+                std::fclose(stream);
+            }, "write " + std::to_string(NumBrushes * 6) + " faces in " + formatName + " format");
+        }
+
+        TEST(MapWriterBenchmark, benchWriteStandardMap) {
+            benchWriteMap(Model::MapFormat::Standard, "standard");
+        }
+
+        TEST(MapWriterBenchmark, benchWriteValveMap) {
+            benchWriteMap(Model::MapFormat::Valve, "valve");
+        }
+    }
+}
@@ -0,0 +1,203 @@
+/*
+ Copyright (C) 2010-2019 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+
+#include "BenchmarkUtils.h"
+
+#include "Logger.h"
+#include "Assets/Palette.h"
+#include "Assets/Texture.h"
+#include "Assets/TextureCollection.h"
+#include "Assets/TextureManager.h"
+#include "IO/DiskFileSystem.h"
+#include "IO/DiskIO.h"
+#include "IO/File.h"
+#include "IO/IdMipTextureReader.h"
+#include "IO/Path.h"
+#include "IO/TextureLoader.h"
+#include "IO/WadFileSystem.h"
+#include "Model/GameConfig.h"
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <memory>
+
+namespace TrenchBroom {
+    namespace IO {
+        template <typename T>
+        static void writeValue(std::ofstream& stream, const T value) {
+            stream.write(reinterpret_cast<const char*>(&value), sizeof(T));
+        }
+
+        static void writeName(std::ofstream& stream, const String& name) {
+            char buffer[16];
+            std::memset(buffer, 0, sizeof(buffer));
+            std::strncpy(buffer, name.c_str(), sizeof(buffer) - 1);
+            stream.write(buffer, sizeof(buffer));
+        }
+
+        static void writePalette(const Path& path) {
+            std::ofstream stream(path.asString(), std::ios::out | std::ios::binary | std::ios::trunc);
+            for (size_t i = 0; i < 256; ++i) {
+                for (size_t j = 0; j < 3; ++j) {
+                    writeValue(stream, static_cast<uint8_t>((i * (j + 1)) & 0xFF));
+                }
+            }
+        }
+
+        /**
+         * Writes a WAD2 file containing the given number of mip textures with the given size.
+         */
+        static void writeWad(const Path& path, const size_t textureCount, const size_t size) {
+            std::ofstream stream(path.asString(), std::ios::out | std::ios::binary | std::ios::trunc);
+
+            const auto headerSize = 16 + 2 * 4 + 4 * 4;
+            const auto mipDataSize = size * size + (size / 2) * (size / 2) + (size / 4) * (size / 4) + (size / 8) * (size / 8);
+            const auto entrySize = static_cast<int32_t>(headerSize + mipDataSize);
+            const auto directoryOffset = static_cast<int32_t>(12 + textureCount * static_cast<size_t>(entrySize));
+
+            stream.write("WAD2", 4);
+            writeValue(stream, static_cast<int32_t>(textureCount));
+            writeValue(stream, directoryOffset);
+
+            std::vector<char> pixels(mipDataSize);
+            for (size_t i = 0; i < textureCount; ++i) {
+                writeName(stream, "texture" + std::to_string(i));
+                writeValue(stream, static_cast<int32_t>(size));
+                writeValue(stream, static_cast<int32_t>(size));
+
+                auto offset = headerSize;
+                for (size_t mip = 0; mip < 4; ++mip) {
+                    writeValue(stream, static_cast<int32_t>(offset));
+                    offset += (size >> mip) * (size >> mip);
+                }
+
+                for (size_t j = 0; j < mipDataSize; ++j) {
+                    pixels[j] = static_cast<char>((i + j) & 0xFF);
+                }
+                stream.write(pixels.data(), static_cast<std::streamsize>(pixels.size()));
+            }
+
+            for (size_t i = 0; i < textureCount; ++i) {
+                writeValue(stream, static_cast<int32_t>(12 + i * static_cast<size_t>(entrySize)));
+                writeValue(stream, entrySize);
+                writeValue(stream, entrySize);
+                stream.write("D", 1);
+                stream.write("\0\0\0", 3);
+                writeName(stream, "texture" + std::to_string(i));
+            }
+        }
+
+        TEST(TextureLoaderBenchmark, benchLoadWad) {
+            using Model::GameConfig;
+
+            static const size_t TextureCount = 4096;
+            static const size_t TextureSize = 128;
+
+            const auto root = Disk::getCurrentWorkingDir();
+            const auto wadPath = Path("texture_loader_benchmark.wad");
+            const auto palettePath = Path("texture_loader_benchmark.lmp");
+            writeWad(root + wadPath, TextureCount, TextureSize);
+            writePalette(root + palettePath);
+
+            const DiskFileSystem fs(root);
+            const GameConfig::TextureConfig textureConfig(GameConfig::TexturePackageConfig(GameConfig::PackageFormatConfig("wad", "idmip")),
+                                                          GameConfig::PackageFormatConfig("D", "idmip"),
+                                                          palettePath,
+                                                          "wad",
+                                                          Path());
+            NullLogger logger;
+
+            timeLambda([&]() {
+                const auto palette = Assets::Palette::loadFile(fs, palettePath);
+                IdMipTextureReader reader(TextureReader::PathSuffixNameStrategy(1, true), palette);
+
+                WadFileSystem wadFS(root + wadPath);
+                auto collection = std::make_unique<Assets::TextureCollection>(wadPath);
+                for (const auto& texturePath : wadFS.findItems(Path(""))) {
+                    collection->addTexture(reader.readTexture(wadFS.openFile(texturePath)));
+                }
+                ASSERT_EQ(TextureCount, collection->textureCount());
+            }, "Decode " + std::to_string(TextureCount) + " textures serially");
+
+            timeLambda([&]() {
+                TextureLoader loader(fs, Path::List{ root }, textureConfig, logger);
+                Assets::TextureManager textureManager(0, 0, logger);
+                loader.loadTextures(Path::List{ wadPath }, textureManager);
+                ASSERT_EQ(TextureCount, textureManager.textures().size());
+            }, "Load " + std::to_string(TextureCount) + " textures with TextureLoader");
+
+            std::remove((root + wadPath).asString().c_str());
+            std::remove((root + palettePath).asString().c_str());
+        }
+
+        TEST(TextureLoaderBenchmark, benchLoadWadFromCache) {
+            using Model::GameConfig;
+
+            static const size_t TextureCount = 4096;
+            static const size_t TextureSize = 128;
+
+            const auto root = Disk::getCurrentWorkingDir();
+            const auto wadPath = Path("texture_cache_benchmark.wad");
+            const auto palettePath = Path("texture_cache_benchmark.lmp");
+            const auto cacheDirectory = root + Path("texture_cache_benchmark");
+            writeWad(root + wadPath, TextureCount, TextureSize);
+            writePalette(root + palettePath);
+
+            const DiskFileSystem fs(root);
+            const GameConfig::TextureConfig textureConfig(GameConfig::TexturePackageConfig(GameConfig::PackageFormatConfig("wad", "idmip")),
+                                                          GameConfig::PackageFormatConfig("D", "idmip"),
+                                                          palettePath,
+                                                          "wad",
+                                                          Path());
+            NullLogger logger;
+            TextureLoader loader(fs, Path::List{ root }, textureConfig, logger);
+
+            timeLambda([&]() {
+                const auto results = loader.loadTextureCollections(Path::List{ wadPath }, false);
+                ASSERT_EQ(TextureCount, results[0].collection->textureCount());
+            }, "Load " + std::to_string(TextureCount) + " textures without cache");
+
+            timeLambda([&]() {
+                const auto results = loader.loadTextureCollections(Path::List{ wadPath }, false, cacheDirectory);
+                ASSERT_EQ(TextureCount, results[0].collection->textureCount());
+            }, "Load " + std::to_string(TextureCount) + " textures with cold cache");
+
+            timeLambda([&]() {
+                const auto results = loader.loadTextureCollections(Path::List{ wadPath }, false, cacheDirectory);
+                ASSERT_EQ(TextureCount, results[0].collection->textureCount());
+            }, "Load " + std::to_string(TextureCount) + " textures with warm cache");
+
+            timeLambda([&]() {
+                const auto results = loader.loadTextureCollections(Path::List{ wadPath }, true, cacheDirectory);
+                ASSERT_EQ(TextureCount, results[0].collection->textureCount());
+            }, "Load " + std::to_string(TextureCount) + " textures lazily with warm cache");
+
+            for (const auto& path : Disk::getDirectoryContents(cacheDirectory)) {
+                std::remove((cacheDirectory + path).asString().c_str());
+            }
+            std::remove(cacheDirectory.asString().c_str());
+            std::remove((root + wadPath).asString().c_str());
+            std::remove((root + palettePath).asString().c_str());
+        }
+    }
+}
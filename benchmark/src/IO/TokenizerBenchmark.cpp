@@ -0,0 +1,62 @@
+/*
+ Copyright (C) 2010-2019 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+
+#include "BenchmarkUtils.h"
+
+#include "IO/DiskIO.h"
+#include "IO/File.h"
+#include "IO/Path.h"
+#include "IO/Reader.h"
+#include "IO/StandardMapParser.h"
+
+#include <cstdio>
+
+namespace TrenchBroom {
+    namespace IO {
+        TEST(TokenizerBenchmark, benchTokenizeMap) {
+            const auto mapPath = Disk::getCurrentWorkingDir() + Path("fixture/benchmark/AABBTree/ne_ruins.map");
+            const auto file = Disk::openFile(mapPath);
+            auto fileReader = file->reader().buffer();
+
+            static const size_t Repetitions = 10;
+            size_t tokenCount = 0;
+            double sum = 0.0;
+
+            const auto seconds = timeLambda([&]() {
+                for (size_t i = 0; i < Repetitions; ++i) {
+                    QuakeMapTokenizer tokenizer(std::begin(fileReader), std::end(fileReader));
+                    auto token = tokenizer.nextToken();
+                    while (!token.hasType(QuakeMapToken::Eof)) {
+                        // the parser converts every number, so the conversion is part of the benchmark
+                        if (token.hasType(QuakeMapToken::Number)) {
+                            sum += token.toFloat<double>();
+                        }
+                        ++tokenCount;
+                        token = tokenizer.nextToken();
+                    }
+                }
+            }, "Tokenize map " + std::to_string(Repetitions) + " times");
+
+            const auto megabytes = static_cast<double>(fileReader.size() * Repetitions) / (1024.0 * 1024.0);
+            std::printf("Tokenized %zu tokens at %f MB/s (checksum %f)\n", tokenCount, megabytes / seconds, sum);
+        }
+    }
+}
@@ -0,0 +1,56 @@
+/*
+ Copyright (C) 2010-2019 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+
+#include "BenchmarkUtils.h"
+
+#include "IO/DiskIO.h"
+#include "IO/File.h"
+#include "IO/Path.h"
+#include "IO/Reader.h"
+#include "IO/TestParserStatus.h"
+#include "IO/WorldReader.h"
+#include "Model/World.h"
+
+#include <vecmath/bbox.h>
+
+namespace TrenchBroom {
+    namespace IO {
+        TEST(WorldReaderBenchmark, benchReadMap) {
+            const auto mapPath = Disk::getCurrentWorkingDir() + Path("fixture/benchmark/AABBTree/ne_ruins.map");
+            const auto file = Disk::openFile(mapPath);
+            auto fileReader = file->reader().buffer();
+
+            const vm::bbox3 worldBounds(8192);
+
+            timeLambda([&]() {
+                TestParserStatus status;
+                WorldReader worldReader(std::begin(fileReader), std::end(fileReader));
+                auto world = worldReader.read(Model::MapFormat::Standard, worldBounds, status);
+            }, "Read map sequentially");
+
+            timeLambda([&]() {
+                TestParserStatus status;
+                WorldReader worldReader(std::begin(fileReader), std::end(fileReader));
+                auto world = worldReader.readInParallel(Model::MapFormat::Standard, worldBounds, status);
+            }, "Read map in parallel");
+        }
+    }
+}
@@ -0,0 +1,83 @@
+/*
+ Copyright (C) 2010-2019 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+
+#include "BenchmarkUtils.h"
+
+#include "CollectionUtils.h"
+#include "Model/AttributableNodeIndex.h"
+#include "Model/Entity.h"
+#include "Model/EntityAttributes.h"
+
+#include <string>
+
+namespace TrenchBroom {
+    namespace Model {
+        static constexpr size_t NumEntities = 100'000;
+        static constexpr size_t NumClassnames = 16;
+
+        TEST(AttributableNodeIndexBenchmark, benchInsertRemoveQuery) {
+            EntityList entities;
+            for (size_t i = 0; i < NumEntities; ++i) {
+                auto* entity = new Entity();
+                entity->addOrUpdateAttribute(AttributeNames::Classname, "class" + std::to_string(i % NumClassnames));
+                entity->addOrUpdateAttribute(AttributeNames::Origin, std::to_string(i) + " " + std::to_string(i % 64) + " 0");
+                entity->addOrUpdateAttribute(AttributeNames::Targetname, "t" + std::to_string(i));
+                entity->addOrUpdateAttribute(AttributeNames::Target, "t" + std::to_string(i + 1));
+                entity->addOrUpdateAttribute(AttributeNames::Spawnflags, std::to_string(i % 8));
+                entity->addOrUpdateAttribute("angle", "90");
+                entities.push_back(entity);
+            }
+
+            AttributableNodeIndex index;
+            timeLambda([&]() {
+                for (auto* entity : entities) {
+                    index.addAttributableNode(entity);
+                }
+            }, "insert " + std::to_string(NumEntities) + " entities");
+
+            timeLambda([&]() {
+                for (size_t i = 0; i < NumEntities; ++i) {
+                    ASSERT_EQ(1u, index.findAttributableNodes(AttributableNodeIndexQuery::exact(AttributeNames::Targetname), "t" + std::to_string(i)).size());
+                }
+            }, "query " + std::to_string(NumEntities) + " targetnames");
+
+            timeLambda([&]() {
+                for (size_t i = 0; i < NumClassnames; ++i) {
+                    ASSERT_EQ(NumEntities / NumClassnames, index.findAttributableNodes(AttributableNodeIndexQuery::exact(AttributeNames::Classname), "class" + std::to_string(i)).size());
+                }
+            }, "query " + std::to_string(NumClassnames) + " classnames");
+
+            timeLambda([&]() {
+                for (size_t i = 0; i < 100; ++i) {
+                    ASSERT_EQ(1u, index.findAttributableNodes(AttributableNodeIndexQuery::numbered(AttributeNames::Target), "t" + std::to_string(i + 1)).size());
+                }
+            }, "query 100 numbered targets");
+
+            timeLambda([&]() {
+                for (auto* entity : entities) {
+                    index.removeAttributableNode(entity);
+                }
+            }, "remove " + std::to_string(NumEntities) + " entities");
+
+            VectorUtils::clearAndDelete(entities);
+        }
+    }
+}
@@ -0,0 +1,88 @@
+/*
+ Copyright (C) 2010-2019 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+
+#include "BenchmarkUtils.h"
+
+#include "CollectionUtils.h"
+#include "Assets/Texture.h"
+#include "Model/Brush.h"
+#include "Model/BrushBuilder.h"
+#include "Model/BrushFace.h"
+#include "Model/MapFormat.h"
+#include "Model/World.h"
+
+#include <vecmath/mat.h>
+#include <vecmath/mat_ext.h>
+
+#include <string>
+#include <vector>
+
+namespace TrenchBroom {
+    namespace Model {
+        static constexpr size_t NumBrushes = 64'000;
+        static constexpr size_t NumTextures = 256;
+
+        TEST(BrushTransformBenchmark, benchTransformBrushes) {
+            std::vector<Assets::Texture*> textures;
+            for (size_t i = 0; i < NumTextures; ++i) {
+                textures.push_back(new Assets::Texture("texture " + std::to_string(i), 64, 64));
+            }
+
+            const vm::bbox3 worldBounds(4096.0);
+            World world(MapFormat::Standard, worldBounds);
+            BrushBuilder builder(&world, worldBounds);
+
+            BrushList brushes;
+            size_t currentTextureIndex = 0;
+            for (size_t i = 0; i < NumBrushes; ++i) {
+                auto* brush = builder.createCube(64.0, "");
+                for (auto* face : brush->faces()) {
+                    face->setTexture(textures.at((currentTextureIndex++) % NumTextures));
+                }
+                brushes.push_back(brush);
+            }
+
+            const auto rotation = vm::rotationMatrix(vm::vec3::pos_z, vm::toRadians(15.0));
+            const auto inverse = vm::rotationMatrix(vm::vec3::pos_z, vm::toRadians(-15.0));
+
+            timeLambda([&]() {
+                for (auto* brush : brushes) {
+                    brush->transform(rotation, true, worldBounds);
+                }
+            }, "transform " + std::to_string(brushes.size()) + " brushes one by one");
+
+            timeLambda([&]() {
+                Brush::transform(brushes, inverse, true, worldBounds);
+            }, "transform " + std::to_string(brushes.size()) + " brushes in parallel");
+
+            timeLambda([&]() {
+                ASSERT_TRUE(Brush::canTransform(brushes, rotation, worldBounds));
+            }, "check whether " + std::to_string(brushes.size()) + " brushes can be transformed");
+
+            timeLambda([&]() {
+                Brush::rebuildGeometry(brushes, worldBounds);
+            }, "rebuild the geometry of " + std::to_string(brushes.size()) + " brushes in parallel");
+
+            VectorUtils::clearAndDelete(brushes);
+            VectorUtils::clearAndDelete(textures);
+        }
+    }
+}
@@ -0,0 +1,102 @@
+/*
+ Copyright (C) 2010-2019 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+
+#include "BenchmarkUtils.h"
+
+#include "CollectionUtils.h"
+#include "Model/Entity.h"
+#include "Model/EntityAttributes.h"
+#include "Model/Layer.h"
+#include "Model/LinkSourceIssueGenerator.h"
+#include "Model/LinkTargetIssueGenerator.h"
+#include "Model/MapFormat.h"
+#include "Model/World.h"
+
+#include <string>
+
+namespace TrenchBroom {
+    namespace Model {
+        static constexpr size_t NumEntities = 20'000;
+        static constexpr size_t NumHubs = 100;
+
+        static String origin(const size_t i) {
+            // spread the entities over the map so that they don't all share the same bounds
+            return std::to_string(i % 128 * 32) + " " + std::to_string(i / 128 % 128 * 32) + " " + std::to_string(i / (128 * 128) * 32);
+        }
+
+        TEST(EntityLinkBenchmark, benchLinkEntities) {
+            const vm::bbox3 worldBounds(4096.0);
+            World world(MapFormat::Standard, worldBounds);
+            world.registerIssueGenerator(new LinkSourceIssueGenerator());
+            world.registerIssueGenerator(new LinkTargetIssueGenerator());
+            world.validateQueuedIssues();
+
+            // every entity targets the next one in a chain and kills one of a few hubs
+            EntityList entities;
+            for (size_t i = 0; i < NumEntities; ++i) {
+                auto* entity = world.createEntity();
+                entity->addOrUpdateAttribute(AttributeNames::Classname, "trigger_relay");
+                entity->addOrUpdateAttribute(AttributeNames::Origin, origin(i));
+                entity->addOrUpdateAttribute(AttributeNames::Targetname, "e" + std::to_string(i));
+                entity->addOrUpdateAttribute(AttributeNames::Target, "e" + std::to_string(i + 1));
+                entity->addOrUpdateAttribute(AttributeNames::Killtarget, "hub" + std::to_string(i % NumHubs));
+                entities.push_back(entity);
+            }
+
+            EntityList hubs;
+            for (size_t i = 0; i < NumHubs; ++i) {
+                auto* hub = world.createEntity();
+                hub->addOrUpdateAttribute(AttributeNames::Classname, "func_wall");
+                hub->addOrUpdateAttribute(AttributeNames::Origin, origin(NumEntities + i));
+                hub->addOrUpdateAttribute(AttributeNames::Targetname, "hub" + std::to_string(i));
+                hubs.push_back(hub);
+            }
+
+            timeLambda([&]() {
+                for (auto* entity : entities) {
+                    world.defaultLayer()->addChild(entity);
+                }
+                for (auto* hub : hubs) {
+                    world.defaultLayer()->addChild(hub);
+                }
+            }, "link " + std::to_string(NumEntities + NumHubs) + " entities");
+
+            timeLambda([&]() {
+                world.validateQueuedIssues();
+            }, "validate the links of " + std::to_string(NumEntities + NumHubs) + " entities");
+
+            timeLambda([&]() {
+                for (size_t i = 0; i < NumHubs; ++i) {
+                    hubs[i]->addOrUpdateAttribute(AttributeNames::Targetname, "renamed_hub" + std::to_string(i));
+                    world.validateQueuedIssues();
+                }
+            }, "rename and revalidate " + std::to_string(NumHubs) + " link targets");
+
+            timeLambda([&]() {
+                for (auto* entity : entities) {
+                    world.defaultLayer()->removeChild(entity);
+                }
+            }, "unlink " + std::to_string(NumEntities) + " entities");
+
+            VectorUtils::clearAndDelete(entities);
+        }
+    }
+}
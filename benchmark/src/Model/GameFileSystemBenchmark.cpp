@@ -0,0 +1,163 @@
+/*
+ Copyright (C) 2010-2019 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+
+#include "BenchmarkUtils.h"
+
+#include "Logger.h"
+#include "IO/DiskIO.h"
+#include "IO/File.h"
+#include "IO/IdPakFileSystem.h"
+#include "IO/Path.h"
+#include "Model/GameConfig.h"
+#include "Model/GameFileSystem.h"
+
+#include <cstdio>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace TrenchBroom {
+    namespace Model {
+        static constexpr size_t NumPackages = 50;
+        static constexpr size_t NumFilesPerPackage = 400;
+        static constexpr size_t NumLookups = 20'000;
+
+        static String fileName(const size_t i) {
+            return "data/d" + std::to_string(i % 16) + "/f" + std::to_string(i) + ".dat";
+        }
+
+        static String intBytes(const size_t value) {
+            String result;
+            for (size_t i = 0; i < 4; ++i) {
+                result.push_back(static_cast<char>((value >> (8 * i)) & 0xFF));
+            }
+            return result;
+        }
+
+        static void writePak(const IO::Path& path, const size_t first, const size_t count) {
+            // header, followed by the file contents and the directory
+            String data = "PACK" + String(8, '\0');
+            String directory;
+            for (size_t i = first; i < first + count; ++i) {
+                const auto contents = path.lastComponent().asString();
+                auto entry = fileName(i);
+                entry.resize(56, '\0');
+                entry += intBytes(data.size());
+                entry += intBytes(contents.size());
+                directory += entry;
+                data += contents;
+            }
+
+            const auto directoryAddress = data.size();
+            data += directory;
+            data.replace(4, 4, intBytes(directoryAddress));
+            data.replace(8, 4, intBytes(directory.size()));
+
+            std::ofstream stream(path.asString(), std::ios::out | std::ios::binary | std::ios::trunc);
+            stream << data;
+        }
+
+        TEST(GameFileSystemBenchmark, benchLookupFiles) {
+            const auto gamePath = IO::Disk::getCurrentWorkingDir() + IO::Path("game_file_system_benchmark");
+            const auto searchPath = gamePath + IO::Path("id1");
+            IO::Disk::ensureDirectoryExists(searchPath);
+
+            // every package overrides half of the files of its predecessor
+            IO::Path::List pakPaths;
+            for (size_t i = 0; i < NumPackages; ++i) {
+                const auto pakName = "pak" + String(i < 10 ? "0" : "") + std::to_string(i) + ".pak";
+                pakPaths.push_back(searchPath + IO::Path(pakName));
+                writePak(pakPaths.back(), i * NumFilesPerPackage / 2, NumFilesPerPackage);
+            }
+
+            const auto numNames = (NumPackages + 1) * NumFilesPerPackage / 2;
+            IO::Path::List lookups;
+            for (size_t i = 0; i < NumLookups; ++i) {
+                // every fourth lookup misses
+                const auto index = (i * 7919) % numNames;
+                lookups.push_back(IO::Path(i % 4 == 0 ? "data/missing/f" + std::to_string(index) + ".dat" : fileName(index)));
+            }
+
+            const auto config = GameConfig(
+                "Benchmark",
+                IO::Path(),
+                IO::Path(),
+                false,
+                GameConfig::MapFormatConfig::List(),
+                GameConfig::FileSystemConfig(IO::Path("id1"), GameConfig::PackageFormatConfig("pak", "idpak")),
+                GameConfig::TextureConfig(),
+                GameConfig::EntityConfig(),
+                GameConfig::FaceAttribsConfig(),
+                std::vector<SmartTag>());
+
+            NullLogger logger;
+            GameFileSystem gameFS;
+            timeLambda([&]() {
+                gameFS.initialize(config, gamePath, {}, logger);
+            }, "index " + std::to_string(NumPackages) + " packages");
+
+            // the same packages as a plain chain, the last package is asked first
+            std::shared_ptr<IO::FileSystem> chainFS;
+            for (const auto& pakPath : pakPaths) {
+                chainFS = std::make_shared<IO::IdPakFileSystem>(chainFS, pakPath);
+            }
+
+            size_t chainHits = 0;
+            timeLambda([&]() {
+                for (const auto& path : lookups) {
+                    if (chainFS->fileExists(path)) {
+                        ++chainHits;
+                    }
+                }
+            }, "look up " + std::to_string(NumLookups) + " files in a chain of " + std::to_string(NumPackages) + " packages");
+
+            size_t indexHits = 0;
+            timeLambda([&]() {
+                for (const auto& path : lookups) {
+                    if (gameFS.fileExists(path)) {
+                        ++indexHits;
+                    }
+                }
+            }, "look up " + std::to_string(NumLookups) + " files in the game file system index");
+
+            ASSERT_EQ(chainHits, indexHits);
+            ASSERT_EQ(NumLookups - NumLookups / 4, indexHits);
+
+            timeLambda([&]() {
+                for (size_t i = 1; i < NumLookups; i += 4) {
+                    gameFS.openFile(lookups[i]);
+                }
+            }, "open " + std::to_string(NumLookups / 4) + " files in the game file system index");
+
+            for (size_t i = 1; i < NumLookups; i += 400) {
+                ASSERT_EQ(chainFS->openFile(lookups[i])->size(), gameFS.openFile(lookups[i])->size());
+            }
+            ASSERT_EQ(chainFS->findItems(IO::Path("data/d3")).size(), gameFS.findItems(IO::Path("data/d3")).size());
+
+            for (const auto& pakPath : pakPaths) {
+                std::remove(pakPath.asString().c_str());
+            }
+            std::remove(searchPath.asString().c_str());
+            std::remove(gamePath.asString().c_str());
+        }
+    }
+}
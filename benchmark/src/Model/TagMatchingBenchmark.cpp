@@ -0,0 +1,150 @@
+/*
+ Copyright (C) 2010-2019 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+
+#include "BenchmarkUtils.h"
+
+#include "CollectionUtils.h"
+#include "Assets/Texture.h"
+#include "Model/Brush.h"
+#include "Model/BrushBuilder.h"
+#include "Model/BrushFace.h"
+#include "Model/Entity.h"
+#include "Model/EntityAttributes.h"
+#include "Model/Layer.h"
+#include "Model/MapFormat.h"
+#include "Model/Tag.h"
+#include "Model/TagAttribute.h"
+#include "Model/TagManager.h"
+#include "Model/TagMatcher.h"
+#include "Model/World.h"
+
+#include <string>
+#include <vector>
+
+namespace TrenchBroom {
+    namespace Model {
+        static constexpr size_t NumBrushes = 1'000'000 / 6 + 1;
+        static constexpr size_t NumTextures = 256;
+        static constexpr size_t NumEntities = 1'000;
+
+        static void registerSmartTags(TagManager& tagManager) {
+            // the tags of the Quake 2 game configuration
+            tagManager.registerSmartTag(SmartTag("Trigger", {}, std::make_unique<EntityClassNameTagMatcher>("trigger*", "trigger")));
+            tagManager.registerSmartTag(SmartTag("Clip", {}, std::make_unique<TextureNameTagMatcher>("clip")));
+            tagManager.registerSmartTag(SmartTag("Skip", {}, std::make_unique<TextureNameTagMatcher>("skip")));
+            tagManager.registerSmartTag(SmartTag("Hint", {}, std::make_unique<TextureNameTagMatcher>("hint*")));
+            tagManager.registerSmartTag(SmartTag("Detail", {}, std::make_unique<ContentFlagsTagMatcher>(1 << 27)));
+            tagManager.registerSmartTag(SmartTag("Liquid", {}, std::make_unique<ContentFlagsTagMatcher>((1 << 3) | (1 << 4) | (1 << 5))));
+            tagManager.registerSmartTag(SmartTag("Sky", {}, std::make_unique<SurfaceParmTagMatcher>("sky")));
+        }
+
+        TEST(TagMatchingBenchmark, benchInitializeFaceTags) {
+            std::vector<Assets::Texture*> textures;
+            for (size_t i = 0; i < NumTextures; ++i) {
+                String name;
+                switch (i % 16) {
+                    case 0:
+                        name = "common/clip";
+                        break;
+                    case 1:
+                        name = "common/hint" + std::to_string(i);
+                        break;
+                    default:
+                        name = "e1u1/texture" + std::to_string(i);
+                        break;
+                }
+
+                auto* texture = new Assets::Texture(name, 64, 64);
+                if (i % 32 == 2) {
+                    texture->setSurfaceParms({ "sky" });
+                }
+                textures.push_back(texture);
+            }
+
+            const vm::bbox3 worldBounds(8192.0);
+            World world(MapFormat::Quake2, worldBounds);
+            BrushBuilder builder(&world, worldBounds);
+
+            EntityList entities;
+            for (size_t i = 0; i < NumEntities; ++i) {
+                auto* entity = world.createEntity();
+                entity->addOrUpdateAttribute(AttributeNames::Classname, i % 2 == 0 ? "trigger_multiple" : "func_wall");
+                entities.push_back(entity);
+            }
+
+            BrushList brushes;
+            size_t currentTextureIndex = 0;
+            for (size_t i = 0; i < NumBrushes; ++i) {
+                auto* brush = builder.createCube(64.0, "");
+                for (auto* face : brush->faces()) {
+                    face->setTexture(textures.at((currentTextureIndex++) % NumTextures));
+                    face->setSurfaceContents(i % 7 == 0 ? (1 << 27) : (i % 11 == 0 ? (1 << 3) : 0));
+                }
+                if (i % 10 == 0) {
+                    entities[i / 10 % NumEntities]->addChild(brush);
+                } else {
+                    world.defaultLayer()->addChild(brush);
+                }
+                brushes.push_back(brush);
+            }
+
+            for (auto* entity : entities) {
+                world.defaultLayer()->addChild(entity);
+            }
+
+            TagManager tagManager;
+            registerSmartTags(tagManager);
+
+            size_t faceCount = 0;
+            for (const auto* brush : brushes) {
+                faceCount += brush->faces().size();
+            }
+
+            timeLambda([&]() {
+                for (auto* brush : brushes) {
+                    brush->initializeTags(tagManager);
+                }
+            }, "initialize the tags of " + std::to_string(faceCount) + " faces one by one");
+
+            timeLambda([&]() {
+                tagManager.clearTagCache();
+                Brush::initializeTags(brushes, tagManager);
+            }, "initialize the tags of " + std::to_string(faceCount) + " faces in parallel");
+
+            size_t taggedFaces = 0;
+            for (const auto* brush : brushes) {
+                for (const auto* face : brush->faces()) {
+                    if (face->hasAnyTag()) {
+                        ++taggedFaces;
+                    }
+                }
+            }
+            ASSERT_LT(0u, taggedFaces);
+
+            for (auto* brush : brushes) {
+                for (auto* face : brush->faces()) {
+                    face->unsetTexture();
+                }
+            }
+            VectorUtils::clearAndDelete(textures);
+        }
+    }
+}
@@ -0,0 +1,115 @@
+/*
+ Copyright (C) 2010-2019 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+
+#include "BenchmarkUtils.h"
+
+#include "IO/DiskIO.h"
+#include "IO/File.h"
+#include "IO/Path.h"
+#include "IO/Reader.h"
+#include "IO/TestParserStatus.h"
+#include "IO/WorldReader.h"
+#include "Model/Brush.h"
+#include "Model/EditorContext.h"
+#include "Model/HitAdapter.h"
+#include "Model/HitFilter.h"
+#include "Model/HitQuery.h"
+#include "Model/Layer.h"
+#include "Model/PickResult.h"
+#include "Model/World.h"
+
+#include <vecmath/bbox.h>
+#include <vecmath/ray.h>
+#include <vecmath/vec.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace TrenchBroom {
+    namespace Model {
+        static constexpr size_t NumMouseMoves = 2000;
+
+        static std::unique_ptr<World> loadWorld() {
+            const auto mapPath = IO::Disk::getCurrentWorkingDir() + IO::Path("fixture/benchmark/AABBTree/ne_ruins.map");
+            const auto file = IO::Disk::openFile(mapPath);
+            auto fileReader = file->reader().buffer();
+
+            IO::TestParserStatus status;
+            IO::WorldReader worldReader(std::begin(fileReader), std::end(fileReader));
+
+            const vm::bbox3 worldBounds(8192);
+            return worldReader.read(MapFormat::Standard, worldBounds, status);
+        }
+
+        static std::vector<vm::ray3> makeMouseMoveRays(const vm::bbox3& bounds, const size_t count) {
+            // a camera at the top of one corner of the map looking across it, with the mouse sweeping over the view in a zig zag
+            // pattern, so that most rays pass through many brushes
+            const auto size = bounds.size();
+            const auto center = bounds.center();
+            const auto origin = vm::vec3(bounds.min.x(), bounds.min.y(), bounds.max.z());
+
+            std::vector<vm::ray3> result;
+            result.reserve(count);
+            for (size_t i = 0; i < count; ++i) {
+                const auto u = static_cast<double>(i % 100u) / 100.0 - 0.5;
+                const auto v = static_cast<double>(i / 100u) / static_cast<double>(count / 100u) - 0.5;
+                const auto target = center + vm::vec3(u * size.x(), v * size.y(), 0.0);
+                result.push_back(vm::ray3(origin, vm::normalize(target - origin)));
+            }
+            return result;
+        }
+
+        TEST(WorldPickBenchmark, pickNearestBrush) {
+            auto world = loadWorld();
+            const EditorContext editorContext;
+            const auto rays = makeMouseMoveRays(world->defaultLayer()->bounds(), NumMouseMoves);
+
+            // build the flattened node tree before timing
+            auto warmUp = PickResult::byDistance(editorContext);
+            world->pick(rays.front(), warmUp);
+
+            std::vector<const BrushFace*> expected;
+            expected.reserve(rays.size());
+            timeLambda([&]() {
+                for (const auto& ray : rays) {
+                    auto pickResult = PickResult::byDistance(editorContext);
+                    world->pick(ray, pickResult);
+                    expected.push_back(hitToFace(pickResult.query().pickable().type(Brush::BrushHit).first()));
+                }
+            }, "pick all hits for " + std::to_string(rays.size()) + " rays");
+
+            std::vector<const BrushFace*> actual;
+            actual.reserve(rays.size());
+            timeLambda([&]() {
+                for (const auto& ray : rays) {
+                    auto* filter = new HitFilterChain(new VisibleHitFilter(editorContext),
+                                                      new HitFilterChain(new ContextHitFilter(editorContext), new TypedHitFilter(Brush::BrushHit)));
+                    auto pickResult = PickResult::byDistance(editorContext, 1, filter);
+                    world->pick(ray, pickResult);
+                    actual.push_back(hitToFace(pickResult.query().pickable().type(Brush::BrushHit).first()));
+                }
+            }, "pick the nearest brush hit for " + std::to_string(rays.size()) + " rays");
+
+            ASSERT_EQ(expected, actual);
+        }
+    }
+}
@@ -0,0 +1,97 @@
+/*
+ Copyright (C) 2010-2019 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+
+#include "BenchmarkUtils.h"
+
+#include "TrenchBroom.h"
+#include "Polyhedron.h"
+#include "Polyhedron_DefaultPayload.h"
+#include "Polyhedron_Instantiation.h"
+
+#include <vecmath/bbox.h>
+#include <vecmath/plane.h>
+#include <vecmath/vec.h>
+
+#include <random>
+#include <string>
+#include <vector>
+
+namespace TrenchBroom {
+    using Polyhedron3d = Polyhedron<FloatType, DefaultPolyhedronPayload, DefaultPolyhedronPayload>;
+
+    static constexpr size_t NumPolyhedra = 64'000;
+    static constexpr size_t NumHullPoints = 24;
+
+    TEST(PolyhedronBenchmark, benchBuildPolyhedra) {
+        const vm::bbox3 worldBounds(4096.0);
+
+        // the planes of a wedge, clipping a world bounds sized cube like a brush geometry is built
+        const std::vector<vm::plane3> planes {
+            vm::plane3(0.0, vm::vec3::neg_x),
+            vm::plane3(0.0, vm::vec3::neg_y),
+            vm::plane3(0.0, vm::vec3::neg_z),
+            vm::plane3(64.0, vm::vec3::pos_z),
+            vm::plane3(64.0, vm::normalize(vm::vec3(1.0, 1.0, 0.0)))
+        };
+
+        std::vector<Polyhedron3d> clipped;
+        clipped.reserve(NumPolyhedra);
+        timeLambda([&]() {
+            for (size_t i = 0; i < NumPolyhedra; ++i) {
+                clipped.emplace_back(worldBounds);
+                for (const auto& plane : planes) {
+                    clipped.back().clip(plane);
+                }
+            }
+        }, "build " + std::to_string(NumPolyhedra) + " polyhedra by clipping");
+
+        std::mt19937 engine(1234);
+        std::uniform_real_distribution<FloatType> distribution(-64.0, 64.0);
+        std::vector<std::vector<vm::vec3>> pointSets(NumPolyhedra);
+        for (auto& points : pointSets) {
+            for (size_t i = 0; i < NumHullPoints; ++i) {
+                points.emplace_back(distribution(engine), distribution(engine), distribution(engine));
+            }
+        }
+
+        std::vector<Polyhedron3d> hulls;
+        hulls.reserve(NumPolyhedra);
+        timeLambda([&]() {
+            for (const auto& points : pointSets) {
+                hulls.emplace_back(points);
+            }
+        }, "build " + std::to_string(NumPolyhedra) + " convex hulls of " + std::to_string(NumHullPoints) + " points");
+
+        std::vector<Polyhedron3d> copies;
+        copies.reserve(NumPolyhedra);
+        timeLambda([&]() {
+            for (const auto& hull : hulls) {
+                copies.push_back(hull);
+            }
+        }, "copy " + std::to_string(NumPolyhedra) + " convex hulls");
+
+        timeLambda([&]() {
+            copies.clear();
+            hulls.clear();
+            clipped.clear();
+        }, "destroy " + std::to_string(3 * NumPolyhedra) + " polyhedra");
+    }
+}
@@ -22,6 +22,7 @@
 #include "BenchmarkUtils.h"
 
 #include "CollectionUtils.h"
+#include "ParallelUtils.h"
 #include "Assets/Texture.h"
 #include "Model/Brush.h"
 #include "Model/BrushBuilder.h"
@@ -127,6 +128,31 @@ namespace TrenchBroom {
             VectorUtils::clearAndDelete(brushes);
             VectorUtils::clearAndDelete(textures);
         }
+
+        TEST(BrushRendererBenchmark, benchValidateScaling) {
+            auto brushesTextures = makeBrushes();
+            std::vector<Model::Brush*> brushes = brushesTextures.first;
+            std::vector<Assets::Texture*> textures = brushesTextures.second;
+
+            // validation is spread over all threads, so compare these timings across machines with different core counts
+            std::cout << "validating with " << ParallelUtils::threadCount() << " threads\n";
+
+            for (size_t count = NumBrushes / 4; count <= NumBrushes; count *= 2) {
+                const Model::BrushList subset(std::begin(brushes), std::next(std::begin(brushes), static_cast<std::ptrdiff_t>(count)));
+
+                BrushRenderer r;
+                r.addBrushes(subset);
+
+                timeLambda([&](){ r.validate(); }, "validate " + std::to_string(count) + " new brushes");
+
+                // this is what happens when the filter changes, e.g. when the selection changes
+                r.invalidate();
+                timeLambda([&](){ r.validate(); }, "revalidate " + std::to_string(count) + " brushes");
+            }
+
+            VectorUtils::clearAndDelete(brushes);
+            VectorUtils::clearAndDelete(textures);
+        }
     }
 }
 
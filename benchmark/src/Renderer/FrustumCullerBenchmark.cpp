@@ -0,0 +1,155 @@
+/*
+ Copyright (C) 2010-2019 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+
+#include "BenchmarkUtils.h"
+
+#include "IO/DiskIO.h"
+#include "IO/File.h"
+#include "IO/Path.h"
+#include "IO/Reader.h"
+#include "IO/TestParserStatus.h"
+#include "IO/WorldReader.h"
+#include "Model/Brush.h"
+#include "Model/Entity.h"
+#include "Model/NodeVisitor.h"
+#include "Model/World.h"
+#include "Renderer/FrustumCuller.h"
+#include "Renderer/PerspectiveCamera.h"
+
+#include <vecmath/bbox.h>
+#include <vecmath/ray.h>
+#include <vecmath/vec.h>
+
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace TrenchBroom {
+    namespace Renderer {
+        static constexpr size_t NumFrames = 1000;
+
+        class CollectCullableNodes : public Model::NodeVisitor {
+        private:
+            Model::NodeList m_nodes;
+        public:
+            const Model::NodeList& nodes() const {
+                return m_nodes;
+            }
+        private:
+            void doVisit(Model::World* world) override {}
+            void doVisit(Model::Layer* layer) override {}
+            void doVisit(Model::Group* group) override {}
+            void doVisit(Model::Entity* entity) override {
+                m_nodes.push_back(entity);
+            }
+            void doVisit(Model::Brush* brush) override {
+                m_nodes.push_back(brush);
+            }
+        };
+
+        static std::unique_ptr<Model::World> loadWorld() {
+            const auto mapPath = IO::Disk::getCurrentWorkingDir() + IO::Path("fixture/benchmark/AABBTree/ne_ruins.map");
+            const auto file = IO::Disk::openFile(mapPath);
+            auto fileReader = file->reader().buffer();
+
+            IO::TestParserStatus status;
+            IO::WorldReader worldReader(std::begin(fileReader), std::end(fileReader));
+
+            const vm::bbox3 worldBounds(8192);
+            return worldReader.read(Model::MapFormat::Standard, worldBounds, status);
+        }
+
+        static std::vector<vm::ray3f> makeViews(const vm::bbox3& bounds) {
+            // look from the center of the map in every horizontal direction, and from the corners towards the center
+            std::vector<vm::ray3f> result;
+            const auto center = vm::vec3f(bounds.center());
+
+            const vm::vec3f directions[] = { vm::vec3f::pos_x, vm::vec3f::neg_x, vm::vec3f::pos_y, vm::vec3f::neg_y };
+            for (const auto& direction : directions) {
+                result.emplace_back(center, direction);
+            }
+
+            const vm::vec3f corners[] = { vm::vec3f(bounds.min), vm::vec3f(bounds.max) };
+            for (const auto& corner : corners) {
+                result.emplace_back(corner, vm::normalize(center - corner));
+            }
+            return result;
+        }
+
+        static size_t cullAll(const Model::NodeList& nodes, const FrustumCuller& culler) {
+            size_t visible = 0;
+            for (const auto* node : nodes) {
+                if (culler.relation(node->bounds()) != VolumeRelation::Outside) {
+                    ++visible;
+                }
+            }
+            return visible;
+        }
+
+        static void benchCulling(const FloatType maxDistance) {
+            auto world = loadWorld();
+
+            CollectCullableNodes collect;
+            world->acceptAndRecurse(collect);
+            const auto& nodes = collect.nodes();
+
+            vm::bbox3 bounds = nodes.front()->bounds();
+            for (const auto* node : nodes) {
+                bounds = vm::merge(bounds, node->bounds());
+            }
+
+            const auto views = makeViews(bounds);
+            for (size_t i = 0; i < views.size(); ++i) {
+                const PerspectiveCamera camera(90.0f, 1.0f, 8000.0f, Camera::Viewport(0, 0, 1920, 1080), views[i].origin, views[i].direction, vm::vec3f::pos_z);
+                const FrustumCuller culler(camera, maxDistance);
+
+                size_t linearCount = 0;
+                timeLambda([&]() {
+                    for (size_t j = 0; j < NumFrames; ++j) {
+                        linearCount = cullAll(nodes, culler);
+                    }
+                }, "camera " + std::to_string(i) + ": test every node in " + std::to_string(NumFrames) + " frames");
+
+                size_t treeCount = 0;
+                timeLambda([&]() {
+                    Model::NodeList visible;
+                    for (size_t j = 0; j < NumFrames; ++j) {
+                        visible.clear();
+                        culler.findVisibleNodes(*world, visible);
+                    }
+                    treeCount = visible.size();
+                }, "camera " + std::to_string(i) + ": query the node tree in " + std::to_string(NumFrames) + " frames");
+
+                std::cout << "camera " << i << ": " << treeCount << " of " << nodes.size() << " nodes visible" << std::endl;
+                ASSERT_EQ(linearCount, treeCount);
+            }
+        }
+
+        TEST(FrustumCullerBenchmark, benchFrustumCulling) {
+            benchCulling(0.0);
+        }
+
+        TEST(FrustumCullerBenchmark, benchDistanceCulling) {
+            benchCulling(1024.0);
+        }
+    }
+}
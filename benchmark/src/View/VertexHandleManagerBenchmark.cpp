@@ -0,0 +1,107 @@
+/*
+ Copyright (C) 2010-2019 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+
+#include "BenchmarkUtils.h"
+
+#include "PreferenceManager.h"
+#include "Preferences.h"
+#include "Model/Hit.h"
+#include "Model/PickResult.h"
+#include "Renderer/PerspectiveCamera.h"
+#include "View/VertexHandleManager.h"
+
+#include <vecmath/ray.h>
+#include <vecmath/vec.h>
+
+#include <string>
+#include <vector>
+
+namespace TrenchBroom {
+    namespace View {
+        static constexpr size_t GridSize = 47; // 47^3 = 103823 handles
+        static constexpr size_t NumPicks = 1000;
+
+        static std::vector<vm::ray3> makePickRays(const Renderer::Camera& camera) {
+            // sweep the mouse over the viewport like a user hovering over the handles
+            std::vector<vm::ray3> result;
+            result.reserve(NumPicks);
+
+            const auto& viewport = camera.viewport();
+            for (size_t i = 0; i < NumPicks; ++i) {
+                const auto x = static_cast<int>((i * 37u) % static_cast<size_t>(viewport.width));
+                const auto y = static_cast<int>((i * 23u) % static_cast<size_t>(viewport.height));
+                result.push_back(vm::ray3(camera.pickRay(x, y)));
+            }
+            return result;
+        }
+
+        TEST(VertexHandleManagerBenchmark, benchPickVertexHandles) {
+            VertexHandleManager manager;
+            timeLambda([&]() {
+                for (size_t x = 0; x < GridSize; ++x) {
+                    for (size_t y = 0; y < GridSize; ++y) {
+                        for (size_t z = 0; z < GridSize; ++z) {
+                            manager.add(vm::vec3(static_cast<FloatType>(x), static_cast<FloatType>(y), static_cast<FloatType>(z)) * 32.0);
+                        }
+                    }
+                }
+            }, "add " + std::to_string(GridSize * GridSize * GridSize) + " vertex handles");
+
+            const Renderer::PerspectiveCamera camera(90.0f, 1.0f, 8000.0f, Renderer::Camera::Viewport(0, 0, 1920, 1080), vm::vec3f(-1024.0f, 512.0f, 768.0f), vm::normalize(vm::vec3f(1.0f, 0.2f, -0.1f)), vm::vec3f::pos_z);
+            const auto pickRays = makePickRays(camera);
+
+            size_t indexedHits = 0;
+            timeLambda([&]() {
+                for (const auto& pickRay : pickRays) {
+                    Model::PickResult pickResult;
+                    manager.pick(pickRay, camera, pickResult);
+                    indexedHits += pickResult.size();
+                }
+            }, "pick vertex handles " + std::to_string(NumPicks) + " times using the spatial index");
+
+            const FloatType handleRadius = pref(Preferences::HandleRadius);
+            size_t linearHits = 0;
+            timeLambda([&]() {
+                for (const auto& pickRay : pickRays) {
+                    Model::PickResult pickResult;
+                    manager.VertexHandleManagerBaseT<vm::vec3>::pick([&](const vm::vec3& position) {
+                        const auto distance = camera.pickPointHandle(pickRay, position, handleRadius);
+                        if (vm::isnan(distance)) {
+                            return Model::Hit::NoHit;
+                        }
+                        return Model::Hit::hit(VertexHandleManager::HandleHit, distance, pickRay.pointAtDistance(distance), position);
+                    }, pickResult);
+                    linearHits += pickResult.size();
+                }
+            }, "pick vertex handles " + std::to_string(NumPicks) + " times by testing every handle");
+
+            ASSERT_EQ(linearHits, indexedHits);
+
+            timeLambda([&]() {
+                for (size_t i = 0; i < NumPicks; ++i) {
+                    const auto handle = vm::vec3(static_cast<FloatType>(i % GridSize), static_cast<FloatType>(i / GridSize % GridSize), 0.0) * 32.0;
+                    manager.select(handle);
+                    manager.deselect(handle);
+                }
+            }, "select and deselect " + std::to_string(NumPicks) + " vertex handles");
+        }
+    }
+}
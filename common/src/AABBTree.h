@@ -22,17 +22,24 @@
 
 #include "NodeTree.h"
 #include "Exceptions.h"
+#include "FlatAABBTree.h"
 #include <vecmath/scalar.h>
 #include <vecmath/bbox.h>
 #include <vecmath/ray.h>
 #include <vecmath/intersection.h>
 
 #include <algorithm>
+#include <array>
 #include <cassert>
 #include <functional>
+#include <iterator>
+#include <limits>
 #include <iostream>
 #include <list>
 #include <memory>
+#include <queue>
+#include <utility>
+#include <vector>
 
 /**
  * An axis aligned bounding box tree that allows for quick ray intersection queries.
@@ -46,9 +53,23 @@ template <typename T, size_t S, typename U, typename Cmp = std::less<U>>
 class AABBTree : public NodeTree<T,S,U,Cmp> {
 public:
     using List = typename NodeTree<T,S,U,Cmp>::List;
+    using Array = typename NodeTree<T,S,U,Cmp>::Array;
     using Box = typename NodeTree<T,S,U,Cmp>::Box;
+    using GetBounds = typename NodeTree<T,S,U,Cmp>::GetBounds;
     using DataType = typename NodeTree<T,S,U,Cmp>::DataType;
     using FloatType = typename NodeTree<T,S,U,Cmp>::FloatType;
+    using FlatTree = FlatAABBTree<T,S,U>;
+
+    /**
+     * Describes a change of the bounds of a data item, see update(const UpdateList&).
+     */
+    struct Update {
+        Box oldBounds;
+        Box newBounds;
+        U data;
+    };
+
+    using UpdateList = std::vector<Update>;
 private:
     class InnerNode;
     class LeafNode;
@@ -149,6 +170,32 @@ private:
          */
         virtual std::pair<Node*, bool> remove(const Box& bounds, const U& data) = 0;
 
+        /**
+         * Sets the bounds of the leaf with the given data in the subtree of which this node is the root to the given
+         * new bounds. The structure of the subtree is not changed.
+         *
+         * @param oldBounds the current bounds of the leaf
+         * @param newBounds the new bounds of the leaf
+         * @param data the data associated with the leaf
+         * @param refitAncestors whether to update the bounds of the inner nodes on the path to the leaf; if this is
+         *     false, then refitAll must be called once all leafs have been refitted
+         * @return true if the leaf was found and false otherwise
+         */
+        virtual bool refit(const Box& oldBounds, const Box& newBounds, const U& data, bool refitAncestors) = 0;
+
+        /**
+         * Recomputes the bounds of every inner node in the subtree of which this node is the root from the bounds of
+         * its children.
+         */
+        virtual void refitAll() = 0;
+
+        /**
+         * Appends this subtree to the given flat tree builder in depth first order.
+         *
+         * @param builder the builder to append to
+         */
+        virtual void flattenTo(typename FlatTree::Builder& builder) const = 0;
+
         /**
          * Accepts the given visitor.
          *
@@ -227,6 +274,20 @@ private:
             return m_height;
         }
 
+        /**
+         * Returns the left child of this node.
+         */
+        const Node* left() const {
+            return m_left;
+        }
+
+        /**
+         * Returns the right child of this node.
+         */
+        const Node* right() const {
+            return m_right;
+        }
+
         const LeafNode* find(const Box& bounds, const U& data) const override {
             const LeafNode* result = nullptr;
             if (this->bounds().contains(bounds)) {
@@ -259,6 +320,32 @@ private:
                 return doRemove(bounds, data, m_right, m_left);
             }
         }
+
+        bool refit(const Box& oldBounds, const Box& newBounds, const U& data, const bool refitAncestors) override {
+            if (this->bounds().contains(oldBounds)) {
+                if (m_left->refit(oldBounds, newBounds, data, refitAncestors) ||
+                    m_right->refit(oldBounds, newBounds, data, refitAncestors)) {
+                    if (refitAncestors) {
+                        updateBounds();
+                    }
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        void refitAll() override {
+            m_left->refitAll();
+            m_right->refitAll();
+            updateBounds();
+        }
+
+        void flattenTo(typename FlatTree::Builder& builder) const override {
+            const auto index = builder.beginInnerNode(this->bounds());
+            m_left->flattenTo(builder);
+            m_right->flattenTo(builder);
+            builder.endInnerNode(index);
+        }
     private:
         /**
          * Attempt to remove the node with the given bounds and data from the given child.
@@ -452,6 +539,21 @@ private:
             }
         }
 
+        bool refit(const Box& /* oldBounds */, const Box& newBounds, const U& data, const bool /* refitAncestors */) override {
+            if (hasData(data)) {
+                this->setBounds(newBounds);
+                return true;
+            } else {
+                return false;
+            }
+        }
+
+        void refitAll() override {}
+
+        void flattenTo(typename FlatTree::Builder& builder) const override {
+            builder.addLeaf(this->bounds(), m_data);
+        }
+
         /**
          * Checks whether the given data equals the data of this leaf. The given data is considered
          * equal to this node's data if and only if !(data < m_data) && !(m_data < data) where < is
@@ -478,10 +580,35 @@ private:
             str << ": " << m_data << std::endl;
         }
     };
+private:
+    /**
+     * A data item to be inserted into the tree by a bulk build.
+     */
+    struct BuildItem {
+        Box bounds;
+        vm::vec<T,S> center;
+        U data;
+    };
+
+    using BuildList = std::vector<BuildItem>;
+    using BuildIterator = typename BuildList::iterator;
+
+    /**
+     * The number of bins along the split axis that are evaluated when looking for a split by the surface area
+     * heuristic.
+     */
+    static constexpr size_t BinCount = 16;
 private:
     Node* m_root;
+    size_t m_leafCount;
+    size_t m_updateCount;
+    FloatType m_rebuildRatio;
 public:
-    AABBTree() : m_root(nullptr) {}
+    AABBTree() :
+    m_root(nullptr),
+    m_leafCount(0),
+    m_updateCount(0),
+    m_rebuildRatio(static_cast<FloatType>(0.0)) {}
 
     ~AABBTree() override {
         clear();
@@ -500,6 +627,67 @@ public:
         } else {
             m_root = m_root->insert(bounds, data);
         }
+        ++m_leafCount;
+    }
+
+    /**
+     * Clears this tree and builds it from the given objects using a top down build that splits the objects by the
+     * surface area heuristic (SAH). This results in a tree with much better query performance than inserting the
+     * objects one by one.
+     *
+     * @param objects the objects to insert
+     * @param getBounds a function that returns the bounds of an object
+     */
+    void clearAndBuild(const List& objects, const GetBounds& getBounds) override {
+        clearAndBuild(std::begin(objects), std::end(objects), getBounds);
+    }
+
+    /**
+     * Clears this tree and builds it from the given objects, see clearAndBuild(const List&, const GetBounds&).
+     *
+     * @param objects the objects to insert
+     * @param getBounds a function that returns the bounds of an object
+     */
+    void clearAndBuild(const Array& objects, const GetBounds& getBounds) override {
+        clearAndBuild(std::begin(objects), std::end(objects), getBounds);
+    }
+
+    /**
+     * Creates a flattened, read only copy of this tree which is faster to query. The copy is not updated when this
+     * tree changes.
+     *
+     * @param result the flat tree to write to, its previous contents are discarded
+     */
+    void flatten(FlatTree& result) const {
+        result.clear();
+        if (!empty()) {
+            // a binary tree with n leafs has 2n - 1 nodes
+            result.reserve(2 * m_leafCount - 1);
+
+            typename FlatTree::Builder builder(result);
+            m_root->flattenTo(builder);
+        }
+    }
+
+    /**
+     * Rebuilds this tree from its current contents using the surface area heuristic. Use this to restore the query
+     * performance of the tree after many updates.
+     */
+    void rebuild() {
+        BuildList items;
+        items.reserve(m_leafCount);
+
+        if (!empty()) {
+            LambdaVisitor visitor(
+                [](const InnerNode* /* innerNode */) { return true; },
+                [&](const LeafNode* leaf) {
+                    items.push_back(BuildItem{ leaf->bounds(), leaf->bounds().center(), leaf->data() });
+                }
+            );
+            m_root->accept(visitor);
+        }
+
+        build(items);
     }
 
     bool remove(const Box& bounds, const U& data) override {
@@ -512,16 +700,85 @@ public:
                     delete m_root;
                     m_root = newRoot;
                 }
+                --m_leafCount;
                 return true;
             }
         }
         return false;
     }
 
+    /**
+     * Updates the bounds of the given data item. If the new bounds are close to the old bounds, the bounds of the leaf
+     * and its ancestors are refitted in place. Otherwise, the leaf is removed and reinserted because refitting it would
+     * degrade the quality of the tree too much, see shouldRefit.
+     *
+     * @param oldBounds the current bounds of the data item
+     * @param newBounds the new bounds of the data item
+     * @param data the data item
+     *
+     * @throw NodeTreeException if the data item is not found
+     */
     void update(const Box& oldBounds, const Box& newBounds, const U& data) override {
         check(oldBounds, data);
         check(newBounds, data);
 
+        if (!shouldRefit(oldBounds, newBounds) || empty() || !m_root->refit(oldBounds, newBounds, data, true)) {
+            reinsert(oldBounds, newBounds, data);
+        }
+
+        ++m_updateCount;
+        rebuildIfNecessary();
+    }
+
+    /**
+     * Updates the bounds of many data items at once. The leafs of the items that can be refitted are updated first,
+     * and then the bounds of all inner nodes are recomputed in a single pass, which is cheaper than refitting the
+     * ancestors of every leaf individually if many items are updated. The remaining items are removed and reinserted.
+     *
+     * @param updates the updates to apply
+     *
+     * @throw NodeTreeException if any of the data items is not found
+     */
+    void update(const UpdateList& updates) {
+        std::vector<const Update*> reinserts;
+        auto refitted = false;
+
+        for (const auto& change : updates) {
+            check(change.oldBounds, change.data);
+            check(change.newBounds, change.data);
+
+            if (shouldRefit(change.oldBounds, change.newBounds) && !empty() && m_root->refit(change.oldBounds, change.newBounds, change.data, false)) {
+                refitted = true;
+            } else {
+                reinserts.push_back(&change);
+            }
+        }
+
+        if (refitted) {
+            m_root->refitAll();
+        }
+
+        for (const auto* change : reinserts) {
+            reinsert(change->oldBounds, change->newBounds, change->data);
+        }
+
+        m_updateCount += updates.size();
+        rebuildIfNecessary();
+    }
+
+    /**
+     * Sets the ratio of updates to the number of data items in this tree after which the tree is rebuilt. For
+     * example, if the ratio is 2 and the tree contains 100 data items, the tree will be rebuilt after 200 updates.
+     * A ratio of 0 disables the automatic rebuilds, which is the default.
+     *
+     * @param rebuildRatio the ratio, must not be negative
+     */
+    void setRebuildRatio(const FloatType rebuildRatio) {
+        assert(rebuildRatio >= static_cast<FloatType>(0.0));
+        m_rebuildRatio = rebuildRatio;
+    }
+private:
+    void reinsert(const Box& oldBounds, const Box& newBounds, const U& data) {
         if (!remove(oldBounds, data)) {
             NodeTreeException ex;
             ex << "AABB node not found with oldBounds [ ( " << oldBounds.min << " ) ( " << oldBounds.max << " ) ]: " << data;
@@ -529,6 +786,163 @@ public:
         }
         insert(newBounds, data);
     }
+
+    /**
+     * Decides whether a leaf whose bounds change from the given old to the given new bounds can be refitted in place.
+     * Refitting grows the ancestors of the leaf by at most the union of both boxes, so the leaf is only refitted if the
+     * surface area of that union, which determines the cost of the ancestors for queries, is not much larger than the
+     * surface area of either box.
+     */
+    static bool shouldRefit(const Box& oldBounds, const Box& newBounds) {
+        const auto maxArea = std::max(surfaceArea(oldBounds), surfaceArea(newBounds));
+        return surfaceArea(vm::merge(oldBounds, newBounds)) <= static_cast<T>(1.5) * maxArea;
+    }
+
+    void rebuildIfNecessary() {
+        if (m_rebuildRatio > static_cast<FloatType>(0.0) &&
+            static_cast<FloatType>(m_updateCount) > m_rebuildRatio * static_cast<FloatType>(m_leafCount)) {
+            rebuild();
+        }
+    }
+
+    template <typename I>
+    void clearAndBuild(I cur, I end, const GetBounds& getBounds) {
+        BuildList items;
+        while (cur != end) {
+            const auto bounds = getBounds(*cur);
+            check(bounds, *cur);
+            items.push_back(BuildItem{ bounds, bounds.center(), *cur });
+            ++cur;
+        }
+
+        build(items);
+    }
+
+    void build(BuildList& items) {
+        clear();
+        if (!items.empty()) {
+            m_root = build(std::begin(items), std::end(items));
+        }
+        m_leafCount = items.size();
+    }
+
+    static Node* build(BuildIterator begin, BuildIterator end) {
+        assert(begin != end);
+        if (std::next(begin) == end) {
+            return new LeafNode(begin->bounds, begin->data);
+        }
+
+        const auto mid = split(begin, end);
+        auto* left = build(begin, mid);
+        auto* right = build(mid, end);
+        return new InnerNode(left, right);
+    }
+
+    /**
+     * Partitions the given items into two non-empty ranges and returns the start of the second range.
+     *
+     * The items are split along the axis with the largest extent of their centers. The centers are sorted into bins
+     * along this axis, and the split between two bins that minimizes the surface area heuristic is chosen. If there
+     * is no such split, e.g. because all centers are the same, the items are split at the median.
+     */
+    static BuildIterator split(BuildIterator begin, BuildIterator end) {
+        const auto count = static_cast<size_t>(std::distance(begin, end));
+
+        auto centerBounds = Box(begin->center, begin->center);
+        for (auto it = std::next(begin); it != end; ++it) {
+            centerBounds = vm::merge(centerBounds, it->center);
+        }
+
+        const auto centerSize = centerBounds.size();
+        size_t axis = 0;
+        for (size_t i = 1; i < S; ++i) {
+            if (centerSize[i] > centerSize[axis]) {
+                axis = i;
+            }
+        }
+
+        const auto extent = centerSize[axis];
+        if (extent <= static_cast<T>(0.0)) {
+            return splitAtMedian(begin, end, axis);
+        }
+
+        const auto binIndex = [&](const BuildItem& item) {
+            const auto offset = (item.center[axis] - centerBounds.min[axis]) / extent;
+            return std::min(static_cast<size_t>(offset * static_cast<T>(BinCount)), BinCount - 1);
+        };
+
+        std::array<Box, BinCount> binBounds;
+        std::array<size_t, BinCount> binCounts;
+        binCounts.fill(0);
+
+        for (auto it = begin; it != end; ++it) {
+            const auto index = binIndex(*it);
+            binBounds[index] = binCounts[index] == 0 ? it->bounds : vm::merge(binBounds[index], it->bounds);
+            ++binCounts[index];
+        }
+
+        // rightCosts[i] is the cost of the items in bins i, ..., BinCount - 1
+        std::array<T, BinCount> rightCosts;
+        rightCosts.fill(static_cast<T>(0.0));
+
+        Box bounds;
+        size_t boundsCount = 0;
+        for (size_t i = BinCount - 1; i > 0; --i) {
+            if (binCounts[i] > 0) {
+                bounds = boundsCount == 0 ? binBounds[i] : vm::merge(bounds, binBounds[i]);
+                boundsCount += binCounts[i];
+            }
+            rightCosts[i] = surfaceArea(bounds) * static_cast<T>(boundsCount);
+        }
+
+        // the index of the first bin of the second range, or 0 if no valid split was found
+        size_t bestSplit = 0;
+        auto bestCost = std::numeric_limits<T>::max();
+
+        boundsCount = 0;
+        for (size_t i = 0; i < BinCount - 1; ++i) {
+            if (binCounts[i] > 0) {
+                bounds = boundsCount == 0 ? binBounds[i] : vm::merge(bounds, binBounds[i]);
+                boundsCount += binCounts[i];
+            }
+
+            if (boundsCount > 0 && boundsCount < count) {
+                const auto cost = surfaceArea(bounds) * static_cast<T>(boundsCount) + rightCosts[i + 1];
+                if (cost < bestCost) {
+                    bestCost = cost;
+                    bestSplit = i + 1;
+                }
+            }
+        }
+
+        if (bestSplit == 0) {
+            return splitAtMedian(begin, end, axis);
+        }
+
+        return std::partition(begin, end, [&](const BuildItem& item) { return binIndex(item) < bestSplit; });
+    }
+
+    static BuildIterator splitAtMedian(BuildIterator begin, BuildIterator end, const size_t axis) {
+        const auto mid = std::next(begin, std::distance(begin, end) / 2);
+        std::nth_element(begin, mid, end, [&](const BuildItem& lhs, const BuildItem& rhs) {
+            return lhs.center[axis] < rhs.center[axis];
+        });
+        return mid;
+    }
+
+    /**
+     * Returns half of the surface area of the given box, which suffices to compare the costs of different splits.
+     */
+    static T surfaceArea(const Box& bounds) {
+        const auto size = bounds.size();
+        auto result = static_cast<T>(0.0);
+        for (size_t i = 0; i < S; ++i) {
+            for (size_t j = i + 1; j < S; ++j) {
+                result += size[i] * size[j];
+            }
+        }
+        return result;
+    }
 private:
     void check(const Box& bounds, const U& data) const {
         if (vm::isNaN(bounds.min) || vm::isNaN(bounds.max)) {
@@ -543,6 +957,8 @@ public:
             delete m_root;
             m_root = nullptr;
         }
+        m_leafCount = 0;
+        m_updateCount = 0;
     }
 
     bool empty() const override {
@@ -597,6 +1013,56 @@ public:
         }
     }
 
+    /**
+     * Visits the data items whose bounding boxes intersect with the given ray in the order of the distances at which
+     * the ray enters their bounding boxes, see FlatAABBTree::findIntersectorsNearestFirst.
+     *
+     * @tparam F the type of the visitor, must accept the data item and its entry distance and return a distance
+     * @param ray the ray to test
+     * @param visitor the visitor to call
+     */
+    template <typename F>
+    void findIntersectorsNearestFirst(const vm::ray<T,S>& ray, const F& visitor) const {
+        if (empty()) {
+            return;
+        }
+
+        const auto entryDistance = [&](const Box& bounds) {
+            return bounds.contains(ray.origin) ? static_cast<T>(0.0) : intersect(ray, bounds);
+        };
+
+        const auto rootDistance = entryDistance(m_root->bounds());
+        if (vm::isnan(rootDistance)) {
+            return;
+        }
+
+        using Entry = std::pair<T, const Node*>;
+        std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> queue;
+        queue.emplace(rootDistance, m_root);
+
+        auto cutoff = std::numeric_limits<T>::max();
+        while (!queue.empty()) {
+            const auto [distance, node] = queue.top();
+            if (distance > cutoff) {
+                break;
+            }
+            queue.pop();
+
+            if (node->leaf()) {
+                const auto* leaf = static_cast<const LeafNode*>(node);
+                cutoff = std::min(cutoff, static_cast<T>(visitor(leaf->data(), distance)));
+            } else {
+                const auto* innerNode = static_cast<const InnerNode*>(node);
+                for (const auto* child : { innerNode->left(), innerNode->right() }) {
+                    const auto childDistance = entryDistance(child->bounds());
+                    if (!vm::isnan(childDistance) && childDistance <= cutoff) {
+                        queue.emplace(childDistance, child);
+                    }
+                }
+            }
+        }
+    }
+
      List findContainers(const vm::vec<T,S>& point) const override {
          List result;
          findContainers(point, std::back_inserter(result));
@@ -629,6 +1095,33 @@ public:
         }
     }
 
+    /**
+     * Finds every data item in this tree whose bounding box overlaps a volume and appends it to the given output
+     * iterator. The volume is given by a function that classifies a bounding box.
+     *
+     * @tparam F the type of the function that classifies a bounding box, must return a VolumeRelation
+     * @tparam O the output iterator type
+     * @param relation the function that classifies a bounding box
+     * @param out the output iterator to append to
+     */
+    template <typename F, typename O>
+    void findInVolume(const F& relation, O out) const {
+        if (!empty()) {
+            LambdaVisitor visitor(
+                    [&](const InnerNode* innerNode) {
+                        return relation(innerNode->bounds()) != VolumeRelation::Outside;
+                    },
+                    [&](const LeafNode* leaf) {
+                        if (relation(leaf->bounds()) != VolumeRelation::Outside) {
+                            out = leaf->data();
+                            ++out;
+                        }
+                    }
+            );
+            m_root->accept(visitor);
+        }
+    }
+
     /**
      * Prints a textual representation of this tree to the given output stream.
      *
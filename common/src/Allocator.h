@@ -21,183 +21,307 @@
 #define TrenchBroom_Allocator_h
 
 #include <cassert>
-#include <iostream>
-#include <limits>
-#include <stack>
-#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <mutex>
+#include <new>
+#include <utility>
+
+#ifdef _WIN32
+#include <malloc.h>
+#endif
 
 // Undefine this to prevent false positives when looking for memory leaks.
 #define TB_ENABLE_ALLOCATOR 1
 
-template <class T, size_t PoolSize = 64, size_t BlocksPerChunk = 256>
+/**
+ * Allocates objects of type T from chunks of fixed size blocks. Classes that inherit from this class use it for
+ * their operator new and operator delete.
+ *
+ * Every thread keeps a list of free blocks, so allocating and deallocating an object usually only pops or pushes a
+ * block without taking a lock. A thread fetches the free blocks of one chunk at a time from a shared pool, and it
+ * returns surplus blocks to the shared pool in batches. Objects may therefore be created on one thread and destroyed
+ * on another. When a thread exits, its free blocks are returned to the shared pool.
+ *
+ * The shared pool keeps the free blocks of each chunk separately. Once all blocks of a chunk are back in the shared
+ * pool, the chunk is released unless it is the only completely free chunk, which is kept for later allocations. A
+ * chunk holds at least BlocksPerChunk blocks.
+ */
+template <class T, size_t BlocksPerChunk = 256>
 class Allocator {
 private:
-    class Chunk {
-    private:
-        unsigned char m_blocks[BlocksPerChunk * sizeof(T)];
-        unsigned char m_firstFreeBlock;
-        unsigned char m_numFreeBlocks;
-    public:
-        Chunk() :
-        m_firstFreeBlock(0),
-        m_numFreeBlocks(BlocksPerChunk - 1) {
-            for (size_t i = 0; i < BlocksPerChunk - 1; i++)
-                m_blocks[i * sizeof(T)] = static_cast<unsigned char>(i + 1);
-        }
+    union Block {
+        Block* next;
+        alignas(T) unsigned char storage[sizeof(T)];
+    };
 
-        bool contains(const T* t) const {
-            const unsigned char* block = reinterpret_cast<const unsigned char*>(t);
-            if (block < m_blocks)
-                return false;
-            size_t offset = static_cast<size_t>(block - m_blocks);
-            return offset < (BlocksPerChunk - 1) * sizeof(T);
-        }
+    using Batch = std::pair<Block*, size_t>;
+
+    /*
+     * A chunk is a single allocation that starts with this header and is followed by its blocks. Chunks are aligned to
+     * their size, which is a power of two, so the chunk of a block is found by masking the block's address.
+     */
+    struct Chunk {
+        // the neighbours in the list of chunks that have blocks in the shared pool
+        Chunk* previous = nullptr;
+        Chunk* next = nullptr;
+        bool available = false;
+
+        // the blocks of this chunk that are in the shared pool
+        Block* freeBlocks = nullptr;
+        size_t freeCount = 0;
+    };
 
-        T* allocate() {
-            if (m_numFreeBlocks == 0)
-                return nullptr;
+    static constexpr size_t roundUp(const size_t value, const size_t alignment) {
+        return (value + alignment - 1) / alignment * alignment;
+    }
 
-            unsigned char* block = m_blocks + m_firstFreeBlock * sizeof(T);
-            m_firstFreeBlock = *block;
-            m_numFreeBlocks--;
-            return reinterpret_cast<T*>(block);
+    static constexpr size_t powerOfTwo(const size_t value) {
+        size_t result = 1;
+        while (result < value) {
+            result *= 2;
         }
+        return result;
+    }
 
-        void deallocate(T* t) {
-            assert(m_numFreeBlocks < BlocksPerChunk - 1);
-            assert(contains(t));
-
-            unsigned char* block = reinterpret_cast<unsigned char*>(t);
-            assert(block >= m_blocks);
-            size_t offset = static_cast<size_t>(block - m_blocks);
-            assert(offset % sizeof(T) == 0);
-
-            size_t index = offset / sizeof(T);
-            assert(index < BlocksPerChunk);
+    static constexpr size_t BlockOffset = roundUp(sizeof(Chunk), alignof(Block));
+    static constexpr size_t ChunkSize = powerOfTwo(BlockOffset + BlocksPerChunk * sizeof(Block));
+    // the space that remains after rounding up the chunk size is used for additional blocks
+    static constexpr size_t ChunkCapacity = (ChunkSize - BlockOffset) / sizeof(Block);
 
-            *block = m_firstFreeBlock;
-            m_firstFreeBlock = static_cast<unsigned char>(index);
-            m_numFreeBlocks++;
-        }
+    struct SharedPool {
+        std::mutex mutex;
+        Chunk* availableChunks = nullptr;
+        size_t chunkCount = 0;
+        size_t emptyChunkCount = 0;
+    };
 
-        bool empty() const {
-            return m_numFreeBlocks == BlocksPerChunk - 1;
-        }
+    struct LocalPool {
+        Block* freeBlocks = nullptr;
+        size_t freeCount = 0;
 
-        bool full() const {
-            return m_numFreeBlocks == 0;
-        }
+        ~LocalPool();
     };
 
-    using ChunkList = std::vector<Chunk*>;
-    using Pool = std::stack<T*>;
-
-    static Pool& pool() {
-        static Pool p;
-        return p;
+    static SharedPool& sharedPool() {
+        // intentionally leaked so that objects can still be deallocated during static destruction
+        static auto* pool = new SharedPool();
+        return *pool;
     }
 
-    static ChunkList& fullChunks() {
-        static ChunkList chunks;
-        return chunks;
+    static LocalPool& localPool() {
+        thread_local LocalPool pool;
+        return pool;
     }
 
-    static ChunkList& mixedChunks() {
-        static ChunkList chunks;
-        return chunks;
+    // set once the local pool of the current thread has been destroyed at thread exit
+    static bool& localPoolDestroyed() {
+        thread_local bool destroyed = false;
+        return destroyed;
     }
 
-    static ChunkList emptyChunks() {
-        static ChunkList chunks;
-        return chunks;
+    static Block* allocateBlock() {
+        if (localPoolDestroyed()) {
+            // the thread is exiting, so take a single block and leave the others in the shared pool
+            auto batch = fetchBatch();
+            auto* block = batch.first;
+            returnBatch(Batch(block->next, batch.second - 1));
+            return block;
+        }
+
+        auto& local = localPool();
+        if (local.freeBlocks == nullptr) {
+            const auto batch = fetchBatch();
+            local.freeBlocks = batch.first;
+            local.freeCount = batch.second;
+        }
+
+        auto* block = local.freeBlocks;
+        local.freeBlocks = block->next;
+        --local.freeCount;
+        return block;
     }
-public:
-#ifdef TB_ENABLE_ALLOCATOR
-    void* operator new(size_t size) {
-        assert(size == sizeof(T));
 
-        if (!pool().empty()) {
-            T* t = pool().top();
-            pool().pop();
-            return t;
+    static void deallocateBlock(Block* block) {
+        if (localPoolDestroyed()) {
+            block->next = nullptr;
+            returnBatch(Batch(block, 1));
+            return;
         }
 
-        Chunk* chunk = nullptr;
-        if (mixedChunks().empty()) {
-            if (!emptyChunks().empty()) {
-                chunk = emptyChunks().back();
-                emptyChunks().pop_back();
-            } else {
-                chunk = new Chunk();
+        auto& local = localPool();
+        block->next = local.freeBlocks;
+        local.freeBlocks = block;
+        ++local.freeCount;
+
+        if (local.freeCount >= 2 * BlocksPerChunk) {
+            // keep one chunk's worth of blocks for this thread and return the rest to the shared pool
+            auto* last = local.freeBlocks;
+            for (size_t i = 1; i < BlocksPerChunk; ++i) {
+                last = last->next;
             }
-        } else {
-            chunk = mixedChunks().back();
-            mixedChunks().pop_back();
+
+            const auto surplus = Batch(last->next, local.freeCount - BlocksPerChunk);
+            last->next = nullptr;
+            local.freeCount = BlocksPerChunk;
+            returnBatch(surplus);
         }
+    }
 
-        assert(!chunk->full());
-        T* block = chunk->allocate();
+    static Batch fetchBatch() {
+        auto& shared = sharedPool();
+        std::lock_guard<std::mutex> lock(shared.mutex);
 
-        if (chunk->full()) {
-            fullChunks().push_back(chunk);
-        } else {
-            mixedChunks().push_back(chunk);
+        auto* chunk = shared.availableChunks;
+        if (chunk != nullptr) {
+            if (chunk->freeCount == ChunkCapacity) {
+                --shared.emptyChunkCount;
+            }
+            removeAvailableChunk(shared, chunk);
+
+            const auto batch = Batch(chunk->freeBlocks, chunk->freeCount);
+            chunk->freeBlocks = nullptr;
+            chunk->freeCount = 0;
+            return batch;
         }
-        return block;
-    }
 
-    void operator delete(void* block) {
-        T* t = reinterpret_cast<T*>(block);
+        chunk = new (allocateChunkMemory()) Chunk();
+        ++shared.chunkCount;
+
+        auto* blocks = chunkBlocks(chunk);
+        for (size_t i = 0; i < ChunkCapacity - 1; ++i) {
+            blocks[i].next = &blocks[i + 1];
+        }
+        blocks[ChunkCapacity - 1].next = nullptr;
+        return Batch(blocks, ChunkCapacity);
+    }
 
-        if (PoolSize > 0 && pool().size() < PoolSize) {
-            pool().push(t);
+    static void returnBatch(const Batch& batch) {
+        if (batch.first == nullptr) {
             return;
         }
 
-        typename ChunkList::reverse_iterator fullIt, fullEnd, mixedIt, mixedEnd;
-        fullIt = fullChunks().rbegin();
-        fullEnd = fullChunks().rend();
-        mixedIt = mixedChunks().rbegin();
-        mixedEnd = mixedChunks().rend();
-
-        Chunk* chunk = nullptr;
-        while (fullIt < fullEnd || mixedIt < mixedEnd) {
-            if (fullIt < fullEnd) {
-                Chunk* fullChunk = *fullIt;
-                if (fullChunk->contains(t)) {
-                    chunk = fullChunk;
-                    break;
-                }
-                ++fullIt;
+        auto& shared = sharedPool();
+        std::lock_guard<std::mutex> lock(shared.mutex);
+
+        auto* block = batch.first;
+        while (block != nullptr) {
+            auto* next = block->next;
+
+            auto* chunk = blockChunk(block);
+            block->next = chunk->freeBlocks;
+            chunk->freeBlocks = block;
+            ++chunk->freeCount;
+
+            if (!chunk->available) {
+                addAvailableChunk(shared, chunk);
             }
-            if (mixedIt < mixedEnd) {
-                Chunk* mixedChunk = *mixedIt;
-                if (mixedChunk->contains(t)) {
-                    chunk = mixedChunk;
-                    break;
+
+            if (chunk->freeCount == ChunkCapacity) {
+                if (shared.emptyChunkCount > 0) {
+                    removeAvailableChunk(shared, chunk);
+                    releaseChunk(shared, chunk);
+                } else {
+                    ++shared.emptyChunkCount;
                 }
-                ++mixedIt;
             }
+
+            block = next;
+        }
+    }
+
+    static Block* chunkBlocks(Chunk* chunk) {
+        return reinterpret_cast<Block*>(reinterpret_cast<unsigned char*>(chunk) + BlockOffset);
+    }
+
+    static Chunk* blockChunk(Block* block) {
+        const auto address = reinterpret_cast<std::uintptr_t>(block);
+        return reinterpret_cast<Chunk*>(address & ~static_cast<std::uintptr_t>(ChunkSize - 1));
+    }
+
+    static void addAvailableChunk(SharedPool& shared, Chunk* chunk) {
+        chunk->previous = nullptr;
+        chunk->next = shared.availableChunks;
+        if (chunk->next != nullptr) {
+            chunk->next->previous = chunk;
+        }
+        shared.availableChunks = chunk;
+        chunk->available = true;
+    }
+
+    static void removeAvailableChunk(SharedPool& shared, Chunk* chunk) {
+        if (chunk->previous != nullptr) {
+            chunk->previous->next = chunk->next;
+        } else {
+            shared.availableChunks = chunk->next;
+        }
+        if (chunk->next != nullptr) {
+            chunk->next->previous = chunk->previous;
         }
+        chunk->previous = chunk->next = nullptr;
+        chunk->available = false;
+    }
 
-        assert(chunk != nullptr);
+    static void releaseChunk(SharedPool& shared, Chunk* chunk) {
+        chunk->~Chunk();
+        freeChunkMemory(chunk);
+        --shared.chunkCount;
+    }
 
-        if (chunk->full()) {
-            fullChunks().erase((fullIt + 1).base());
-            mixedChunks().push_back(chunk);
+    // aligned operator new is not available on all supported platforms, so use the platform functions instead
+    static void* allocateChunkMemory() {
+#ifdef _WIN32
+        void* memory = _aligned_malloc(ChunkSize, ChunkSize);
+#else
+        void* memory = nullptr;
+        if (posix_memalign(&memory, ChunkSize, ChunkSize) != 0) {
+            memory = nullptr;
         }
+#endif
+        if (memory == nullptr) {
+            throw std::bad_alloc();
+        }
+        return memory;
+    }
+
+    static void freeChunkMemory(void* memory) {
+#ifdef _WIN32
+        _aligned_free(memory);
+#else
+        free(memory);
+#endif
+    }
+public:
+    /**
+     * Returns the number of chunks that are currently allocated for objects of type T.
+     */
+    static size_t chunkCount() {
+        auto& shared = sharedPool();
+        std::lock_guard<std::mutex> lock(shared.mutex);
+        return shared.chunkCount;
+    }
 
-        chunk->deallocate(t);
+#ifdef TB_ENABLE_ALLOCATOR
+    void* operator new(size_t size) {
+        assert(size == sizeof(T));
+        return allocateBlock();
+    }
 
-        if (chunk->empty()) {
-            mixedChunks().erase((mixedIt + 1).base());
-            if (emptyChunks().size() < 2)
-                emptyChunks().push_back(chunk);
-                else
-                    delete chunk;
+    void operator delete(void* block) {
+        if (block != nullptr) {
+            deallocateBlock(static_cast<Block*>(block));
         }
     }
 #endif
 };
 
+template <class T, size_t BlocksPerChunk>
+Allocator<T, BlocksPerChunk>::LocalPool::~LocalPool() {
+    localPoolDestroyed() = true;
+    returnBatch(Batch(freeBlocks, freeCount));
+    freeBlocks = nullptr;
+    freeCount = 0;
+}
+
 #endif
@@ -56,14 +56,14 @@ namespace TrenchBroom {
 
         EntityDefinition* EntityDefinitionManager::definition(const Model::AttributableNode* attributable) const {
             ensure(attributable != nullptr, "attributable is null");
-            return definition(attributable->attribute(Model::AttributeNames::Classname));
+            return definition(attributable->internedClassname());
         }
 
         EntityDefinition* EntityDefinitionManager::definition(const Model::AttributeValue& classname) const {
-            auto it = m_cache.find(classname);
-            if (it == std::end(m_cache))
+            Model::InternedString internedClassname;
+            if (!Model::InternedString::find(classname, internedClassname))
                 return nullptr;
-            return it->second;
+            return definition(internedClassname);
         }
 
         EntityDefinitionList EntityDefinitionManager::definitions(const EntityDefinition::Type type, const EntityDefinition::SortOrder order) const {
@@ -78,6 +78,13 @@ namespace TrenchBroom {
             return m_groups;
         }
 
+        EntityDefinition* EntityDefinitionManager::definition(const Model::InternedString& classname) const {
+            auto it = m_cache.find(classname);
+            if (it == std::end(m_cache))
+                return nullptr;
+            return it->second;
+        }
+
         void EntityDefinitionManager::updateIndices() {
             for (size_t i = 0; i < m_definitions.size(); ++i)
                 m_definitions[i]->setIndex(i+1);
@@ -105,7 +112,7 @@ namespace TrenchBroom {
         void EntityDefinitionManager::updateCache() {
             clearCache();
             for (EntityDefinition* definition : m_definitions)
-                m_cache[definition->name()] = definition;
+                m_cache[Model::InternedString(definition->name())] = definition;
         }
 
         void EntityDefinitionManager::bindObservers() {
@@ -24,9 +24,10 @@
 #include "Assets/AssetTypes.h"
 #include "Assets/EntityDefinition.h"
 #include "Assets/EntityDefinitionGroup.h"
+#include "Model/InternedString.h"
 #include "Model/ModelTypes.h"
 
-#include <map>
+#include <unordered_map>
 
 namespace TrenchBroom {
     namespace IO {
@@ -38,7 +39,8 @@ namespace TrenchBroom {
     namespace Assets {
         class EntityDefinitionManager {
         private:
-            using Cache = std::map<String, EntityDefinition*>;
+            // keyed by the interned definition names so that looking up the definition of a node is a pointer hash
+            using Cache = std::unordered_map<Model::InternedString, EntityDefinition*>;
             EntityDefinitionList m_definitions;
             EntityDefinitionGroup::List m_groups;
             Cache m_cache;
@@ -58,6 +60,8 @@ namespace TrenchBroom {
 
             const EntityDefinitionGroup::List& groups() const;
         private:
+            EntityDefinition* definition(const Model::InternedString& classname) const;
+
             void updateIndices();
             void updateGroups();
             void updateCache();
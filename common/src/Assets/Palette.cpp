@@ -37,6 +37,7 @@ namespace TrenchBroom {
         m_data(std::move(data)) {
             ensure(m_size > 0, "size is 0");
             ensure(m_data.get() != nullptr, "data is null");
+            initTables();
         }
 
         Palette::Data::Data(const size_t size, unsigned char* data) :
@@ -44,6 +45,67 @@ namespace TrenchBroom {
         m_data(data) {
             ensure(m_size > 0, "size is 0");
             ensure(m_data.get() != nullptr, "data is null");
+            initTables();
+        }
+
+        bool Palette::Data::indexedToRgba(const unsigned char* indexedImage, const size_t pixelCount, unsigned char* rgbaImage, const PaletteTransparency transparency, Color& averageColor) const {
+            const auto& table = transparency == PaletteTransparency::Opaque ? m_opaqueTable : m_index255TransparentTable;
+
+            // Four histograms are filled in turn so that runs of equal indices don't stall on the same counter.
+            size_t histograms[4][256] = {};
+            size_t i = 0;
+            for (; i + 4 <= pixelCount; i += 4) {
+                for (size_t j = 0; j < 4; ++j) {
+                    const auto index = indexedImage[i + j];
+                    std::memcpy(rgbaImage + (i + j) * 4, &table[index], 4);
+                    ++histograms[j][index];
+                }
+            }
+            for (; i < pixelCount; ++i) {
+                const auto index = indexedImage[i];
+                std::memcpy(rgbaImage + i * 4, &table[index], 4);
+                ++histograms[0][index];
+            }
+
+            // The sums are exact integers, so converting them to double yields the same average as accumulating the
+            // components one pixel at a time.
+            uint64_t sum[3] = { 0, 0, 0 };
+            for (size_t index = 0; index < 256; ++index) {
+                const auto count = static_cast<uint64_t>(histograms[0][index] + histograms[1][index] + histograms[2][index] + histograms[3][index]);
+                if (count > 0) {
+                    unsigned char rgba[4];
+                    std::memcpy(rgba, &table[index], 4);
+                    for (size_t j = 0; j < 3; ++j) {
+                        sum[j] += count * rgba[j];
+                    }
+                }
+            }
+
+            for (size_t j = 0; j < 3; ++j) {
+                averageColor[j] = static_cast<float>(static_cast<double>(sum[j]) / pixelCount / 0xFF);
+            }
+            averageColor[3] = 1.0f;
+
+            if (transparency == PaletteTransparency::Opaque) {
+                return false;
+            } else {
+                return histograms[0][255] + histograms[1][255] + histograms[2][255] + histograms[3][255] > 0;
+            }
+        }
+
+        void Palette::Data::initTables() {
+            for (size_t index = 0; index < 256; ++index) {
+                unsigned char rgba[4] = { 0x00, 0x00, 0x00, 0xFF };
+                for (size_t j = 0; j < 3; ++j) {
+                    if (index * 3 + j < m_size) {
+                        rgba[j] = m_data[index * 3 + j];
+                    }
+                }
+                std::memcpy(&m_opaqueTable[index], rgba, 4);
+
+                rgba[3] = index == 255 ? 0x00 : 0xFF;
+                std::memcpy(&m_index255TransparentTable[index], rgba, 4);
+            }
         }
 
         Palette::Palette() {}
@@ -24,8 +24,11 @@
 #include "ByteBuffer.h"
 #include "IO/Reader.h"
 
+#include <array>
 #include <cassert>
+#include <cstdint>
 #include <memory>
+#include <vector>
 
 namespace TrenchBroom {
     namespace IO {
@@ -45,8 +48,13 @@ namespace TrenchBroom {
 
             class Data {
             private:
+                using PaletteTable = std::array<uint32_t, 256>;
+
                 size_t m_size;
                 RawDataPtr m_data;
+                // every palette entry packed into RGBA pixels, with the alpha channel set for the given transparency
+                PaletteTable m_opaqueTable;
+                PaletteTable m_index255TransparentTable;
             public:
                 Data(size_t size, RawDataPtr&& data);
                 Data(size_t size, unsigned char* data);
@@ -66,8 +74,14 @@ namespace TrenchBroom {
                  */
                 template <typename IndexT, typename ColorT>
                 bool indexedToRgba(const Buffer<IndexT>& indexedImage, const size_t pixelCount, Buffer<ColorT>& rgbaImage, const PaletteTransparency transparency, Color& averageColor) const {
-                    auto reader = IO::Reader::from(&indexedImage[0], &indexedImage[0] + pixelCount);
-                    return indexedToRgba(reader, pixelCount, rgbaImage, transparency, averageColor);
+                    static_assert(sizeof(IndexT) == 1, "index type must be a byte");
+                    static_assert(sizeof(ColorT) == 1, "pixel type must be a byte");
+                    assert(indexedImage.size() >= pixelCount);
+                    assert(rgbaImage.size() >= 4 * pixelCount);
+                    if (pixelCount == 0) {
+                        return indexedToRgba(nullptr, 0, nullptr, transparency, averageColor);
+                    }
+                    return indexedToRgba(reinterpret_cast<const unsigned char*>(indexedImage.ptr()), pixelCount, reinterpret_cast<unsigned char*>(rgbaImage.ptr()), transparency, averageColor);
                 }
 
                 /**
@@ -84,35 +98,33 @@ namespace TrenchBroom {
                  */
                 template <typename ColorT>
                 bool indexedToRgba(IO::Reader& reader, const size_t pixelCount, Buffer<ColorT>& rgbaImage, const PaletteTransparency transparency, Color& averageColor) const {
-                    double avg[3];
-                    avg[0] = avg[1] = avg[2] = 0.0;
-                    bool hasTransparency = false;
-                    for (size_t i = 0; i < pixelCount; ++i) {
-                        const size_t index = reader.readSize<unsigned char>();
-                        assert(index < m_size);
-                        for (size_t j = 0; j < 3; ++j) {
-                            const unsigned char c = m_data[index * 3 + j];
-                            rgbaImage[i * 4 + j] = c;
-                            avg[j] += static_cast<double>(c);
-                        }
-                        switch (transparency) {
-                            case PaletteTransparency::Opaque:
-                                rgbaImage[i * 4 + 3] = 0xFF;
-                                break;
-                            case PaletteTransparency::Index255Transparent:
-                                rgbaImage[i * 4 + 3] = (index == 255) ? 0x00 : 0xFF;
-                                hasTransparency |= (index == 255);
-                                break;
-                        }
-                    }
-
-                    for (size_t i = 0; i < 3; ++i) {
-                        averageColor[i] = static_cast<float>(avg[i] / pixelCount / 0xFF);
+                    static_assert(sizeof(ColorT) == 1, "pixel type must be a byte");
+                    assert(rgbaImage.size() >= 4 * pixelCount);
+                    if (pixelCount == 0) {
+                        return indexedToRgba(nullptr, 0, nullptr, transparency, averageColor);
                     }
-                    averageColor[3] = 1.0f;
 
-                    return hasTransparency;
+                    std::vector<unsigned char> indexedImage(pixelCount);
+                    reader.read(indexedImage.data(), pixelCount);
+                    return indexedToRgba(indexedImage.data(), pixelCount, reinterpret_cast<unsigned char*>(rgbaImage.ptr()), transparency, averageColor);
                 }
+
+                /**
+                 * Converts the given index buffer to an RGBA image. The pixels are expanded by looking up the packed RGBA
+                 * values in a precomputed table, and the average color is computed from a histogram of the indices, so
+                 * the result is identical to summing up the color components of every pixel.
+                 *
+                 * @param indexedImage the index buffer, must contain at least pixelCount bytes
+                 * @param pixelCount the number of pixels
+                 * @param rgbaImage the pixel buffer, must have room for at least 4 * pixelCount bytes
+                 * @param transparency controls whether or not the given index buffer contains a transparent index
+                 * @param averageColor output parameter for the average color of the generated pixel buffer
+                 * @return true if the given index buffer did contain a transparent index, unless the transparency parameter
+                 *     indicates that the image is opaque
+                 */
+                bool indexedToRgba(const unsigned char* indexedImage, size_t pixelCount, unsigned char* rgbaImage, PaletteTransparency transparency, Color& averageColor) const;
+            private:
+                void initTables();
             };
 
             using DataPtr = std::shared_ptr<Data>;
@@ -18,12 +18,14 @@
  */
 
 #include "Texture.h"
+#include "Exceptions.h"
 #include "Assets/ImageUtils.h"
 #include "Assets/TextureCollection.h"
 #include "Renderer/GL.h"
 
 #include <cassert>
 #include <algorithm>
+#include <memory>
 
 namespace TrenchBroom {
     namespace Assets {
@@ -72,7 +74,10 @@ namespace TrenchBroom {
         m_type(type),
         m_culling(TextureCulling::CullDefault),
         m_blendFunc{false, GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA},
-        m_textureId(0) {
+        m_textureId(0),
+        m_deferredTextureId(0),
+        m_minFilter(0),
+        m_magFilter(0) {
             assert(m_width > 0);
             assert(m_height > 0);
             assert(buffer.size() >= m_width * m_height * bytesPerPixelForFormat(format));
@@ -92,7 +97,10 @@ namespace TrenchBroom {
         m_culling(TextureCulling::CullDefault),
         m_blendFunc{false, GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA},
         m_textureId(0),
-        m_buffers(buffers) {
+        m_buffers(buffers),
+        m_deferredTextureId(0),
+        m_minFilter(0),
+        m_magFilter(0) {
             assert(m_width > 0);
             assert(m_height > 0);
 
@@ -105,6 +113,23 @@ namespace TrenchBroom {
             }
         }
 
+        Texture::Texture(const String& name, const size_t width, const size_t height, const Color& averageColor, const GLenum format, const TextureType type) :
+        m_collection(nullptr),
+        m_name(name),
+        m_width(width),
+        m_height(height),
+        m_averageColor(averageColor),
+        m_usageCount(0),
+        m_overridden(false),
+        m_format(format),
+        m_type(type),
+        m_culling(TextureCulling::CullDefault),
+        m_blendFunc{false, GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA},
+        m_textureId(0),
+        m_deferredTextureId(0),
+        m_minFilter(0),
+        m_magFilter(0) {}
+
         Texture::Texture(const String& name, const size_t width, const size_t height, const GLenum format, const TextureType type) :
         m_collection(nullptr),
         m_name(name),
@@ -117,7 +142,10 @@ namespace TrenchBroom {
         m_type(type),
         m_culling(TextureCulling::CullDefault),
         m_blendFunc{false, GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA},
-        m_textureId(0) {}
+        m_textureId(0),
+        m_deferredTextureId(0),
+        m_minFilter(0),
+        m_magFilter(0) {}
 
         Texture::~Texture() {
             if (m_collection == nullptr && m_textureId != 0) {
@@ -211,47 +239,13 @@ namespace TrenchBroom {
             assert(textureId > 0);
             assert(m_textureId == 0);
 
-            if (!m_buffers.empty()) {
-                glAssert(glPixelStorei(GL_UNPACK_SWAP_BYTES, false));
-                glAssert(glPixelStorei(GL_UNPACK_LSB_FIRST, false));
-                glAssert(glPixelStorei(GL_UNPACK_ROW_LENGTH, 0));
-                glAssert(glPixelStorei(GL_UNPACK_SKIP_PIXELS, 0));
-                glAssert(glPixelStorei(GL_UNPACK_SKIP_ROWS, 0));
-                glAssert(glPixelStorei(GL_UNPACK_ALIGNMENT, 1));
-
-                glAssert(glBindTexture(GL_TEXTURE_2D, textureId));
-                glAssert(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, minFilter));
-                glAssert(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, magFilter));
-                glAssert(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT));
-                glAssert(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT));
-
-                if (m_type == TextureType::Masked) {
-                    // masked textures don't work well with automatic mipmaps, so we force GL_NEAREST filtering and don't generate any
-                    glAssert(glTexParameteri(GL_TEXTURE_2D, GL_GENERATE_MIPMAP, GL_FALSE));
-                    glAssert(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST));
-                    glAssert(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST));
-                } else if (m_buffers.size() == 1) {
-                    // generate mipmaps if we don't have any
-                    glAssert(glTexParameteri(GL_TEXTURE_2D, GL_GENERATE_MIPMAP, GL_TRUE));
-                } else {
-                    glAssert(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, static_cast<GLint>(m_buffers.size() - 1)));
-                }
-
-                // Upload only the first mipmap for masked textures.
-                const auto mipmapsToUpload = (m_type == TextureType::Masked) ? 1u : m_buffers.size();
-
-                for (size_t j = 0; j < mipmapsToUpload; ++j) {
-                    const auto mipSize = sizeAtMipLevel(m_width, m_height, j);
-
-                    const GLvoid* data = reinterpret_cast<const GLvoid*>(m_buffers[j].ptr());
-                    glAssert(glTexImage2D(GL_TEXTURE_2D, static_cast<GLint>(j), GL_RGBA,
-                                          static_cast<GLsizei>(mipSize.x()),
-                                          static_cast<GLsizei>(mipSize.y()),
-                                          0, m_format, GL_UNSIGNED_BYTE, data));
-                }
-
-                m_buffers.clear();
-                m_textureId = textureId;
+            if (m_buffers.empty() && m_decoder) {
+                // the pixels are decoded and uploaded when the texture is first activated
+                m_deferredTextureId = textureId;
+                m_minFilter = minFilter;
+                m_magFilter = magFilter;
+            } else {
+                upload(textureId, minFilter, magFilter);
             }
         }
 
@@ -267,10 +261,60 @@ namespace TrenchBroom {
                     glAssert(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, magFilter));
                 }
                 deactivate();
+            } else {
+                m_minFilter = minFilter;
+                m_magFilter = magFilter;
             }
         }
 
+        void Texture::setDecoder(Decoder decoder) {
+            m_decoder = std::move(decoder);
+        }
+
+        bool Texture::needsDecoding() const {
+            return m_decoder && m_buffers.empty() && !isPrepared();
+        }
+
+        void Texture::decode() const {
+            if (!needsDecoding()) {
+                return;
+            }
+
+            try {
+                std::unique_ptr<Texture> decoded(m_decoder());
+                if (decoded != nullptr && !decoded->m_buffers.empty() && decoded->m_width == m_width && decoded->m_height == m_height) {
+                    m_buffers = std::move(decoded->m_buffers);
+                    m_averageColor = decoded->m_averageColor;
+                    m_format = decoded->m_format;
+                    m_type = decoded->m_type;
+                    return;
+                }
+            } catch (const Exception&) {}
+
+            // don't try again, the texture is left without pixels like any texture that could not be read
+            m_decoder = nullptr;
+        }
+
+        void Texture::discardDecodedPixels() {
+            if (m_decoder && !isPrepared()) {
+                m_buffers.clear();
+            }
+        }
+
+        size_t Texture::bufferSize() const {
+            size_t result = 0;
+            for (const auto& buffer : m_buffers) {
+                result += buffer.size();
+            }
+            return result;
+        }
+
         void Texture::activate() const {
+            if (!isPrepared() && m_deferredTextureId != 0) {
+                decode();
+                upload(m_deferredTextureId, m_minFilter, m_magFilter);
+            }
+
             if (isPrepared()) {
                 glAssert(glBindTexture(GL_TEXTURE_2D, m_textureId));
 
@@ -333,6 +377,52 @@ namespace TrenchBroom {
             return m_type;
         }
 
+        void Texture::upload(const GLuint textureId, const int minFilter, const int magFilter) const {
+            if (!m_buffers.empty()) {
+                glAssert(glPixelStorei(GL_UNPACK_SWAP_BYTES, false));
+                glAssert(glPixelStorei(GL_UNPACK_LSB_FIRST, false));
+                glAssert(glPixelStorei(GL_UNPACK_ROW_LENGTH, 0));
+                glAssert(glPixelStorei(GL_UNPACK_SKIP_PIXELS, 0));
+                glAssert(glPixelStorei(GL_UNPACK_SKIP_ROWS, 0));
+                glAssert(glPixelStorei(GL_UNPACK_ALIGNMENT, 1));
+
+                glAssert(glBindTexture(GL_TEXTURE_2D, textureId));
+                glAssert(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, minFilter));
+                glAssert(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, magFilter));
+                glAssert(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT));
+                glAssert(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT));
+
+                if (m_type == TextureType::Masked) {
+                    // masked textures don't work well with automatic mipmaps, so we force GL_NEAREST filtering and don't generate any
+                    glAssert(glTexParameteri(GL_TEXTURE_2D, GL_GENERATE_MIPMAP, GL_FALSE));
+                    glAssert(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST));
+                    glAssert(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST));
+                } else if (m_buffers.size() == 1) {
+                    // generate mipmaps if we don't have any
+                    glAssert(glTexParameteri(GL_TEXTURE_2D, GL_GENERATE_MIPMAP, GL_TRUE));
+                } else {
+                    glAssert(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, static_cast<GLint>(m_buffers.size() - 1)));
+                }
+
+                // Upload only the first mipmap for masked textures.
+                const auto mipmapsToUpload = (m_type == TextureType::Masked) ? 1u : m_buffers.size();
+
+                for (size_t j = 0; j < mipmapsToUpload; ++j) {
+                    const auto mipSize = sizeAtMipLevel(m_width, m_height, j);
+
+                    const GLvoid* data = reinterpret_cast<const GLvoid*>(m_buffers[j].ptr());
+                    glAssert(glTexImage2D(GL_TEXTURE_2D, static_cast<GLint>(j), GL_RGBA,
+                                          static_cast<GLsizei>(mipSize.x()),
+                                          static_cast<GLsizei>(mipSize.y()),
+                                          0, m_format, GL_UNSIGNED_BYTE, data));
+                }
+
+                m_buffers.clear();
+                m_textureId = textureId;
+                m_decoder = nullptr;
+            }
+        }
+
         void Texture::setCollection(TextureCollection* collection) {
             m_collection = collection;
         }
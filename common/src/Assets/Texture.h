@@ -27,6 +27,8 @@
 
 #include <vecmath/forward.h>
 
+#include <atomic>
+#include <functional>
 #include <utility>
 #include <cassert>
 #include <vector>
@@ -64,19 +66,26 @@ namespace TrenchBroom {
         void setMipBufferSize(TextureBuffer::List& buffers, size_t mipLevels, size_t width, size_t height, GLenum format);
 
         class Texture {
+        public:
+            /**
+             * Decodes the pixels of a texture that was loaded without them. Returns a new texture that contains the
+             * decoded pixels.
+             */
+            using Decoder = std::function<Texture*()>;
         private:
             TextureCollection* m_collection;
             String m_name;
 
             size_t m_width;
             size_t m_height;
-            Color m_averageColor;
+            // a texture that decodes its pixels on demand only knows its average color once it has been decoded
+            mutable Color m_averageColor;
 
-            size_t m_usageCount;
+            std::atomic<size_t> m_usageCount;
             bool m_overridden;
 
-            GLenum m_format;
-            TextureType m_type;
+            mutable GLenum m_format;
+            mutable TextureType m_type;
 
             // Quake 3 surface parameters; move these to materials when we add proper support for those.
             StringSet m_surfaceParms;
@@ -89,9 +98,16 @@ namespace TrenchBroom {
 
             mutable GLuint m_textureId;
             mutable TextureBuffer::List m_buffers;
+
+            // set if the pixels are decoded on demand, the upload is then deferred until the texture is activated
+            mutable Decoder m_decoder;
+            GLuint m_deferredTextureId;
+            int m_minFilter;
+            int m_magFilter;
         public:
             Texture(const String& name, size_t width, size_t height, const Color& averageColor, const TextureBuffer& buffer, GLenum format, TextureType type);
             Texture(const String& name, size_t width, size_t height, const Color& averageColor, const TextureBuffer::List& buffers, GLenum format, TextureType type);
+            Texture(const String& name, size_t width, size_t height, const Color& averageColor, GLenum format, TextureType type);
             Texture(const String& name, size_t width, size_t height, GLenum format = GL_RGB, TextureType type = TextureType::Opaque);
             ~Texture();
 
@@ -122,6 +138,37 @@ namespace TrenchBroom {
             void prepare(GLuint textureId, int minFilter, int magFilter);
             void setMode(int minFilter, int magFilter);
 
+            /**
+             * Makes this texture decode its pixels on demand using the given decoder. The pixels are decoded when
+             * decode() is called or when the texture is first activated, whichever happens first.
+             */
+            void setDecoder(Decoder decoder);
+
+            /**
+             * Indicates whether this texture's pixels must be decoded before it can be uploaded.
+             */
+            bool needsDecoding() const;
+
+            /**
+             * Decodes this texture's pixels if necessary. Different textures can be decoded concurrently. If decoding
+             * fails, the texture is left without pixels and no further attempts are made.
+             */
+            void decode() const;
+
+            /**
+             * Releases the decoded pixels of a texture that has not been uploaded yet, so that they are decoded again
+             * when needed. Does nothing if this texture does not decode its pixels on demand.
+             */
+            void discardDecodedPixels();
+
+            /**
+             * Returns the number of bytes held by this texture's pixel buffers.
+             */
+            size_t bufferSize() const;
+
+            /**
+             * Binds this texture. If its upload was deferred, the texture is decoded and uploaded first.
+             */
             void activate() const;
             void deactivate() const;
         public: // exposed for tests only
@@ -137,6 +184,7 @@ namespace TrenchBroom {
             TextureType type() const;
 
         private:
+            void upload(GLuint textureId, int minFilter, int magFilter) const;
             void setCollection(TextureCollection* collection);
             friend class TextureCollection;
         };
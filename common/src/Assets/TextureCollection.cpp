@@ -20,29 +20,34 @@
 #include "TextureCollection.h"
 
 #include "CollectionUtils.h"
+#include "ParallelUtils.h"
 #include "Assets/Texture.h"
 
 namespace TrenchBroom {
     namespace Assets {
         TextureCollection::TextureCollection() :
         m_loaded(false),
-        m_usageCount(0) {}
+        m_usageCount(0),
+        m_usageCountChangePending(false) {}
 
         TextureCollection::TextureCollection(const TextureList& textures) :
         m_loaded(false),
-        m_usageCount(0) {
+        m_usageCount(0),
+        m_usageCountChangePending(false) {
             addTextures(textures);
         }
 
         TextureCollection::TextureCollection(const IO::Path& path) :
         m_loaded(false),
         m_path(path),
-        m_usageCount(0) {}
+        m_usageCount(0),
+        m_usageCountChangePending(false) {}
 
         TextureCollection::TextureCollection(const IO::Path& path, const TextureList& textures) :
         m_loaded(true),
         m_path(path),
-        m_usageCount(0) {
+        m_usageCount(0),
+        m_usageCountChangePending(false) {
             addTextures(textures);
         }
 
@@ -135,13 +140,25 @@ namespace TrenchBroom {
 
         void TextureCollection::incUsageCount() {
             ++m_usageCount;
-            usageCountDidChange();
+            notifyUsageCountDidChange();
         }
 
         void TextureCollection::decUsageCount() {
             assert(m_usageCount > 0);
             --m_usageCount;
-            usageCountDidChange();
+            notifyUsageCountDidChange();
+        }
+
+        void TextureCollection::notifyUsageCountDidChange() {
+            // observers are UI components, so changes on worker threads are reported once the parallel work is done
+            if (!ParallelUtils::isWorkerThread()) {
+                usageCountDidChange();
+            } else if (!m_usageCountChangePending.exchange(true)) {
+                ParallelUtils::runOnCallingThread([this]() {
+                    m_usageCountChangePending = false;
+                    usageCountDidChange();
+                });
+            }
         }
     }
 }
@@ -26,6 +26,7 @@
 #include "IO/Path.h"
 #include "Renderer/GL.h"
 
+#include <atomic>
 #include <vector>
 
 namespace TrenchBroom {
@@ -38,7 +39,9 @@ namespace TrenchBroom {
             IO::Path m_path;
             TextureList m_textures;
 
-            size_t m_usageCount;
+            std::atomic<size_t> m_usageCount;
+            // whether a notification about a usage count change on a worker thread is waiting to be sent
+            std::atomic<bool> m_usageCountChangePending;
 
             TextureIdList m_textureIds;
 
@@ -71,6 +74,7 @@ namespace TrenchBroom {
         private:
             void incUsageCount();
             void decUsageCount();
+            void notifyUsageCountDidChange();
         };
     }
 }
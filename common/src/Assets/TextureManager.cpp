@@ -22,12 +22,14 @@
 #include "Exceptions.h"
 #include "CollectionUtils.h"
 #include "Logger.h"
+#include "ParallelUtils.h"
 #include "Assets/Texture.h"
 #include "Assets/TextureCollection.h"
 #include "IO/TextureLoader.h"
 
 #include <algorithm>
 #include <iterator>
+#include <unordered_set>
 
 namespace TrenchBroom {
     namespace Assets {
@@ -50,11 +52,19 @@ namespace TrenchBroom {
             }
         };
 
+        static const size_t DefaultDecodedBufferBudget = 128u * 1024u * 1024u;
+
         TextureManager::TextureManager(int magFilter, int minFilter, Logger& logger) :
         m_logger(logger),
         m_minFilter(minFilter),
         m_magFilter(magFilter),
-        m_resetTextureMode(false) {}
+        m_resetTextureMode(false),
+        m_lazyLoading(false),
+        m_decodeUsedTextures(false),
+        m_decodedBufferBudget(DefaultDecodedBufferBudget),
+        m_decodedBufferSize(0) {
+            usageCountDidChange.addObserver(this, &TextureManager::textureUsageDidChange);
+        }
 
         TextureManager::~TextureManager() {
             clear();
@@ -62,32 +72,60 @@ namespace TrenchBroom {
 
         void TextureManager::setTextureCollections(const IO::Path::List& paths, IO::TextureLoader& loader) {
             auto collections = collectionMap();
+            const auto decodedTextures = m_decodedTextures;
             m_collections.clear();
             clear();
 
+            // take over the existing collections and find the ones that must be (re)loaded
+            TextureCollectionList existing;
+            existing.reserve(paths.size());
+
+            IO::Path::List pathsToLoad;
             for (const auto& path : paths) {
                 const auto it = collections.find(path);
-                if (it == std::end(collections) || !it->second->loaded()) {
-                    try {
-                        auto collection = loader.loadTextureCollection(path);
+                if (it != std::end(collections)) {
+                    existing.push_back(it->second);
+                    collections.erase(it);
+                } else {
+                    existing.push_back(nullptr);
+                }
+
+                if (existing.back() == nullptr || !existing.back()->loaded()) {
+                    pathsToLoad.push_back(path);
+                }
+            }
+
+            // decode all collections in parallel, but add them in the given order so that overriding is deterministic
+            auto loaded = loader.loadTextureCollections(pathsToLoad, m_lazyLoading, m_cacheDirectory);
+            auto loadedIt = std::begin(loaded);
+
+            for (size_t i = 0; i < paths.size(); ++i) {
+                const auto& path = paths[i];
+                auto* collection = existing[i];
+
+                if (collection == nullptr || !collection->loaded()) {
+                    auto& result = *loadedIt++;
+                    if (result.collection != nullptr) {
                         m_logger.info() << "Loaded texture collection '" << path << "'";
-                        collection->usageCountDidChange.addObserver(usageCountDidChange);
-                        addTextureCollection(collection.release());
-                    } catch (const Exception& e) {
+                        result.collection->usageCountDidChange.addObserver(usageCountDidChange);
+                        addTextureCollection(result.collection.release());
+                    } else {
                         addTextureCollection(new Assets::TextureCollection(path));
-                        if (it == std::end(collections)) {
-                            m_logger.error() << "Could not load texture collection '" << path << "': " << e.what();
+                        if (collection == nullptr) {
+                            m_logger.error() << "Could not load texture collection '" << path << "': " << result.error;
                         }
                     }
+
+                    if (collection != nullptr) {
+                        m_toRemove.push_back(collection);
+                    }
                 } else {
-                    addTextureCollection(it->second);
-                }
-                if (it != std::end(collections)) {
-                    collections.erase(it);
+                    addTextureCollection(collection);
                 }
             }
 
             updateTextures();
+            keepDecodedTextures(decodedTextures);
             VectorUtils::append(m_toRemove, collections);
         }
 
@@ -125,6 +163,8 @@ namespace TrenchBroom {
             m_texturesByName.clear();
             m_textures.clear();
 
+            clearDecodedTextures();
+
             // Remove logging because it might fail when the document is already destroyed.
         }
 
@@ -137,9 +177,81 @@ namespace TrenchBroom {
         void TextureManager::commitChanges() {
             resetTextureMode();
             prepare();
+            forgetUploadedTextures();
+            decodeUsedTextures();
             VectorUtils::clearAndDelete(m_toRemove);
         }
 
+        void TextureManager::setLazyLoading(const bool lazyLoading) {
+            m_lazyLoading = lazyLoading;
+        }
+
+        bool TextureManager::lazyLoading() const {
+            return m_lazyLoading;
+        }
+
+        void TextureManager::setCacheDirectory(const IO::Path& cacheDirectory) {
+            m_cacheDirectory = cacheDirectory;
+        }
+
+        const IO::Path& TextureManager::cacheDirectory() const {
+            return m_cacheDirectory;
+        }
+
+        void TextureManager::setDecodedBufferBudget(const size_t budget) {
+            m_decodedBufferBudget = budget;
+        }
+
+        size_t TextureManager::decodedBufferSize() const {
+            return m_decodedBufferSize;
+        }
+
+        void TextureManager::decodeTextures(const TextureList& textures) {
+            forgetUploadedTextures();
+
+            TextureList toDecode;
+            std::unordered_set<Texture*> visited;
+            size_t estimatedSize = 0;
+
+            for (auto* texture : textures) {
+                if (!visited.insert(texture).second) {
+                    continue;
+                }
+
+                const auto it = m_decodedTextureIndex.find(texture);
+                if (it != std::end(m_decodedTextureIndex)) {
+                    // already decoded, so it only becomes the most recently used texture
+                    m_decodedTextures.splice(std::end(m_decodedTextures), m_decodedTextures, it->second);
+                    estimatedSize += it->second->second;
+                } else if (texture->needsDecoding()) {
+                    // an RGBA image with a full mip chain
+                    const auto textureSize = 4u * texture->width() * texture->height() * 4u / 3u;
+                    if (estimatedSize + textureSize > m_decodedBufferBudget) {
+                        break;
+                    }
+                    estimatedSize += textureSize;
+                    toDecode.push_back(texture);
+                }
+            }
+
+            ParallelUtils::parallelFor(toDecode.size(), [&](const size_t i) {
+                toDecode[i]->decode();
+            });
+
+            for (auto* texture : toDecode) {
+                const auto bufferSize = texture->bufferSize();
+                if (bufferSize > 0) {
+                    addDecodedTexture(texture, bufferSize);
+                }
+            }
+
+            while (m_decodedBufferSize > m_decodedBufferBudget) {
+                const auto it = std::begin(m_decodedTextures);
+                it->first->discardDecodedPixels();
+                removeDecodedTexture(it);
+            }
+        }
+
         Texture* TextureManager::texture(const String& name) const {
             auto it = m_texturesByName.find(StringUtils::toLower(name));
             if (it == std::end(m_texturesByName)) {
@@ -179,6 +291,67 @@ namespace TrenchBroom {
             m_toPrepare.clear();
         }
 
+        void TextureManager::decodeUsedTextures() {
+            if (m_decodeUsedTextures && m_lazyLoading) {
+                TextureList usedTextures;
+                for (auto* texture : m_textures) {
+                    if (texture->usageCount() > 0 && !texture->isPrepared()) {
+                        usedTextures.push_back(texture);
+                    }
+                }
+
+                decodeTextures(usedTextures);
+                m_decodeUsedTextures = false;
+            }
+        }
+
+        void TextureManager::forgetUploadedTextures() {
+            auto it = std::begin(m_decodedTextures);
+            while (it != std::end(m_decodedTextures)) {
+                const auto current = it++;
+                if (current->first->isPrepared()) {
+                    removeDecodedTexture(current);
+                }
+            }
+        }
+
+        void TextureManager::addDecodedTexture(Texture* texture, const size_t bufferSize) {
+            m_decodedTextures.emplace_back(texture, bufferSize);
+            m_decodedTextureIndex[texture] = std::prev(std::end(m_decodedTextures));
+            m_decodedBufferSize += bufferSize;
+        }
+
+        void TextureManager::removeDecodedTexture(const DecodedTextureList::iterator it) {
+            m_decodedBufferSize -= it->second;
+            m_decodedTextureIndex.erase(it->first);
+            m_decodedTextures.erase(it);
+        }
+
+        void TextureManager::clearDecodedTextures() {
+            m_decodedTextures.clear();
+            m_decodedTextureIndex.clear();
+            m_decodedBufferSize = 0;
+        }
+
+        void TextureManager::keepDecodedTextures(const DecodedTextureList& decodedTextures) {
+            // the textures of collections that were taken over are still decoded, account for them in their order
+            std::unordered_set<Texture*> keptTextures;
+            for (auto* collection : m_collections) {
+                const auto& textures = collection->textures();
+                keptTextures.insert(std::begin(textures), std::end(textures));
+            }
+
+            for (const auto& [texture, bufferSize] : decodedTextures) {
+                if (keptTextures.count(texture) > 0) {
+                    addDecodedTexture(texture, bufferSize);
+                }
+            }
+        }
+
+        void TextureManager::textureUsageDidChange() {
+            m_decodeUsedTextures = true;
+        }
+
         void TextureManager::updateTextures() {
             m_texturesByName.clear();
             m_textures.clear();
@@ -199,6 +372,7 @@ namespace TrenchBroom {
             }
 
             m_textures = MapUtils::valueList(m_texturesByName);
+            m_decodeUsedTextures = true;
         }
     }
 }
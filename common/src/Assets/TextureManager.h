@@ -25,7 +25,10 @@
 #include "IO/Path.h"
 #include "Model/ModelTypes.h"
 
+#include <list>
 #include <map>
+#include <unordered_map>
+#include <utility>
 #include <vector>
 
 namespace TrenchBroom {
@@ -41,6 +44,8 @@ namespace TrenchBroom {
             using TextureCollectionMap = std::map<IO::Path, TextureCollection*>;
             using TextureCollectionMapEntry = std::pair<IO::Path, TextureCollection*>;
             using TextureMap = std::map<String, Texture*>;
+            using DecodedTexture = std::pair<Texture*, size_t>;
+            using DecodedTextureList = std::list<DecodedTexture>;
 
             Logger& m_logger;
 
@@ -55,6 +60,15 @@ namespace TrenchBroom {
             int m_minFilter;
             int m_magFilter;
             bool m_resetTextureMode;
+
+            bool m_lazyLoading;
+            IO::Path m_cacheDirectory;
+            bool m_decodeUsedTextures;
+            size_t m_decodedBufferBudget;
+            size_t m_decodedBufferSize;
+            // decoded textures that are waiting to be uploaded, least recently used first
+            DecodedTextureList m_decodedTextures;
+            std::unordered_map<Texture*, DecodedTextureList::iterator> m_decodedTextureIndex;
         public:
             Notifier<> usageCountDidChange;
         public:
@@ -72,6 +86,38 @@ namespace TrenchBroom {
             void setTextureMode(int minFilter, int magFilter);
             void commitChanges();
 
+            /**
+             * Controls whether texture collections that are loaded from now on decode their pixels on demand. A lazily
+             * loaded texture is decoded when it is first used by a face or first activated.
+             *
+             * Until then, its average color is only approximated from its smallest mip level, and image textures have
+             * no average color at all, so face colors may differ from an eagerly loaded collection.
+             */
+            void setLazyLoading(bool lazyLoading);
+            bool lazyLoading() const;
+
+            /**
+             * Sets the directory in which texture collections that are loaded from now on are cached. The cache is
+             * disabled if the given path is empty.
+             */
+            void setCacheDirectory(const IO::Path& cacheDirectory);
+            const IO::Path& cacheDirectory() const;
+
+            /**
+             * Sets the maximum number of bytes that decoded textures which are waiting to be uploaded may occupy. If
+             * the budget is exceeded, the pixels of the least recently used textures are released again.
+             */
+            void setDecodedBufferBudget(size_t budget);
+            size_t decodedBufferSize() const;
+
+            /**
+             * Decodes those of the given textures that were loaded lazily and that are not decoded yet in parallel.
+             * Call this for textures that are about to be rendered. Stops once the decoded buffer budget is used up,
+             * the remaining textures will be decoded when they are activated. Given textures that are already decoded
+             * become the most recently used ones.
+             */
+            void decodeTextures(const TextureList& textures);
+
             Texture* texture(const String& name) const;
             const TextureList& textures() const;
             const TextureCollectionList& collections() const;
@@ -79,6 +125,13 @@ namespace TrenchBroom {
         private:
             void resetTextureMode();
             void prepare();
+            void decodeUsedTextures();
+            void forgetUploadedTextures();
+            void addDecodedTexture(Texture* texture, size_t bufferSize);
+            void removeDecodedTexture(DecodedTextureList::iterator it);
+            void clearDecodedTextures();
+            void keepDecodedTextures(const DecodedTextureList& decodedTextures);
+            void textureUsageDidChange();
 
             void updateTextures();
         };
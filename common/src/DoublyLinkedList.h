@@ -22,6 +22,8 @@
 
 #include "Ensure.h"
 
+#include <cassert>
+#include <cstddef>
 #include <iterator>
 
 template <typename Item, typename GetLink>
@@ -71,106 +73,11 @@ public:
             swap(m_previous, m_next);
         }
     };
-private:
-    template <typename ListType, typename ItemType, typename LinkType>
-    class iterator_delegate_item;
-
-    template <typename ListType, typename ItemType, typename LinkType>
-    class iterator_delegate_end;
-
-    template <typename ListType, typename ItemType, typename LinkType>
-    class iterator_delegate_base {
-    protected:
-        ListType* m_list;
-    private:
-        size_t m_listVersion;
-    protected:
-        explicit iterator_delegate_base(ListType& list) :
-                m_list(&list),
-                m_listVersion(m_list->m_version) {}
-    public:
-        virtual ~iterator_delegate_base() = default;
-    public:
-        iterator_delegate_base* clone() const { return doClone(); }
-
-        int compare(const iterator_delegate_base& other) const {
-            if (index() < other.index())
-                return -1;
-            if (index() > other.index())
-                return 1;
-            return 0;
-        }
-
-        void increment()      { assert(checkListVersion()); doIncrement(); }
-        size_t index() const  { assert(checkListVersion()); return doGetIndex(); }
-        ItemType& reference() { assert(checkListVersion()); return doGetItem(); }
-        ItemType item()       { assert(checkListVersion()); return doGetItem(); }
-    private:
-        bool checkListVersion() const { return m_listVersion == m_list->m_version; }
-    private:
-        virtual iterator_delegate_base* doClone() const = 0;
-        virtual void doIncrement() = 0;
-        virtual size_t doGetIndex() const = 0;
-        virtual ItemType& doGetItem() = 0;
-    };
-
-    template <typename ListType, typename ItemType, typename LinkType>
-    class iterator_delegate_item : public iterator_delegate_base<ListType, ItemType, LinkType> {
-    private:
-        using base = iterator_delegate_base<ListType, ItemType, LinkType>;
-        ItemType m_item;
-        size_t m_index;
-    public:
-        iterator_delegate_item(ListType& list, ItemType item, const size_t index) :
-                base(list),
-                m_item(item),
-                m_index(index) {}
-    private:
-        base* doClone() const override {
-            return new iterator_delegate_item(*base::m_list, m_item, m_index);
-        }
-
-        void doIncrement() override {
-            ++m_index;
-
-            LinkType& link = base::m_list->getLink(m_item);
-            m_item = link.next();
-        }
-
-        size_t doGetIndex() const override {
-            return m_index;
-        }
-
-        ItemType& doGetItem() override {
-            assert(m_index < base::m_list->size());
-            return m_item;
-        }
-    };
-
-    template <typename ListType, typename ItemType, typename LinkType>
-    class iterator_delegate_end : public iterator_delegate_base<ListType, ItemType, LinkType> {
-    private:
-        using base = iterator_delegate_base<ListType, ItemType, LinkType>;
-    public:
-        explicit iterator_delegate_end(ListType& list) :
-                base(list) {}
-    private:
-        base* doClone() const override {
-            return new iterator_delegate_end(*base::m_list);
-        }
-
-        void doIncrement() override {}
-
-        size_t doGetIndex() const override {
-            return base::m_list->size();
-        }
-
-        ItemType& doGetItem() override {
-            static ItemType null = nullptr;
-            return null;
-        }
-    };
 public:
+    /**
+     * Iterates over the items of a list. Iterators are compared by the index of their item, and the end iterator has
+     * the size of the list as its index.
+     */
     template <typename ListType, typename ItemType, typename LinkType>
     class iterator_base {
     public:
@@ -182,29 +89,33 @@ public:
     private:
         friend class DoublyLinkedList<Item, GetLink>;
 
-        using delegate = iterator_delegate_base<ListType, ItemType, LinkType>;
-        delegate* m_delegate;
+        ListType* m_list;
+        mutable ItemType m_item;
+        size_t m_index;
+        size_t m_listVersion;
+    private:
+        iterator_base(ListType& list, ItemType item, const size_t index) :
+        m_list(&list),
+        m_item(item),
+        m_index(index),
+        m_listVersion(list.m_version) {}
     public:
-        explicit iterator_base(delegate* delegate = nullptr) : m_delegate(delegate) {}
-        iterator_base(const iterator_base& other) : m_delegate(other.m_delegate->clone()) {}
-        ~iterator_base() { delete m_delegate; }
+        iterator_base() :
+        m_list(nullptr),
+        m_item(nullptr),
+        m_index(0),
+        m_listVersion(0) {}
 
         static iterator_base begin(ListType& list) {
             return item(list, list.m_head, 0);
         }
 
         static iterator_base item(ListType& list, Item* item, const size_t index) {
-            return iterator_base(new iterator_delegate_item<ListType, ItemType, LinkType>(list, item, index));
+            return iterator_base(list, item, index);
         }
 
         static iterator_base end(ListType& list) {
-            return iterator_base(new iterator_delegate_end<ListType, ItemType, LinkType>(list));
-        }
-
-        iterator_base& operator=(const iterator_base& other) {
-            delete m_delegate;
-            m_delegate = other.m_delegate->clone();
-            return *this;
+            return iterator_base(list, nullptr, list.size());
         }
 
         bool operator<(const iterator_base& other) const  { return compare(other) <  0; }
@@ -214,29 +125,53 @@ public:
 
         // prefix increment
         iterator_base& operator++() {
-            m_delegate->increment();
+            assert(checkListVersion());
+            assert(m_index < m_list->size());
+
+            ++m_index;
+            LinkType& link = m_list->getLink(m_item);
+            m_item = link.next();
             return *this;
         }
 
         // postfix increment
         iterator_base operator++(int) {
             iterator_base result(*this);
-            m_delegate->increment();
+            ++*this;
             return result;
         }
 
-        ItemType& operator*() const { return m_delegate->reference(); }
-        ItemType operator->() const { return m_delegate->item(); }
+        ItemType& operator*() const {
+            assert(checkListVersion());
+            return m_item;
+        }
+
+        ItemType operator->() const {
+            assert(checkListVersion());
+            return m_item;
+        }
     private:
         int compare(const iterator_base& other) const {
-            ensure(m_delegate != nullptr, "delegate is null");
-            ensure(other.m_delegate != nullptr, "other delegate is null");
-            return m_delegate->compare(*other.m_delegate);
+            ensure(m_list != nullptr, "list is null");
+            ensure(other.m_list != nullptr, "other list is null");
+            assert(checkListVersion());
+            assert(other.checkListVersion());
+
+            if (m_index < other.m_index)
+                return -1;
+            if (m_index > other.m_index)
+                return 1;
+            return 0;
         }
 
         size_t index() const {
-            ensure(m_delegate != nullptr, "delegate is null");
-            return m_delegate->index();
+            ensure(m_list != nullptr, "list is null");
+            assert(checkListVersion());
+            return m_index;
+        }
+
+        bool checkListVersion() const {
+            return m_listVersion == m_list->m_version;
         }
     };
 
@@ -266,7 +201,7 @@ public:
         other.m_version += 1;
     }
 
-    virtual ~DoublyLinkedList() {
+    ~DoublyLinkedList() {
         clear();
     }
 
@@ -286,6 +221,7 @@ public:
         other.m_head = nullptr;
         other.m_size = 0;
         other.m_version += 1;
+        return *this;
     }
 public:
     // Copying is not allowed since this is an intrusive list.
@@ -0,0 +1,405 @@
+/*
+ Copyright (C) 2010-2019 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef TRENCHBROOM_FLATAABBTREE_H
+#define TRENCHBROOM_FLATAABBTREE_H
+
+#include "NodeTree.h"
+
+#include <vecmath/bbox.h>
+#include <vecmath/ray.h>
+#include <vecmath/scalar.h>
+#include <vecmath/vec.h>
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cmath>
+#include <cstdint>
+#include <iterator>
+#include <functional>
+#include <limits>
+#include <list>
+#include <queue>
+#include <utility>
+#include <vector>
+
+/**
+ * A read only, linearized copy of an AABB tree.
+ *
+ * The nodes are stored in a contiguous array in depth first order, so the first child of an inner node immediately
+ * follows it. Instead of child pointers, every node stores the index of the node that follows its subtree, which is
+ * used to skip the subtree if the node's bounds do not match a query. The bounds are stored as float values in one
+ * array per component, and they are rounded outwards so that the stored bounds always contain the original bounds.
+ * Consequently, the queries may return a few more items than the original tree would return for rays or points that
+ * touch the bounds of an item.
+ *
+ * A flat tree is created by calling AABBTree::flatten.
+ *
+ * @tparam T the floating point type
+ * @tparam S the number of dimensions for vector types
+ * @tparam U the node data to store in the leafs
+ */
+template <typename T, size_t S, typename U>
+class FlatAABBTree {
+public:
+    using List = std::list<U>;
+    using Box = vm::bbox<T,S>;
+    using DataType = U;
+    using FloatType = T;
+    static const size_t Components = S;
+
+    /**
+     * Appends nodes to a flat tree in depth first order.
+     */
+    class Builder {
+    private:
+        FlatAABBTree& m_tree;
+    public:
+        explicit Builder(FlatAABBTree& tree) :
+        m_tree(tree) {}
+
+        /**
+         * Appends an inner node with the given bounds. Its children must be appended next, followed by a call to
+         * endInnerNode with the returned index.
+         *
+         * @param bounds the bounds of the inner node
+         * @return the index of the inner node
+         */
+        size_t beginInnerNode(const Box& bounds) {
+            return m_tree.append(bounds, U());
+        }
+
+        /**
+         * Marks the end of the subtree of the inner node with the given index.
+         *
+         * @param index the index of the inner node, as returned by beginInnerNode
+         */
+        void endInnerNode(const size_t index) {
+            m_tree.m_skip[index] = static_cast<uint32_t>(m_tree.size());
+        }
+
+        /**
+         * Appends a leaf with the given bounds and data.
+         *
+         * @param bounds the bounds of the leaf
+         * @param data the data of the leaf
+         */
+        void addLeaf(const Box& bounds, const U& data) {
+            const auto index = m_tree.append(bounds, data);
+            m_tree.m_skip[index] = static_cast<uint32_t>(index + 1);
+        }
+    };
+private:
+    std::array<std::vector<float>, S> m_min;
+    std::array<std::vector<float>, S> m_max;
+    std::vector<uint32_t> m_skip;
+    std::vector<U> m_data;
+public:
+    /**
+     * Removes all nodes from this tree.
+     */
+    void clear() {
+        for (size_t i = 0; i < S; ++i) {
+            m_min[i].clear();
+            m_max[i].clear();
+        }
+        m_skip.clear();
+        m_data.clear();
+    }
+
+    /**
+     * Reserves memory for the given number of nodes.
+     */
+    void reserve(const size_t count) {
+        for (size_t i = 0; i < S; ++i) {
+            m_min[i].reserve(count);
+            m_max[i].reserve(count);
+        }
+        m_skip.reserve(count);
+        m_data.reserve(count);
+    }
+
+    bool empty() const {
+        return m_skip.empty();
+    }
+
+    /**
+     * Returns the number of nodes (inner nodes and leafs) in this tree.
+     */
+    size_t size() const {
+        return m_skip.size();
+    }
+
+    /**
+     * The slab test scales the maximum distance by this factor to compensate for rounding errors, otherwise rays that
+     * touch a box might miss it. See Ize, "Robust BVH Ray Traversal".
+     */
+    static constexpr T RoundingFactor = static_cast<T>(1.0) + static_cast<T>(8.0) * std::numeric_limits<T>::epsilon();
+
+    List findIntersectors(const vm::ray<T,S>& ray) const {
+        List result;
+        findIntersectors(ray, std::back_inserter(result));
+        return result;
+    }
+
+    /**
+     * Finds every data item in this tree whose bounding box intersects with the given ray and appends it to the given
+     * output iterator.
+     *
+     * @tparam O the output iterator type
+     * @param ray the ray to test
+     * @param out the output iterator to append to
+     */
+    template <typename O>
+    void findIntersectors(const vm::ray<T,S>& ray, O out) const {
+        const RaySlabs slabs(ray);
+        visit([&](const size_t index) {
+            return !std::isnan(entryDistance(slabs, index));
+        }, out);
+    }
+
+    /**
+     * Visits the data items whose bounding boxes intersect with the given ray in the order of the distances at which
+     * the ray enters their bounding boxes. The given visitor is called with each data item and its entry distance, and
+     * it returns the distance beyond which no further items need to be visited. The traversal stops once every
+     * remaining node is entered beyond that distance.
+     *
+     * This allows a ray query to stop at the nearest confirmed hit without visiting the items that are hidden behind
+     * it, provided that the items never report hits closer than the entry distance of their bounding boxes.
+     *
+     * @tparam F the type of the visitor, must accept the data item and its entry distance and return a distance
+     * @param ray the ray to test
+     * @param visitor the visitor to call
+     */
+    template <typename F>
+    void findIntersectorsNearestFirst(const vm::ray<T,S>& ray, const F& visitor) const {
+        if (empty()) {
+            return;
+        }
+
+        const RaySlabs slabs(ray);
+        const auto rootDistance = entryDistance(slabs, 0);
+        if (std::isnan(rootDistance)) {
+            return;
+        }
+
+        using Entry = std::pair<T, uint32_t>;
+        std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> queue;
+        queue.emplace(rootDistance, 0u);
+
+        auto cutoff = std::numeric_limits<T>::max();
+        while (!queue.empty()) {
+            const auto [distance, index] = queue.top();
+            if (distance > cutoff) {
+                break;
+            }
+            queue.pop();
+
+            if (leaf(index)) {
+                cutoff = std::min(cutoff, static_cast<T>(visitor(m_data[index], distance)));
+            } else {
+                // every inner node has exactly two children, the first one immediately follows it
+                const uint32_t children[] = { index + 1, m_skip[index + 1] };
+                for (const auto child : children) {
+                    const auto childDistance = entryDistance(slabs, child);
+                    if (!std::isnan(childDistance) && childDistance <= cutoff) {
+                        queue.emplace(childDistance, child);
+                    }
+                }
+            }
+        }
+    }
+
+    List findContainers(const vm::vec<T,S>& point) const {
+        List result;
+        findContainers(point, std::back_inserter(result));
+        return result;
+    }
+
+    /**
+     * Finds every data item in this tree whose bounding box contains the given point and appends it to the given
+     * output iterator.
+     *
+     * @tparam O the output iterator type
+     * @param point the point to test
+     * @param out the output iterator to append to
+     */
+    template <typename O>
+    void findContainers(const vm::vec<T,S>& point, O out) const {
+        visit([&](const size_t index) {
+            for (size_t i = 0; i < S; ++i) {
+                if (point[i] < static_cast<T>(m_min[i][index]) || point[i] > static_cast<T>(m_max[i][index])) {
+                    return false;
+                }
+            }
+            return true;
+        }, out);
+    }
+
+    /**
+     * Finds every data item in this tree whose bounding box overlaps a volume and appends it to the given output
+     * iterator. The volume is given by a function that classifies a bounding box. If a node is inside the volume, all
+     * data items in its subtree are appended without classifying their bounding boxes.
+     *
+     * @tparam F the type of the function that classifies a bounding box, must return a VolumeRelation
+     * @tparam O the output iterator type
+     * @param relation the function that classifies a bounding box
+     * @param out the output iterator to append to
+     */
+    template <typename F, typename O>
+    void findInVolume(const F& relation, O out) const {
+        size_t index = 0;
+        while (index < m_skip.size()) {
+            switch (relation(bounds(index))) {
+                case VolumeRelation::Outside:
+                    index = m_skip[index];
+                    break;
+                case VolumeRelation::Intersecting:
+                    if (leaf(index)) {
+                        out = m_data[index];
+                        ++out;
+                    }
+                    ++index;
+                    break;
+                case VolumeRelation::Inside: {
+                    const size_t end = m_skip[index];
+                    while (index < end) {
+                        if (leaf(index)) {
+                            out = m_data[index];
+                            ++out;
+                        }
+                        ++index;
+                    }
+                    break;
+                }
+            }
+        }
+    }
+private:
+    /**
+     * Precomputes the inverse direction of a ray for the slab test, axes parallel to the ray are handled separately.
+     */
+    struct RaySlabs {
+        const vm::ray<T,S>& ray;
+        std::array<T, S> invDirection;
+        std::array<bool, S> parallel;
+
+        explicit RaySlabs(const vm::ray<T,S>& i_ray) :
+        ray(i_ray) {
+            for (size_t i = 0; i < S; ++i) {
+                parallel[i] = ray.direction[i] == static_cast<T>(0.0);
+                invDirection[i] = parallel[i] ? static_cast<T>(0.0) : static_cast<T>(1.0) / ray.direction[i];
+            }
+        }
+    };
+
+    /**
+     * Returns the distance at which the given ray enters the bounds of the node with the given index, or NaN if the
+     * ray misses the bounds. The distance is 0 if the ray origin is inside the bounds.
+     */
+    T entryDistance(const RaySlabs& slabs, const size_t index) const {
+        const auto& ray = slabs.ray;
+        auto minDistance = static_cast<T>(0.0);
+        auto maxDistance = std::numeric_limits<T>::max();
+
+        for (size_t i = 0; i < S; ++i) {
+            const auto min = static_cast<T>(m_min[i][index]);
+            const auto max = static_cast<T>(m_max[i][index]);
+
+            if (slabs.parallel[i]) {
+                if (ray.origin[i] < min || ray.origin[i] > max) {
+                    return vm::nan<T>();
+                }
+            } else {
+                auto t1 = (min - ray.origin[i]) * slabs.invDirection[i];
+                auto t2 = (max - ray.origin[i]) * slabs.invDirection[i];
+                if (t1 > t2) {
+                    std::swap(t1, t2);
+                }
+
+                minDistance = std::max(minDistance, t1);
+                maxDistance = std::min(maxDistance, t2);
+                if (minDistance > maxDistance * RoundingFactor) {
+                    return vm::nan<T>();
+                }
+            }
+        }
+        return minDistance;
+    }
+
+    Box bounds(const size_t index) const {
+        Box result;
+        for (size_t i = 0; i < S; ++i) {
+            result.min[i] = static_cast<T>(m_min[i][index]);
+            result.max[i] = static_cast<T>(m_max[i][index]);
+        }
+        return result;
+    }
+
+    /**
+     * Visits the nodes in depth first order, skipping the subtree of every node that does not match the given test,
+     * and appends the data of every matching leaf to the given output iterator.
+     */
+    template <typename F, typename O>
+    void visit(const F& test, O out) const {
+        size_t index = 0;
+        while (index < m_skip.size()) {
+            if (test(index)) {
+                if (leaf(index)) {
+                    out = m_data[index];
+                    ++out;
+                }
+                ++index;
+            } else {
+                index = m_skip[index];
+            }
+        }
+    }
+
+    bool leaf(const size_t index) const {
+        // every inner node has two children, so a node whose subtree ends right after it must be a leaf
+        return m_skip[index] == index + 1;
+    }
+
+    size_t append(const Box& bounds, const U& data) {
+        assert(size() < std::numeric_limits<uint32_t>::max());
+
+        for (size_t i = 0; i < S; ++i) {
+            m_min[i].push_back(roundDown(bounds.min[i]));
+            m_max[i].push_back(roundUp(bounds.max[i]));
+        }
+        m_skip.push_back(0);
+        m_data.push_back(data);
+
+        return size() - 1;
+    }
+
+    static float roundDown(const T value) {
+        const auto result = static_cast<float>(value);
+        return static_cast<T>(result) > value ? std::nextafter(result, -std::numeric_limits<float>::infinity()) : result;
+    }
+
+    static float roundUp(const T value) {
+        const auto result = static_cast<float>(value);
+        return static_cast<T>(result) < value ? std::nextafter(result, std::numeric_limits<float>::infinity()) : result;
+    }
+};
+
+#endif //TRENCHBROOM_FLATAABBTREE_H
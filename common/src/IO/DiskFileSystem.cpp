@@ -56,6 +56,10 @@ namespace TrenchBroom {
             return m_root + path.makeCanonical();
         }
 
+        Path DiskFileSystem::doGetRealPath(const Path& path) const {
+            return Disk::realPath(doMakeAbsolute(path));
+        }
+
         bool DiskFileSystem::doDirectoryExists(const Path& path) const {
             return Disk::directoryExists(doMakeAbsolute(path));
         }
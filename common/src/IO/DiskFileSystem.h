@@ -40,6 +40,7 @@ namespace TrenchBroom {
         protected:
             bool doCanMakeAbsolute(const Path& path) const override;
             Path doMakeAbsolute(const Path& path) const override;
+            Path doGetRealPath(const Path& path) const override;
 
             bool doDirectoryExists(const Path& path) const override;
             bool doFileExists(const Path& path) const override;
@@ -25,6 +25,13 @@
 #include <wx/filefn.h>
 #include <wx/filename.h>
 
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <climits>
+#include <cstdlib>
+#endif
+
 #include <cstdio>
 #include <fstream>
 
@@ -100,6 +107,30 @@ namespace TrenchBroom {
                 }
             }
 
+            Path realPath(const Path& path) {
+                const Path fixedPath = fixPath(path);
+#ifdef _WIN32
+                const auto handle = ::CreateFileW(wxString(fixedPath.asString()).wc_str(), 0, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, nullptr, OPEN_EXISTING, FILE_FLAG_BACKUP_SEMANTICS, nullptr);
+                if (handle == INVALID_HANDLE_VALUE) {
+                    return fixedPath;
+                }
+
+                wchar_t buffer[MAX_PATH];
+                const auto length = ::GetFinalPathNameByHandleW(handle, buffer, MAX_PATH, FILE_NAME_NORMALIZED);
+                ::CloseHandle(handle);
+                if (length == 0 || length >= MAX_PATH) {
+                    return fixedPath;
+                }
+                return Path(wxString(buffer, length).ToStdString());
+#else
+                char buffer[PATH_MAX];
+                if (::realpath(fixedPath.asString().c_str(), buffer) == nullptr) {
+                    return fixedPath;
+                }
+                return Path(buffer);
+#endif
+            }
+
             bool directoryExists(const Path& path) {
                 const Path fixedPath = fixPath(path);
                 return ::wxDirExists(fixedPath.asString());
@@ -140,7 +171,8 @@ namespace TrenchBroom {
                     throw FileNotFoundException("File not found: '" + fixedPath.asString() + "'");
                 }
 
-                return std::make_shared<CFile>(fixedPath);
+                // callers read these files and release them quickly, which keeps the risks of a mapping small
+                return std::make_shared<MappedFile>(fixedPath);
             }
 
             Path getCurrentWorkingDir() {
@@ -35,6 +35,15 @@ namespace TrenchBroom {
 
             Path fixPath(const Path& path);
 
+            /**
+             * Resolves all symbolic links in the given absolute path. If the path cannot be resolved, the fixed
+             * path is returned.
+             *
+             * @param path the path to resolve
+             * @return the resolved path
+             */
+            Path realPath(const Path& path);
+
             bool directoryExists(const Path& path);
             bool fileExists(const Path& path);
 
@@ -21,6 +21,15 @@
 
 #include "IO/IOUtils.h"
 
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
 namespace TrenchBroom {
     namespace IO {
         File::File(const Path& path) :
@@ -89,6 +98,114 @@ namespace TrenchBroom {
             return m_file;
         }
 
+#ifdef _WIN32
+        MappedFile::MappedFile(const Path& path) :
+        File(path),
+        m_begin(nullptr),
+        m_size(0),
+        m_fileHandle(INVALID_HANDLE_VALUE),
+        m_mappingHandle(nullptr) {
+            m_fileHandle = CreateFileA(path.asString().c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_DELETE, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+            if (m_fileHandle == INVALID_HANDLE_VALUE) {
+                throw FileSystemException() << "Cannot open file " << path;
+            }
+
+            LARGE_INTEGER size;
+            if (!GetFileSizeEx(m_fileHandle, &size)) {
+                unmap();
+                throw FileSystemException() << "Cannot get size of file " << path;
+            }
+            m_size = static_cast<size_t>(size.QuadPart);
+
+            // empty files cannot be mapped
+            if (m_size > 0) {
+                m_mappingHandle = CreateFileMappingA(m_fileHandle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+                if (m_mappingHandle == nullptr) {
+                    unmap();
+                    throw FileSystemException() << "Cannot map file " << path;
+                }
+
+                m_begin = static_cast<const char*>(MapViewOfFile(m_mappingHandle, FILE_MAP_READ, 0, 0, 0));
+                if (m_begin == nullptr) {
+                    unmap();
+                    throw FileSystemException() << "Cannot map file " << path;
+                }
+            }
+        }
+
+        void MappedFile::unmap() {
+            if (m_begin != nullptr) {
+                UnmapViewOfFile(m_begin);
+                m_begin = nullptr;
+            }
+            if (m_mappingHandle != nullptr) {
+                CloseHandle(m_mappingHandle);
+                m_mappingHandle = nullptr;
+            }
+            if (m_fileHandle != INVALID_HANDLE_VALUE) {
+                CloseHandle(m_fileHandle);
+                m_fileHandle = INVALID_HANDLE_VALUE;
+            }
+        }
+#else
+        MappedFile::MappedFile(const Path& path) :
+        File(path),
+        m_begin(nullptr),
+        m_size(0) {
+            const auto fd = ::open(path.asString().c_str(), O_RDONLY);
+            if (fd == -1) {
+                throw FileSystemException() << "Cannot open file " << path;
+            }
+
+            struct stat info;
+            if (::fstat(fd, &info) == -1) {
+                ::close(fd);
+                throw FileSystemException() << "Cannot get size of file " << path;
+            }
+            m_size = static_cast<size_t>(info.st_size);
+
+            // empty files cannot be mapped
+            if (m_size > 0) {
+                auto* addr = ::mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, fd, 0);
+                if (addr == MAP_FAILED) {
+                    ::close(fd);
+                    throw FileSystemException() << "Cannot map file " << path;
+                }
+                m_begin = static_cast<const char*>(addr);
+            }
+
+            // the mapping remains valid after the file descriptor is closed
+            ::close(fd);
+        }
+
+        void MappedFile::unmap() {
+            if (m_begin != nullptr) {
+                ::munmap(const_cast<char*>(m_begin), m_size);
+                m_begin = nullptr;
+            }
+        }
+#endif
+
+        MappedFile::~MappedFile() {
+            unmap();
+        }
+
+        Reader MappedFile::reader() const {
+            return Reader::from(begin(), end());
+        }
+
+        size_t MappedFile::size() const {
+            return m_size;
+        }
+
+        const char* MappedFile::begin() const {
+            return m_begin;
+        }
+
+        const char* MappedFile::end() const {
+            return m_begin + m_size;
+        }
+
         FileView::FileView(const Path& path, std::shared_ptr<File> file, const size_t offset, const size_t length) :
         File(path),
         m_file(std::move(file)),
@@ -136,6 +136,52 @@ namespace TrenchBroom {
             std::FILE* file() const;
         };
 
+        /**
+         * A file that is backed by a physical file on the disk which is mapped into memory. The file is mapped in the
+         * constructor and unmapped in the destructor.
+         *
+         * The readers returned by this file and by any file views into it access the mapped memory directly, so the
+         * contents of the file are never copied. The readers are only valid as long as this file exists.
+         *
+         * Only use this for files that are read and released quickly. If another program truncates the file while it
+         * is mapped, reading the missing pages raises SIGBUS rather than an exception, and on Windows the file cannot
+         * be replaced or deleted while it is mapped.
+         */
+        class MappedFile : public File {
+        private:
+            const char* m_begin;
+            size_t m_size;
+#ifdef _WIN32
+            void* m_fileHandle;
+            void* m_mappingHandle;
+#endif
+        public:
+            /**
+             * Creates a new file with the given path and maps its contents into memory.
+             *
+             * @param path the path of the file
+             *
+             * @throw FileSystemException if the file cannot be opened or mapped
+             */
+            explicit MappedFile(const Path& path);
+            ~MappedFile() override;
+
+            Reader reader() const override;
+            size_t size() const override;
+
+            /**
+             * Returns the start of the mapped memory.
+             */
+            const char* begin() const;
+
+            /**
+             * Returns the end of the mapped memory (position after the last byte).
+             */
+            const char* end() const;
+        private:
+            void unmap();
+        };
+
         /**
          * A file that is backed by a portion of a physical file.
          */
@@ -189,6 +189,11 @@ namespace TrenchBroom {
             throw FileSystemException("Cannot make absolute path of '" + path.asString() + "'");
         }
 
+        Path FileSystem::doGetRealPath(const Path& path) const {
+            // file systems without symbolic links can use the path itself
+            return path;
+        }
+
         WritableFileSystem::WritableFileSystem() = default;
         WritableFileSystem::~WritableFileSystem() = default;
 
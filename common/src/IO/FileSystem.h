@@ -28,6 +28,7 @@
 
 #include <iostream>
 #include <memory>
+#include <set>
 
 namespace TrenchBroom {
     namespace IO {
@@ -112,6 +113,24 @@ namespace TrenchBroom {
              */
             Path::List findItemsRecursively(const Path& directoryPath) const;
 
+            /**
+             * Calls the given function for every item in this file system and its sub directories. Unlike the other
+             * queries, this does not include the items of the next file systems in the chain.
+             *
+             * A directory that cannot be read or that is its own ancestor by way of a symbolic link is skipped, and
+             * the given error handler is called with its path and the reason.
+             *
+             * @tparam F the type of the function, must accept the path of an item and whether it is a directory
+             * @tparam E the type of the error handler, must accept the path of a directory and an exception
+             * @param fun the function to call
+             * @param onError the error handler to call
+             */
+            template <class F, class E>
+            void forEachLocalItem(const F& fun, const E& onError) const {
+                std::set<Path> ancestors;
+                _forEachLocalItem(Path(""), fun, onError, ancestors);
+            }
+
             Path::List getDirectoryContents(const Path& directoryPath) const;
             std::shared_ptr<File> openFile(const Path& path) const;
         private: // private API to be used for chaining, avoids multiple checks of parameters
@@ -174,6 +193,44 @@ namespace TrenchBroom {
                 }
             }
 
+            /**
+             * Calls the given function for every item in the given directory of this file system, and recurses into
+             * the sub directories after visiting them.
+             *
+             * @tparam F the type of the function
+             * @tparam E the type of the error handler
+             * @param directoryPath the path to the directory
+             * @param fun the function to call
+             * @param onError the error handler to call if the directory is skipped
+             * @param ancestors the real paths of the directories currently being visited
+             */
+            template <class F, class E>
+            void _forEachLocalItem(const Path& directoryPath, const F& fun, const E& onError, std::set<Path>& ancestors) const {
+                Path realPath;
+                Path::List contents;
+                try {
+                    realPath = doGetRealPath(directoryPath);
+                    if (ancestors.count(realPath) > 0) {
+                        throw FileSystemException("Skipping symbolic link cycle at '" + directoryPath.asString() + "'");
+                    }
+                    contents = doGetDirectoryContents(directoryPath);
+                } catch (const Exception& e) {
+                    onError(directoryPath, e);
+                    return;
+                }
+
+                ancestors.insert(realPath);
+                for (const auto& itemPath : contents) {
+                    const auto path = directoryPath + itemPath;
+                    const auto directory = doDirectoryExists(path);
+                    fun(path, directory);
+                    if (directory) {
+                        _forEachLocalItem(path, fun, onError, ancestors);
+                    }
+                }
+                ancestors.erase(realPath);
+            }
+
             /**
              * Finds all items matching the given matcher at the given search path, optionally recursively, and adds
              * the matches to the given result.
@@ -201,6 +258,7 @@ namespace TrenchBroom {
         private: // subclassing API
             virtual bool doCanMakeAbsolute(const Path& path) const;
             virtual Path doMakeAbsolute(const Path& path) const;
+            virtual Path doGetRealPath(const Path& path) const;
 
             virtual bool doDirectoryExists(const Path& path) const = 0;
             virtual bool doFileExists(const Path& path) const = 0;
@@ -116,5 +116,38 @@ namespace TrenchBroom {
             const auto textureType = Assets::Texture::selectTextureType(masked);
             return new Assets::Texture(textureName(imageName, path), imageWidth, imageHeight, Color(), buffers, format, textureType);
         }
+
+        Assets::Texture* FreeImageTextureReader::doReadTextureInfo(std::shared_ptr<File> file) const {
+            auto reader = file->reader().buffer();
+
+            const auto& path            = file->path();
+            const auto* begin           = reader.begin();
+            const auto* end             = reader.end();
+            const auto  imageSize       = static_cast<size_t>(end - begin);
+                  auto* imageBegin      = reinterpret_cast<BYTE*>(const_cast<char*>(begin));
+                  auto* imageMemory     = FreeImage_OpenMemory(imageBegin, static_cast<DWORD>(imageSize));
+            const auto  imageFormat     = FreeImage_GetFileTypeFromMemory(imageMemory);
+                  auto* image           = FreeImage_LoadFromMemory(imageFormat, imageMemory, FIF_LOAD_NOPIXELS);
+            const auto  imageName       = path.filename();
+
+            if (image == nullptr) {
+                FreeImage_CloseMemory(imageMemory);
+                return new Assets::Texture(textureName(imageName, path), 64, 64);
+            }
+
+            const auto imageWidth      = static_cast<size_t>(FreeImage_GetWidth(image));
+            const auto imageHeight     = static_cast<size_t>(FreeImage_GetHeight(image));
+
+            FreeImage_Unload(image);
+            FreeImage_CloseMemory(imageMemory);
+
+            if (!checkTextureDimensions(imageWidth, imageHeight)) {
+                return new Assets::Texture(textureName(imageName, path), 64, 64);
+            }
+
+            // the texture type is determined when the pixels are decoded
+            constexpr auto format = freeImage32BPPFormatToGLFormat();
+            return new Assets::Texture(textureName(imageName, path), imageWidth, imageHeight, Color(), format, Assets::TextureType::Opaque);
+        }
     }
 }
@@ -24,8 +24,19 @@
 #include <vecmath/forward.h>
 #include <vecmath/vec.h>
 
+#include <cerrno>
+#include <chrono>
+#include <cstdio>
 #include <cstring>
+#include <functional>
+#include <random>
+#include <sstream>
 #include <streambuf>
+#include <thread>
+
+#ifdef _WIN32
+#include <windows.h>
+#endif
 
 namespace TrenchBroom {
     namespace IO {
@@ -41,6 +52,63 @@ namespace TrenchBroom {
                 fclose(file);
         }
 
+        /**
+         * Returns a name for a temporary file that does not clash with the temporary files of other threads or other
+         * processes writing to the same directory.
+         */
+        static String temporaryFileName(const Path& path) {
+            std::random_device random;
+            const auto time = std::chrono::steady_clock::now().time_since_epoch().count();
+            const auto thread = std::hash<std::thread::id>()(std::this_thread::get_id());
+
+            std::stringstream name;
+            name << path.asString() << "." << std::hex << random() << "." << time << "." << thread << ".tmp";
+            return name.str();
+        }
+
+        ReplaceFile::ReplaceFile(const Path& path) :
+        file(nullptr),
+        m_path(path.asString()),
+        m_temporaryPath(temporaryFileName(path)) {
+            // binary mode, otherwise line endings would be translated on Windows
+            file = fopen(m_temporaryPath.c_str(), "wb");
+            if (file == nullptr)
+                throw FileSystemException("Cannot open file: " + m_temporaryPath);
+        }
+
+        ReplaceFile::~ReplaceFile() {
+            if (file != nullptr) {
+                fclose(file);
+                std::remove(m_temporaryPath.c_str());
+            }
+        }
+
+        void ReplaceFile::commit() {
+            ensure(file != nullptr, "file is already committed");
+
+            const auto closed = fclose(file) == 0;
+            file = nullptr;
+            if (!closed) {
+                std::remove(m_temporaryPath.c_str());
+                throw FileSystemException("Cannot write file: " + m_temporaryPath);
+            }
+
+#ifdef _WIN32
+            // rename does not replace existing files on Windows
+            if (!MoveFileExA(m_temporaryPath.c_str(), m_path.c_str(), MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH)) {
+                const auto error = GetLastError();
+                std::remove(m_temporaryPath.c_str());
+                throw FileSystemException() << "Cannot replace file " << m_path << " (error " << error << ")";
+            }
+#else
+            if (std::rename(m_temporaryPath.c_str(), m_path.c_str()) != 0) {
+                const auto error = errno;
+                std::remove(m_temporaryPath.c_str());
+                throw FileSystemException() << "Cannot replace file " << m_path << ": " << std::strerror(error);
+            }
+#endif
+        }
+
         OpenStream::OpenStream(const Path& path, const bool write) :
         stream(path.asString().c_str(), std::ios::in | (write ? std::ios::out : std::ios::in)) {
             if (!stream.is_open()) {
@@ -55,6 +55,32 @@ namespace TrenchBroom {
             deleteCopyAndMove(OpenFile)
         };
 
+        /**
+         * Opens a temporary file next to the given path for writing in binary mode. Once the temporary file has been
+         * written completely, commit replaces the file at the given path with it in one step, so that readers, including
+         * other instances of the editor, never see a partially written file. If this object is destroyed before commit
+         * was called, the temporary file is removed.
+         */
+        class ReplaceFile {
+        public:
+            FILE* file;
+        private:
+            String m_path;
+            String m_temporaryPath;
+        public:
+            explicit ReplaceFile(const Path& path);
+            ~ReplaceFile();
+
+            /**
+             * Closes the temporary file and moves it to the path given on construction, replacing any existing file.
+             *
+             * @throw FileSystemException if the temporary file cannot be written or moved
+             */
+            void commit();
+
+            deleteCopyAndMove(ReplaceFile)
+        };
+
         class OpenStream {
         public:
             std::fstream stream;
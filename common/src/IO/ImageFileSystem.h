@@ -114,6 +114,7 @@ namespace TrenchBroom {
 
         class ImageFileSystem : public ImageFileSystemBase {
         protected:
+            // archives stay open as long as the file system exists, which is too long to map them safely (see MappedFile)
             std::shared_ptr<CFile> m_file;
         protected:
             ImageFileSystem(std::shared_ptr<FileSystem> next, const Path& path);
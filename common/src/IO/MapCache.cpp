@@ -0,0 +1,135 @@
+/*
+ Copyright (C) 2010-2019 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "MapCache.h"
+
+#include "Exceptions.h"
+#include "Logger.h"
+#include "IO/File.h"
+#include "IO/IOUtils.h"
+#include "IO/MapCacheReader.h"
+#include "IO/MapCacheSerializer.h"
+#include "IO/NodeWriter.h"
+#include "IO/Path.h"
+#include "IO/SimpleParserStatus.h"
+#include "Model/World.h"
+
+#include <sys/stat.h>
+#include <sys/types.h>
+
+#include <cstdio>
+
+namespace TrenchBroom {
+    namespace IO {
+        static int64_t modificationTime(const Path& path) {
+#ifdef _WIN32
+            struct _stat64 info;
+            if (_stat64(path.asString().c_str(), &info) != 0) {
+#else
+            struct stat info;
+            if (::stat(path.asString().c_str(), &info) != 0) {
+#endif
+                throw FileSystemException() << "Cannot get modification time of " << path;
+            }
+            return static_cast<int64_t>(info.st_mtime);
+        }
+
+        /**
+         * Computes the 64 bit FNV-1a hash of the given bytes.
+         */
+        static uint64_t hash(const char* begin, const char* end) {
+            uint64_t result = 14695981039346656037ull;
+            for (const auto* cur = begin; cur < end; ++cur) {
+                result ^= static_cast<unsigned char>(*cur);
+                result *= 1099511628211ull;
+            }
+            return result;
+        }
+
+        MapCacheKey::MapCacheKey() :
+        size(0),
+        modificationTime(0),
+        hash(0) {}
+
+        MapCacheKey::MapCacheKey(const uint64_t i_size, const int64_t i_modificationTime, const uint64_t i_hash) :
+        size(i_size),
+        modificationTime(i_modificationTime),
+        hash(i_hash) {}
+
+        MapCacheKey MapCacheKey::compute(const Path& mapPath) {
+            const MappedFile file(mapPath);
+            return MapCacheKey(
+                static_cast<uint64_t>(file.size()),
+                IO::modificationTime(mapPath),
+                IO::hash(file.begin(), file.end()));
+        }
+
+        bool MapCacheKey::operator==(const MapCacheKey& other) const {
+            return size == other.size && modificationTime == other.modificationTime && hash == other.hash;
+        }
+
+        bool MapCacheKey::operator!=(const MapCacheKey& other) const {
+            return !(*this == other);
+        }
+
+        namespace MapCache {
+            Path cachePath(const Path& mapPath) {
+                return mapPath.addExtension("tbcache");
+            }
+
+            void write(Model::World& world, const vm::bbox3& worldBounds, const Path& mapPath) {
+                const auto key = MapCacheKey::compute(mapPath);
+                const auto path = cachePath(mapPath);
+
+                // write to a temporary file first so that a crash or another instance never leaves a truncated
+                // cache file behind
+                ReplaceFile file(path);
+                NodeWriter writer(world, new MapCacheSerializer(file.file, world.format(), worldBounds, key));
+                writer.writeMap();
+                file.commit();
+            }
+
+            std::unique_ptr<Model::World> read(const Model::MapFormat format, const vm::bbox3& worldBounds, const Path& mapPath, Logger& logger) {
+                const auto path = cachePath(mapPath);
+                try {
+                    std::unique_ptr<MappedFile> file;
+                    try {
+                        file = std::make_unique<MappedFile>(path);
+                    } catch (const FileSystemException&) {
+                        // there is no cache file
+                        return nullptr;
+                    }
+
+                    const auto key = MapCacheKey::compute(mapPath);
+
+                    SimpleParserStatus status(logger);
+                    MapCacheReader reader(file->begin(), file->end());
+                    auto world = reader.readCache(key, format, worldBounds, status);
+                    if (world == nullptr) {
+                        logger.debug() << "Ignoring outdated map cache " << path;
+                    }
+                    return world;
+                } catch (const Exception& e) {
+                    logger.warn() << "Could not read map cache " << path << ": " << e.what();
+                    return nullptr;
+                }
+            }
+        }
+    }
+}
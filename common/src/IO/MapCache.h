@@ -0,0 +1,90 @@
+/*
+ Copyright (C) 2010-2019 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef TrenchBroom_MapCache
+#define TrenchBroom_MapCache
+
+#include "TrenchBroom.h"
+#include "Model/MapFormat.h"
+#include "Model/ModelTypes.h"
+
+#include <vecmath/forward.h>
+
+#include <cstdint>
+#include <memory>
+
+namespace TrenchBroom {
+    class Logger;
+
+    namespace IO {
+        class Path;
+
+        /**
+         * Identifies the contents of a map file. A cache file is only used if the key stored in it matches the key of
+         * the map file it belongs to.
+         */
+        struct MapCacheKey {
+            uint64_t size;
+            int64_t modificationTime;
+            uint64_t hash;
+
+            MapCacheKey();
+            MapCacheKey(uint64_t i_size, int64_t i_modificationTime, uint64_t i_hash);
+
+            /**
+             * Computes the key of the given map file.
+             *
+             * @throw FileSystemException if the file cannot be opened
+             */
+            static MapCacheKey compute(const Path& mapPath);
+
+            bool operator==(const MapCacheKey& other) const;
+            bool operator!=(const MapCacheKey& other) const;
+        };
+
+        /**
+         * A map cache is a binary file that is stored next to a map file and contains the same nodes as the map file,
+         * including the brush geometry. Loading a map from its cache avoids parsing the map file and computing the
+         * brush geometry, which is much faster for large maps.
+         *
+         * The cache is written whenever the map is saved and it is ignored if the map file was changed afterwards.
+         */
+        namespace MapCache {
+            /**
+             * Returns the path of the cache file for the given map file.
+             */
+            Path cachePath(const Path& mapPath);
+
+            /**
+             * Writes the cache file for the given world, which must just have been saved to the given map file.
+             *
+             * @throw FileSystemException if the cache file cannot be written
+             */
+            void write(Model::World& world, const vm::bbox3& worldBounds, const Path& mapPath);
+
+            /**
+             * Reads the world from the cache file of the given map file. Returns null if there is no cache file, if
+             * it does not match the map file or the given format or world bounds, or if it cannot be read.
+             */
+            std::unique_ptr<Model::World> read(Model::MapFormat format, const vm::bbox3& worldBounds, const Path& mapPath, Logger& logger);
+        }
+    }
+}
+
+#endif /* defined(TrenchBroom_MapCache) */
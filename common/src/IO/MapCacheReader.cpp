@@ -0,0 +1,227 @@
+/*
+ Copyright (C) 2010-2019 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "MapCacheReader.h"
+
+#include "CollectionUtils.h"
+#include "Exceptions.h"
+#include "IO/MapCacheSerializer.h"
+#include "IO/Reader.h"
+#include "Model/Brush.h"
+#include "Model/BrushFace.h"
+#include "Model/BrushFaceAttributes.h"
+#include "Model/ModelFactoryImpl.h"
+#include "Model/World.h"
+
+#include <cstring>
+
+namespace TrenchBroom {
+    namespace IO {
+        static String readCacheString(Reader& reader) {
+            const auto size = reader.readSize<uint32_t>();
+            if (!reader.canRead(size)) {
+                throw ReaderException("Map cache string exceeds the end of the file");
+            }
+            return reader.readString(size);
+        }
+
+        static vm::vec3 readCacheVec(Reader& reader) {
+            return reader.readVec<double, 3, FloatType>();
+        }
+
+        MapCacheReader::MapCacheReader(const char* begin, const char* end) :
+        WorldReader(begin, end),
+        m_begin(begin),
+        m_end(end) {}
+
+        MapCacheReader::~MapCacheReader() {
+            MapChunkReader::deleteBrushes(m_events);
+        }
+
+        std::unique_ptr<Model::World> MapCacheReader::readCache(const MapCacheKey& key, const Model::MapFormat format, const vm::bbox3& worldBounds, ParserStatus& status) {
+            auto reader = Reader::from(m_begin, m_end);
+            if (!readHeader(reader, key, format, worldBounds)) {
+                return nullptr;
+            }
+
+            const Model::ModelFactoryImpl factory(format);
+            readRecords(reader, factory);
+
+            readEvents(format, worldBounds, m_events, status);
+            return releaseWorld();
+        }
+
+        bool MapCacheReader::readHeader(Reader& reader, const MapCacheKey& key, const Model::MapFormat format, const vm::bbox3& worldBounds) const {
+            char magic[sizeof(MapCacheSerializer::Magic)];
+            if (!reader.canRead(sizeof(magic))) {
+                return false;
+            }
+
+            reader.read(magic, sizeof(magic));
+            if (std::memcmp(magic, MapCacheSerializer::Magic, sizeof(magic)) != 0 ||
+                reader.read<uint32_t, uint32_t>() != MapCacheSerializer::ByteOrderMark ||
+                reader.readSize<uint8_t>() != sizeof(FloatType) ||
+                reader.readUnsignedInt<uint32_t>() != MapCacheSerializer::Version ||
+                reader.readUnsignedInt<uint32_t>() != static_cast<unsigned int>(format)) {
+                return false;
+            }
+
+            const auto min = readCacheVec(reader);
+            const auto max = readCacheVec(reader);
+            if (vm::bbox3(min, max) != worldBounds) {
+                return false;
+            }
+
+            const auto size = reader.read<uint64_t, uint64_t>();
+            const auto modificationTime = reader.read<int64_t, int64_t>();
+            const auto hash = reader.read<uint64_t, uint64_t>();
+            return MapCacheKey(size, modificationTime, hash) == key;
+        }
+
+        void MapCacheReader::readRecords(Reader& reader, const Model::ModelFactory& factory) {
+            while (true) {
+                const auto type = reader.readUnsignedChar<uint8_t>();
+                switch (type) {
+                    case MapCacheSerializer::Record_BeginEntity: {
+                        MapChunkReader::Event event(MapChunkReader::Event::Type_BeginEntity);
+                        event.line = reader.readSize<uint64_t>();
+                        m_events.push_back(std::move(event));
+                        break;
+                    }
+                    case MapCacheSerializer::Record_EntityAttribute: {
+                        if (m_events.empty() || m_events.back().type != MapChunkReader::Event::Type_BeginEntity) {
+                            throw ParserException("Unexpected entity attribute in map cache");
+                        }
+
+                        auto name = readCacheString(reader);
+                        auto value = readCacheString(reader);
+                        m_events.back().attributes.push_back(Model::EntityAttribute(name, value));
+                        break;
+                    }
+                    case MapCacheSerializer::Record_EndEntity: {
+                        MapChunkReader::Event event(MapChunkReader::Event::Type_EndEntity);
+                        event.line = reader.readSize<uint64_t>();
+                        event.lineCount = reader.readSize<uint64_t>();
+                        m_events.push_back(std::move(event));
+                        break;
+                    }
+                    case MapCacheSerializer::Record_Brush: {
+                        MapChunkReader::Event event(MapChunkReader::Event::Type_Brush);
+                        event.brush = readBrush(reader, factory);
+                        event.line = event.brush->lineNumber();
+                        event.lineCount = event.brush->lineCount();
+                        m_events.push_back(std::move(event));
+                        break;
+                    }
+                    case MapCacheSerializer::Record_EndFile:
+                        return;
+                    default:
+                        throw ParserException() << "Unknown record type " << static_cast<unsigned int>(type) << " in map cache";
+                }
+            }
+        }
+
+        Model::Brush* MapCacheReader::readBrush(Reader& reader, const Model::ModelFactory& factory) const {
+            const auto line = reader.readSize<uint64_t>();
+            const auto lineCount = reader.readSize<uint64_t>();
+            const auto faceCount = reader.readSize<uint32_t>();
+
+            Model::BrushFaceList faces;
+            try {
+                for (size_t i = 0; i < faceCount; ++i) {
+                    faces.push_back(readBrushFace(reader, factory));
+                }
+            } catch (...) {
+                VectorUtils::clearAndDelete(faces);
+                throw;
+            }
+
+            Model::BrushGeometry* geometry = nullptr;
+            try {
+                geometry = readBrushGeometry(reader, faceCount);
+            } catch (...) {
+                VectorUtils::clearAndDelete(faces);
+                throw;
+            }
+
+            // the brush takes ownership of the faces and the geometry, even if it throws
+            auto* brush = new Model::Brush(faces, geometry);
+            brush->setFilePosition(line, lineCount);
+            return brush;
+        }
+
+        Model::BrushFace* MapCacheReader::readBrushFace(Reader& reader, const Model::ModelFactory& factory) const {
+            const auto line = reader.readSize<uint64_t>();
+            const auto point1 = readCacheVec(reader);
+            const auto point2 = readCacheVec(reader);
+            const auto point3 = readCacheVec(reader);
+
+            Model::BrushFaceAttributes attribs(readCacheString(reader));
+            attribs.setXOffset(reader.readFloat<float>());
+            attribs.setYOffset(reader.readFloat<float>());
+            attribs.setRotation(reader.readFloat<float>());
+            attribs.setXScale(reader.readFloat<float>());
+            attribs.setYScale(reader.readFloat<float>());
+            attribs.setSurfaceContents(reader.readInt<int32_t>());
+            attribs.setSurfaceFlags(reader.readInt<int32_t>());
+            attribs.setSurfaceValue(reader.readFloat<float>());
+
+            const auto r = reader.readFloat<float>();
+            const auto g = reader.readFloat<float>();
+            const auto b = reader.readFloat<float>();
+            const auto a = reader.readFloat<float>();
+            attribs.setColor(Color(r, g, b, a));
+
+            const auto texAxisX = readCacheVec(reader);
+            const auto texAxisY = readCacheVec(reader);
+
+            auto* face = factory.createFace(point1, point2, point3, attribs, texAxisX, texAxisY);
+            face->setFilePosition(line, 1);
+            return face;
+        }
+
+        Model::BrushGeometry* MapCacheReader::readBrushGeometry(Reader& reader, const size_t faceCount) const {
+            const auto vertexCount = reader.readSize<uint32_t>();
+            if (!reader.canRead(vertexCount * 3 * sizeof(double))) {
+                throw ReaderException("Map cache brush exceeds the end of the file");
+            }
+
+            std::vector<vm::vec3> positions;
+            positions.reserve(vertexCount);
+            for (size_t i = 0; i < vertexCount; ++i) {
+                positions.push_back(readCacheVec(reader));
+            }
+
+            std::vector<std::vector<size_t>> faces(faceCount);
+            for (auto& indices : faces) {
+                const auto indexCount = reader.readSize<uint32_t>();
+                if (!reader.canRead(indexCount * sizeof(uint32_t))) {
+                    throw ReaderException("Map cache brush exceeds the end of the file");
+                }
+
+                indices.reserve(indexCount);
+                for (size_t i = 0; i < indexCount; ++i) {
+                    indices.push_back(reader.readSize<uint32_t>());
+                }
+            }
+
+            return new Model::BrushGeometry(positions, faces);
+        }
+    }
+}
@@ -0,0 +1,74 @@
+/*
+ Copyright (C) 2010-2019 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef TrenchBroom_MapCacheReader
+#define TrenchBroom_MapCacheReader
+
+#include "IO/MapCache.h"
+#include "IO/MapChunkReader.h"
+#include "IO/WorldReader.h"
+#include "Model/BrushGeometry.h"
+
+#include <memory>
+
+namespace TrenchBroom {
+    namespace Model {
+        class ModelFactory;
+    }
+
+    namespace IO {
+        class ParserStatus;
+        class Reader;
+
+        /**
+         * Reads a world from a map cache file written by MapCacheSerializer.
+         *
+         * The records of the cache are decoded into the same events that MapChunkReader creates when parsing a map
+         * file, and the events are then replayed to create the world. The brush geometry is read from the cache
+         * instead of being computed from the brush faces.
+         */
+        class MapCacheReader : public WorldReader {
+        private:
+            const char* m_begin;
+            const char* m_end;
+            MapChunkReader::EventList m_events;
+        public:
+            MapCacheReader(const char* begin, const char* end);
+            ~MapCacheReader() override;
+
+            /**
+             * Reads the world from the cache. Returns null if the cache was written for a different map file, map
+             * format or world bounds, or by a different version of the cache format.
+             *
+             * @throw ReaderException if the cache is truncated
+             * @throw ParserException if the cache contains an unknown record
+             * @throw GeometryException if the cache contains an invalid brush
+             */
+            std::unique_ptr<Model::World> readCache(const MapCacheKey& key, Model::MapFormat format, const vm::bbox3& worldBounds, ParserStatus& status);
+        private:
+            bool readHeader(Reader& reader, const MapCacheKey& key, Model::MapFormat format, const vm::bbox3& worldBounds) const;
+            void readRecords(Reader& reader, const Model::ModelFactory& factory);
+            Model::Brush* readBrush(Reader& reader, const Model::ModelFactory& factory) const;
+            Model::BrushFace* readBrushFace(Reader& reader, const Model::ModelFactory& factory) const;
+            Model::BrushGeometry* readBrushGeometry(Reader& reader, size_t faceCount) const;
+        };
+    }
+}
+
+#endif /* defined(TrenchBroom_MapCacheReader) */
@@ -0,0 +1,150 @@
+/*
+ Copyright (C) 2010-2019 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "MapCacheSerializer.h"
+
+#include "Model/Brush.h"
+#include "Model/BrushFace.h"
+#include "Model/BrushGeometry.h"
+#include "Model/Node.h"
+
+#include <map>
+
+namespace TrenchBroom {
+    namespace IO {
+        const char MapCacheSerializer::Magic[4] = { 'T', 'B', 'M', 'C' };
+        const uint32_t MapCacheSerializer::Version = 2;
+        const uint32_t MapCacheSerializer::ByteOrderMark = 0x01020304;
+
+        MapCacheSerializer::MapCacheSerializer(FILE* stream, const Model::MapFormat format, const vm::bbox3& worldBounds, const MapCacheKey& key) :
+        m_stream(stream),
+        m_format(format),
+        m_worldBounds(worldBounds),
+        m_key(key) {
+            ensure(m_stream != nullptr, "stream is null");
+        }
+
+        void MapCacheSerializer::doBeginFile() {
+            if (std::fwrite(Magic, sizeof(Magic), 1, m_stream) != 1) {
+                throw FileSystemException("Cannot write map cache");
+            }
+
+            write(ByteOrderMark);
+            write(static_cast<uint8_t>(sizeof(FloatType)));
+            write(Version);
+            write(static_cast<uint32_t>(m_format));
+            writeVec(m_worldBounds.min);
+            writeVec(m_worldBounds.max);
+            write(m_key.size);
+            write(m_key.modificationTime);
+            write(m_key.hash);
+        }
+
+        void MapCacheSerializer::doEndFile() {
+            write(static_cast<uint8_t>(Record_EndFile));
+        }
+
+        void MapCacheSerializer::doBeginEntity(const Model::Node* node) {
+            write(static_cast<uint8_t>(Record_BeginEntity));
+            write(static_cast<uint64_t>(node->lineNumber()));
+        }
+
+        void MapCacheSerializer::doEndEntity(Model::Node* node) {
+            write(static_cast<uint8_t>(Record_EndEntity));
+            write(static_cast<uint64_t>(node->lineNumber()));
+            write(static_cast<uint64_t>(node->lineCount()));
+        }
+
+        void MapCacheSerializer::doEntityAttribute(const Model::EntityAttribute& attribute) {
+            write(static_cast<uint8_t>(Record_EntityAttribute));
+            writeString(attribute.name());
+            writeString(attribute.value());
+        }
+
+        void MapCacheSerializer::doBeginBrush(const Model::Brush* brush) {
+            write(static_cast<uint8_t>(Record_Brush));
+            write(static_cast<uint64_t>(brush->lineNumber()));
+            write(static_cast<uint64_t>(brush->lineCount()));
+            write(static_cast<uint32_t>(brush->faceCount()));
+        }
+
+        void MapCacheSerializer::doEndBrush(Model::Brush* brush) {
+            writeBrushGeometry(brush);
+        }
+
+        void MapCacheSerializer::doBrushFace(Model::BrushFace* face) {
+            write(static_cast<uint64_t>(face->lineNumber()));
+
+            const auto& points = face->points();
+            writeVec(points[0]);
+            writeVec(points[1]);
+            writeVec(points[2]);
+
+            writeString(face->textureName());
+            write(face->xOffset());
+            write(face->yOffset());
+            write(face->rotation());
+            write(face->xScale());
+            write(face->yScale());
+            write(static_cast<int32_t>(face->surfaceContents()));
+            write(static_cast<int32_t>(face->surfaceFlags()));
+            write(face->surfaceValue());
+
+            const auto& color = face->color();
+            write(color.r());
+            write(color.g());
+            write(color.b());
+            write(color.a());
+
+            writeVec(face->textureXAxis());
+            writeVec(face->textureYAxis());
+        }
+
+        void MapCacheSerializer::writeBrushGeometry(const Model::Brush* brush) {
+            std::map<const Model::BrushVertex*, uint32_t> indices;
+
+            write(static_cast<uint32_t>(brush->vertexCount()));
+            for (const auto* vertex : brush->vertices()) {
+                indices.insert(std::make_pair(vertex, static_cast<uint32_t>(indices.size())));
+                writeVec(vertex->position());
+            }
+
+            // the face loops are written in the order of the brush faces so that the faces can be matched when reading
+            for (const auto* face : brush->faces()) {
+                write(static_cast<uint32_t>(face->vertexCount()));
+                for (const auto* vertex : face->vertices()) {
+                    write(indices[vertex]);
+                }
+            }
+        }
+
+        void MapCacheSerializer::writeString(const String& str) {
+            write(static_cast<uint32_t>(str.size()));
+            if (!str.empty() && std::fwrite(str.data(), str.size(), 1, m_stream) != 1) {
+                throw FileSystemException("Cannot write map cache");
+            }
+        }
+
+        void MapCacheSerializer::writeVec(const vm::vec3& vec) {
+            write(vec.x());
+            write(vec.y());
+            write(vec.z());
+        }
+    }
+}
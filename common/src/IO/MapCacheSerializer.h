@@ -0,0 +1,96 @@
+/*
+ Copyright (C) 2010-2019 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef TrenchBroom_MapCacheSerializer
+#define TrenchBroom_MapCacheSerializer
+
+#include "Exceptions.h"
+#include "IO/MapCache.h"
+#include "IO/NodeSerializer.h"
+#include "Model/MapFormat.h"
+
+#include <vecmath/forward.h>
+#include <vecmath/bbox.h>
+
+#include <cstdint>
+#include <cstdio>
+
+namespace TrenchBroom {
+    namespace IO {
+        /**
+         * Writes a map cache file.
+         *
+         * The file starts with a header that contains a magic number, a byte order mark, the size of a floating point
+         * value, the version of the file format, the map format, the world bounds and the key of the map file. It is followed by a sequence of records, each of which starts
+         * with its record type. Entities are written as a begin record, followed by one record per attribute, the
+         * brushes of the entity and an end record. A brush record contains the brush faces followed by the vertices of
+         * the brush geometry and the vertex indices of each face. The file ends with an end of file record.
+         *
+         * All values are written in the native byte order, so a cache file cannot be used on a machine with a
+         * different byte order or a build with a different floating point type. The byte order mark and the size of a
+         * floating point value identify such files.
+         */
+        class MapCacheSerializer : public NodeSerializer {
+        public:
+            static const char Magic[4];
+            static const uint32_t Version;
+            static const uint32_t ByteOrderMark;
+
+            typedef enum {
+                Record_BeginEntity = 1,
+                Record_EntityAttribute = 2,
+                Record_EndEntity = 3,
+                Record_Brush = 4,
+                Record_EndFile = 5
+            } RecordType;
+        private:
+            FILE* m_stream;
+            Model::MapFormat m_format;
+            vm::bbox3 m_worldBounds;
+            MapCacheKey m_key;
+        public:
+            MapCacheSerializer(FILE* stream, Model::MapFormat format, const vm::bbox3& worldBounds, const MapCacheKey& key);
+        private:
+            void doBeginFile() override;
+            void doEndFile() override;
+
+            void doBeginEntity(const Model::Node* node) override;
+            void doEndEntity(Model::Node* node) override;
+            void doEntityAttribute(const Model::EntityAttribute& attribute) override;
+
+            void doBeginBrush(const Model::Brush* brush) override;
+            void doEndBrush(Model::Brush* brush) override;
+            void doBrushFace(Model::BrushFace* face) override;
+        private:
+            void writeBrushGeometry(const Model::Brush* brush);
+
+            template <typename T>
+            void write(const T& value) {
+                if (std::fwrite(&value, sizeof(T), 1, m_stream) != 1) {
+                    throw FileSystemException("Cannot write map cache");
+                }
+            }
+
+            void writeString(const String& str);
+            void writeVec(const vm::vec3& vec);
+        };
+    }
+}
+
+#endif /* defined(TrenchBroom_MapCacheSerializer) */
@@ -0,0 +1,141 @@
+/*
+ Copyright (C) 2010-2019 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "MapChunkReader.h"
+
+#include "CollectionUtils.h"
+#include "Exceptions.h"
+#include "IO/ParserStatus.h"
+#include "Model/Brush.h"
+#include "Model/BrushFace.h"
+#include "Model/ModelFactory.h"
+
+namespace TrenchBroom {
+    namespace IO {
+        /**
+         * Records the messages of the parser as events so that they can be forwarded to the actual parser status
+         * in the correct order.
+         */
+        class MapChunkReader::ChunkStatus : public ParserStatus {
+        private:
+            static NullLogger _logger;
+            EventList& m_events;
+        public:
+            explicit ChunkStatus(EventList& events) :
+            ParserStatus(_logger, ""),
+            m_events(events) {}
+        private:
+            void doProgress(const double progress) override {}
+
+            void doLog(const Logger::LogLevel level, const String& str) override {
+                Event event(Event::Type_Message);
+                event.level = level;
+                event.message = str;
+                m_events.push_back(std::move(event));
+            }
+        };
+
+        NullLogger MapChunkReader::ChunkStatus::_logger;
+
+        MapChunkReader::Event::Event(const Type i_type) :
+        type(i_type),
+        line(0),
+        lineCount(0),
+        brush(nullptr),
+        level(Logger::LogLevel_Debug) {}
+
+        MapChunkReader::MapChunkReader(const char* begin, const char* end, const size_t firstLine, const Model::ModelFactory& factory, const vm::bbox3& worldBounds) :
+        StandardMapParser(begin, end, firstLine),
+        m_factory(factory),
+        m_worldBounds(worldBounds) {}
+
+        MapChunkReader::~MapChunkReader() {
+            VectorUtils::clearAndDelete(m_faces);
+            deleteBrushes(m_events);
+        }
+
+        MapChunkReader::EventList MapChunkReader::readEntities(const Model::MapFormat format) {
+            ChunkStatus status(m_events);
+            parseEntities(format, status);
+            return std::move(m_events);
+        }
+
+        MapChunkReader::EventList MapChunkReader::readBrushes(const Model::MapFormat format) {
+            ChunkStatus status(m_events);
+            parseBrushes(format, status);
+            return std::move(m_events);
+        }
+
+        void MapChunkReader::deleteBrushes(EventList& events) {
+            for (auto& event : events) {
+                if (event.type == Event::Type_Brush) {
+                    delete event.brush;
+                    event.brush = nullptr;
+                }
+            }
+        }
+
+        void MapChunkReader::onFormatSet(const Model::MapFormat format) {}
+
+        void MapChunkReader::onBeginEntity(const size_t line, const Model::EntityAttribute::List& attributes, const ExtraAttributes& extraAttributes, ParserStatus& status) {
+            Event event(Event::Type_BeginEntity);
+            event.line = line;
+            event.attributes = attributes;
+            event.extraAttributes = extraAttributes;
+            m_events.push_back(std::move(event));
+        }
+
+        void MapChunkReader::onEndEntity(const size_t startLine, const size_t lineCount, ParserStatus& status) {
+            Event event(Event::Type_EndEntity);
+            event.line = startLine;
+            event.lineCount = lineCount;
+            m_events.push_back(std::move(event));
+        }
+
+        void MapChunkReader::onBeginBrush(const size_t line, ParserStatus& status) {
+            assert(m_faces.empty());
+        }
+
+        void MapChunkReader::onEndBrush(const size_t startLine, const size_t lineCount, const ExtraAttributes& extraAttributes, ParserStatus& status) {
+            try {
+                Model::Brush* brush = m_factory.createBrush(m_worldBounds, m_faces);
+                brush->setFilePosition(startLine, lineCount);
+                m_faces.clear();
+
+                Event event(Event::Type_Brush);
+                event.line = startLine;
+                event.lineCount = lineCount;
+                event.extraAttributes = extraAttributes;
+                event.brush = brush;
+                m_events.push_back(std::move(event));
+            } catch (GeometryException& e) {
+                StringStream msg;
+                msg << "Skipping brush: " << e.what();
+                status.error(startLine, msg.str());
+                m_faces.clear(); // the faces will have been deleted by the brush's constructor
+            }
+        }
+
+        void MapChunkReader::onBrushFace(const size_t line, const vm::vec3& point1, const vm::vec3& point2, const vm::vec3& point3, const Model::BrushFaceAttributes& attribs, const vm::vec3& texAxisX, const vm::vec3& texAxisY, ParserStatus& status) {
+            Model::BrushFace* face = m_factory.createFace(point1, point2, point3, attribs, texAxisX, texAxisY);
+            face->setFilePosition(line, 1);
+            m_faces.push_back(face);
+        }
+    }
+}
@@ -0,0 +1,106 @@
+/*
+ Copyright (C) 2010-2019 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef TrenchBroom_MapChunkReader
+#define TrenchBroom_MapChunkReader
+
+#include "Logger.h"
+#include "TrenchBroom.h"
+#include "IO/StandardMapParser.h"
+#include "Model/ModelTypes.h"
+
+#include <vecmath/forward.h>
+#include <vecmath/bbox.h>
+
+#include <vector>
+
+namespace TrenchBroom {
+    namespace Model {
+        class ModelFactory;
+    }
+
+    namespace IO {
+        /**
+         * Parses a chunk of a map file on a worker thread.
+         *
+         * The reader creates the brushes of the chunk, including their geometry, but it does not create any other
+         * nodes. Instead, it records the entities, the brushes and the parser messages as a list of events in the
+         * order in which they appear in the file. The events are replayed by a MapReader on the main thread, which
+         * creates the remaining nodes and inserts the brushes into them.
+         */
+        class MapChunkReader : public StandardMapParser {
+        public:
+            struct Event {
+                typedef enum {
+                    Type_BeginEntity,
+                    Type_EndEntity,
+                    Type_Brush,
+                    Type_Message
+                } Type;
+
+                Type type;
+                size_t line;
+                size_t lineCount;
+                Model::EntityAttribute::List attributes;
+                ExtraAttributes extraAttributes;
+                Model::Brush* brush;
+                Logger::LogLevel level;
+                String message;
+
+                explicit Event(Type i_type);
+            };
+
+            using EventList = std::vector<Event>;
+        private:
+            class ChunkStatus;
+
+            const Model::ModelFactory& m_factory;
+            vm::bbox3 m_worldBounds;
+            Model::BrushFaceList m_faces;
+            EventList m_events;
+        public:
+            MapChunkReader(const char* begin, const char* end, size_t firstLine, const Model::ModelFactory& factory, const vm::bbox3& worldBounds);
+            ~MapChunkReader() override;
+
+            /**
+             * Parses a sequence of entities. Throws a ParserException if the chunk cannot be parsed.
+             */
+            EventList readEntities(Model::MapFormat format);
+
+            /**
+             * Parses a sequence of brushes. Throws a ParserException if the chunk cannot be parsed.
+             */
+            EventList readBrushes(Model::MapFormat format);
+
+            /**
+             * Deletes the brushes of the given events which have not been added to a parent.
+             */
+            static void deleteBrushes(EventList& events);
+        private: // implement MapParser interface
+            void onFormatSet(Model::MapFormat format) override;
+            void onBeginEntity(size_t line, const Model::EntityAttribute::List& attributes, const ExtraAttributes& extraAttributes, ParserStatus& status) override;
+            void onEndEntity(size_t startLine, size_t lineCount, ParserStatus& status) override;
+            void onBeginBrush(size_t line, ParserStatus& status) override;
+            void onEndBrush(size_t startLine, size_t lineCount, const ExtraAttributes& extraAttributes, ParserStatus& status) override;
+            void onBrushFace(size_t line, const vm::vec3& point1, const vm::vec3& point2, const vm::vec3& point3, const Model::BrushFaceAttributes& attribs, const vm::vec3& texAxisX, const vm::vec3& texAxisY, ParserStatus& status) override;
+        };
+    }
+}
+
+#endif /* defined(TrenchBroom_MapChunkReader) */
@@ -0,0 +1,271 @@
+/*
+ Copyright (C) 2010-2019 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "MapChunkScanner.h"
+
+#include "Macros.h"
+
+namespace TrenchBroom {
+    namespace IO {
+        MapChunkScanner::Chunk::Chunk(const Type i_type, const char* i_begin, const char* i_end, const size_t i_line) :
+        type(i_type),
+        begin(i_begin),
+        end(i_end),
+        line(i_line),
+        closesEntity(false),
+        entityLine(0),
+        entityLineCount(0) {}
+
+        struct MapChunkScanner::BrushInfo {
+            const char* lineStart;
+            size_t line;
+        };
+
+        struct MapChunkScanner::EntityInfo {
+            // the start of the line containing the opening brace, or null if there is other text before the brace
+            const char* lineStart;
+            size_t line;
+            const char* close;
+            size_t closeLine;
+            bool splittable;
+            std::vector<BrushInfo> brushes;
+
+            EntityInfo(const char* i_lineStart, const size_t i_line) :
+            lineStart(i_lineStart),
+            line(i_line),
+            close(nullptr),
+            closeLine(0),
+            splittable(i_lineStart != nullptr) {}
+        };
+
+        static bool isWhitespace(const char c) {
+            return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+        }
+
+        MapChunkScanner::MapChunkScanner(const char* begin, const char* end) :
+        m_begin(begin),
+        m_end(end) {}
+
+        bool MapChunkScanner::scan(const size_t chunkSize, ChunkList& chunks) const {
+            EntityList entities;
+            if (!scanEntities(entities) || entities.empty()) {
+                return false;
+            }
+
+            buildChunks(entities, chunkSize, chunks);
+            return true;
+        }
+
+        bool MapChunkScanner::scanEntities(EntityList& entities) const {
+            const auto* cur = m_begin;
+            const auto* lineStart = m_begin;
+            size_t line = 1;
+            size_t depth = 0;
+
+            // whether there is only whitespace between the start of the current line and the current position
+            auto blank = true;
+            auto entity = EntityInfo(nullptr, 0);
+
+            while (cur < m_end) {
+                const auto c = *cur;
+                switch (c) {
+                    case '\r':
+                        if (cur + 1 < m_end && *(cur + 1) == '\n') {
+                            ++cur;
+                        }
+                        switchFallthrough();
+                    case '\n':
+                        ++cur;
+                        ++line;
+                        lineStart = cur;
+                        blank = true;
+                        break;
+                    case ' ':
+                    case '\t':
+                        ++cur;
+                        break;
+                    case '/':
+                        if (cur + 1 < m_end && *(cur + 1) == '/') {
+                            // comments starting with "/// " contain extra attributes, they are only allowed where
+                            // the parser expects them
+                            if (cur + 3 < m_end && *(cur + 2) == '/' && *(cur + 3) == ' ') {
+                                if (depth == 0) {
+                                    return false;
+                                } else if (depth == 1 && !entity.brushes.empty()) {
+                                    entity.splittable = false;
+                                }
+                            }
+                            while (cur < m_end && *cur != '\n' && *cur != '\r') {
+                                ++cur;
+                            }
+                        } else {
+                            // the tokenizer skips a single slash
+                            ++cur;
+                        }
+                        blank = false;
+                        break;
+                    case '"': {
+                        if (depth == 0) {
+                            return false;
+                        } else if (depth == 1 && !entity.brushes.empty()) {
+                            entity.splittable = false;
+                        }
+
+                        // mirror the tokenizer's handling of escaped quotation marks, including its treatment of
+                        // trailing backslashes in paths
+                        ++cur;
+                        auto escaped = false;
+                        while (true) {
+                            if (cur >= m_end) {
+                                return false;
+                            }
+
+                            const auto q = *cur;
+                            if (q == '"') {
+                                if (!escaped || (cur + 1 < m_end && (*(cur + 1) == '\n' || *(cur + 1) == '}'))) {
+                                    break;
+                                }
+                                escaped = false;
+                            } else if (q == '\n' || (q == '\r' && !(cur + 1 < m_end && *(cur + 1) == '\n'))) {
+                                ++line;
+                                lineStart = cur + 1;
+                                escaped = false;
+                            } else if (q == '\\') {
+                                escaped = !escaped;
+                            } else {
+                                escaped = false;
+                            }
+                            ++cur;
+                        }
+                        ++cur;
+                        blank = false;
+                        break;
+                    }
+                    default: {
+                        // braces are only recognized if they form a token on their own, otherwise they are part of
+                        // a texture name such as {fence
+                        const auto standalone = (c == '{' || c == '}') && (cur + 1 == m_end || isWhitespace(*(cur + 1)));
+                        if (standalone && c == '{') {
+                            if (depth == 0) {
+                                entity = EntityInfo(blank ? lineStart : nullptr, line);
+                            } else if (depth == 1) {
+                                if (!blank) {
+                                    entity.splittable = false;
+                                }
+                                entity.brushes.push_back(BrushInfo{ lineStart, line });
+                            }
+                            ++depth;
+                            ++cur;
+                        } else if (standalone && c == '}') {
+                            if (depth == 0) {
+                                return false;
+                            }
+
+                            --depth;
+                            if (depth == 0) {
+                                entity.close = cur;
+                                entity.closeLine = line;
+                                entities.push_back(std::move(entity));
+                                entity = EntityInfo(nullptr, 0);
+                            }
+                            ++cur;
+                        } else {
+                            if (depth == 0) {
+                                return false;
+                            } else if (depth == 1 && !entity.brushes.empty()) {
+                                entity.splittable = false;
+                            }
+
+                            while (cur < m_end && !isWhitespace(*cur)) {
+                                ++cur;
+                            }
+                        }
+                        blank = false;
+                        break;
+                    }
+                }
+            }
+
+            return depth == 0;
+        }
+
+        void MapChunkScanner::buildChunks(const EntityList& entities, const size_t chunkSize, ChunkList& chunks) const {
+            const auto* chunkBegin = m_begin;
+            size_t chunkLine = 1;
+            auto pending = false;
+
+            for (size_t i = 0; i < entities.size(); ++i) {
+                const auto& entity = entities[i];
+                const auto* nextBegin = i + 1 < entities.size() ? entities[i + 1].lineStart : m_end;
+                const auto nextLine = i + 1 < entities.size() ? entities[i + 1].line : 0;
+
+                if (pending && entity.lineStart != nullptr && static_cast<size_t>(entity.lineStart - chunkBegin) >= chunkSize) {
+                    chunks.push_back(Chunk(Chunk::Type_Entities, chunkBegin, entity.lineStart, chunkLine));
+                    chunkBegin = entity.lineStart;
+                    chunkLine = entity.line;
+                    pending = false;
+                }
+
+                const auto split =
+                    entity.splittable &&
+                    entity.brushes.size() > 1 &&
+                    static_cast<size_t>(entity.close - entity.lineStart) > chunkSize &&
+                    nextBegin != nullptr;
+
+                if (!split) {
+                    pending = true;
+                    continue;
+                }
+
+                if (pending) {
+                    chunks.push_back(Chunk(Chunk::Type_Entities, chunkBegin, entity.lineStart, chunkLine));
+                    pending = false;
+                }
+
+                const auto& brushes = entity.brushes;
+                chunks.push_back(Chunk(Chunk::Type_EntityHeader, entity.lineStart, brushes.front().lineStart, entity.line));
+
+                auto runBegin = brushes.front().lineStart;
+                auto runLine = brushes.front().line;
+                for (size_t j = 1; j < brushes.size(); ++j) {
+                    if (static_cast<size_t>(brushes[j].lineStart - runBegin) >= chunkSize) {
+                        chunks.push_back(Chunk(Chunk::Type_Brushes, runBegin, brushes[j].lineStart, runLine));
+                        runBegin = brushes[j].lineStart;
+                        runLine = brushes[j].line;
+                    }
+                }
+
+                // the last brush chunk ends right before the entity's closing brace
+                auto last = Chunk(Chunk::Type_Brushes, runBegin, entity.close, runLine);
+                last.closesEntity = true;
+                last.entityLine = entity.line;
+                last.entityLineCount = entity.closeLine - entity.line;
+                chunks.push_back(last);
+
+                // whatever follows the closing brace up to the next entity is whitespace or comments
+                chunkBegin = nextBegin;
+                chunkLine = nextLine;
+            }
+
+            if (pending) {
+                chunks.push_back(Chunk(Chunk::Type_Entities, chunkBegin, m_end, chunkLine));
+            }
+        }
+    }
+}
@@ -0,0 +1,89 @@
+/*
+ Copyright (C) 2010-2019 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef TrenchBroom_MapChunkScanner
+#define TrenchBroom_MapChunkScanner
+
+#include <cstddef>
+#include <vector>
+
+namespace TrenchBroom {
+    namespace IO {
+        /**
+         * Splits the text of a map file into chunks that can be parsed independently of each other.
+         *
+         * The scanner only tracks the nesting of braces, quoted strings and comments, so it is much cheaper than
+         * tokenizing the file. Every chunk begins at the start of a line so that a parser can be started on it with
+         * the correct line number. A chunk contains either a sequence of complete entities, the header of an entity
+         * (everything up to its first brush) or a sequence of brushes of an entity. Large entities such as worldspawn
+         * are split into a header and brush chunks, but only if nothing else than brushes and comments follow the
+         * first brush.
+         *
+         * The scanner does not validate the file. If it finds anything it does not understand, it gives up, and the
+         * caller must parse the file sequentially.
+         */
+        class MapChunkScanner {
+        public:
+            struct Chunk {
+                typedef enum {
+                    Type_Entities,
+                    Type_EntityHeader,
+                    Type_Brushes
+                } Type;
+
+                Type type;
+                const char* begin;
+                const char* end;
+                size_t line;
+
+                // set for the last brush chunk of a split entity, the position of the entity that it closes
+                bool closesEntity;
+                size_t entityLine;
+                size_t entityLineCount;
+
+                Chunk(Type i_type, const char* i_begin, const char* i_end, size_t i_line);
+            };
+
+            using ChunkList = std::vector<Chunk>;
+        private:
+            struct BrushInfo;
+            struct EntityInfo;
+            using EntityList = std::vector<EntityInfo>;
+
+            const char* m_begin;
+            const char* m_end;
+        public:
+            MapChunkScanner(const char* begin, const char* end);
+
+            /**
+             * Splits the text into chunks of roughly the given size.
+             *
+             * @param chunkSize the number of bytes after which a new chunk should be started
+             * @param chunks the chunks are appended to this list
+             * @return true if the text could be split, and false otherwise
+             */
+            bool scan(size_t chunkSize, ChunkList& chunks) const;
+        private:
+            bool scanEntities(EntityList& entities) const;
+            void buildChunks(const EntityList& entities, size_t chunkSize, ChunkList& chunks) const;
+        };
+    }
+}
+
+#endif /* defined(TrenchBroom_MapChunkScanner) */
@@ -21,6 +21,8 @@
 
 #include "Exceptions.h"
 #include "Macros.h"
+#include "ParallelUtils.h"
+#include "StringUtils.h"
 #include "IO/DiskFileSystem.h"
 #include "IO/Path.h"
 #include "Model/BrushFace.h"
@@ -28,121 +30,107 @@
 namespace TrenchBroom {
     namespace IO {
         class QuakeFileSerializer : public MapFileSerializer {
-        private:
-            String FacePointFormat;
-            String TextureInfoFormat;
         public:
             QuakeFileSerializer(FILE* stream) :
-            MapFileSerializer(stream) {
-                StringStream str;
-                str <<
-                "( %." << FloatPrecision << "g " <<
-                "%." << FloatPrecision << "g " <<
-                "%." << FloatPrecision << "g ) " <<
-                "( %." << FloatPrecision << "g " <<
-                "%." << FloatPrecision << "g " <<
-                "%." << FloatPrecision << "g ) " <<
-                "( %." << FloatPrecision << "g " <<
-                "%." << FloatPrecision << "g " <<
-                "%." << FloatPrecision << "g )";
-
-                FacePointFormat = str.str();
-                TextureInfoFormat = " %s %.6g %.6g %.6g %.6g %.6g";
-            }
+            MapFileSerializer(stream) {}
         private:
-            size_t doWriteBrushFace(FILE* stream, Model::BrushFace* face) override {
-                writeFacePoints(stream, face);
-                writeTextureInfo(stream, face);
-                std::fprintf(stream, "\n");
-                return 1;
+            void doWriteBrushFace(String& buffer, const MapSnapshot::Face& face) const override {
+                writeFacePoints(buffer, face);
+                writeTextureInfo(buffer, face);
+                buffer += '\n';
             }
         protected:
-            void writeFacePoints(FILE* stream, Model::BrushFace* face) {
-                const Model::BrushFace::Points& points = face->points();
-
-                std::fprintf(stream, FacePointFormat.c_str(),
-                             points[0].x(),
-                             points[0].y(),
-                             points[0].z(),
-                             points[1].x(),
-                             points[1].y(),
-                             points[1].z(),
-                             points[2].x(),
-                             points[2].y(),
-                             points[2].z());
+            void writeFacePoints(String& buffer, const MapSnapshot::Face& face) const {
+                const auto& points = face.points;
+
+                buffer += "( ";
+                writeFacePoint(buffer, points[0]);
+                buffer += " ) ( ";
+                writeFacePoint(buffer, points[1]);
+                buffer += " ) ( ";
+                writeFacePoint(buffer, points[2]);
+                buffer += " )";
             }
 
-            void writeTextureInfo(FILE* stream, Model::BrushFace* face) {
-                const String& textureName = face->textureName().empty() ? Model::BrushFace::NoTextureName : face->textureName();
-                std::fprintf(stream, TextureInfoFormat.c_str(),
-                             textureName.c_str(),
-                             face->xOffset(),
-                             face->yOffset(),
-                             face->rotation(),
-                             face->xScale(),
-                             face->yScale());
+            void writeTextureInfo(String& buffer, const MapSnapshot::Face& face) const {
+                const String& textureName = face.textureName.empty() ? Model::BrushFace::NoTextureName : face.textureName;
+                buffer += ' ';
+                buffer += textureName;
+                writeValue(buffer, face.xOffset);
+                writeValue(buffer, face.yOffset);
+                writeValue(buffer, face.rotation);
+                writeValue(buffer, face.xScale);
+                writeValue(buffer, face.yScale);
+            }
+
+            /**
+             * Appends a space and the given value with six significant digits.
+             */
+            static void writeValue(String& buffer, const double value) {
+                buffer += ' ';
+                StringUtils::appendFloat(buffer, value, 6);
+            }
+
+            static void writeValue(String& buffer, const int value) {
+                buffer += ' ';
+                StringUtils::appendInt(buffer, value);
+            }
+        private:
+            static void writeFacePoint(String& buffer, const vm::vec3& point) {
+                StringUtils::appendFloat(buffer, point.x(), FloatPrecision);
+                buffer += ' ';
+                StringUtils::appendFloat(buffer, point.y(), FloatPrecision);
+                buffer += ' ';
+                StringUtils::appendFloat(buffer, point.z(), FloatPrecision);
             }
         };
 
         class Quake2FileSerializer : public QuakeFileSerializer {
-        private:
-            String SurfaceAttributesFormat;
         public:
             Quake2FileSerializer(FILE* stream) :
-            QuakeFileSerializer(stream) {
-                SurfaceAttributesFormat = " %d %d %.6g";
-            }
+            QuakeFileSerializer(stream) {}
         private:
-            size_t doWriteBrushFace(FILE* stream, Model::BrushFace* face) override {
-                writeFacePoints(stream, face);
-                writeTextureInfo(stream, face);
+            void doWriteBrushFace(String& buffer, const MapSnapshot::Face& face) const override {
+                writeFacePoints(buffer, face);
+                writeTextureInfo(buffer, face);
 
-                if (face->hasSurfaceAttributes()) {
-                    writeSurfaceAttributes(stream, face);
+                if (face.hasSurfaceAttributes) {
+                    writeSurfaceAttributes(buffer, face);
                 }
 
-                std::fprintf(stream, "\n");
-                return 1;
+                buffer += '\n';
             }
         protected:
-            void writeSurfaceAttributes(FILE* stream, Model::BrushFace* face) {
-                std::fprintf(stream, SurfaceAttributesFormat.c_str(),
-                             face->surfaceContents(),
-                             face->surfaceFlags(),
-                             face->surfaceValue());
+            void writeSurfaceAttributes(String& buffer, const MapSnapshot::Face& face) const {
+                writeValue(buffer, face.surfaceContents);
+                writeValue(buffer, face.surfaceFlags);
+                writeValue(buffer, face.surfaceValue);
             }
         };
 
-
         class DaikatanaFileSerializer : public Quake2FileSerializer {
-        private:
-            String SurfaceColorFormat;
         public:
             DaikatanaFileSerializer(FILE* stream) :
-            Quake2FileSerializer(stream) {
-                SurfaceColorFormat = " %d %d %d";
-            }
+            Quake2FileSerializer(stream) {}
         private:
-            size_t doWriteBrushFace(FILE* stream, Model::BrushFace* face) override {
-                writeFacePoints(stream, face);
-                writeTextureInfo(stream, face);
+            void doWriteBrushFace(String& buffer, const MapSnapshot::Face& face) const override {
+                writeFacePoints(buffer, face);
+                writeTextureInfo(buffer, face);
 
-                if (face->hasSurfaceAttributes() || face->hasColor()) {
-                    writeSurfaceAttributes(stream, face);
+                if (face.hasSurfaceAttributes || face.hasColor) {
+                    writeSurfaceAttributes(buffer, face);
                 }
-                if (face->hasColor()) {
-                    writeSurfaceColor(stream, face);
+                if (face.hasColor) {
+                    writeSurfaceColor(buffer, face);
                 }
 
-                std::fprintf(stream, "\n");
-                return 1;
+                buffer += '\n';
             }
         protected:
-            void writeSurfaceColor(FILE* stream, Model::BrushFace* face) {
-                std::fprintf(stream, SurfaceColorFormat.c_str(),
-                             static_cast<int>(face->color().r()),
-                             static_cast<int>(face->color().g()),
-                             static_cast<int>(face->color().b()));
+            void writeSurfaceColor(String& buffer, const MapSnapshot::Face& face) const {
+                writeValue(buffer, static_cast<int>(face.color.r()));
+                writeValue(buffer, static_cast<int>(face.color.g()));
+                writeValue(buffer, static_cast<int>(face.color.b()));
             }
         };
 
@@ -151,68 +139,75 @@ namespace TrenchBroom {
             Hexen2FileSerializer(FILE* stream):
             QuakeFileSerializer(stream) {}
         private:
-            size_t doWriteBrushFace(FILE* stream, Model::BrushFace* face) override {
-                writeFacePoints(stream, face);
-                writeTextureInfo(stream, face);
-                std::fprintf(stream, " 0\n"); // extra value written here
-                return 1;
+            void doWriteBrushFace(String& buffer, const MapSnapshot::Face& face) const override {
+                writeFacePoints(buffer, face);
+                writeTextureInfo(buffer, face);
+                buffer += " 0\n"; // extra value written here
             }
         };
 
         class ValveFileSerializer : public QuakeFileSerializer {
-        private:
-            String ValveTextureInfoFormat;
         public:
             ValveFileSerializer(FILE* stream) :
-            QuakeFileSerializer(stream),
-            ValveTextureInfoFormat(" %s [ %.6g %.6g %.6g %.6g ] [ %.6g %.6g %.6g %.6g ] %.6g %.6g %.6g") {}
+            QuakeFileSerializer(stream) {}
         private:
-            size_t doWriteBrushFace(FILE* stream, Model::BrushFace* face) override {
-                writeFacePoints(stream, face);
-                writeValveTextureInfo(stream, face);
-                std::fprintf(stream, "\n");
-                return 1;
+            void doWriteBrushFace(String& buffer, const MapSnapshot::Face& face) const override {
+                writeFacePoints(buffer, face);
+                writeValveTextureInfo(buffer, face);
+                buffer += '\n';
             }
         private:
-            void writeValveTextureInfo(FILE* stream, Model::BrushFace* face) {
-                const String& textureName = face->textureName().empty() ? Model::BrushFace::NoTextureName : face->textureName();
-                const vm::vec3 xAxis = face->textureXAxis();
-                const vm::vec3 yAxis = face->textureYAxis();
-
-                std::fprintf(stream, ValveTextureInfoFormat.c_str(),
-                             textureName.c_str(),
-
-                             xAxis.x(),
-                             xAxis.y(),
-                             xAxis.z(),
-                             face->xOffset(),
-
-                             yAxis.x(),
-                             yAxis.y(),
-                             yAxis.z(),
-                             face->yOffset(),
-
-                             face->rotation(),
-                             face->xScale(),
-                             face->yScale());
+            void writeValveTextureInfo(String& buffer, const MapSnapshot::Face& face) const {
+                const String& textureName = face.textureName.empty() ? Model::BrushFace::NoTextureName : face.textureName;
+                const vm::vec3 xAxis = face.textureXAxis;
+                const vm::vec3 yAxis = face.textureYAxis;
+
+                buffer += ' ';
+                buffer += textureName;
+
+                buffer += " [";
+                writeValue(buffer, xAxis.x());
+                writeValue(buffer, xAxis.y());
+                writeValue(buffer, xAxis.z());
+                writeValue(buffer, face.xOffset);
+
+                buffer += " ] [";
+                writeValue(buffer, yAxis.x());
+                writeValue(buffer, yAxis.y());
+                writeValue(buffer, yAxis.z());
+                writeValue(buffer, face.yOffset);
+
+                buffer += " ]";
+                writeValue(buffer, face.rotation);
+                writeValue(buffer, face.xScale);
+                writeValue(buffer, face.yScale);
             }
         };
 
         NodeSerializer::Ptr MapFileSerializer::create(const Model::MapFormat format, FILE* stream) {
+            return createSerializer(format, stream);
+        }
+
+        void MapFileSerializer::writeSnapshot(const MapSnapshot& snapshot, FILE* stream) {
+            auto serializer = createSerializer(snapshot.format(), stream);
+            serializer->doWriteSnapshot(snapshot);
+        }
+
+        std::unique_ptr<MapFileSerializer> MapFileSerializer::createSerializer(const Model::MapFormat format, FILE* stream) {
             switch (format) {
                 case Model::MapFormat::Standard:
-                    return NodeSerializer::Ptr(new QuakeFileSerializer(stream));
+                    return std::unique_ptr<MapFileSerializer>(new QuakeFileSerializer(stream));
                 case Model::MapFormat::Quake2:
                     // TODO 2427: Implement Quake3 serializers and use them
                 case Model::MapFormat::Quake3:
                 case Model::MapFormat::Quake3_Legacy:
-                    return NodeSerializer::Ptr(new Quake2FileSerializer(stream));
+                    return std::unique_ptr<MapFileSerializer>(new Quake2FileSerializer(stream));
                 case Model::MapFormat::Daikatana:
-                    return NodeSerializer::Ptr(new DaikatanaFileSerializer(stream));
+                    return std::unique_ptr<MapFileSerializer>(new DaikatanaFileSerializer(stream));
                 case Model::MapFormat::Valve:
-                    return NodeSerializer::Ptr(new ValveFileSerializer(stream));
+                    return std::unique_ptr<MapFileSerializer>(new ValveFileSerializer(stream));
                 case Model::MapFormat::Hexen2:
-                    return NodeSerializer::Ptr(new Hexen2FileSerializer(stream));
+                    return std::unique_ptr<MapFileSerializer>(new Hexen2FileSerializer(stream));
                 case Model::MapFormat::Unknown:
                     throw FileFormatException("Unknown map file format");
                 switchDefault()
@@ -223,50 +218,140 @@ namespace TrenchBroom {
         m_line(1),
         m_stream(stream) {
             ensure(m_stream != nullptr, "stream is null");
+            m_buffer.reserve(BufferSize);
+        }
+
+        MapFileSerializer::~MapFileSerializer() {
+            // write what is left if the file was not ended, errors cannot be reported anymore
+            std::fwrite(m_buffer.data(), 1, m_buffer.size(), m_stream);
         }
 
         void MapFileSerializer::doBeginFile() {}
-        void MapFileSerializer::doEndFile() {}
+
+        void MapFileSerializer::doEndFile() {
+            flush();
+        }
 
         void MapFileSerializer::doBeginEntity(const Model::Node* node) {
-            std::fprintf(m_stream, "// entity %u\n", entityNo());
-            ++m_line;
-            m_startLineStack.push_back(m_line);
-            std::fprintf(m_stream, "{\n");
-            ++m_line;
+            writeEntityStart(entityNo());
+            // the entity starts at its opening brace
+            m_startLineStack.push_back(m_line - 1);
         }
 
         void MapFileSerializer::doEndEntity(Model::Node* node) {
-            std::fprintf(m_stream, "}\n");
-            ++m_line;
+            writeBlockEnd();
             setFilePosition(node);
+            flushIfNecessary();
         }
 
         void MapFileSerializer::doEntityAttribute(const Model::EntityAttribute& attribute) {
-            std::fprintf(m_stream, "\"%s\" \"%s\"\n",
-                         escapeEntityAttribute( attribute.name()).c_str(),
-                         escapeEntityAttribute(attribute.value()).c_str());
-            ++m_line;
+            writeAttribute(attribute.name(), attribute.value());
+        }
+
+        void MapFileSerializer::doBrushes(const Model::BrushList& brushes) {
+            if (brushes.size() < MinParallelBrushCount) {
+                NodeSerializer::doBrushes(brushes);
+                return;
+            }
+
+            const auto faces = ParallelUtils::parallelTransform(brushes, [this](const Model::Brush* brush) {
+                String result;
+                for (const auto* face : brush->faces()) {
+                    doWriteBrushFace(result, MapSnapshot::Face(face));
+                }
+                return result;
+            });
+
+            for (size_t i = 0; i < brushes.size(); ++i) {
+                auto* brush = brushes[i];
+                beginBrush(brush);
+                for (auto* face : brush->faces()) {
+                    face->setFilePosition(m_line, 1);
+                    ++m_line;
+                }
+                m_buffer += faces[i];
+                endBrush(brush);
+            }
         }
 
         void MapFileSerializer::doBeginBrush(const Model::Brush* brush) {
-            std::fprintf(m_stream, "// brush %u\n", brushNo());
-            ++m_line;
-            m_startLineStack.push_back(m_line);
-            std::fprintf(m_stream, "{\n");
-            ++m_line;
+            writeBrushStart(brushNo());
+            m_startLineStack.push_back(m_line - 1);
         }
 
         void MapFileSerializer::doEndBrush(Model::Brush* brush) {
-            std::fprintf(m_stream, "}\n");
-            ++m_line;
+            writeBlockEnd();
             setFilePosition(brush);
+            flushIfNecessary();
         }
 
         void MapFileSerializer::doBrushFace(Model::BrushFace* face) {
-            const size_t lines = doWriteBrushFace(m_stream, face);
-            face->setFilePosition(m_line, lines);
-            m_line += lines;
+            doWriteBrushFace(m_buffer, MapSnapshot::Face(face));
+            face->setFilePosition(m_line, 1);
+            ++m_line;
+        }
+
+        void MapFileSerializer::doWriteSnapshot(const MapSnapshot& snapshot) {
+            const auto& entities = snapshot.entities();
+            const auto& facesEnd = snapshot.facesEnd();
+            const auto& faces = snapshot.faces();
+
+            size_t brushIndex = 0;
+            size_t faceIndex = 0;
+            for (size_t entityIndex = 0; entityIndex < entities.size(); ++entityIndex) {
+                const auto& entity = entities[entityIndex];
+                writeEntityStart(static_cast<ObjectNo>(entityIndex));
+                for (const auto& attribute : entity.attributes) {
+                    writeAttribute(attribute.first, attribute.second);
+                }
+
+                for (ObjectNo brushNo = 0; brushIndex < entity.brushesEnd; ++brushIndex, ++brushNo) {
+                    writeBrushStart(brushNo);
+                    for (; faceIndex < facesEnd[brushIndex]; ++faceIndex) {
+                        doWriteBrushFace(m_buffer, faces[faceIndex]);
+                        ++m_line;
+                    }
+                    writeBlockEnd();
+                    flushIfNecessary();
+                }
+
+                writeBlockEnd();
+                flushIfNecessary();
+            }
+
+            flush();
+        }
+
+        void MapFileSerializer::writeEntityStart(const ObjectNo no) {
+            m_buffer += "// entity ";
+            StringUtils::appendInt(m_buffer, no);
+            m_buffer += '\n';
+            ++m_line;
+            m_buffer += "{\n";
+            ++m_line;
+        }
+
+        void MapFileSerializer::writeBrushStart(const ObjectNo no) {
+            m_buffer += "// brush ";
+            StringUtils::appendInt(m_buffer, no);
+            m_buffer += '\n';
+            ++m_line;
+            m_buffer += "{\n";
+            ++m_line;
+        }
+
+        void MapFileSerializer::writeBlockEnd() {
+            m_buffer += "}\n";
+            ++m_line;
+        }
+
+        void MapFileSerializer::writeAttribute(const String& name, const String& value) {
+            m_buffer += '"';
+            m_buffer += escapeEntityAttribute(name);
+            m_buffer += "\" \"";
+            m_buffer += escapeEntityAttribute(value);
+            m_buffer += "\"\n";
+            ++m_line;
         }
 
         void MapFileSerializer::setFilePosition(Model::Node* node) {
@@ -280,5 +365,21 @@ namespace TrenchBroom {
             m_startLineStack.pop_back();
             return result;
         }
+
+        void MapFileSerializer::flushIfNecessary() {
+            if (m_buffer.size() >= BufferSize) {
+                flush();
+            }
+        }
+
+        void MapFileSerializer::flush() {
+            const auto count = std::fwrite(m_buffer.data(), 1, m_buffer.size(), m_stream);
+            const auto success = count == m_buffer.size();
+            m_buffer.clear();
+
+            if (!success) {
+                throw FileSystemException("Cannot write map file");
+            }
+        }
     }
 }
@@ -20,27 +20,49 @@
 #ifndef TrenchBroom_MapFileSerializer
 #define TrenchBroom_MapFileSerializer
 
+#include "IO/MapSnapshot.h"
 #include "IO/NodeSerializer.h"
 #include "Model/MapFormat.h"
 #include "Model/Brush.h"
 #include "Model/Node.h"
 
 #include <cstdio>
+#include <memory>
 
 namespace TrenchBroom {
     namespace IO {
         class Path;
 
+        /**
+         * Writes map files. The output is formatted into a memory buffer that is written to the file in large chunks.
+         * The faces of entities with many brushes are formatted in parallel.
+         */
         class MapFileSerializer : public NodeSerializer {
         private:
+            static const size_t BufferSize = 1 << 20;
+            static const size_t MinParallelBrushCount = 256;
+
             using LineStack = std::vector<size_t>;
             LineStack m_startLineStack;
             size_t m_line;
             FILE* m_stream;
+            String m_buffer;
         public:
             static Ptr create(Model::MapFormat format, FILE* stream);
+
+            /**
+             * Writes the given snapshot to the given file. The output is the same as if the world of which the snapshot
+             * was taken had been written by a NodeWriter.
+             *
+             * @throws FileSystemException if the file cannot be written
+             */
+            static void writeSnapshot(const MapSnapshot& snapshot, FILE* stream);
+        private:
+            static std::unique_ptr<MapFileSerializer> createSerializer(Model::MapFormat format, FILE* stream);
         protected:
             MapFileSerializer(FILE* file);
+        public:
+            ~MapFileSerializer() override;
         private:
             void doBeginFile() override;
             void doEndFile() override;
@@ -48,14 +70,29 @@ namespace TrenchBroom {
             void doBeginEntity(const Model::Node* node) override;
             void doEndEntity(Model::Node* node) override;
             void doEntityAttribute(const Model::EntityAttribute& attribute) override;
+            void doBrushes(const Model::BrushList& brushes) override;
             void doBeginBrush(const Model::Brush* brush) override;
             void doEndBrush(Model::Brush* brush) override;
             void doBrushFace(Model::BrushFace* face) override;
+
+            void doWriteSnapshot(const MapSnapshot& snapshot);
         private:
+            void writeEntityStart(ObjectNo no);
+            void writeBrushStart(ObjectNo no);
+            void writeBlockEnd();
+            void writeAttribute(const String& name, const String& value);
+
             void setFilePosition(Model::Node* node);
             size_t startLine();
+
+            void flushIfNecessary();
+            void flush();
         private:
-            virtual size_t doWriteBrushFace(FILE* stream, Model::BrushFace* face) = 0;
+            /**
+             * Appends the given face to the given buffer as a single line. This function is called concurrently for
+             * different faces and buffers.
+             */
+            virtual void doWriteBrushFace(String& buffer, const MapSnapshot::Face& face) const = 0;
         };
     }
 }
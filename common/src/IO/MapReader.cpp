@@ -21,6 +21,8 @@
 
 #include "CollectionUtils.h"
 #include "Logger.h"
+#include "ParallelUtils.h"
+#include "IO/ParserStatus.h"
 #include "Model/Brush.h"
 #include "Model/BrushFace.h"
 #include "Model/Entity.h"
@@ -29,6 +31,8 @@
 #include "Model/Layer.h"
 #include "Model/ModelFactory.h"
 
+#include <atomic>
+
 namespace TrenchBroom {
     namespace IO {
         MapReader::ParentInfo MapReader::ParentInfo::layer(const Model::IdType layerId) {
@@ -57,12 +61,16 @@ namespace TrenchBroom {
 
         MapReader::MapReader(const char* begin, const char* end) :
         StandardMapParser(begin, end),
+        m_begin(begin),
+        m_end(end),
         m_factory(nullptr),
         m_brushParent(nullptr),
         m_currentNode(nullptr) {}
 
         MapReader::MapReader(const String& str) :
         StandardMapParser(str),
+        m_begin(str.c_str()),
+        m_end(str.c_str() + str.size()),
         m_factory(nullptr),
         m_brushParent(nullptr),
         m_currentNode(nullptr) {}
@@ -77,6 +85,14 @@ namespace TrenchBroom {
             resolveNodes(status);
         }
 
+        void MapReader::readEntitiesInParallel(const Model::MapFormat format, const vm::bbox3& worldBounds, ParserStatus& status, const size_t chunkSize) {
+            m_worldBounds = worldBounds;
+            if (!parseEntitiesInParallel(format, chunkSize, status)) {
+                parseEntities(format, status);
+            }
+            resolveNodes(status);
+        }
+
         void MapReader::readBrushes(Model::MapFormat format, const vm::bbox3& worldBounds, ParserStatus& status) {
             m_worldBounds = worldBounds;
             parseBrushes(format, status);
@@ -87,6 +103,13 @@ namespace TrenchBroom {
             parseBrushFaces(format, status);
         }
 
+        void MapReader::readEvents(const Model::MapFormat format, const vm::bbox3& worldBounds, MapChunkReader::EventList& events, ParserStatus& status) {
+            m_worldBounds = worldBounds;
+            formatSet(format);
+            replayEvents(events, true, status);
+            resolveNodes(status);
+        }
+
         void MapReader::onFormatSet(const Model::MapFormat format) {
             m_factory = &initialize(format, m_worldBounds);
         }
@@ -239,6 +262,109 @@ namespace TrenchBroom {
 
         }
 
+        bool MapReader::parseEntitiesInParallel(const Model::MapFormat format, const size_t chunkSize, ParserStatus& status) {
+            MapChunkScanner::ChunkList chunks;
+            if (!MapChunkScanner(m_begin, m_end).scan(chunkSize, chunks) || chunks.size() < 2) {
+                return false;
+            }
+
+            formatSet(format);
+
+            const auto& factory = *m_factory;
+            const auto& worldBounds = m_worldBounds;
+
+            std::vector<MapChunkReader::EventList> events(chunks.size());
+            std::atomic<bool> failed(false);
+
+            const auto deleteBrushes = [&events]() {
+                for (auto& chunkEvents : events) {
+                    MapChunkReader::deleteBrushes(chunkEvents);
+                }
+            };
+
+            try {
+                ParallelUtils::parallelFor(chunks.size(), [&](const size_t i) {
+                    if (failed) {
+                        return;
+                    }
+
+                    const auto& chunk = chunks[i];
+                    try {
+                        switch (chunk.type) {
+                            case MapChunkScanner::Chunk::Type_Entities: {
+                                MapChunkReader reader(chunk.begin, chunk.end, chunk.line, factory, worldBounds);
+                                events[i] = reader.readEntities(format);
+                                break;
+                            }
+                            case MapChunkScanner::Chunk::Type_EntityHeader: {
+                                // close the entity so that it can be parsed on its own, its brushes are in the following chunks
+                                const String header = String(chunk.begin, chunk.end) + "}";
+                                MapChunkReader reader(header.c_str(), header.c_str() + header.size(), chunk.line, factory, worldBounds);
+                                events[i] = reader.readEntities(format);
+                                break;
+                            }
+                            case MapChunkScanner::Chunk::Type_Brushes: {
+                                MapChunkReader reader(chunk.begin, chunk.end, chunk.line, factory, worldBounds);
+                                events[i] = reader.readBrushes(format);
+                                break;
+                            }
+                            switchDefault();
+                        }
+                    } catch (const ParserException&) {
+                        failed = true;
+                    }
+                });
+            } catch (...) {
+                deleteBrushes();
+                throw;
+            }
+
+            if (failed) {
+                // let the sequential parser report the error
+                deleteBrushes();
+                return false;
+            }
+
+            for (size_t i = 0; i < chunks.size(); ++i) {
+                replayChunk(chunks[i], events[i], status);
+            }
+
+            return true;
+        }
+
+        void MapReader::replayChunk(const MapChunkScanner::Chunk& chunk, MapChunkReader::EventList& events, ParserStatus& status) {
+            // a split entity is closed by its last brush chunk
+            replayEvents(events, chunk.type != MapChunkScanner::Chunk::Type_EntityHeader, status);
+
+            if (chunk.closesEntity) {
+                onEndEntity(chunk.entityLine, chunk.entityLineCount, status);
+            }
+        }
+
+        void MapReader::replayEvents(MapChunkReader::EventList& events, const bool endEntities, ParserStatus& status) {
+            for (auto& event : events) {
+                switch (event.type) {
+                    case MapChunkReader::Event::Type_BeginEntity:
+                        onBeginEntity(event.line, event.attributes, event.extraAttributes, status);
+                        break;
+                    case MapChunkReader::Event::Type_EndEntity:
+                        if (endEntities) {
+                            onEndEntity(event.line, event.lineCount, status);
+                        }
+                        break;
+                    case MapChunkReader::Event::Type_Brush:
+                        setExtraAttributes(event.brush, event.extraAttributes);
+                        onBrush(m_brushParent, event.brush, status);
+                        event.brush = nullptr;
+                        break;
+                    case MapChunkReader::Event::Type_Message:
+                        status.forward(event.level, event.message);
+                        break;
+                    switchDefault();
+                }
+            }
+        }
+
         MapReader::ParentInfo::Type MapReader::storeNode(Model::Node* node, const Model::EntityAttribute::List& attributes, ParserStatus& status) {
             const String& layerIdStr = findAttribute(attributes, Model::AttributeNames::Layer);
             if (!StringUtils::isBlank(layerIdStr)) {
@@ -21,6 +21,8 @@
 #define TrenchBroom_MapReader
 
 #include "TrenchBroom.h"
+#include "IO/MapChunkReader.h"
+#include "IO/MapChunkScanner.h"
 #include "IO/StandardMapParser.h"
 #include "Model/ModelTypes.h"
 
@@ -71,6 +73,9 @@ namespace TrenchBroom {
             using NodeParentPair = std::pair<Model::Node*, ParentInfo>;
             using NodeParentList = std::vector<NodeParentPair>;
 
+            const char* m_begin;
+            const char* m_end;
+
             vm::bbox3 m_worldBounds;
             Model::ModelFactory* m_factory;
 
@@ -86,8 +91,27 @@ namespace TrenchBroom {
             explicit MapReader(const String& str);
 
             void readEntities(Model::MapFormat format, const vm::bbox3& worldBounds, ParserStatus& status);
+
+            /**
+             * Reads the entities like readEntities, but splits the input into chunks of roughly the given size which
+             * are parsed on worker threads, including the construction of the brush geometry. The resulting nodes are
+             * then added on the calling thread in the order in which they appear in the file, so the result is the same
+             * as if the entities had been read sequentially.
+             *
+             * If the input cannot be split or if any chunk fails to parse, the input is parsed sequentially instead.
+             *
+             * Since the faces are created on worker threads, onBrushFace(Model::BrushFace*, ParserStatus&) is not
+             * called for the faces of brushes that are read in parallel.
+             */
+            void readEntitiesInParallel(Model::MapFormat format, const vm::bbox3& worldBounds, ParserStatus& status, size_t chunkSize);
             void readBrushes(Model::MapFormat format, const vm::bbox3& worldBounds, ParserStatus& status);
             void readBrushFaces(Model::MapFormat format, const vm::bbox3& worldBounds, ParserStatus& status);
+
+            /**
+             * Creates the nodes from the given events instead of parsing the input. The brushes of the events are
+             * added to their parents, and the events lose ownership of them.
+             */
+            void readEvents(Model::MapFormat format, const vm::bbox3& worldBounds, MapChunkReader::EventList& events, ParserStatus& status);
         public:
             ~MapReader() override;
         private: // implement MapParser interface
@@ -98,6 +122,10 @@ namespace TrenchBroom {
             void onEndBrush(size_t startLine, size_t lineCount, const ExtraAttributes& extraAttributes, ParserStatus& status) override;
             void onBrushFace(size_t line, const vm::vec3& point1, const vm::vec3& point2, const vm::vec3& point3, const Model::BrushFaceAttributes& attribs, const vm::vec3& texAxisX, const vm::vec3& texAxisY, ParserStatus& status) override;
         private: // helper methods
+            bool parseEntitiesInParallel(Model::MapFormat format, size_t chunkSize, ParserStatus& status);
+            void replayChunk(const MapChunkScanner::Chunk& chunk, MapChunkReader::EventList& events, ParserStatus& status);
+            void replayEvents(MapChunkReader::EventList& events, bool endEntities, ParserStatus& status);
+
             void createLayer(size_t line, const Model::EntityAttribute::List& attributes, const ExtraAttributes& extraAttributes, ParserStatus& status);
             void createGroup(size_t line, const Model::EntityAttribute::List& attributes, const ExtraAttributes& extraAttributes, ParserStatus& status);
             void createEntity(size_t line, const Model::EntityAttribute::List& attributes, const ExtraAttributes& extraAttributes, ParserStatus& status);
@@ -0,0 +1,110 @@
+/*
+ Copyright (C) 2010-2019 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "MapSnapshot.h"
+
+#include "IO/MapFileSerializer.h"
+#include "IO/NodeSerializer.h"
+#include "IO/NodeWriter.h"
+#include "Model/BrushFace.h"
+#include "Model/World.h"
+
+namespace TrenchBroom {
+    namespace IO {
+        MapSnapshot::Face::Face(const Model::BrushFace* face) :
+        textureName(face->textureName()),
+        xOffset(face->xOffset()),
+        yOffset(face->yOffset()),
+        rotation(face->rotation()),
+        xScale(face->xScale()),
+        yScale(face->yScale()),
+        textureXAxis(face->textureXAxis()),
+        textureYAxis(face->textureYAxis()),
+        surfaceContents(face->surfaceContents()),
+        surfaceFlags(face->surfaceFlags()),
+        surfaceValue(face->surfaceValue()),
+        hasSurfaceAttributes(face->hasSurfaceAttributes()),
+        hasColor(face->hasColor()),
+        color(face->color()) {
+            const auto& facePoints = face->points();
+            for (size_t i = 0; i < 3; ++i) {
+                points[i] = facePoints[i];
+            }
+        }
+
+        class MapSnapshot::Recorder : public NodeSerializer {
+        private:
+            MapSnapshot& m_snapshot;
+        public:
+            explicit Recorder(MapSnapshot& snapshot) :
+            m_snapshot(snapshot) {}
+        private:
+            void doBeginFile() override {}
+            void doEndFile() override {}
+
+            void doBeginEntity(const Model::Node* node) override {
+                m_snapshot.m_entities.push_back(Entity{ AttributeList(), 0 });
+            }
+
+            void doEndEntity(Model::Node* node) override {
+                m_snapshot.m_entities.back().brushesEnd = m_snapshot.m_facesEnd.size();
+            }
+
+            void doEntityAttribute(const Model::EntityAttribute& attribute) override {
+                m_snapshot.m_entities.back().attributes.emplace_back(attribute.name(), attribute.value());
+            }
+
+            void doBeginBrush(const Model::Brush* brush) override {}
+
+            void doEndBrush(Model::Brush* brush) override {
+                m_snapshot.m_facesEnd.push_back(m_snapshot.m_faces.size());
+            }
+
+            void doBrushFace(Model::BrushFace* face) override {
+                m_snapshot.m_faces.emplace_back(face);
+            }
+        };
+
+        MapSnapshot::MapSnapshot(Model::World& world) :
+        m_format(world.format()) {
+            NodeWriter writer(world, new Recorder(*this));
+            writer.writeMap();
+        }
+
+        Model::MapFormat MapSnapshot::format() const {
+            return m_format;
+        }
+
+        const std::vector<MapSnapshot::Entity>& MapSnapshot::entities() const {
+            return m_entities;
+        }
+
+        const std::vector<size_t>& MapSnapshot::facesEnd() const {
+            return m_facesEnd;
+        }
+
+        const std::vector<MapSnapshot::Face>& MapSnapshot::faces() const {
+            return m_faces;
+        }
+
+        void MapSnapshot::write(FILE* stream) const {
+            MapFileSerializer::writeSnapshot(*this, stream);
+        }
+    }
+}
@@ -0,0 +1,104 @@
+/*
+ Copyright (C) 2010-2019 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef TrenchBroom_MapSnapshot
+#define TrenchBroom_MapSnapshot
+
+#include "Color.h"
+#include "StringUtils.h"
+#include "Model/MapFormat.h"
+#include "Model/ModelTypes.h"
+
+#include <vecmath/vec.h>
+
+#include <cstdio>
+#include <utility>
+#include <vector>
+
+namespace TrenchBroom {
+    namespace IO {
+        /**
+         * An immutable copy of the data that is written to a map file. Taking a snapshot only copies the entity
+         * attributes and face data of the world, so it is much cheaper than writing the map. The snapshot does not
+         * reference any nodes, so it can be written to a file on another thread while the world is being modified.
+         */
+        class MapSnapshot {
+        public:
+            /**
+             * The data of a brush face that is written to a map file.
+             */
+            struct Face {
+                vm::vec3 points[3];
+                String textureName;
+                float xOffset;
+                float yOffset;
+                float rotation;
+                float xScale;
+                float yScale;
+                vm::vec3 textureXAxis;
+                vm::vec3 textureYAxis;
+                int surfaceContents;
+                int surfaceFlags;
+                float surfaceValue;
+                bool hasSurfaceAttributes;
+                bool hasColor;
+                Color color;
+
+                explicit Face(const Model::BrushFace* face);
+            };
+
+            using Attribute = std::pair<String, String>;
+            using AttributeList = std::vector<Attribute>;
+
+            struct Entity {
+                AttributeList attributes;
+                // the index one past the entity's last brush
+                size_t brushesEnd;
+            };
+        private:
+            class Recorder;
+
+            Model::MapFormat m_format;
+            std::vector<Entity> m_entities;
+            // the index one past each brush's last face
+            std::vector<size_t> m_facesEnd;
+            std::vector<Face> m_faces;
+        public:
+            /**
+             * Takes a snapshot of the given world. Must be called on the thread that owns the world.
+             */
+            explicit MapSnapshot(Model::World& world);
+
+            Model::MapFormat format() const;
+            const std::vector<Entity>& entities() const;
+            const std::vector<size_t>& facesEnd() const;
+            const std::vector<Face>& faces() const;
+
+            /**
+             * Writes this snapshot to the given file in the same way as NodeWriter writes the world. Can be called on
+             * any thread.
+             *
+             * @throws FileSystemException if the file cannot be written
+             */
+            void write(FILE* stream) const;
+        };
+    }
+}
+
+#endif /* defined(TrenchBroom_MapSnapshot) */
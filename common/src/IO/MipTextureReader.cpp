@@ -47,6 +47,14 @@ namespace TrenchBroom {
         }
 
         Assets::Texture* MipTextureReader::doReadTexture(std::shared_ptr<File> file) const {
+            return readMipTexture(file, false);
+        }
+
+        Assets::Texture* MipTextureReader::doReadTextureInfo(std::shared_ptr<File> file) const {
+            return readMipTexture(file, true);
+        }
+
+        Assets::Texture* MipTextureReader::readMipTexture(std::shared_ptr<File> file, const bool infoOnly) const {
             static const size_t MipLevels = 4;
 
             Color averageColor;
@@ -72,14 +80,29 @@ namespace TrenchBroom {
                 const auto transparent = (name.size() > 0 && name.at(0) == '{')
                                          ? Assets::PaletteTransparency::Index255Transparent
                                          : Assets::PaletteTransparency::Opaque;
+                const auto type = (transparent == Assets::PaletteTransparency::Index255Transparent)
+                                  ? Assets::TextureType::Masked
+                                  : Assets::TextureType::Opaque;
 
-                Assets::setMipBufferSize(buffers, MipLevels, width, height, GL_RGBA);
                 auto palette = doGetPalette(reader, offset, width, height);
 
                 if (!palette.initialized()) {
                     return new Assets::Texture(textureName(name, path), width, height);
                 }
 
+                if (infoOnly) {
+                    // approximate the average color using the smallest mip level
+                    const auto level = MipLevels - 1;
+                    const auto size = mipSize(width, height, level);
+                    Assets::TextureBuffer buffer(4 * size);
+
+                    reader.seekFromBegin(offset[level]);
+                    palette.indexedToRgba(reader, size, buffer, transparent, averageColor);
+                    return new Assets::Texture(textureName(name, path), width, height, averageColor, GL_RGBA, type);
+                }
+
+                Assets::setMipBufferSize(buffers, MipLevels, width, height, GL_RGBA);
+
                 for (size_t i = 0; i < MipLevels; ++i) {
                     reader.seekFromBegin(offset[i]);
                     const size_t size = mipSize(width, height, i);
@@ -91,9 +114,6 @@ namespace TrenchBroom {
                     }
                 }
 
-                const auto type = (transparent == Assets::PaletteTransparency::Index255Transparent)
-                                  ? Assets::TextureType::Masked
-                                  : Assets::TextureType::Opaque;
                 return new Assets::Texture(textureName(name, path), width, height, averageColor, buffers, GL_RGBA, type);
             } catch (const ReaderException&) {
                 return new Assets::Texture(textureName(path), 16, 16);
@@ -35,8 +35,11 @@ namespace TrenchBroom {
             virtual ~MipTextureReader() override;
         public:
             static size_t mipFileSize(size_t width, size_t height, size_t mipLevels);
+        private:
+            Assets::Texture* readMipTexture(std::shared_ptr<File> file, bool infoOnly) const;
         protected:
             Assets::Texture* doReadTexture(std::shared_ptr<File> file) const override;
+            Assets::Texture* doReadTextureInfo(std::shared_ptr<File> file) const override;
             virtual Assets::Palette doGetPalette(Reader& reader, const size_t offset[], size_t width, size_t height) const = 0;
         };
     }
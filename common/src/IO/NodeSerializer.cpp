@@ -19,6 +19,7 @@
 
 #include "NodeSerializer.h"
 
+#include "Model/AssortNodesVisitor.h"
 #include "Model/Brush.h"
 #include "Model/Group.h"
 #include "Model/Layer.h"
@@ -27,19 +28,6 @@
 
 namespace TrenchBroom {
     namespace IO {
-        class NodeSerializer::BrushSerializer : public Model::NodeVisitor {
-        private:
-            NodeSerializer& m_serializer;
-        public:
-            BrushSerializer(NodeSerializer& serializer) : m_serializer(serializer) {}
-
-            void doVisit(Model::World* world) override   {}
-            void doVisit(Model::Layer* layer) override   {}
-            void doVisit(Model::Group* group) override   {}
-            void doVisit(Model::Entity* entity) override {}
-            void doVisit(Model::Brush* brush) override   { m_serializer.brush(brush); }
-        };
-
         NodeSerializer::NodeSerializer() :
         m_entityNo(0),
         m_brushNo(0) {}
@@ -77,11 +65,11 @@ namespace TrenchBroom {
         }
 
         void NodeSerializer::entity(Model::Node* node, const Model::EntityAttribute::List& attributes, const Model::EntityAttribute::List& parentAttributes, Model::Node* brushParent) {
-            beginEntity(node, attributes, parentAttributes);
-
-            BrushSerializer brushSerializer(*this);
-            brushParent->iterate(brushSerializer);
+            Model::CollectBrushesVisitor collectBrushes;
+            brushParent->iterate(collectBrushes);
 
+            beginEntity(node, attributes, parentAttributes);
+            brushes(collectBrushes.brushes());
             endEntity(node);
         }
 
@@ -117,8 +105,7 @@ namespace TrenchBroom {
         }
 
         void NodeSerializer::brushes(const Model::BrushList& brushes) {
-            std::for_each(std::begin(brushes), std::end(brushes),
-                          [this](Model::Brush* brush) { this->brush(brush); });
+            doBrushes(brushes);
         }
 
         void NodeSerializer::brush(Model::Brush* brush) {
@@ -194,6 +181,11 @@ namespace TrenchBroom {
             return attrs;
         }
 
+        void NodeSerializer::doBrushes(const Model::BrushList& brushes) {
+            std::for_each(std::begin(brushes), std::end(brushes),
+                          [this](Model::Brush* brush) { this->brush(brush); });
+        }
+
         String NodeSerializer::escapeEntityAttribute(const String& str) const {
             // Remove a trailing unescaped backslash, as this will choke the parser.
             const auto l = str.size();
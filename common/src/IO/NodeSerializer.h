@@ -31,8 +31,6 @@ namespace TrenchBroom {
         class Path;
 
         class NodeSerializer {
-        private:
-            class BrushSerializer;
         protected:
             static const int FloatPrecision = 17;
             using ObjectNo = unsigned int;
@@ -42,6 +40,8 @@ namespace TrenchBroom {
             private:
                 using IdMap = std::map<T, String>;
                 mutable IdMap m_ids;
+                // ids only have to be unique within the serialized nodes
+                mutable Model::IdType m_currentId = 1;
             public:
                 const String& getId(const T& t) const {
                     typename IdMap::iterator it = m_ids.find(t);
@@ -51,8 +51,7 @@ namespace TrenchBroom {
                 }
             private:
                 Model::IdType makeId() const {
-                    static Model::IdType currentId = 1;
-                    return currentId++;
+                    return m_currentId++;
                 }
 
                 String idToString(const Model::IdType nodeId) const {
@@ -98,7 +97,7 @@ namespace TrenchBroom {
 
             void brushes(const Model::BrushList& brushes);
             void brush(Model::Brush* brush);
-
+        protected:
             void beginBrush(const Model::Brush* brush);
             void endBrush(Model::Brush* brush);
         public:
@@ -114,6 +113,12 @@ namespace TrenchBroom {
             Model::EntityAttribute::List groupAttributes(const Model::Group* group);
         protected:
             String escapeEntityAttribute(const String& str) const;
+
+            /**
+             * Writes the given brushes of an entity in order. The default implementation writes one brush after the
+             * other. Subclasses that override this must call beginBrush and endBrush for every brush.
+             */
+            virtual void doBrushes(const Model::BrushList& brushes);
         private:
             virtual void doBeginFile() = 0;
             virtual void doEndFile() = 0;
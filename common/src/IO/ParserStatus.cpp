@@ -96,6 +96,14 @@ namespace TrenchBroom {
             throw ParserException(buildMessage(str));
         }
 
+        void ParserStatus::forward(const Logger::LogLevel level, const String& message) {
+            if (m_prefix.empty()) {
+                doLog(level, message);
+            } else {
+                doLog(level, m_prefix + ": " + message);
+            }
+        }
+
         void ParserStatus::log(const Logger::LogLevel level, const size_t line, const size_t column, const String& str) {
             doLog(level, buildMessage(line, column, str));
         }
@@ -53,6 +53,12 @@ namespace TrenchBroom {
             void warn(const String& str);
             void error(const String& str);
             void errorAndThrow(const String& str);
+
+            /**
+             * Logs a message that was already formatted by another parser status, e.g. one that collected the
+             * messages of a parser running on a worker thread. Only this status' prefix is added to the message.
+             */
+            void forward(Logger::LogLevel level, const String& message);
         private:
             void log(Logger::LogLevel level, size_t line, size_t column, const String& str);
             String buildMessage(size_t line, size_t column, const String& str) const;
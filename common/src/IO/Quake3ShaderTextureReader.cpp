@@ -39,7 +39,10 @@ namespace TrenchBroom {
             }
 
             const auto& shader = shaderFile->object();
-            const auto texturePath = findTexturePath(shader);
+            const auto texturePath = [&]() {
+                std::lock_guard<std::mutex> lock(m_fsMutex);
+                return findTexturePath(shader);
+            }();
 
             auto* texture = loadTextureImage(shader.shaderPath, texturePath);
             texture->setSurfaceParms(shader.surfaceParms);
@@ -70,10 +73,28 @@ namespace TrenchBroom {
             return texture;
         }
 
+        bool Quake3ShaderTextureReader::doCanDecodeLazily() const {
+            // the file system is not owned by this reader
+            return false;
+        }
+
+        bool Quake3ShaderTextureReader::doCanCache() const {
+            // the texture image is read from another file than the shader
+            return false;
+        }
+
         Assets::Texture* Quake3ShaderTextureReader::loadTextureImage(const Path& shaderPath, const Path& imagePath) const {
-            if (m_fs.fileExists(imagePath)) {
+            std::shared_ptr<File> imageFile;
+            {
+                std::lock_guard<std::mutex> lock(m_fsMutex);
+                if (m_fs.fileExists(imagePath)) {
+                    imageFile = m_fs.openFile(imagePath);
+                }
+            }
+
+            if (imageFile != nullptr) {
                 FreeImageTextureReader imageReader(StaticNameStrategy(textureName(shaderPath)));
-                return imageReader.readTexture(m_fs.openFile(imagePath));
+                return imageReader.readTexture(imageFile);
             } else {
                 return new Assets::Texture(textureName(shaderPath), 64, 64);
             }
@@ -23,6 +23,7 @@
 #include "IO/TextureReader.h"
 
 #include <memory>
+#include <mutex>
 
 namespace TrenchBroom {
     namespace Assets {
@@ -38,10 +39,14 @@ namespace TrenchBroom {
          * Loads a texture that represents a Quake 3 shader from the file system. Uses a given file system
          * to locate the actual editor image for the shader. The shader is expected to be readily parsed and
          * available as a virtual object file in the file system.
+         *
+         * Textures may be read concurrently. Accesses to the file system are serialized, only decoding the editor
+         * image happens in parallel.
          */
         class Quake3ShaderTextureReader : public TextureReader {
         private:
             const FileSystem& m_fs;
+            mutable std::mutex m_fsMutex;
         public:
             /**
              * Creates a texture reader using the given name strategy and file system to locate the texture image.
@@ -52,6 +57,8 @@ namespace TrenchBroom {
             Quake3ShaderTextureReader(const NameStrategy& nameStrategy, const FileSystem& fs);
         private:
             Assets::Texture* doReadTexture(std::shared_ptr<File> file) const override;
+            bool doCanDecodeLazily() const override;
+            bool doCanCache() const override;
             Assets::Texture* loadTextureImage(const Path& shaderPath, const Path& imagePath) const;
             Path findTexturePath(const Assets::Quake3Shader& shader) const;
             Path findTexture(const Path& texturePath) const;
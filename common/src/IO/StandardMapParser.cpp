@@ -26,15 +26,93 @@
 #include <vecmath/plane.h>
 #include <vecmath/vec.h>
 
+#include <algorithm>
+#include <array>
+
 namespace TrenchBroom {
     namespace IO {
-        const String& QuakeMapTokenizer::NumberDelim() {
-            static const String numberDelim(Whitespace() + ")");
-            return numberDelim;
+        namespace {
+            enum CharClass : unsigned char {
+                Blank       = 1 << 0, // space and tab
+                LineBreak   = 1 << 1,
+                Digit       = 1 << 2,
+                Sign        = 1 << 3,
+                NumberDelim = 1 << 4  // terminates a number
+            };
+
+            using CharClassTable = std::array<unsigned char, 256>;
+
+            constexpr CharClassTable makeCharClassTable() {
+                CharClassTable table{};
+                table[static_cast<unsigned char>(' ')]  = Blank | NumberDelim;
+                table[static_cast<unsigned char>('\t')] = Blank | NumberDelim;
+                table[static_cast<unsigned char>('\n')] = LineBreak | NumberDelim;
+                table[static_cast<unsigned char>('\r')] = LineBreak | NumberDelim;
+                table[static_cast<unsigned char>(')')]  = NumberDelim;
+                table[static_cast<unsigned char>('+')]  = Sign;
+                table[static_cast<unsigned char>('-')]  = Sign;
+                for (char c = '0'; c <= '9'; ++c) {
+                    table[static_cast<unsigned char>(c)] = Digit;
+                }
+                return table;
+            }
+
+            constexpr CharClassTable CharClasses = makeCharClassTable();
+
+            bool hasClass(const char c, const unsigned char charClass) {
+                return (CharClasses[static_cast<unsigned char>(c)] & charClass) != 0;
+            }
+
+            const char* skipClass(const char* c, const char* end, const unsigned char charClass) {
+                while (c < end && hasClass(*c, charClass)) {
+                    ++c;
+                }
+                return c;
+            }
+
+            bool isNumberEnd(const char* c, const char* end) {
+                return c == end || hasClass(*c, NumberDelim);
+            }
+
+            /**
+             * Returns the end of the integer at the given position, or nullptr if there is no integer.
+             */
+            const char* scanInteger(const char* c, const char* end) {
+                if (!hasClass(*c, Sign | Digit)) {
+                    return nullptr;
+                }
+                if (hasClass(*c, Sign)) {
+                    ++c;
+                }
+                c = skipClass(c, end, Digit);
+                return isNumberEnd(c, end) ? c : nullptr;
+            }
+
+            /**
+             * Returns the end of the decimal at the given position, or nullptr if there is no decimal.
+             */
+            const char* scanDecimal(const char* c, const char* end) {
+                if (!hasClass(*c, Sign | Digit) && *c != '.') {
+                    return nullptr;
+                }
+                if (*c != '.') {
+                    c = skipClass(c + 1, end, Digit);
+                }
+                if (c < end && *c == '.') {
+                    c = skipClass(c + 1, end, Digit);
+                }
+                if (c < end && *c == 'e') {
+                    ++c;
+                    if (c < end && hasClass(*c, Sign | Digit)) {
+                        c = skipClass(c + 1, end, Digit);
+                    }
+                }
+                return isNumberEnd(c, end) ? c : nullptr;
+            }
         }
 
-        QuakeMapTokenizer::QuakeMapTokenizer(const char* begin, const char* end) :
-        Tokenizer(begin, end, "\"", '\\'),
+        QuakeMapTokenizer::QuakeMapTokenizer(const char* begin, const char* end, const size_t firstLine) :
+        Tokenizer(begin, end, "\"", '\\', firstLine),
         m_skipEol(true) {}
 
         QuakeMapTokenizer::QuakeMapTokenizer(const String& str) :
@@ -59,7 +137,7 @@ namespace TrenchBroom {
                                 advance();
                                 return Token(QuakeMapToken::Comment, c, c+3, offset(c), startLine, startColumn);
                             }
-                            discardUntil("\n\r");
+                            discardLineComment();
                         }
                         break;
                     case '{':
@@ -101,24 +179,24 @@ namespace TrenchBroom {
                         switchFallthrough();
                     case ' ':
                     case '\t':
-                        discardWhile(Whitespace());
+                        discardWhitespace();
                         break;
-                    default: { // whitespace, integer, decimal or word
-                        const auto* e = readInteger(NumberDelim());
+                    default: { // integer, decimal or word
+                        const auto* e = scanInteger(c, endPos());
                         if (e != nullptr) {
+                            advanceColumns(static_cast<size_t>(e - c));
                             return Token(QuakeMapToken::Integer, c, e, offset(c), startLine, startColumn);
                         }
 
-                        e = readDecimal(NumberDelim());
+                        e = scanDecimal(c, endPos());
                         if (e != nullptr) {
+                            advanceColumns(static_cast<size_t>(e - c));
                             return Token(QuakeMapToken::Decimal, c, e, offset(c), startLine, startColumn);
                         }
 
-                        e = readUntil(Whitespace());
-                        if (e == nullptr) {
-                            throw ParserException(startLine, startColumn, "Unexpected character: " + String(c, 1));
-                        }
-
+                        // a word extends until the next whitespace
+                        e = std::find_if(c + 1, endPos(), [](const char x) { return hasClass(x, Blank | LineBreak); });
+                        advanceColumns(static_cast<size_t>(e - c));
                         return Token(QuakeMapToken::String, c, e, offset(c), startLine, startColumn);
                     }
                 }
@@ -126,11 +204,30 @@ namespace TrenchBroom {
             return Token(QuakeMapToken::Eof, nullptr, nullptr, length(), line(), column());
         }
 
+        void QuakeMapTokenizer::discardWhitespace() {
+            while (!eof()) {
+                const auto* c = curPos();
+                const auto* e = skipClass(c, endPos(), Blank);
+                advanceColumns(static_cast<size_t>(e - c));
+
+                if (e == endPos() || !hasClass(*e, LineBreak)) {
+                    break;
+                }
+                advance();
+            }
+        }
+
+        void QuakeMapTokenizer::discardLineComment() {
+            const auto* c = curPos();
+            const auto* e = std::find_if(c, endPos(), [](const char x) { return hasClass(x, LineBreak); });
+            advanceColumns(static_cast<size_t>(e - c));
+        }
+
         const String StandardMapParser::BrushPrimitiveId = "brushDef";
         const String StandardMapParser::PatchId = "patchDef2";
 
-        StandardMapParser::StandardMapParser(const char* begin, const char* end) :
-        m_tokenizer(QuakeMapTokenizer(begin, end)),
+        StandardMapParser::StandardMapParser(const char* begin, const char* end, const size_t firstLine) :
+        m_tokenizer(QuakeMapTokenizer(begin, end, firstLine)),
         m_format(Model::MapFormat::Unknown) {}
 
         StandardMapParser::StandardMapParser(const String& str) :
@@ -50,17 +50,23 @@ namespace TrenchBroom {
             static const Type Number        = Integer | Decimal;
         }
 
+        /**
+         * Tokenizes the Quake map grammar. Numbers, words and whitespace are scanned with a character class table
+         * directly on the source buffer, only line breaks are processed character by character.
+         */
         class QuakeMapTokenizer : public Tokenizer<QuakeMapToken::Type> {
         private:
-            static const String& NumberDelim();
             bool m_skipEol;
         public:
-            QuakeMapTokenizer(const char* begin, const char* end);
+            QuakeMapTokenizer(const char* begin, const char* end, size_t firstLine = 1);
             QuakeMapTokenizer(const String& str);
 
             void setSkipEol(bool skipEol);
         private:
             Token emitToken() override;
+
+            void discardWhitespace();
+            void discardLineComment();
         };
 
         class ParserStatus;
@@ -76,7 +82,7 @@ namespace TrenchBroom {
             QuakeMapTokenizer m_tokenizer;
             Model::MapFormat m_format;
         public:
-            StandardMapParser(const char* begin, const char* end);
+            StandardMapParser(const char* begin, const char* end, size_t firstLine = 1);
             StandardMapParser(const String& str);
 
             virtual ~StandardMapParser() override;
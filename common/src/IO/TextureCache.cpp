@@ -0,0 +1,343 @@
+/*
+ Copyright (C) 2010-2019 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "TextureCache.h"
+
+#include "Exceptions.h"
+#include "IO/DiskIO.h"
+#include "IO/File.h"
+#include "IO/FileMatcher.h"
+#include "IO/IOUtils.h"
+#include "IO/Reader.h"
+
+#include <sys/stat.h>
+#include <sys/types.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <sstream>
+#include <tuple>
+
+namespace TrenchBroom {
+    namespace IO {
+        /**
+         * Computes a 64 bit hash of the given bytes. Processes eight bytes at a time since texture files are hashed
+         * every time they are loaded.
+         */
+        static uint64_t hash(const char* begin, const char* end) {
+            static const uint64_t Prime = 0x9E3779B97F4A7C15ull;
+
+            uint64_t result = 14695981039346656037ull ^ static_cast<uint64_t>(end - begin);
+            const auto* cur = begin;
+            for (; cur + sizeof(uint64_t) <= end; cur += sizeof(uint64_t)) {
+                uint64_t word;
+                std::memcpy(&word, cur, sizeof(word));
+                result = (result ^ word) * Prime;
+                result ^= result >> 32;
+            }
+            for (; cur < end; ++cur) {
+                result = (result ^ static_cast<unsigned char>(*cur)) * Prime;
+                result ^= result >> 32;
+            }
+            return result;
+        }
+
+        TextureCacheKey::TextureCacheKey() :
+        size(0),
+        hash(0) {}
+
+        TextureCacheKey::TextureCacheKey(const String& i_entry, const uint64_t i_size, const uint64_t i_hash) :
+        entry(i_entry),
+        size(i_size),
+        hash(i_hash) {}
+
+        TextureCacheKey TextureCacheKey::compute(const File& file) {
+            const auto reader = file.reader().buffer();
+            return TextureCacheKey(
+                file.path().asString('/'),
+                static_cast<uint64_t>(reader.size()),
+                IO::hash(reader.begin(), reader.end()));
+        }
+
+        bool TextureCacheKey::operator==(const TextureCacheKey& other) const {
+            return size == other.size && hash == other.hash && entry == other.entry;
+        }
+
+        bool TextureCacheKey::operator!=(const TextureCacheKey& other) const {
+            return !(*this == other);
+        }
+
+        TextureCacheFile::TextureCacheFile(std::unique_ptr<MappedFile> file, std::vector<Record> records) :
+        m_file(std::move(file)) {
+            for (auto& record : records) {
+                auto entry = record.key.entry;
+                m_records.emplace(std::move(entry), std::move(record));
+            }
+        }
+
+        TextureCacheFile::~TextureCacheFile() = default;
+
+        const TextureCacheFile::Record* TextureCacheFile::find(const TextureCacheKey& key) const {
+            const auto it = m_records.find(key.entry);
+            if (it == std::end(m_records) || it->second.key != key) {
+                return nullptr;
+            }
+            return &it->second;
+        }
+
+        Assets::Texture* TextureCacheFile::readTexture(const Record& record) const {
+            Assets::TextureBuffer::List buffers;
+            buffers.reserve(record.mipLevels.size());
+
+            for (const auto& mipLevel : record.mipLevels) {
+                Assets::TextureBuffer buffer(mipLevel.second);
+                if (mipLevel.second > 0) {
+                    std::memcpy(buffer.ptr(), mipLevel.first, mipLevel.second);
+                }
+                buffers.push_back(buffer);
+            }
+
+            return new Assets::Texture(record.name, record.width, record.height, record.averageColor, buffers, record.format, record.type);
+        }
+
+        Assets::Texture* TextureCacheFile::readTextureInfo(const Record& record) const {
+            return new Assets::Texture(record.name, record.width, record.height, record.averageColor, record.format, record.type);
+        }
+
+        const uint64_t TextureCache::DefaultMaximumSize = 1024u * 1024u * 1024u;
+        const char TextureCache::Magic[4] = { 'T', 'B', 'T', 'C' };
+        const uint32_t TextureCache::Version = 1;
+
+        TextureCache::TextureCache(const Path& directory, const String& signature, const uint64_t maximumSize) :
+        m_directory(directory),
+        m_signature(signature),
+        m_maximumSize(maximumSize) {}
+
+        Path TextureCache::cacheFilePath(const Path& collectionPath) const {
+            const auto key = m_signature + "\n" + collectionPath.asString('/');
+
+            std::stringstream name;
+            name << std::hex << IO::hash(key.data(), key.data() + key.size()) << ".tbtex";
+            return m_directory + Path(name.str());
+        }
+
+        static String readCacheString(Reader& reader) {
+            const auto size = reader.readSize<uint32_t>();
+            if (!reader.canRead(size)) {
+                throw ReaderException("Texture cache string exceeds the end of the file");
+            }
+            return reader.readString(size);
+        }
+
+        /**
+         * Checks that the pixels of the given record have the size that its format, width and height require.
+         */
+        static bool validRecord(const TextureCacheFile::Record& record) {
+            if (record.type != Assets::TextureType::Opaque && record.type != Assets::TextureType::Masked) {
+                return false;
+            }
+
+            size_t bytesPerPixel;
+            switch (record.format) {
+                case GL_RGB:
+                case GL_BGR:
+                case GL_RGBA:
+                case GL_BGRA:
+                    bytesPerPixel = Assets::bytesPerPixelForFormat(record.format);
+                    break;
+                default:
+                    return false;
+            }
+
+            for (size_t level = 0; level < record.mipLevels.size(); ++level) {
+                const auto mipSize = Assets::sizeAtMipLevel(record.width, record.height, level);
+                if (record.mipLevels[level].second != bytesPerPixel * mipSize.x() * mipSize.y()) {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        std::shared_ptr<const TextureCacheFile> TextureCache::read(const Path& collectionPath) const {
+            std::unique_ptr<MappedFile> file;
+            try {
+                file = std::make_unique<MappedFile>(cacheFilePath(collectionPath));
+            } catch (const FileSystemException&) {
+                // there is no cache file
+                return nullptr;
+            }
+
+            try {
+                auto reader = Reader::from(file->begin(), file->end());
+
+                char magic[sizeof(Magic)];
+                if (!reader.canRead(sizeof(magic))) {
+                    return nullptr;
+                }
+
+                reader.read(magic, sizeof(magic));
+                if (std::memcmp(magic, Magic, sizeof(magic)) != 0 ||
+                    reader.readUnsignedInt<uint32_t>() != Version ||
+                    readCacheString(reader) != m_signature ||
+                    readCacheString(reader) != collectionPath.asString('/')) {
+                    return nullptr;
+                }
+
+                std::vector<TextureCacheFile::Record> records(reader.readSize<uint32_t>());
+                for (auto& record : records) {
+                    record.key.entry = readCacheString(reader);
+                    record.key.size = reader.read<uint64_t, uint64_t>();
+                    record.key.hash = reader.read<uint64_t, uint64_t>();
+
+                    record.name = readCacheString(reader);
+                    record.width = reader.readSize<uint64_t>();
+                    record.height = reader.readSize<uint64_t>();
+                    for (size_t i = 0; i < 4; ++i) {
+                        record.averageColor[i] = reader.readFloat<float>();
+                    }
+                    record.format = static_cast<GLenum>(reader.readUnsignedInt<uint32_t>());
+                    record.type = static_cast<Assets::TextureType>(reader.readUnsignedInt<uint32_t>());
+
+                    const auto mipLevelCount = reader.readSize<uint32_t>();
+                    for (size_t i = 0; i < mipLevelCount; ++i) {
+                        const auto size = reader.readSize<uint64_t>();
+                        if (!reader.canRead(size)) {
+                            throw ReaderException("Texture cache mip level exceeds the end of the file");
+                        }
+                        record.mipLevels.emplace_back(file->begin() + reader.position(), size);
+                        reader.seekForward(size);
+                    }
+
+                    if (!validRecord(record)) {
+                        return nullptr;
+                    }
+                }
+
+                return std::make_shared<TextureCacheFile>(std::move(file), std::move(records));
+            } catch (const ReaderException& e) {
+                throw FileSystemException() << "Invalid texture cache file " << cacheFilePath(collectionPath) << ": " << e.what();
+            }
+        }
+
+        template <typename T>
+        static void write(std::FILE* stream, const T value) {
+            if (std::fwrite(&value, sizeof(T), 1, stream) != 1) {
+                throw FileSystemException("Cannot write texture cache");
+            }
+        }
+
+        static void writeBytes(std::FILE* stream, const void* bytes, const size_t size) {
+            if (size > 0 && std::fwrite(bytes, size, 1, stream) != 1) {
+                throw FileSystemException("Cannot write texture cache");
+            }
+        }
+
+        static void writeString(std::FILE* stream, const String& str) {
+            write(stream, static_cast<uint32_t>(str.size()));
+            writeBytes(stream, str.data(), str.size());
+        }
+
+        void TextureCache::write(const Path& collectionPath, const std::vector<TextureCacheKey>& keys, const std::vector<const Assets::Texture*>& textures) const {
+            ensure(keys.size() == textures.size(), "keys and textures do not match");
+
+            if (!Disk::directoryExists(m_directory)) {
+                Disk::createDirectory(m_directory);
+            }
+
+            // Replace the cache file in one step so that other instances never see a partially written file.
+            const auto path = cacheFilePath(collectionPath);
+            ReplaceFile file(path);
+            auto* stream = file.file;
+
+            writeBytes(stream, Magic, sizeof(Magic));
+            IO::write(stream, Version);
+            writeString(stream, m_signature);
+            writeString(stream, collectionPath.asString('/'));
+
+            IO::write(stream, static_cast<uint32_t>(textures.size()));
+            for (size_t i = 0; i < textures.size(); ++i) {
+                const auto& key = keys[i];
+                writeString(stream, key.entry);
+                IO::write(stream, key.size);
+                IO::write(stream, key.hash);
+
+                const auto* texture = textures[i];
+                writeString(stream, texture->name());
+                IO::write(stream, static_cast<uint64_t>(texture->width()));
+                IO::write(stream, static_cast<uint64_t>(texture->height()));
+                for (size_t j = 0; j < 4; ++j) {
+                    IO::write(stream, texture->averageColor()[j]);
+                }
+                IO::write(stream, static_cast<uint32_t>(texture->format()));
+                IO::write(stream, static_cast<uint32_t>(texture->type()));
+
+                const auto& buffers = texture->buffersIfUnprepared();
+                IO::write(stream, static_cast<uint32_t>(buffers.size()));
+                for (const auto& buffer : buffers) {
+                    IO::write(stream, static_cast<uint64_t>(buffer.size()));
+                    if (buffer.size() > 0) {
+                        writeBytes(stream, buffer.ptr(), buffer.size());
+                    }
+                }
+            }
+
+            file.commit();
+            deleteOldCacheFiles(path);
+        }
+
+        void TextureCache::deleteOldCacheFiles(const Path& keepPath) const {
+            // the size, the modification time and the path of each cache file
+            std::vector<std::tuple<uint64_t, int64_t, Path>> cacheFiles;
+            uint64_t totalSize = 0;
+
+            for (const auto& path : Disk::findItems(m_directory, FileExtensionMatcher("tbtex"))) {
+#ifdef _WIN32
+                struct _stat64 info;
+                if (_stat64(path.asString().c_str(), &info) != 0) {
+#else
+                struct stat info;
+                if (::stat(path.asString().c_str(), &info) != 0) {
+#endif
+                    // another instance may have deleted the file in the meantime
+                    continue;
+                }
+
+                const auto size = static_cast<uint64_t>(info.st_size);
+                totalSize += size;
+                if (path != keepPath) {
+                    cacheFiles.emplace_back(size, static_cast<int64_t>(info.st_mtime), path);
+                }
+            }
+
+            std::sort(std::begin(cacheFiles), std::end(cacheFiles), [](const auto& lhs, const auto& rhs) {
+                return std::get<1>(lhs) < std::get<1>(rhs);
+            });
+
+            for (const auto& cacheFile : cacheFiles) {
+                if (totalSize <= m_maximumSize) {
+                    break;
+                }
+                if (std::remove(std::get<2>(cacheFile).asString().c_str()) == 0) {
+                    totalSize -= std::get<0>(cacheFile);
+                }
+            }
+        }
+    }
+}
@@ -0,0 +1,149 @@
+/*
+ Copyright (C) 2010-2019 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef TrenchBroom_TextureCache
+#define TrenchBroom_TextureCache
+
+#include "Color.h"
+#include "StringUtils.h"
+#include "Assets/Texture.h"
+#include "IO/Path.h"
+
+#include <cstdint>
+#include <memory>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace TrenchBroom {
+    namespace IO {
+        class File;
+        class MappedFile;
+
+        /**
+         * Identifies the contents of a texture file within its collection. A cached texture is only used if its key
+         * matches the key of the texture file it was decoded from.
+         */
+        struct TextureCacheKey {
+            String entry;
+            uint64_t size;
+            uint64_t hash;
+
+            TextureCacheKey();
+            TextureCacheKey(const String& i_entry, uint64_t i_size, uint64_t i_hash);
+
+            /**
+             * Computes the key of the given texture file from its path and its contents. Can be called on any thread.
+             */
+            static TextureCacheKey compute(const File& file);
+
+            bool operator==(const TextureCacheKey& other) const;
+            bool operator!=(const TextureCacheKey& other) const;
+        };
+
+        /**
+         * A texture cache file contains the decoded textures of one texture collection. The file is mapped into
+         * memory while it is open, and cached textures are copied out of it when they are read.
+         */
+        class TextureCacheFile {
+        public:
+            struct Record {
+                TextureCacheKey key;
+                String name;
+                size_t width;
+                size_t height;
+                Color averageColor;
+                GLenum format;
+                Assets::TextureType type;
+                // the mip levels, each given by the position and size of its pixels in the mapped file
+                std::vector<std::pair<const char*, size_t>> mipLevels;
+            };
+        private:
+            std::unique_ptr<MappedFile> m_file;
+            std::unordered_map<String, Record> m_records;
+        public:
+            TextureCacheFile(std::unique_ptr<MappedFile> file, std::vector<Record> records);
+            ~TextureCacheFile();
+
+            /**
+             * Returns the record of the texture with the given key, or null if this file does not contain it.
+             */
+            const Record* find(const TextureCacheKey& key) const;
+
+            /**
+             * Creates a texture with the pixels of the given record. Can be called on any thread.
+             */
+            Assets::Texture* readTexture(const Record& record) const;
+
+            /**
+             * Creates a texture with the name, size and average color of the given record, but without its pixels.
+             */
+            Assets::Texture* readTextureInfo(const Record& record) const;
+        };
+
+        /**
+         * Stores decoded textures in a local cache directory so that texture collections need not be decoded again
+         * when they are loaded the next time. Each collection is cached in a separate file whose name is derived from
+         * the collection path and the signature, which must identify everything besides the texture files that
+         * affects the decoded textures, such as the texture format and the palette.
+         *
+         * Cache files are written to a temporary file first that then replaces the cache file, so several instances
+         * of the editor can share a cache directory. Cache files use the native byte order. Once the cache files in
+         * the directory exceed the maximum size, the least recently written ones are deleted.
+         */
+        class TextureCache {
+        public:
+            static const uint64_t DefaultMaximumSize;
+        private:
+            static const char Magic[4];
+            static const uint32_t Version;
+
+            Path m_directory;
+            String m_signature;
+            uint64_t m_maximumSize;
+        public:
+            TextureCache(const Path& directory, const String& signature, uint64_t maximumSize = DefaultMaximumSize);
+
+            /**
+             * Returns the path of the cache file of the given collection.
+             */
+            Path cacheFilePath(const Path& collectionPath) const;
+
+            /**
+             * Opens the cache file of the given collection. Returns null if there is no cache file, if it was written
+             * for another collection or signature, or if the size of a texture does not match the size of its pixels.
+             *
+             * @throw FileSystemException if the cache file is truncated or otherwise invalid
+             */
+            std::shared_ptr<const TextureCacheFile> read(const Path& collectionPath) const;
+
+            /**
+             * Writes the cache file of the given collection and deletes old cache files if the maximum size is
+             * exceeded. The given textures must not have been prepared yet and there must be one key for each texture.
+             *
+             * @throw FileSystemException if the cache file cannot be written
+             */
+            void write(const Path& collectionPath, const std::vector<TextureCacheKey>& keys, const std::vector<const Assets::Texture*>& textures) const;
+        private:
+            void deleteOldCacheFiles(const Path& keepPath) const;
+        };
+    }
+}
+
+#endif /* defined(TrenchBroom_TextureCache) */
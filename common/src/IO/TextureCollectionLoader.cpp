@@ -19,17 +19,24 @@
 
 #include "TextureCollectionLoader.h"
 
+#include "CollectionUtils.h"
+#include "Exceptions.h"
 #include "Logger.h"
+#include "ParallelUtils.h"
 #include "Assets/AssetTypes.h"
+#include "Assets/Texture.h"
 #include "Assets/TextureCollection.h"
 #include "Assets/TextureManager.h"
 #include "IO/DiskIO.h"
 #include "IO/FileMatcher.h"
 #include "IO/FileSystem.h"
+#include "IO/TextureCache.h"
 #include "IO/TextureReader.h"
 #include "IO/WadFileSystem.h"
 
+#include <algorithm>
 #include <cassert>
+#include <iterator>
 #include <memory>
 
 namespace TrenchBroom {
@@ -39,15 +46,166 @@ namespace TrenchBroom {
 
         TextureCollectionLoader::~TextureCollectionLoader() = default;
 
-        std::unique_ptr<Assets::TextureCollection> TextureCollectionLoader::loadTextureCollection(const Path& path, const StringList& textureExtensions, const TextureReader& textureReader) {
-            auto collection = std::make_unique<Assets::TextureCollection>(path);
+        static void findCachedTextures(const Path::List& paths, const std::vector<size_t>& filesEnd, const std::vector<TextureCacheKey>& cacheKeys, const TextureCache& textureCache, std::vector<std::shared_ptr<const TextureCacheFile>>& cacheFiles, std::vector<const TextureCacheFile::Record*>& cacheRecords, Logger& logger) {
+            size_t fileIndex = 0;
+            for (size_t i = 0; i < paths.size(); ++i) {
+                const auto fileBegin = fileIndex;
+                fileIndex = filesEnd[i];
 
-            for (auto file : doFindTextures(path, textureExtensions)) {
-                auto* texture = textureReader.readTexture(file);
-                collection->addTexture(texture);
+                if (fileBegin == fileIndex) {
+                    continue;
+                }
+
+                std::shared_ptr<const TextureCacheFile> cacheFile;
+                try {
+                    cacheFile = textureCache.read(paths[i]);
+                } catch (const Exception& e) {
+                    logger.warn() << "Ignoring texture cache of '" << paths[i] << "': " << e.what();
+                }
+
+                if (cacheFile == nullptr) {
+                    continue;
+                }
+
+                // a collection is only read from the cache if none of its files have changed
+                for (size_t j = fileBegin; j < fileIndex; ++j) {
+                    cacheRecords[j] = cacheFile->find(cacheKeys[j]);
+                    if (cacheRecords[j] == nullptr) {
+                        std::fill(std::next(std::begin(cacheRecords), static_cast<std::ptrdiff_t>(fileBegin)), std::next(std::begin(cacheRecords), static_cast<std::ptrdiff_t>(j)), nullptr);
+                        break;
+                    }
+                    cacheFiles[j] = cacheFile;
+                }
+
+                if (cacheRecords[fileBegin] == nullptr) {
+                    std::fill(std::next(std::begin(cacheFiles), static_cast<std::ptrdiff_t>(fileBegin)), std::next(std::begin(cacheFiles), static_cast<std::ptrdiff_t>(fileIndex)), nullptr);
+                }
+            }
+        }
+
+        static void writeCachedTextures(const Path& path, const size_t fileBegin, const size_t fileEnd, const std::vector<TextureCacheKey>& cacheKeys, const std::vector<std::unique_ptr<Assets::Texture>>& textures, const TextureCache& textureCache, Logger& logger) {
+            std::vector<TextureCacheKey> keys;
+            std::vector<const Assets::Texture*> cachedTextures;
+            for (size_t i = fileBegin; i < fileEnd; ++i) {
+                // textures that could not be read are skipped, so they are not cached either
+                if (textures[i] != nullptr) {
+                    keys.push_back(cacheKeys[i]);
+                    cachedTextures.push_back(textures[i].get());
+                }
+            }
+
+            try {
+                textureCache.write(path, keys, cachedTextures);
+            } catch (const Exception& e) {
+                logger.warn() << "Could not write texture cache of '" << path << "': " << e.what();
+            }
+        }
+
+        TextureCollectionLoader::ResultList TextureCollectionLoader::loadTextureCollections(const Path::List& paths, const StringList& textureExtensions, std::shared_ptr<const TextureReader> textureReader, const bool lazy, const TextureCache* textureCache) {
+            ResultList results(paths.size());
+
+            // Locate the files on this thread because the loaders log warnings and the file systems are not
+            // thread safe. All files are decoded in one batch so that small collections don't leave threads idle.
+            FileList files;
+            std::vector<size_t> filesEnd;
+            filesEnd.reserve(paths.size());
+
+            for (size_t i = 0; i < paths.size(); ++i) {
+                try {
+                    VectorUtils::append(files, doFindTextures(paths[i], textureExtensions));
+                } catch (const Exception& e) {
+                    results[i].error = e.what();
+                }
+                filesEnd.push_back(files.size());
+            }
+
+            std::vector<std::unique_ptr<Assets::Texture>> textures(files.size());
+            StringList errors(files.size());
+
+            // the cache file and the cached record of each texture file, both are null if the file must be decoded
+            std::vector<std::shared_ptr<const TextureCacheFile>> cacheFiles(files.size());
+            std::vector<const TextureCacheFile::Record*> cacheRecords(files.size(), nullptr);
+            std::vector<TextureCacheKey> cacheKeys;
+
+            const auto useCache = textureCache != nullptr && textureReader->canCache();
+            if (useCache) {
+                cacheKeys.resize(files.size());
+                ParallelUtils::parallelFor(files.size(), [&](const size_t i) {
+                    try {
+                        cacheKeys[i] = TextureCacheKey::compute(*files[i]);
+                    } catch (const Exception& e) {
+                        errors[i] = e.what();
+                    }
+                });
+
+                findCachedTextures(paths, filesEnd, cacheKeys, *textureCache, cacheFiles, cacheRecords, m_logger);
+            }
+
+            const auto decodeLazily = lazy && textureReader->canDecodeLazily();
+            ParallelUtils::parallelFor(files.size(), [&](const size_t i) {
+                if (!errors[i].empty()) {
+                    return;
+                }
+
+                try {
+                    const auto& cacheFile = cacheFiles[i];
+                    const auto* cacheRecord = cacheRecords[i];
+                    if (cacheRecord != nullptr) {
+                        if (lazy) {
+                            textures[i].reset(cacheFile->readTextureInfo(*cacheRecord));
+                            textures[i]->setDecoder([cacheFile, cacheRecord]() { return cacheFile->readTexture(*cacheRecord); });
+                        } else {
+                            textures[i].reset(cacheFile->readTexture(*cacheRecord));
+                        }
+                    } else if (decodeLazily) {
+                        const auto& file = files[i];
+                        textures[i].reset(textureReader->readTextureInfo(file));
+                        if (textures[i] != nullptr) {
+                            textures[i]->setDecoder([textureReader, file]() { return textureReader->readTexture(file); });
+                        }
+                    } else {
+                        textures[i].reset(textureReader->readTexture(files[i]));
+                    }
+                } catch (const Exception& e) {
+                    errors[i] = e.what();
+                }
+            });
+
+            size_t fileIndex = 0;
+            for (size_t i = 0; i < paths.size(); ++i) {
+                const auto fileBegin = fileIndex;
+                fileIndex = filesEnd[i];
+
+                if (!results[i].error.empty()) {
+                    continue;
+                }
+
+                const auto errorsBegin = std::next(std::begin(errors), static_cast<StringList::difference_type>(fileBegin));
+                const auto errorsEnd = std::next(std::begin(errors), static_cast<StringList::difference_type>(fileIndex));
+                const auto error = std::find_if(errorsBegin, errorsEnd, [](const String& e) { return !e.empty(); });
+                if (error != errorsEnd) {
+                    results[i].error = *error;
+                    continue;
+                }
+
+                // collections that are decoded lazily are only written to the cache once they are loaded eagerly
+                if (useCache && !decodeLazily && fileBegin < fileIndex && cacheRecords[fileBegin] == nullptr) {
+                    writeCachedTextures(paths[i], fileBegin, fileIndex, cacheKeys, textures, *textureCache, m_logger);
+                }
+
+                try {
+                    auto collection = std::make_unique<Assets::TextureCollection>(paths[i]);
+                    for (size_t j = fileBegin; j < fileIndex; ++j) {
+                        collection->addTexture(textures[j].get());
+                        textures[j].release();
+                    }
+                    results[i].collection = std::move(collection);
+                } catch (const Exception& e) {
+                    results[i].error = e.what();
+                }
             }
 
-            return collection;
+            return results;
         }
 
         FileTextureCollectionLoader::FileTextureCollectionLoader(Logger& logger, const IO::Path::List& searchPaths) :
@@ -30,6 +30,7 @@ namespace TrenchBroom {
     class Logger;
 
     namespace Assets {
+        class Texture;
         class TextureCollection;
         class TextureReader;
         class TextureManager;
@@ -38,9 +39,20 @@ namespace TrenchBroom {
     namespace IO {
         class File;
         class FileSystem;
+        class TextureCache;
         class TextureReader;
 
         class TextureCollectionLoader {
+        public:
+            /**
+             * The outcome of loading a single texture collection. If the collection could not be loaded, the
+             * collection is null and the error contains the reason.
+             */
+            struct Result {
+                std::unique_ptr<Assets::TextureCollection> collection;
+                String error;
+            };
+            using ResultList = std::vector<Result>;
         protected:
             using FileList = std::vector<std::shared_ptr<File>>;
         protected:
@@ -50,7 +62,28 @@ namespace TrenchBroom {
         public:
             virtual ~TextureCollectionLoader();
         public:
-            std::unique_ptr<Assets::TextureCollection> loadTextureCollection(const Path& path, const StringList& textureExtensions, const TextureReader& textureReader);
+            /**
+             * Loads the texture collections with the given paths. The texture files of all collections are located on
+             * the calling thread, and then all textures are decoded in parallel. The given texture reader must
+             * therefore support reading textures concurrently.
+             *
+             * A collection that cannot be loaded does not prevent the others from loading, its error is returned in
+             * the corresponding result instead.
+             *
+             * If lazy is true and the given reader supports it, only the name, size and average color of each texture
+             * is read, and the textures keep the reader and their file to decode their pixels on demand.
+             *
+             * If a texture cache is given, a collection whose texture files all match the cache is read from the
+             * cache instead of being decoded. Otherwise, the collection is decoded eagerly and written to the cache.
+             *
+             * @param paths the paths of the collections to load
+             * @param textureExtensions the extensions of the texture files to load
+             * @param textureReader the reader to decode the texture files with
+             * @param lazy whether to defer decoding the pixels until they are needed
+             * @param textureCache the cache to read the textures from and write them to, may be null
+             * @return the results, in the order of the given paths
+             */
+            ResultList loadTextureCollections(const Path::List& paths, const StringList& textureExtensions, std::shared_ptr<const TextureReader> textureReader, bool lazy, const TextureCache* textureCache);
         private:
             virtual FileList doFindTextures(const Path& path, const StringList& extensions) = 0;
         };
@@ -28,6 +28,7 @@
 #include "IO/HlMipTextureReader.h"
 #include "IO/IdMipTextureReader.h"
 #include "IO/Quake3ShaderTextureReader.h"
+#include "IO/TextureCache.h"
 #include "IO/WalTextureReader.h"
 #include "IO/FreeImageTextureReader.h"
 #include "IO/Path.h"
@@ -37,6 +38,7 @@ namespace TrenchBroom {
     namespace IO {
         TextureLoader::TextureLoader(const FileSystem& gameFS, const IO::Path::List& fileSearchPaths, const Model::GameConfig::TextureConfig& textureConfig, Logger& logger) :
         m_textureExtensions(getTextureExtensions(textureConfig)),
+        m_cacheSignature(getCacheSignature(gameFS, textureConfig)),
         m_textureReader(createTextureReader(gameFS, textureConfig, logger)),
         m_textureCollectionLoader(createTextureCollectionLoader(gameFS, fileSearchPaths, textureConfig, logger)) {
             ensure(m_textureReader != nullptr, "textureReader is null");
@@ -47,6 +49,25 @@ namespace TrenchBroom {
             return textureConfig.format.extensions;
         }
 
+        String TextureLoader::getCacheSignature(const FileSystem& gameFS, const Model::GameConfig::TextureConfig& textureConfig) {
+            // the texture format determines the reader and its name strategy, the palette determines the colors
+            StringStream signature;
+            signature << textureConfig.format.format << ":" << textureConfig.palette.asString('/');
+
+            if (!textureConfig.palette.isEmpty()) {
+                // a palette file with the same path may have different contents, e.g. in another game directory
+                try {
+                    const auto palette = TextureCacheKey::compute(*gameFS.openFile(textureConfig.palette));
+                    signature << ":" << std::hex << palette.size << ":" << palette.hash;
+                } catch (const Exception&) {
+                    // the palette cannot be loaded, so the textures are read without it
+                    signature << ":missing";
+                }
+            }
+
+            return signature.str();
+        }
+
         std::unique_ptr<TextureReader> TextureLoader::createTextureReader(const FileSystem& gameFS, const Model::GameConfig::TextureConfig& textureConfig, Logger& logger) {
             if (textureConfig.format.format == "idmip") {
                 TextureReader::PathSuffixNameStrategy nameStrategy(1, true);
@@ -96,8 +117,13 @@ namespace TrenchBroom {
             }
         }
 
-        std::unique_ptr<Assets::TextureCollection> TextureLoader::loadTextureCollection(const Path& path) {
-            return m_textureCollectionLoader->loadTextureCollection(path, m_textureExtensions, *m_textureReader);
+        TextureCollectionLoader::ResultList TextureLoader::loadTextureCollections(const Path::List& paths, const bool lazy, const Path& cacheDirectory) {
+            if (cacheDirectory.isEmpty()) {
+                return m_textureCollectionLoader->loadTextureCollections(paths, m_textureExtensions, m_textureReader, lazy, nullptr);
+            } else {
+                const TextureCache textureCache(cacheDirectory, m_cacheSignature);
+                return m_textureCollectionLoader->loadTextureCollections(paths, m_textureExtensions, m_textureReader, lazy, &textureCache);
+            }
         }
 
         void TextureLoader::loadTextures(const Path::List& paths, Assets::TextureManager& textureManager) {
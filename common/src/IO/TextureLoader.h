@@ -47,17 +47,25 @@ namespace TrenchBroom {
         class TextureLoader {
         private:
             StringList m_textureExtensions;
-            std::unique_ptr<TextureReader> m_textureReader;
+            String m_cacheSignature;
+            std::shared_ptr<TextureReader> m_textureReader;
             std::unique_ptr<TextureCollectionLoader> m_textureCollectionLoader;
         public:
             TextureLoader(const FileSystem& gameFS, const IO::Path::List& fileSearchPaths, const Model::GameConfig::TextureConfig& textureConfig, Logger& logger);
         private:
             static StringList getTextureExtensions(const Model::GameConfig::TextureConfig& textureConfig);
+            static String getCacheSignature(const FileSystem& gameFS, const Model::GameConfig::TextureConfig& textureConfig);
             static std::unique_ptr<TextureReader> createTextureReader(const FileSystem& gameFS, const Model::GameConfig::TextureConfig& textureConfig, Logger& logger);
             static Assets::Palette loadPalette(const FileSystem& gameFS, const Model::GameConfig::TextureConfig& textureConfig, Logger& logger);
             static std::unique_ptr<TextureCollectionLoader> createTextureCollectionLoader(const FileSystem& gameFS, const IO::Path::List& fileSearchPaths, const Model::GameConfig::TextureConfig& textureConfig, Logger& logger);
         public:
-            std::unique_ptr<Assets::TextureCollection> loadTextureCollection(const Path& path);
+            /**
+             * Loads the texture collections with the given paths, decoding their textures in parallel or, if lazy is
+             * true, on demand. If a cache directory is given, decoded textures are cached there.
+             *
+             * @see TextureCollectionLoader::loadTextureCollections
+             */
+            TextureCollectionLoader::ResultList loadTextureCollections(const Path::List& paths, bool lazy, const Path& cacheDirectory = Path());
             void loadTextures(const Path::List& paths, Assets::TextureManager& textureManager);
 
             deleteCopyAndMove(TextureLoader)
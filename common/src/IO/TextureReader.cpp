@@ -86,6 +86,30 @@ namespace TrenchBroom {
             return doReadTexture(file);
         }
 
+        Assets::Texture* TextureReader::readTextureInfo(std::shared_ptr<File> file) const {
+            return doReadTextureInfo(file);
+        }
+
+        bool TextureReader::canDecodeLazily() const {
+            return doCanDecodeLazily();
+        }
+
+        bool TextureReader::canCache() const {
+            return doCanCache();
+        }
+
+        Assets::Texture* TextureReader::doReadTextureInfo(std::shared_ptr<File> file) const {
+            return doReadTexture(file);
+        }
+
+        bool TextureReader::doCanDecodeLazily() const {
+            return true;
+        }
+
+        bool TextureReader::doCanCache() const {
+            return true;
+        }
+
         String TextureReader::textureName(const String& textureName, const Path& path) const {
             return m_nameStrategy->textureName(textureName, path);
         }
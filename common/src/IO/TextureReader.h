@@ -90,6 +90,27 @@ namespace TrenchBroom {
             virtual ~TextureReader();
 
             Assets::Texture* readTexture(std::shared_ptr<File> file) const;
+
+            /**
+             * Reads the name, size and average color of the texture in the given file without decoding its pixels,
+             * if this reader supports that. The pixels can be decoded later by calling readTexture.
+             *
+             * @param file the file containing the texture
+             * @return an Assets::Texture object allocated with new, which may not contain any pixel data
+             */
+            Assets::Texture* readTextureInfo(std::shared_ptr<File> file) const;
+
+            /**
+             * Indicates whether this reader can decode a texture at any time after the texture collection was loaded.
+             * Readers that depend on objects with a shorter lifetime, such as a file system, cannot.
+             */
+            bool canDecodeLazily() const;
+
+            /**
+             * Indicates whether the textures read by this reader can be cached. This requires that a texture only
+             * depends on the contents of its file and on the configuration of this reader.
+             */
+            bool canCache() const;
         protected:
             String textureName(const String& textureName, const Path& path) const;
             String textureName(const Path& path) const;
@@ -103,6 +124,13 @@ namespace TrenchBroom {
              * @return an Assets::Texture object allocated with new
              */
             virtual Assets::Texture* doReadTexture(std::shared_ptr<File> file) const = 0;
+
+            /**
+             * Reads the texture without decoding its pixels. The default implementation reads the entire texture.
+             */
+            virtual Assets::Texture* doReadTextureInfo(std::shared_ptr<File> file) const;
+            virtual bool doCanDecodeLazily() const;
+            virtual bool doCanCache() const;
         protected:
             static bool checkTextureDimensions(size_t width, size_t height);
         public:
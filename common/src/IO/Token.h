@@ -22,7 +22,9 @@
 
 #include "StringUtils.h"
 
+#include <algorithm>
 #include <cassert>
+#include <charconv>
 #include <cstdlib>
 #include <cstring>
 
@@ -92,27 +94,63 @@ namespace TrenchBroom {
                 return m_column;
             }
 
+            /**
+             * Parses this token as a floating point number in the same way as std::atof.
+             */
             template <typename T>
             T toFloat() const {
-                static const size_t BufferSize = 256;
-                static char buffer[BufferSize];
-                assert(length() < BufferSize);
-
-                memcpy(buffer, m_begin, length());
-                buffer[length()] = 0;
-                const T f = static_cast<T>(std::atof(buffer));
-                return f;
+#ifdef __cpp_lib_to_chars
+                double value = 0.0;
+                if (parseNumber(value)) {
+                    return static_cast<T>(value);
+                }
+#endif
+                char buffer[BufferSize];
+                return static_cast<T>(std::atof(copyToBuffer(buffer)));
             }
 
+            /**
+             * Parses this token as an integer in the same way as std::atoi.
+             */
             template <typename T>
             T toInteger() const {
-                static char buffer[64];
-                assert(length() < 64);
+                int value = 0;
+                if (parseNumber(value)) {
+                    return static_cast<T>(value);
+                }
+
+                char buffer[BufferSize];
+                return static_cast<T>(std::atoi(copyToBuffer(buffer)));
+            }
+        private:
+            static const size_t BufferSize = 256;
 
-                memcpy(buffer, m_begin, length());
-                buffer[length()] = 0;
-                const T i = static_cast<T>(std::atoi(buffer));
-                return i;
+            /**
+             * Parses the entire token without copying it. Returns false if the token is not a plain number, in which
+             * case the caller falls back to the C library functions to handle all other inputs in the same way as
+             * before, e.g. hexadecimal numbers or trailing garbage.
+             */
+            template <typename T>
+            bool parseNumber(T& value) const {
+                const auto* begin = m_begin;
+                // the C library functions accept a leading plus sign, from_chars does not
+                if (begin != m_end && *begin == '+') {
+                    ++begin;
+                    if (begin != m_end && *begin == '-') {
+                        return false;
+                    }
+                }
+
+                const auto result = std::from_chars(begin, m_end, value);
+                return result.ec == std::errc() && result.ptr == m_end;
+            }
+
+            const char* copyToBuffer(char (&buffer)[BufferSize]) const {
+                assert(length() < BufferSize);
+                const auto count = std::min(length(), BufferSize - 1);
+                memcpy(buffer, m_begin, count);
+                buffer[count] = 0;
+                return buffer;
             }
         };
     }
@@ -19,15 +19,18 @@
 
 #include "Tokenizer.h"
 
+#include <algorithm>
+
 namespace TrenchBroom {
     namespace IO {
-        TokenizerState::TokenizerState(const char* begin, const char* end, const String& escapableChars, const char escapeChar) :
+        TokenizerState::TokenizerState(const char* begin, const char* end, const String& escapableChars, const char escapeChar, const size_t firstLine) :
         m_begin(begin),
         m_cur(m_begin),
         m_end(end),
         m_escapableChars(escapableChars),
         m_escapeChar(escapeChar),
-        m_line(1),
+        m_firstLine(firstLine),
+        m_line(m_firstLine),
         m_column(1),
         m_escaped(false) {}
 
@@ -131,9 +134,29 @@ namespace TrenchBroom {
             ++m_cur;
         }
 
+        void TokenizerState::advanceColumns(const size_t offset) {
+            assert(m_cur + offset <= m_end);
+            assert(std::none_of(m_cur, m_cur + offset, [](const char c) { return c == '\n' || c == '\r'; }));
+
+            // every escape character toggles the escaped state, and any other character resets it
+            size_t escapeChars = 0;
+            while (escapeChars < offset && m_cur[offset - escapeChars - 1] == m_escapeChar) {
+                ++escapeChars;
+            }
+
+            if (escapeChars < offset) {
+                m_escaped = escapeChars % 2 == 1;
+            } else if (escapeChars % 2 == 1) {
+                m_escaped = !m_escaped;
+            }
+
+            m_cur += offset;
+            m_column += offset;
+        }
+
         void TokenizerState::reset() {
             m_cur = m_begin;
-            m_line = 1;
+            m_line = m_firstLine;
             m_column = 1;
             m_escaped = false;
         }
@@ -36,11 +36,12 @@ namespace TrenchBroom {
             const char* m_end;
             String m_escapableChars;
             char m_escapeChar;
+            size_t m_firstLine;
             size_t m_line;
             size_t m_column;
             bool m_escaped;
         public:
-            TokenizerState(const char* begin, const char* end, const String& escapableChars, char escapeChar);
+            TokenizerState(const char* begin, const char* end, const String& escapableChars, char escapeChar, size_t firstLine = 1);
 
             TokenizerState* clone(const char* begin, const char* end) const;
 
@@ -67,6 +68,11 @@ namespace TrenchBroom {
 
             void advance(const size_t offset);
             void advance();
+            /**
+             * Advances by the given number of characters, none of which may be a line break. This is much faster than
+             * advancing character by character.
+             */
+            void advanceColumns(const size_t offset);
             void reset();
 
             void errorIfEof() const;
@@ -107,8 +113,8 @@ namespace TrenchBroom {
                 return whitespace;
             }
         public:
-            Tokenizer(const char* begin, const char* end, const String& escapableChars, const char escapeChar) :
-            m_state(std::make_shared<TokenizerState>(begin, end, escapableChars, escapeChar)) {}
+            Tokenizer(const char* begin, const char* end, const String& escapableChars, const char escapeChar, const size_t firstLine = 1) :
+            m_state(std::make_shared<TokenizerState>(begin, end, escapableChars, escapeChar, firstLine)) {}
 
             Tokenizer(const String& str, const String& escapableChars, const char escapeChar) :
             m_state(std::make_shared<TokenizerState>(str.c_str(), str.c_str() + str.size(), escapableChars, escapeChar)) {}
@@ -224,6 +230,10 @@ namespace TrenchBroom {
                 return m_state->curPos();
             }
 
+            const char* endPos() const {
+                return m_state->end();
+            }
+
             char curChar() const {
                 if (eof()) {
                     return 0;
@@ -244,6 +254,10 @@ namespace TrenchBroom {
                 m_state->advance();
             }
 
+            void advanceColumns(const size_t offset) {
+                m_state->advanceColumns(offset);
+            }
+
             bool isDigit(const char c) const {
                 return c >= '0' && c <= '9';
             }
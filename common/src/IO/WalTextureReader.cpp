@@ -35,6 +35,14 @@ namespace TrenchBroom {
         m_palette(palette) {}
 
         Assets::Texture* WalTextureReader::doReadTexture(std::shared_ptr<File> file) const {
+            return readWal(file, false);
+        }
+
+        Assets::Texture* WalTextureReader::doReadTextureInfo(std::shared_ptr<File> file) const {
+            return readWal(file, true);
+        }
+
+        Assets::Texture* WalTextureReader::readWal(std::shared_ptr<File> file, const bool infoOnly) const {
             const auto& path = file->path();
             auto reader = file->reader();
 
@@ -43,20 +51,20 @@ namespace TrenchBroom {
                 reader.seekFromBegin(0);
 
                 if (version == 3) {
-                    return readDkWal(reader, path);
+                    return readDkWal(reader, path, infoOnly);
                 } else {
-                    return readQ2Wal(reader, path);
+                    return readQ2Wal(reader, path, infoOnly);
                 }
             } catch (const ReaderException&) {
                 return new Assets::Texture(textureName(path), 16, 16);
             }
         }
 
-        Assets::Texture* WalTextureReader::readQ2Wal(Reader& reader, const Path& path) const {
+        Assets::Texture* WalTextureReader::readQ2Wal(Reader& reader, const Path& path, const bool infoOnly) const {
             static const size_t MaxMipLevels = 4;
-            static Color tempColor, averageColor;
-            static Assets::TextureBuffer::List buffers(MaxMipLevels);
-            static size_t offsets[MaxMipLevels];
+            Color averageColor;
+            Assets::TextureBuffer::List buffers(MaxMipLevels);
+            size_t offsets[MaxMipLevels];
 
             const String name = reader.readString(WalLayout::TextureNameLength);
             const size_t width = reader.readSize<uint32_t>();
@@ -71,16 +79,21 @@ namespace TrenchBroom {
             }
 
             const auto mipLevels = readMipOffsets(MaxMipLevels, offsets, width, height, reader);
+            if (infoOnly) {
+                readAverageColor(m_palette, mipLevels, offsets, width, height, reader, averageColor, Assets::PaletteTransparency::Opaque);
+                return new Assets::Texture(textureName(name, path), width, height, averageColor, GL_RGBA, Assets::TextureType::Opaque);
+            }
+
             Assets::setMipBufferSize(buffers, mipLevels, width, height, GL_RGBA);
             readMips(m_palette, mipLevels, offsets, width, height, reader, buffers, averageColor, Assets::PaletteTransparency::Opaque);
             return new Assets::Texture(textureName(name, path), width, height, averageColor, buffers, GL_RGBA, Assets::TextureType::Opaque);
         }
 
-        Assets::Texture* WalTextureReader::readDkWal(Reader& reader, const Path& path) const {
+        Assets::Texture* WalTextureReader::readDkWal(Reader& reader, const Path& path, const bool infoOnly) const {
             static const size_t MaxMipLevels = 9;
-            static Color tempColor, averageColor;
-            static Assets::TextureBuffer::List buffers(MaxMipLevels);
-            static size_t offsets[MaxMipLevels];
+            Color averageColor;
+            Assets::TextureBuffer::List buffers(MaxMipLevels);
+            size_t offsets[MaxMipLevels];
 
             const char version = reader.readChar<char>();
             ensure(version == 3, "Unknown WAL texture version");
@@ -96,12 +109,19 @@ namespace TrenchBroom {
             }
 
             const auto mipLevels = readMipOffsets(MaxMipLevels, offsets, width, height, reader);
-            Assets::setMipBufferSize(buffers, mipLevels, width, height, GL_RGBA);
 
             reader.seekForward(32 + 2 * sizeof(uint32_t)); // animation name, flags, contents
 
             auto paletteReader = reader.subReaderFromCurrent(3 * 256);
             const auto embeddedPalette = Assets::Palette::fromRaw(paletteReader);
+
+            if (infoOnly) {
+                // the texture type is determined from the full size image once the texture is decoded
+                const auto hasTransparency = readAverageColor(embeddedPalette, mipLevels, offsets, width, height, reader, averageColor, Assets::PaletteTransparency::Index255Transparent);
+                return new Assets::Texture(textureName(name, path), width, height, averageColor, GL_RGBA, hasTransparency ? Assets::TextureType::Masked : Assets::TextureType::Opaque);
+            }
+
+            Assets::setMipBufferSize(buffers, mipLevels, width, height, GL_RGBA);
             const auto hasTransparency = readMips(embeddedPalette, mipLevels, offsets, width, height, reader, buffers, averageColor, Assets::PaletteTransparency::Index255Transparent);
             return new Assets::Texture(textureName(name, path), width, height, averageColor, buffers, GL_RGBA, hasTransparency ? Assets::TextureType::Masked : Assets::TextureType::Opaque);
         }
@@ -123,7 +143,7 @@ namespace TrenchBroom {
         }
 
         bool WalTextureReader::readMips(const Assets::Palette& palette, const size_t mipLevels, const size_t offsets[], const size_t width, const size_t height, Reader& reader, Assets::TextureBuffer::List& buffers, Color& averageColor, const Assets::PaletteTransparency transparency) {
-            static Color tempColor;
+            Color tempColor;
 
             auto hasTransparency = false;
             for (size_t i = 0; i < mipLevels; ++i) {
@@ -147,5 +167,19 @@ namespace TrenchBroom {
             }
             return hasTransparency;
         }
+
+        bool WalTextureReader::readAverageColor(const Assets::Palette& palette, const size_t mipLevels, const size_t offsets[], const size_t width, const size_t height, Reader& reader, Color& averageColor, const Assets::PaletteTransparency transparency) {
+            // approximate the average color using the smallest mip level
+            const auto level = mipLevels - 1;
+            const auto size = mipSize(width, height, level);
+
+            reader.seekFromBegin(offsets[level]);
+            if (!reader.canRead(size)) {
+                return false;
+            }
+
+            Assets::TextureBuffer buffer(4 * size);
+            return palette.indexedToRgba(reader, size, buffer, transparency, averageColor);
+        }
     }
 }
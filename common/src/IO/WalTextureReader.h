@@ -32,15 +32,18 @@ namespace TrenchBroom {
 
         class WalTextureReader : public TextureReader {
         private:
-            mutable Assets::Palette m_palette;
+            Assets::Palette m_palette;
         public:
             WalTextureReader(const NameStrategy& nameStrategy, const Assets::Palette& palette = Assets::Palette());
         private:
             Assets::Texture* doReadTexture(std::shared_ptr<File> file) const override;
-            Assets::Texture* readQ2Wal(Reader& reader, const Path& path) const;
-            Assets::Texture* readDkWal(Reader& reader, const Path& path) const;
+            Assets::Texture* doReadTextureInfo(std::shared_ptr<File> file) const override;
+            Assets::Texture* readWal(std::shared_ptr<File> file, bool infoOnly) const;
+            Assets::Texture* readQ2Wal(Reader& reader, const Path& path, bool infoOnly) const;
+            Assets::Texture* readDkWal(Reader& reader, const Path& path, bool infoOnly) const;
             size_t readMipOffsets(size_t maxMipLevels, size_t offsets[], size_t width, size_t height, Reader& reader) const;
             static bool readMips(const Assets::Palette& palette, size_t mipLevels, const size_t offsets[], size_t width, size_t height, Reader& reader, Assets::TextureBuffer::List& buffers, Color& averageColor, Assets::PaletteTransparency transparency);
+            static bool readAverageColor(const Assets::Palette& palette, size_t mipLevels, const size_t offsets[], size_t width, size_t height, Reader& reader, Color& averageColor, Assets::PaletteTransparency transparency);
         };
     }
 }
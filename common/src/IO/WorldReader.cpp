@@ -26,6 +26,8 @@
 
 namespace TrenchBroom {
     namespace IO {
+        const size_t WorldReader::DefaultChunkSize = 256 * 1024;
+
         WorldReader::WorldReader(const char* begin, const char* end) :
         MapReader(begin, end) {}
 
@@ -34,6 +36,15 @@ namespace TrenchBroom {
 
         std::unique_ptr<Model::World> WorldReader::read(Model::MapFormat format, const vm::bbox3& worldBounds, ParserStatus& status) {
             readEntities(format, worldBounds, status);
+            return releaseWorld();
+        }
+
+        std::unique_ptr<Model::World> WorldReader::readInParallel(const Model::MapFormat format, const vm::bbox3& worldBounds, ParserStatus& status, const size_t chunkSize) {
+            readEntitiesInParallel(format, worldBounds, status, chunkSize);
+            return releaseWorld();
+        }
+
+        std::unique_ptr<Model::World> WorldReader::releaseWorld() {
             m_world->rebuildNodeTree();
             m_world->enableNodeTreeUpdates();
             return std::move(m_world);
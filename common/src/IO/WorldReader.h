@@ -29,12 +29,29 @@ namespace TrenchBroom {
         class ParserStatus;
 
         class WorldReader : public MapReader {
+        public:
+            /**
+             * The default number of bytes of the input that are parsed by a single worker in readInParallel.
+             */
+            static const size_t DefaultChunkSize;
+        private:
             std::unique_ptr<Model::World> m_world;
         public:
             WorldReader(const char* begin, const char* end);
             WorldReader(const String& str);
 
             std::unique_ptr<Model::World> read(Model::MapFormat format, const vm::bbox3& worldBounds, ParserStatus& status);
+
+            /**
+             * Reads the world like read, but parses the input and builds the brushes on worker threads. The resulting
+             * world is the same as the one returned by read.
+             */
+            std::unique_ptr<Model::World> readInParallel(Model::MapFormat format, const vm::bbox3& worldBounds, ParserStatus& status, size_t chunkSize = DefaultChunkSize);
+        protected:
+            /**
+             * Enables the node tree of the world that has been read and returns the world.
+             */
+            std::unique_ptr<Model::World> releaseWorld();
         private: // implement MapReader interface
             Model::ModelFactory& initialize(Model::MapFormat format, const vm::bbox3& worldBounds) override;
             Model::Node* onWorldspawn(const Model::EntityAttribute::List& attributes, const ExtraAttributes& extraAttributes, ParserStatus& status) override;
@@ -0,0 +1,115 @@
+/*
+ Copyright (C) 2010-2019 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "AttributableLinkIndex.h"
+
+#include "CollectionUtils.h"
+
+#include <algorithm>
+#include <cassert>
+
+namespace TrenchBroom {
+    namespace Model {
+        bool AttributableLinkIndex::Entry::empty() const {
+            return targets.empty() && linkSources.empty() && killSources.empty();
+        }
+
+        bool AttributableLinkIndex::isLinkAttribute(const AttributeName& name) {
+            return (name == AttributeNames::Targetname ||
+                    isNumberedAttribute(AttributeNames::Target, name) ||
+                    isNumberedAttribute(AttributeNames::Killtarget, name));
+        }
+
+        void AttributableLinkIndex::addAttribute(AttributableNode* attributable, const AttributeName& name, const AttributeValue& value) {
+            if (!isLinkAttribute(name)) {
+                return;
+            }
+
+            auto& entry = m_entries[value];
+            auto* list = findList(entry, name);
+            list->push_back(attributable);
+        }
+
+        void AttributableLinkIndex::removeAttribute(AttributableNode* attributable, const AttributeName& name, const AttributeValue& value) {
+            if (!isLinkAttribute(name)) {
+                return;
+            }
+
+            auto entryIt = m_entries.find(value);
+            if (entryIt == std::end(m_entries)) {
+                return;
+            }
+
+            // only remove one occurrence, the node might have another attribute with the same value
+            auto& entry = entryIt->second;
+            auto* list = findList(entry, name);
+            auto it = std::find(std::begin(*list), std::end(*list), attributable);
+            if (it != std::end(*list)) {
+                *it = list->back();
+                list->pop_back();
+            }
+
+            if (entry.empty()) {
+                m_entries.erase(entryIt);
+            }
+        }
+
+        void AttributableLinkIndex::findLinkTargets(const AttributeValue& targetname, AttributableNodeList& result) const {
+            const auto it = m_entries.find(targetname);
+            if (it != std::end(m_entries)) {
+                VectorUtils::append(result, it->second.targets);
+            }
+        }
+
+        void AttributableLinkIndex::findLinkSources(const AttributeValue& targetname, AttributableNodeList& result) const {
+            const auto it = m_entries.find(targetname);
+            if (it != std::end(m_entries)) {
+                appendUnique(it->second.linkSources, result);
+            }
+        }
+
+        void AttributableLinkIndex::findKillSources(const AttributeValue& targetname, AttributableNodeList& result) const {
+            const auto it = m_entries.find(targetname);
+            if (it != std::end(m_entries)) {
+                appendUnique(it->second.killSources, result);
+            }
+        }
+
+        AttributableNodeList* AttributableLinkIndex::findList(Entry& entry, const AttributeName& name) {
+            if (name == AttributeNames::Targetname) {
+                return &entry.targets;
+            } else if (isNumberedAttribute(AttributeNames::Target, name)) {
+                return &entry.linkSources;
+            } else {
+                assert(isNumberedAttribute(AttributeNames::Killtarget, name));
+                return &entry.killSources;
+            }
+        }
+
+        void AttributableLinkIndex::appendUnique(const AttributableNodeList& nodes, AttributableNodeList& result) {
+            if (nodes.size() < 2) {
+                VectorUtils::append(result, nodes);
+            } else {
+                AttributableNodeList unique = nodes;
+                VectorUtils::sortAndRemoveDuplicates(unique);
+                VectorUtils::append(result, unique);
+            }
+        }
+    }
+}
@@ -0,0 +1,84 @@
+/*
+ Copyright (C) 2010-2019 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef TrenchBroom_AttributableLinkIndex
+#define TrenchBroom_AttributableLinkIndex
+
+#include "Model/EntityAttributes.h"
+#include "Model/ModelTypes.h"
+
+#include <unordered_map>
+
+namespace TrenchBroom {
+    namespace Model {
+        /**
+         * Maps targetnames to the attributable nodes that link to them and the attributable nodes that they name.
+         *
+         * Only the targetname, numbered target and numbered killtarget attributes are indexed, all other attributes
+         * are ignored. The index is updated with every change to these attributes, so resolving the links of a node
+         * only costs a hash lookup per link instead of a query of the attributable node index.
+         */
+        class AttributableLinkIndex {
+        private:
+            struct Entry {
+                // the nodes whose targetname attribute has the key as its value
+                AttributableNodeList targets;
+                // the nodes that have a numbered target or killtarget attribute with the key as its value, once per
+                // attribute
+                AttributableNodeList linkSources;
+                AttributableNodeList killSources;
+
+                bool empty() const;
+            };
+
+            using EntryMap = std::unordered_map<AttributeValue, Entry>;
+            EntryMap m_entries;
+        public:
+            /**
+             * Indicates whether the given attribute name is a targetname, numbered target or numbered killtarget.
+             */
+            static bool isLinkAttribute(const AttributeName& name);
+
+            void addAttribute(AttributableNode* attributable, const AttributeName& name, const AttributeValue& value);
+            void removeAttribute(AttributableNode* attributable, const AttributeName& name, const AttributeValue& value);
+
+            /**
+             * Appends the nodes whose targetname is the given value to the given list.
+             */
+            void findLinkTargets(const AttributeValue& targetname, AttributableNodeList& result) const;
+
+            /**
+             * Appends the nodes that have a numbered target attribute with the given value to the given list. Every
+             * node is only appended once.
+             */
+            void findLinkSources(const AttributeValue& targetname, AttributableNodeList& result) const;
+
+            /**
+             * Appends the nodes that have a numbered killtarget attribute with the given value to the given list.
+             * Every node is only appended once.
+             */
+            void findKillSources(const AttributeValue& targetname, AttributableNodeList& result) const;
+        private:
+            static AttributableNodeList* findList(Entry& entry, const AttributeName& name);
+            static void appendUnique(const AttributableNodeList& nodes, AttributableNodeList& result);
+        };
+    }
+}
+
+#endif /* defined(TrenchBroom_AttributableLinkIndex) */
@@ -167,7 +167,11 @@ namespace TrenchBroom {
         }
 
         const AttributeValue& AttributableNode::classname(const AttributeValue& defaultClassname) const {
-            return m_classname.empty() ? defaultClassname : m_classname;
+            return m_classname.empty() ? defaultClassname : m_classname.str();
+        }
+
+        const InternedString& AttributableNode::internedClassname() const {
+            return m_classname;
         }
 
         EntityAttributeSnapshot AttributableNode::attributeSnapshot(const AttributeName& name) const {
@@ -182,15 +186,16 @@ namespace TrenchBroom {
             const NotifyAttributeChange notifyChange(this);
 
             const Assets::AttributeDefinition* definition = Assets::EntityDefinition::safeGetAttributeDefinition(m_definition, name);
-            const AttributeValue* oldValue = m_attributes.attribute(name);
+            const EntityAttribute* oldAttribute = m_attributes.entityAttribute(name);
+            const AttributeValue* oldValue = oldAttribute != nullptr ? &oldAttribute->value() : nullptr;
             if (oldValue != nullptr) {
                 attributeWillChangeNotifier(this, name);
-                removeAttributeFromIndex(name, *oldValue);
+                removeAttributeFromIndex(*oldAttribute);
                 removeLinks(name, *oldValue);
             }
 
-            m_attributes.addOrUpdateAttribute(name, value, definition);
-            addAttributeToIndex(name, value);
+            const EntityAttribute& attribute = m_attributes.addOrUpdateAttribute(name, value, definition);
+            addAttributeToIndex(attribute);
             addLinks(name, value);
 
             if (oldValue == nullptr)
@@ -206,11 +211,12 @@ namespace TrenchBroom {
             if (name == newName)
                 return;
 
-            const AttributeValue* valuePtr = m_attributes.attribute(name);
-            if (valuePtr == nullptr)
+            const EntityAttribute* attributePtr = m_attributes.entityAttribute(name);
+            if (attributePtr == nullptr)
                 return;
 
-            const AttributeValue value = *valuePtr;
+            const EntityAttribute oldAttribute = *attributePtr;
+            const AttributeValue& value = oldAttribute.value();
 			const NotifyAttributeChange notifyChange(this);
 
             const Assets::AttributeDefinition* newDefinition = Assets::EntityDefinition::safeGetAttributeDefinition(m_definition, newName);
@@ -218,7 +224,7 @@ namespace TrenchBroom {
             attributeWillBeRemovedNotifier(this, name);
             m_attributes.renameAttribute(name, newName, newDefinition);
 
-            updateAttributeIndex(name, value, newName, value);
+            updateAttributeIndex(oldAttribute, *m_attributes.entityAttribute(newName));
             updateLinks(name, value, newName, value);
             attributeWasAddedNotifier(this, newName);
         }
@@ -228,18 +234,18 @@ namespace TrenchBroom {
         }
 
         void AttributableNode::removeAttribute(const AttributeName& name) {
-            const AttributeValue* valuePtr = m_attributes.attribute(name);
-            if (valuePtr == nullptr)
+            const EntityAttribute* attributePtr = m_attributes.entityAttribute(name);
+            if (attributePtr == nullptr)
                 return;
 
             attributeWillBeRemovedNotifier(this, name);
             const NotifyAttributeChange notifyChange(this);
 
-            const AttributeValue value = *valuePtr;
+            const EntityAttribute attribute = *attributePtr;
             m_attributes.removeAttribute(name);
 
-            removeAttributeFromIndex(name, value);
-            removeLinks(name, value);
+            removeAttributeFromIndex(attribute);
+            removeLinks(name, attribute.value());
         }
 
         void AttributableNode::removeNumberedAttribute(const AttributeName& prefix) {
@@ -247,13 +253,13 @@ namespace TrenchBroom {
             if (!attributes.empty()) {
                 const NotifyAttributeChange notifyChange(this);
 
-                for (const EntityAttribute& attribute : m_attributes.attributes()) {
+                for (const EntityAttribute& attribute : attributes) {
                     const AttributeName& name = attribute.name();
                     const AttributeValue& value = attribute.value();
 
                     attributeWillBeRemovedNotifier(this, name);
                     m_attributes.removeAttribute(name);
-                    removeAttributeFromIndex(name, value);
+                    removeAttributeFromIndex(attribute);
                     removeLinks(name, value);
                 }
             }
@@ -287,17 +293,18 @@ namespace TrenchBroom {
         }
 
         void AttributableNode::updateClassname() {
-            m_classname = attribute(AttributeNames::Classname);
+            const EntityAttribute* classname = m_attributes.entityAttribute(AttributeNames::Classname);
+            m_classname = classname != nullptr ? classname->internedValue() : InternedString();
         }
 
         void AttributableNode::addAttributesToIndex() {
             for (const EntityAttribute& attribute : m_attributes.attributes())
-                addAttributeToIndex(attribute.name(), attribute.value());
+                addAttributeToIndex(attribute);
         }
 
         void AttributableNode::removeAttributesFromIndex() {
             for (const EntityAttribute& attribute : m_attributes.attributes())
-                removeAttributeFromIndex(attribute.name(), attribute.value());
+                removeAttributeFromIndex(attribute);
         }
 
         void AttributableNode::updateAttributeIndex(const EntityAttribute::List& newAttributes) {
@@ -318,41 +325,41 @@ namespace TrenchBroom {
 
                 const int cmp = oldAttr.compare(newAttr);
                 if (cmp < 0) {
-                    removeAttributeFromIndex(oldAttr.name(), oldAttr.value());
+                    removeAttributeFromIndex(oldAttr);
                     ++oldIt;
                 } else if (cmp > 0) {
-                    addAttributeToIndex(newAttr.name(), newAttr.value());
+                    addAttributeToIndex(newAttr);
                     ++newIt;
                 } else {
-                    updateAttributeIndex(oldAttr.name(), oldAttr.value(), newAttr.name(), newAttr.value());
+                    updateAttributeIndex(oldAttr, newAttr);
                     ++oldIt; ++newIt;
                 }
             }
 
             while (oldIt != oldEnd) {
                 const EntityAttribute& oldAttr = *oldIt;
-                removeAttributeFromIndex(oldAttr.name(), oldAttr.value());
+                removeAttributeFromIndex(oldAttr);
                 ++oldIt;
             }
 
             while (newIt != newEnd) {
                 const EntityAttribute& newAttr = *newIt;
-                addAttributeToIndex(newAttr.name(), newAttr.value());
+                addAttributeToIndex(newAttr);
                 ++newIt;
             }
         }
 
-        void AttributableNode::addAttributeToIndex(const AttributeName& name, const AttributeValue& value) {
-            addToIndex(this, name, value);
+        void AttributableNode::addAttributeToIndex(const EntityAttribute& attribute) {
+            addToIndex(this, attribute);
         }
 
-        void AttributableNode::removeAttributeFromIndex(const AttributeName& name, const AttributeValue& value) {
-            removeFromIndex(this, name, value);
+        void AttributableNode::removeAttributeFromIndex(const EntityAttribute& attribute) {
+            removeFromIndex(this, attribute);
         }
 
-        void AttributableNode::updateAttributeIndex(const AttributeName& oldName, const AttributeValue& oldValue, const AttributeName& newName, const AttributeValue& newValue) {
-            removeFromIndex(this, oldName, oldValue);
-            addToIndex(this, newName, newValue);
+        void AttributableNode::updateAttributeIndex(const EntityAttribute& oldAttribute, const EntityAttribute& newAttribute) {
+            removeFromIndex(this, oldAttribute);
+            addToIndex(this, newAttribute);
         }
 
         const AttributableNodeList& AttributableNode::linkSources() const {
@@ -398,12 +405,17 @@ namespace TrenchBroom {
         }
 
         void AttributableNode::findMissingTargets(const AttributeName& prefix, AttributeNameList& result) const {
-            for (const EntityAttribute& attribute : m_attributes.numberedAttributes(prefix)) {
+            AttributableNodeList linkTargets;
+            for (const EntityAttribute& attribute : m_attributes.attributes()) {
+                if (!isNumberedAttribute(prefix, attribute.name())) {
+                    continue;
+                }
+
                 const AttributeValue& targetname = attribute.value();
                 if (targetname.empty()) {
                     result.push_back(attribute.name());
                 } else {
-                    AttributableNodeList linkTargets;
+                    linkTargets.clear();
                     findAttributableNodesWithAttribute(AttributeNames::Targetname, targetname, linkTargets);
                     if (linkTargets.empty())
                         result.push_back(attribute.name());
@@ -676,6 +688,7 @@ namespace TrenchBroom {
         void AttributableNode::removeKillTarget(AttributableNode* attributable) {
             ensure(attributable != nullptr, "attributable is null");
             VectorUtils::erase(m_killTargets, attributable);
+            invalidateIssues();
         }
     }
 }
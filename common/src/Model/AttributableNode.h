@@ -46,7 +46,7 @@ namespace TrenchBroom {
             AttributableNodeList m_killTargets;
 
             // cache the classname for faster access
-            AttributeValue m_classname;
+            InternedString m_classname;
         public:
             virtual ~AttributableNode() override;
         public: // definition
@@ -78,6 +78,7 @@ namespace TrenchBroom {
 
             const AttributeValue& attribute(const AttributeName& name, const AttributeValue& defaultValue = DefaultAttributeValue) const;
             const AttributeValue& classname(const AttributeValue& defaultClassname = AttributeValues::NoClassname) const;
+            const InternedString& internedClassname() const;
 
             EntityAttributeSnapshot attributeSnapshot(const AttributeName& name) const;
 
@@ -131,9 +132,9 @@ namespace TrenchBroom {
             void removeAttributesFromIndex();
             void updateAttributeIndex(const EntityAttribute::List& newAttributes);
 
-            void addAttributeToIndex(const AttributeName& name, const AttributeValue& value);
-            void removeAttributeFromIndex(const AttributeName& name, const AttributeValue& value);
-            void updateAttributeIndex(const AttributeName& oldName, const AttributeValue& oldValue, const AttributeName& newName, const AttributeValue& newValue);
+            void addAttributeToIndex(const EntityAttribute& attribute);
+            void removeAttributeFromIndex(const EntityAttribute& attribute);
+            void updateAttributeIndex(const EntityAttribute& oldAttribute, const EntityAttribute& newAttribute);
         public: // link management
             const AttributableNodeList& linkSources() const;
             const AttributableNodeList& linkTargets() const;
@@ -20,9 +20,11 @@
 #include "AttributableNodeIndex.h"
 
 #include "CollectionUtils.h"
+#include "Exceptions.h"
 #include "Macros.h"
 #include "Model/AttributableNode.h"
 
+#include <algorithm>
 #include <cassert>
 
 namespace TrenchBroom {
@@ -43,6 +45,28 @@ namespace TrenchBroom {
             return AttributableNodeIndexQuery(Type_Any);
         }
 
+        AttributableNodeIndexQuery::Type AttributableNodeIndexQuery::type() const {
+            return m_type;
+        }
+
+        const String& AttributableNodeIndexQuery::pattern() const {
+            return m_pattern;
+        }
+
+        bool AttributableNodeIndexQuery::matches(const AttributeName& name) const {
+            switch (m_type) {
+                case Type_Exact:
+                    return name == m_pattern;
+                case Type_Prefix:
+                    return StringUtils::isPrefix(name, m_pattern);
+                case Type_Numbered:
+                    return isNumberedAttribute(m_pattern, name);
+                case Type_Any:
+                    return true;
+                switchDefault()
+            }
+        }
+
         AttributableNodeSet AttributableNodeIndexQuery::execute(const AttributableNodeStringIndex& index) const {
             switch (m_type) {
                 case Type_Exact:
@@ -91,41 +115,55 @@ namespace TrenchBroom {
 
         void AttributableNodeIndex::addAttributableNode(AttributableNode* attributable) {
             for (const EntityAttribute& attribute : attributable->attributes())
-                addAttribute(attributable, attribute.name(), attribute.value());
+                addAttribute(attributable, attribute);
         }
 
         void AttributableNodeIndex::removeAttributableNode(AttributableNode* attributable) {
             for (const EntityAttribute& attribute : attributable->attributes())
-                removeAttribute(attributable, attribute.name(), attribute.value());
+                removeAttribute(attributable, attribute);
+        }
+
+        bool AttributableNodeIndex::ExactKey::operator==(const ExactKey& other) const {
+            return name == other.name && value == other.value;
+        }
+
+        size_t AttributableNodeIndex::ExactKeyHash::operator()(const ExactKey& key) const {
+            size_t result = key.name.hash();
+            result ^= key.value.hash() + 0x9e3779b9 + (result << 6) + (result >> 2);
+            return result;
         }
 
         void AttributableNodeIndex::addAttribute(AttributableNode* attributable, const AttributeName& name, const AttributeValue& value) {
-            m_nameIndex.insert(name, attributable);
-            m_valueIndex.insert(value, attributable);
+            addAttribute(attributable, name, ExactKey{ InternedString(name), InternedString(value) });
         }
 
         void AttributableNodeIndex::removeAttribute(AttributableNode* attributable, const AttributeName& name, const AttributeValue& value) {
-            m_nameIndex.remove(name, attributable);
-            m_valueIndex.remove(value, attributable);
+            ExactKey key;
+            if (!InternedString::find(name, key.name) || !InternedString::find(value, key.value))
+                throw Exception("Cannot remove value from attributable node index.");
+            removeAttribute(attributable, name, key);
         }
 
-        AttributableNodeList AttributableNodeIndex::findAttributableNodes(const AttributableNodeIndexQuery& nameQuery, const AttributeValue& value) const {
-            const AttributableNodeSet nameResult = nameQuery.execute(m_nameIndex);
-            const AttributableNodeSet valueResult = m_valueIndex.queryExactMatches(value);
+        void AttributableNodeIndex::addAttribute(AttributableNode* attributable, const EntityAttribute& attribute) {
+            addAttribute(attributable, attribute.name(), ExactKey{ attribute.internedName(), attribute.internedValue() });
+        }
 
-            if (nameResult.empty() || valueResult.empty())
-                return EmptyAttributableNodeList;
+        void AttributableNodeIndex::removeAttribute(AttributableNode* attributable, const EntityAttribute& attribute) {
+            removeAttribute(attributable, attribute.name(), ExactKey{ attribute.internedName(), attribute.internedValue() });
+        }
 
+        AttributableNodeList AttributableNodeIndex::findAttributableNodes(const AttributableNodeIndexQuery& nameQuery, const AttributeValue& value) const {
             AttributableNodeList result;
-            SetUtils::intersection(nameResult, valueResult, result);
-
-            AttributableNodeList::iterator it = std::begin(result);
-            while (it != std::end(result)) {
-                const AttributableNode* node = *it;
-                if (!nameQuery.execute(node, value))
-                    it = result.erase(it);
-                else
-                    ++it;
+
+            if (nameQuery.type() == AttributableNodeIndexQuery::Type_Exact) {
+                findAttributableNodes(nameQuery.pattern(), value, result);
+            } else if (nameQuery.type() != AttributableNodeIndexQuery::Type_Any) {
+                // there are only a few distinct attribute names, so look up every matching name separately
+                for (const String& name : m_nameIndex.getKeys()) {
+                    if (nameQuery.matches(name))
+                        findAttributableNodes(name, value, result);
+                }
+                VectorUtils::sortAndRemoveDuplicates(result);
             }
 
             return result;
@@ -148,5 +186,35 @@ namespace TrenchBroom {
 
             return result;
         }
+
+        void AttributableNodeIndex::addAttribute(AttributableNode* attributable, const AttributeName& name, ExactKey key) {
+            m_nameIndex.insert(name, attributable);
+            AttributableNodeIndexValueContainer::insertValue(m_exactIndex[std::move(key)], attributable);
+        }
+
+        void AttributableNodeIndex::removeAttribute(AttributableNode* attributable, const AttributeName& name, const ExactKey& key) {
+            m_nameIndex.remove(name, attributable);
+
+            const auto it = m_exactIndex.find(key);
+            if (it == std::end(m_exactIndex))
+                throw Exception("Cannot remove value from attributable node index.");
+
+            AttributableNodeIndexValueContainer::removeValue(it->second, attributable);
+            if (it->second.empty())
+                m_exactIndex.erase(it);
+        }
+
+        void AttributableNodeIndex::findAttributableNodes(const AttributeName& name, const AttributeValue& value, AttributableNodeList& result) const {
+            // if either string is not interned, no node can have an attribute with it
+            ExactKey key;
+            if (!InternedString::find(name, key.name) || !InternedString::find(value, key.value))
+                return;
+
+            const auto it = m_exactIndex.find(key);
+            if (it != std::end(m_exactIndex)) {
+                for (const auto& entry : it->second)
+                    result.push_back(entry.first);
+            }
+        }
     }
 }
@@ -23,9 +23,10 @@
 #include "StringUtils.h"
 #include "Model/ModelTypes.h"
 #include "Model/EntityAttributes.h"
+#include "Model/InternedString.h"
 #include "StringMap.h"
 
-#include <map>
+#include <unordered_map>
 
 namespace TrenchBroom {
     namespace Model {
@@ -49,6 +50,10 @@ namespace TrenchBroom {
             static AttributableNodeIndexQuery numbered(const String& pattern);
             static AttributableNodeIndexQuery any();
 
+            Type type() const;
+            const String& pattern() const;
+            bool matches(const AttributeName& name) const;
+
             AttributableNodeSet execute(const AttributableNodeStringIndex& index) const;
             bool execute(const AttributableNode* node, const String& value) const;
             Model::EntityAttribute::List execute(const AttributableNode* node) const;
@@ -58,18 +63,42 @@ namespace TrenchBroom {
 
         class AttributableNodeIndex {
         private:
+            // finds nodes by attribute name, only used for prefix and numbered queries
             AttributableNodeStringIndex m_nameIndex;
-            AttributableNodeStringIndex m_valueIndex;
+
+            /*
+             * Finds nodes by their interned attribute name and value. Every node is counted once per attribute with
+             * the name and value.
+             */
+            struct ExactKey {
+                InternedString name;
+                InternedString value;
+
+                bool operator==(const ExactKey& other) const;
+            };
+
+            struct ExactKeyHash {
+                size_t operator()(const ExactKey& key) const;
+            };
+
+            using ExactIndex = std::unordered_map<ExactKey, AttributableNodeIndexValueContainer::ValueContainer, ExactKeyHash>;
+            ExactIndex m_exactIndex;
         public:
             void addAttributableNode(AttributableNode* attributable);
             void removeAttributableNode(AttributableNode* attributable);
 
             void addAttribute(AttributableNode* attributable, const AttributeName& name, const AttributeValue& value);
             void removeAttribute(AttributableNode* attributable, const AttributeName& name, const AttributeValue& value);
+            void addAttribute(AttributableNode* attributable, const EntityAttribute& attribute);
+            void removeAttribute(AttributableNode* attributable, const EntityAttribute& attribute);
 
             AttributableNodeList findAttributableNodes(const AttributableNodeIndexQuery& keyQuery, const AttributeValue& value) const;
             StringList allNames() const;
             StringList allValuesForNames(const AttributableNodeIndexQuery& keyQuery) const;
+        private:
+            void addAttribute(AttributableNode* attributable, const AttributeName& name, ExactKey key);
+            void removeAttribute(AttributableNode* attributable, const AttributeName& name, const ExactKey& key);
+            void findAttributableNodes(const AttributeName& name, const AttributeValue& value, AttributableNodeList& result) const;
         };
     }
 }
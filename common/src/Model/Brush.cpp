@@ -21,6 +21,7 @@
 
 #include "CollectionUtils.h"
 #include "Macros.h"
+#include "ParallelUtils.h"
 #include "Model/BrushFace.h"
 #include "Model/BrushGeometry.h"
 #include "Model/BrushSnapshot.h"
@@ -44,6 +45,8 @@
 #include <vecmath/util.h>
 
 #include <algorithm>
+#include <atomic>
+#include <exception>
 #include <iterator>
 
 namespace TrenchBroom {
@@ -307,6 +310,26 @@ namespace TrenchBroom {
             }
         }
 
+        Brush::Brush(const BrushFaceList& faces, BrushGeometry* geometry) :
+        m_geometry(geometry) {
+            ensure(m_geometry != nullptr, "geometry is null");
+
+            addFaces(faces);
+            if (m_faces.size() != m_geometry->faceCount()) {
+                cleanup();
+                throw GeometryException("Brush geometry does not match brush faces");
+            }
+
+            auto faceIt = std::begin(m_faces);
+            for (auto* faceG : m_geometry->faces()) {
+                auto* face = *faceIt++;
+                face->setGeometry(faceG);
+                face->resetTexCoordSystemCache();
+            }
+
+            invalidateVertexCache();
+        }
+
         Brush::~Brush() {
             cleanup();
         }
@@ -1215,6 +1238,39 @@ namespace TrenchBroom {
             return result;
         }
 
+        bool Brush::canTransform(const BrushList& brushes, const vm::mat4x4& transformation, const vm::bbox3& worldBounds) {
+            std::atomic<bool> result(true);
+            ParallelUtils::parallelFor(brushes.size(), [&](const size_t i) {
+                if (result && !brushes[i]->canTransform(transformation, worldBounds)) {
+                    result = false;
+                }
+            });
+            return result;
+        }
+
+        void Brush::transform(const BrushList& brushes, const vm::mat4x4& transformation, const bool lockTextures, const vm::bbox3& worldBounds) {
+            for (auto* brush : brushes) {
+                brush->nodeWillChange();
+            }
+
+            try {
+                rebuildGeometry(brushes, worldBounds, [&](Brush* brush) {
+                    for (auto* face : brush->m_faces) {
+                        face->transform(transformation, lockTextures);
+                    }
+                });
+            } catch (...) {
+                for (auto* brush : brushes) {
+                    brush->nodeDidChange();
+                }
+                throw;
+            }
+
+            for (auto* brush : brushes) {
+                brush->nodeDidChange();
+            }
+        }
+
         Brush* Brush::createBrush(const ModelFactory& factory, const vm::bbox3& worldBounds, const String& defaultTextureName, const BrushGeometry& geometry, const BrushList& subtrahends) const {
             BrushFaceList faces(0);
             faces.reserve(geometry.faceCount());
@@ -1275,6 +1331,42 @@ namespace TrenchBroom {
             nodeBoundsDidChange(oldBounds);
         }
 
+        void Brush::rebuildGeometry(const BrushList& brushes, const vm::bbox3& worldBounds) {
+            rebuildGeometry(brushes, worldBounds, [](Brush*) {});
+        }
+
+        void Brush::rebuildGeometry(const BrushList& brushes, const vm::bbox3& worldBounds, const std::function<void(Brush*)>& prepare) {
+            std::vector<vm::bbox3> oldBounds(brushes.size());
+            std::vector<std::exception_ptr> errors(brushes.size());
+
+            ParallelUtils::parallelFor(brushes.size(), [&](const size_t i) {
+                auto* brush = brushes[i];
+                oldBounds[i] = brush->bounds();
+                try {
+                    prepare(brush);
+                    brush->deleteGeometry();
+                    brush->buildGeometry(worldBounds);
+                } catch (...) {
+                    errors[i] = std::current_exception();
+                }
+            });
+
+            std::exception_ptr error;
+            for (size_t i = 0; i < brushes.size(); ++i) {
+                if (errors[i]) {
+                    if (!error) {
+                        error = errors[i];
+                    }
+                } else {
+                    brushes[i]->nodeBoundsDidChange(oldBounds[i]);
+                }
+            }
+
+            if (error) {
+                std::rethrow_exception(error);
+            }
+        }
+
         void Brush::buildGeometry(const vm::bbox3& worldBounds) {
             assert(m_geometry == nullptr);
 
@@ -1538,6 +1630,13 @@ namespace TrenchBroom {
             }
         }
 
+        void Brush::initializeTags(const BrushList& brushes, TagManager& tagManager) {
+            // every brush only modifies its own tags and the tags of its faces
+            ParallelUtils::parallelFor(brushes.size(), [&](const size_t i) {
+                brushes[i]->initializeTags(tagManager);
+            });
+        }
+
         void Brush::clearTags() {
             for (auto* face : m_faces) {
                 face->clearTags();
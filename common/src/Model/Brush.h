@@ -39,6 +39,7 @@
 #include <vecmath/segment.h>
 #include <vecmath/polygon.h>
 
+#include <functional>
 #include <set>
 #include <vector>
 
@@ -83,6 +84,15 @@ namespace TrenchBroom {
             mutable Renderer::BrushRendererBrushCache m_brushRendererBrushCache;
         public:
             Brush(const vm::bbox3& worldBounds, const BrushFaceList& faces);
+
+            /**
+             * Creates a brush with the given faces and an already computed geometry, e.g. one that was read from a
+             * cache. The brush takes ownership of the faces and the geometry. The faces of the given geometry must
+             * correspond to the given faces in the same order.
+             *
+             * Throws a GeometryException if the number of faces does not match the geometry.
+             */
+            Brush(const BrushFaceList& faces, BrushGeometry* geometry);
             ~Brush() override;
         private:
             void cleanup();
@@ -254,6 +264,22 @@ namespace TrenchBroom {
 
             // transformation
             bool canTransform(const vm::mat4x4& transformation, const vm::bbox3& worldBounds) const;
+
+            /**
+             * Checks whether all of the given brushes can be transformed. The brushes are checked in parallel.
+             */
+            static bool canTransform(const BrushList& brushes, const vm::mat4x4& transformation, const vm::bbox3& worldBounds);
+
+            /**
+             * Transforms all of the given brushes. This has the same effect as transforming each brush individually,
+             * but the faces and geometries of the brushes are updated in parallel. The node change notifications are
+             * sent on the calling thread, before and after all brushes were updated.
+             *
+             * If the geometry of some brushes cannot be built, the remaining brushes are still transformed, and the
+             * first exception (in the order of the given brushes) is rethrown.
+             */
+            using Object::transform;
+            static void transform(const BrushList& brushes, const vm::mat4x4& transformation, bool lockTextures, const vm::bbox3& worldBounds);
         private:
             /**
              * Final step of CSG subtraction; takes the geometry that is the result of the subtraction, and turns it
@@ -273,7 +299,25 @@ namespace TrenchBroom {
             void updatePointsFromVertices(const vm::bbox3& worldBounds);
         public: // brush geometry
             void rebuildGeometry(const vm::bbox3& worldBounds);
+
+            /**
+             * Rebuilds the geometries of all of the given brushes in parallel. The bounds change notifications are
+             * sent on the calling thread once all geometries were rebuilt.
+             *
+             * If the geometry of some brushes cannot be built, the remaining brushes are still rebuilt, and the first
+             * exception (in the order of the given brushes) is rethrown.
+             */
+            static void rebuildGeometry(const BrushList& brushes, const vm::bbox3& worldBounds);
         private:
+            /**
+             * Calls the given function for each of the given brushes and rebuilds the brush's geometry afterwards.
+             *
+             * Every brush only modifies its own faces and geometry, so the brushes are processed in parallel. Node
+             * notifications affect the parents of the brushes and are therefore sent on the calling thread. The given
+             * brushes must be distinct.
+             */
+            static void rebuildGeometry(const BrushList& brushes, const vm::bbox3& worldBounds, const std::function<void(Brush*)>& prepare);
+
             void buildGeometry(const vm::bbox3& worldBounds);
             void deleteGeometry();
             bool checkGeometry() const;
@@ -333,6 +377,12 @@ namespace TrenchBroom {
             void initializeTags(TagManager& tagManager) override;
             void clearTags() override;
 
+            /**
+             * Initializes the tags of all of the given brushes and their faces in parallel. The given brushes must be
+             * distinct.
+             */
+            static void initializeTags(const BrushList& brushes, TagManager& tagManager);
+
             /**
              * Indicates whether all of the faces of this brush have any of the given tags.
              *
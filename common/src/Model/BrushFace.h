@@ -196,6 +196,7 @@ namespace TrenchBroom {
             void invalidate();
 
             size_t lineNumber() const;
+            size_t lineCount() const;
             void setFilePosition(size_t lineNumber, size_t lineCount);
 
             bool selected() const;
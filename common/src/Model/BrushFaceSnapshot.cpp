@@ -20,6 +20,7 @@
 #include "BrushFaceSnapshot.h"
 
 #include "Model/Brush.h"
+#include "Model/ParallelTexCoordSystem.h"
 
 namespace TrenchBroom {
     namespace Model {
@@ -35,5 +36,12 @@ namespace TrenchBroom {
                 face->restoreTexCoordSystemSnapshot(*m_coordSystemSnapshot);
             }
         }
+
+        size_t BrushFaceSnapshot::memorySize() const {
+            size_t result = sizeof(BrushFaceSnapshot) + m_attribs.textureName().capacity();
+            if (m_coordSystemSnapshot != nullptr)
+                result += sizeof(ParallelTexCoordSystemSnapshot);
+            return result;
+        }
     }
 }
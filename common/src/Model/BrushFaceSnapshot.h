@@ -35,6 +35,7 @@ namespace TrenchBroom {
         public:
             BrushFaceSnapshot(BrushFace* face, TexCoordSystem& coordSystemSnapshot);
             void restore();
+            size_t memorySize() const;
         };
     }
 }
@@ -19,32 +19,108 @@
 
 #include "BrushSnapshot.h"
 
-#include "CollectionUtils.h"
 #include "Model/Brush.h"
 #include "Model/BrushFace.h"
+#include "Model/ParallelTexCoordSystem.h"
+#include "Model/ParaxialTexCoordSystem.h"
 
 namespace TrenchBroom {
     namespace Model {
+        static bool sameAttribs(const BrushFaceAttributes& lhs, const BrushFaceAttributes& rhs) {
+            return (lhs.textureName() == rhs.textureName() &&
+                    lhs.offset() == rhs.offset() &&
+                    lhs.scale() == rhs.scale() &&
+                    lhs.rotation() == rhs.rotation() &&
+                    lhs.surfaceContents() == rhs.surfaceContents() &&
+                    lhs.surfaceFlags() == rhs.surfaceFlags() &&
+                    lhs.surfaceValue() == rhs.surfaceValue() &&
+                    lhs.color() == rhs.color());
+        }
+
         BrushSnapshot::BrushSnapshot(Brush* brush) :
         m_brush(brush) {
             takeSnapshot(brush);
         }
 
-        BrushSnapshot::~BrushSnapshot() {
-            VectorUtils::clearAndDelete(m_faces);
-        }
+        BrushSnapshot::~BrushSnapshot() = default;
 
         void BrushSnapshot::takeSnapshot(Brush* brush) {
-            for (BrushFace* face : brush->faces()) {
-                BrushFace *faceClone = face->clone();
-                faceClone->setTexture(nullptr);
-                m_faces.push_back(faceClone);
+            const BrushFaceList& faces = brush->faces();
+            m_faces.reserve(faces.size());
+
+            for (const BrushFace* face : faces) {
+                const BrushFace::Points& points = face->points();
+                m_faces.push_back(FaceSnapshot{
+                    { points[0], points[1], points[2] },
+                    findOrAddAttribs(face->attribs()),
+                    face->lineNumber(),
+                    face->lineCount(),
+                    face->selected()
+                });
+
+                auto texCoordSystem = face->takeTexCoordSystemSnapshot();
+                if (texCoordSystem != nullptr && m_texCoordSystems.empty())
+                    m_texCoordSystems.resize(faces.size());
+                if (!m_texCoordSystems.empty())
+                    m_texCoordSystems[m_faces.size() - 1] = std::move(texCoordSystem);
             }
+
+            m_attribs.shrink_to_fit();
+        }
+
+        size_t BrushSnapshot::findOrAddAttribs(const BrushFaceAttributes& attribs) {
+            for (size_t i = 0; i < m_attribs.size(); ++i) {
+                if (sameAttribs(m_attribs[i], attribs))
+                    return i;
+            }
+
+            // the snapshot must not hold on to the texture, it is set again when the snapshot is restored
+            m_attribs.push_back(attribs.takeSnapshot());
+            return m_attribs.size() - 1;
+        }
+
+        BrushFace* BrushSnapshot::restoreFace(const size_t index) const {
+            const FaceSnapshot& snapshot = m_faces[index];
+            const vm::vec3& p0 = snapshot.points[0];
+            const vm::vec3& p1 = snapshot.points[1];
+            const vm::vec3& p2 = snapshot.points[2];
+            const BrushFaceAttributes& attribs = m_attribs[snapshot.attribsIndex];
+
+            BrushFace* face;
+            if (!m_texCoordSystems.empty() && m_texCoordSystems[index] != nullptr) {
+                face = new BrushFace(p0, p1, p2, attribs, std::make_unique<ParallelTexCoordSystem>(p0, p1, p2, attribs));
+                face->restoreTexCoordSystemSnapshot(*m_texCoordSystems[index]);
+            } else {
+                face = new BrushFace(p0, p1, p2, attribs, std::make_unique<ParaxialTexCoordSystem>(p0, p1, p2, attribs));
+            }
+
+            face->setFilePosition(snapshot.lineNumber, snapshot.lineCount);
+            if (snapshot.selected)
+                face->select();
+            return face;
         }
 
         void BrushSnapshot::doRestore(const vm::bbox3& worldBounds) {
-            m_brush->setFaces(worldBounds, m_faces);
-            m_faces.clear();
+            BrushFaceList faces;
+            faces.reserve(m_faces.size());
+            for (size_t i = 0; i < m_faces.size(); ++i)
+                faces.push_back(restoreFace(i));
+
+            m_brush->setFaces(worldBounds, faces);
+        }
+
+        size_t BrushSnapshot::doGetMemorySize() const {
+            size_t result = sizeof(BrushSnapshot);
+            result += m_faces.capacity() * sizeof(FaceSnapshot);
+            result += m_attribs.capacity() * sizeof(BrushFaceAttributes);
+            for (const BrushFaceAttributes& attribs : m_attribs)
+                result += attribs.textureName().capacity();
+            result += m_texCoordSystems.capacity() * sizeof(std::unique_ptr<TexCoordSystemSnapshot>);
+            for (const auto& texCoordSystem : m_texCoordSystems) {
+                if (texCoordSystem != nullptr)
+                    result += sizeof(ParallelTexCoordSystemSnapshot);
+            }
+            return result;
         }
     }
 }
@@ -20,26 +20,56 @@
 #ifndef TrenchBroom_BrushSnapshot
 #define TrenchBroom_BrushSnapshot
 
+#include "Model/BrushFaceAttributes.h"
 #include "Model/ModelTypes.h"
 #include "Model/NodeSnapshot.h"
+#include "Model/TexCoordSystem.h"
 
+#include <vecmath/vec.h>
+
+#include <memory>
 #include <vector>
 
 namespace TrenchBroom {
     namespace Model {
         class Brush;
-        class BrushFaceSnapshot;
+        class BrushFace;
 
+        /**
+         * Stores the faces of a brush so that they can be restored later.
+         *
+         * The faces are not cloned, since a clone also carries the tags, caches and geometry links of a face. Instead,
+         * only the plane points of every face are stored in one contiguous list together with an index into the
+         * distinct face attributes of the brush, which are usually shared by most faces. The faces are recreated
+         * from this data when the snapshot is restored, and the brush rebuilds its geometry from them.
+         */
         class BrushSnapshot : public NodeSnapshot {
         private:
+            struct FaceSnapshot {
+                vm::vec3 points[3];
+                size_t attribsIndex;
+                size_t lineNumber;
+                size_t lineCount;
+                bool selected;
+            };
+
             Brush* m_brush;
-            BrushFaceList m_faces;
+            std::vector<FaceSnapshot> m_faces;
+            std::vector<BrushFaceAttributes> m_attribs;
+
+            // only filled if the texture coordinate systems of the faces have state that cannot be recomputed from
+            // the plane points and attributes, then there is one entry per face
+            std::vector<std::unique_ptr<TexCoordSystemSnapshot>> m_texCoordSystems;
         public:
             BrushSnapshot(Brush* brush);
             ~BrushSnapshot() override;
         private:
             void takeSnapshot(Brush* brush);
+            size_t findOrAddAttribs(const BrushFaceAttributes& attribs);
+            BrushFace* restoreFace(size_t index) const;
+
             void doRestore(const vm::bbox3& worldBounds) override;
+            size_t doGetMemorySize() const override;
         };
     }
 }
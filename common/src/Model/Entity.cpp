@@ -34,6 +34,7 @@
 #include "Model/NodeVisitor.h"
 #include "Model/PickResult.h"
 #include "Model/TagVisitor.h"
+#include "Model/TransformObjectVisitor.h"
 
 #include <vecmath/forward.h>
 #include <vecmath/vec.h>
@@ -363,29 +364,12 @@ namespace TrenchBroom {
             return visitor.hasResult() ? visitor.result() : nullptr;
         }
 
-        class TransformEntity : public NodeVisitor {
-        private:
-            const vm::mat4x4& m_transformation;
-            bool m_lockTextures;
-            const vm::bbox3& m_worldBounds;
-        public:
-            TransformEntity(const vm::mat4x4& transformation, const bool lockTextures, const vm::bbox3& worldBounds) :
-            m_transformation(transformation),
-            m_lockTextures(lockTextures),
-            m_worldBounds(worldBounds) {}
-        private:
-            void doVisit(World* world) override   {}
-            void doVisit(Layer* layer) override   {}
-            void doVisit(Group* group) override   {}
-            void doVisit(Entity* entity) override {}
-            void doVisit(Brush* brush) override   { brush->transform(m_transformation, m_lockTextures, m_worldBounds); }
-        };
-
         void Entity::doTransform(const vm::mat4x4& transformation, const bool lockTextures, const vm::bbox3& worldBounds) {
             if (hasChildren()) {
                 const NotifyNodeChange nodeChange(this);
-                TransformEntity visitor(transformation, lockTextures, worldBounds);
+                TransformObjectVisitor visitor(transformation, lockTextures, worldBounds);
                 iterate(visitor);
+                visitor.transformBrushes();
             } else {
                 // node change is called by setOrigin already
                 const auto center = bounds().center();
@@ -22,6 +22,8 @@
 #include "Exceptions.h"
 #include "Assets/EntityDefinition.h"
 
+#include <algorithm>
+
 namespace TrenchBroom {
     namespace Model {
         const String AttributeEscapeChars = "\"\n\\";
@@ -101,17 +103,29 @@ namespace TrenchBroom {
         }
 
         int EntityAttribute::compare(const EntityAttribute& rhs) const {
-            const int nameCmp = m_name.compare(rhs.m_name);
-            if (nameCmp != 0)
-                return nameCmp;
-            return m_value.compare(rhs.m_value);
+            if (m_name != rhs.m_name) {
+                const int nameCmp = m_name.str().compare(rhs.m_name.str());
+                if (nameCmp != 0)
+                    return nameCmp;
+            }
+            if (m_value == rhs.m_value)
+                return 0;
+            return m_value.str().compare(rhs.m_value.str());
         }
 
         const AttributeName& EntityAttribute::name() const {
-            return m_name;
+            return m_name.str();
         }
 
         const AttributeValue& EntityAttribute::value() const {
+            return m_value.str();
+        }
+
+        const InternedString& EntityAttribute::internedName() const {
+            return m_name;
+        }
+
+        const InternedString& EntityAttribute::internedValue() const {
             return m_value;
         }
 
@@ -120,12 +134,14 @@ namespace TrenchBroom {
         }
 
         void EntityAttribute::setName(const AttributeName& name, const Assets::AttributeDefinition* definition) {
-            m_name = name;
+            if (m_name != name)
+                m_name = InternedString(name);
             m_definition = definition;
         }
 
         void EntityAttribute::setValue(const AttributeValue& value) {
-            m_value = value;
+            if (m_value != value)
+                m_value = InternedString(value);
         }
 
         bool isLayer(const String& classname, const EntityAttribute::List& attributes) {
@@ -160,7 +176,6 @@ namespace TrenchBroom {
 
         void EntityAttributes::setAttributes(const EntityAttribute::List& attributes) {
             m_attributes = attributes;
-            rebuildIndex();
         }
 
         const EntityAttribute& EntityAttributes::addOrUpdateAttribute(const AttributeName& name, const AttributeValue& value, const Assets::AttributeDefinition* definition) {
@@ -171,7 +186,6 @@ namespace TrenchBroom {
                 return *it;
             } else {
                 m_attributes.push_back(EntityAttribute(name, value, definition));
-                m_index.insert(name, --std::end(m_attributes));
                 return m_attributes.back();
             }
         }
@@ -189,7 +203,6 @@ namespace TrenchBroom {
             EntityAttribute::List::iterator it = findAttribute(name);
             if (it == std::end(m_attributes))
                 return;
-            m_index.remove(name, it);
             m_attributes.erase(it);
         }
 
@@ -213,44 +226,26 @@ namespace TrenchBroom {
         }
 
         bool EntityAttributes::hasAttributeWithPrefix(const AttributeName& prefix, const AttributeValue& value) const {
-            return containsValue(m_index.queryPrefixMatches(prefix), value);
+            for (const EntityAttribute& attribute : m_attributes) {
+                if (attribute.internedValue() == value && StringUtils::isPrefix(attribute.name(), prefix))
+                    return true;
+            }
+            return false;
         }
 
         bool EntityAttributes::hasNumberedAttribute(const AttributeName& prefix, const AttributeValue& value) const {
-            return containsValue(m_index.queryNumberedMatches(prefix), value);
-        }
-
-        EntityAttributeSnapshot EntityAttributes::snapshot(const AttributeName& name) const {
-            const AttributeIndex::QueryResult matches = m_index.queryExactMatches(name);
-            if (matches.empty())
-                return EntityAttributeSnapshot(name);
-
-            assert(matches.size() == 1);
-            return EntityAttributeSnapshot(name, matches.front()->value());
-        }
-
-        bool EntityAttributes::containsValue(const AttributeIndex::QueryResult& matches, const AttributeValue& value) const {
-            if (matches.empty())
-                return false;
-
-            for (auto attrIt : matches) {
-                const EntityAttribute& attribute = *attrIt;
-                if (attribute.value() == value)
+            for (const EntityAttribute& attribute : m_attributes) {
+                if (attribute.internedValue() == value && isNumberedAttribute(prefix, attribute.name()))
                     return true;
             }
-
             return false;
         }
 
-        EntityAttribute::List EntityAttributes::listFromQueryResult(const AttributeIndex::QueryResult& matches) const {
-            EntityAttribute::List result;
-
-            for (auto attrIt : matches) {
-                const EntityAttribute& attribute = *attrIt;
-                result.push_back(attribute);
-            }
-
-            return result;
+        EntityAttributeSnapshot EntityAttributes::snapshot(const AttributeName& name) const {
+            const EntityAttribute::List::const_iterator it = findAttribute(name);
+            if (it == std::end(m_attributes))
+                return EntityAttributeSnapshot(name);
+            return EntityAttributeSnapshot(name, it->value());
         }
 
         const AttributeNameSet EntityAttributes::names() const {
@@ -267,6 +262,13 @@ namespace TrenchBroom {
             return &it->value();
         }
 
+        const EntityAttribute* EntityAttributes::entityAttribute(const AttributeName& name) const {
+            EntityAttribute::List::const_iterator it = findAttribute(name);
+            if (it == std::end(m_attributes))
+                return nullptr;
+            return &*it;
+        }
+
         const AttributeValue& EntityAttributes::safeAttribute(const AttributeName& name, const AttributeValue& defaultValue) const {
             const AttributeValue* value = attribute(name);
             if (value == nullptr)
@@ -275,11 +277,24 @@ namespace TrenchBroom {
         }
 
         EntityAttribute::List EntityAttributes::attributeWithName(const AttributeName& name) const {
-            return listFromQueryResult(m_index.queryExactMatches(name));
+            EntityAttribute::List result;
+
+            const EntityAttribute::List::const_iterator it = findAttribute(name);
+            if (it != std::end(m_attributes))
+                result.push_back(*it);
+
+            return result;
         }
 
         EntityAttribute::List EntityAttributes::attributesWithPrefix(const AttributeName& prefix) const{
-            return listFromQueryResult(m_index.queryPrefixMatches(prefix));
+            EntityAttribute::List result;
+
+            for (const EntityAttribute& attribute : m_attributes) {
+                if (StringUtils::isPrefix(attribute.name(), prefix))
+                    result.push_back(attribute);
+            }
+
+            return result;
         }
 
         EntityAttribute::List EntityAttributes::numberedAttributes(const String& prefix) const {
@@ -294,30 +309,15 @@ namespace TrenchBroom {
         }
 
         EntityAttribute::List::const_iterator EntityAttributes::findAttribute(const AttributeName& name) const {
-            const AttributeIndex::QueryResult matches = m_index.queryExactMatches(name);
-            if (matches.empty())
-                return std::end(m_attributes);
-
-            assert(matches.size() == 1);
-            return matches.front();
+            return std::find_if(std::begin(m_attributes), std::end(m_attributes), [&name](const EntityAttribute& attribute) {
+                return attribute.internedName() == name;
+            });
         }
 
         EntityAttribute::List::iterator EntityAttributes::findAttribute(const AttributeName& name) {
-            const AttributeIndex::QueryResult matches = m_index.queryExactMatches(name);
-            if (matches.empty())
-                return std::end(m_attributes);
-
-            assert(matches.size() == 1);
-            return matches.front();
-        }
-
-        void EntityAttributes::rebuildIndex() {
-            m_index.clear();
-
-            for (auto it = std::begin(m_attributes), end = std::end(m_attributes); it != end; ++it) {
-                const EntityAttribute& attribute = *it;
-                m_index.insert(attribute.name(), it);
-            }
+            return std::find_if(std::begin(m_attributes), std::end(m_attributes), [&name](const EntityAttribute& attribute) {
+                return attribute.internedName() == name;
+            });
         }
     }
 }
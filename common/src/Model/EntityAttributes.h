@@ -21,8 +21,8 @@
 #define TrenchBroom_EntityProperties
 
 #include "StringUtils.h"
-#include "StringMap.h"
 #include "Model/EntityAttributeSnapshot.h"
+#include "Model/InternedString.h"
 #include "Model/ModelTypes.h"
 
 #include <map>
@@ -81,8 +81,9 @@ namespace TrenchBroom {
             using List = std::list<EntityAttribute>;
             static const List EmptyList;
         private:
-            AttributeName m_name;
-            AttributeValue m_value;
+            // names and values are interned because they repeat across many entities
+            InternedString m_name;
+            InternedString m_value;
             const Assets::AttributeDefinition* m_definition;
         public:
             EntityAttribute();
@@ -92,6 +93,8 @@ namespace TrenchBroom {
 
             const AttributeName& name() const;
             const AttributeValue& value() const;
+            const InternedString& internedName() const;
+            const InternedString& internedValue() const;
             const Assets::AttributeDefinition* definition() const;
 
             void setName(const AttributeName& name, const Assets::AttributeDefinition* definition);
@@ -105,12 +108,11 @@ namespace TrenchBroom {
 
         class EntityAttributes {
         private:
+            /*
+             * Entities only have a handful of attributes, so they are searched linearly instead of maintaining an
+             * index per entity.
+             */
             EntityAttribute::List m_attributes;
-
-            using IndexValue = EntityAttribute::List::iterator;
-            using IndexValueContainer = StringMapValueContainer<IndexValue>;
-            using AttributeIndex = StringMap<IndexValue, IndexValueContainer>;
-            AttributeIndex m_index;
         public:
             const EntityAttribute::List& attributes() const;
             void setAttributes(const EntityAttribute::List& attributes);
@@ -126,12 +128,10 @@ namespace TrenchBroom {
             bool hasNumberedAttribute(const AttributeName& prefix, const AttributeValue& value) const;
 
             EntityAttributeSnapshot snapshot(const AttributeName& name) const;
-        private:
-            bool containsValue(const AttributeIndex::QueryResult& matches, const AttributeValue& value) const;
-            EntityAttribute::List listFromQueryResult(const AttributeIndex::QueryResult& matches) const;
-        public:
+
             const AttributeNameSet names() const;
             const AttributeValue* attribute(const AttributeName& name) const;
+            const EntityAttribute* entityAttribute(const AttributeName& name) const;
             const AttributeValue& safeAttribute(const AttributeName& name, const AttributeValue& defaultValue) const;
 
             EntityAttribute::List attributeWithName(const AttributeName& name) const;
@@ -140,8 +140,6 @@ namespace TrenchBroom {
         private:
             EntityAttribute::List::const_iterator findAttribute(const AttributeName& name) const;
             EntityAttribute::List::iterator findAttribute(const AttributeName& name);
-
-            void rebuildIndex();
         };
     }
 }
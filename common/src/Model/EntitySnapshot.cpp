@@ -48,5 +48,10 @@ namespace TrenchBroom {
             restoreAttribute(m_entity, m_origin);
             restoreAttribute(m_entity, m_rotation);
         }
+
+        size_t EntitySnapshot::doGetMemorySize() const {
+            // the attribute names and values are interned and shared with the entity
+            return sizeof(EntitySnapshot);
+        }
     }
 }
@@ -73,6 +73,10 @@ namespace TrenchBroom {
             doWriteMap(world, path);
         }
 
+        void Game::writeMapSnapshot(const IO::MapSnapshot& snapshot, const IO::Path& path) const {
+            doWriteMapSnapshot(snapshot, path);
+        }
+
         void Game::exportMap(World& world, const Model::ExportFormat format, const IO::Path& path) const {
             doExportMap(world, format, path);
         }
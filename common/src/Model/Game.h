@@ -38,6 +38,10 @@
 namespace TrenchBroom {
     class Logger;
 
+    namespace IO {
+        class MapSnapshot;
+    }
+
     namespace Assets {
         class TextureManager;
     }
@@ -71,6 +75,7 @@ namespace TrenchBroom {
             std::unique_ptr<World> newMap(MapFormat format, const vm::bbox3& worldBounds, Logger& logger) const;
             std::unique_ptr<World> loadMap(MapFormat format, const vm::bbox3& worldBounds, const IO::Path& path, Logger& logger) const;
             void writeMap(World& world, const IO::Path& path) const;
+            void writeMapSnapshot(const IO::MapSnapshot& snapshot, const IO::Path& path) const;
             void exportMap(World& world, Model::ExportFormat format, const IO::Path& path) const;
         public: // parsing and serializing objects
             NodeList parseNodes(const String& str, World& world, const vm::bbox3& worldBounds, Logger& logger) const;
@@ -113,6 +118,7 @@ namespace TrenchBroom {
             virtual std::unique_ptr<World> doNewMap(MapFormat format, const vm::bbox3& worldBounds, Logger& logger) const = 0;
             virtual std::unique_ptr<World> doLoadMap(MapFormat format, const vm::bbox3& worldBounds, const IO::Path& path, Logger& logger) const = 0;
             virtual void doWriteMap(World& world, const IO::Path& path) const = 0;
+            virtual void doWriteMapSnapshot(const IO::MapSnapshot& snapshot, const IO::Path& path) const = 0;
             virtual void doExportMap(World& world, Model::ExportFormat format, const IO::Path& path) const = 0;
 
             virtual NodeList doParseNodes(const String& str, World& world, const vm::bbox3& worldBounds, Logger& logger) const = 0;
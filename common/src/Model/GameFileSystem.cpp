@@ -34,12 +34,14 @@ namespace TrenchBroom {
     namespace Model {
         GameFileSystem::GameFileSystem() :
         FileSystem(),
-        m_shaderFS(nullptr) {}
+        m_shaderFS(nullptr),
+        m_logger(nullptr) {}
 
         void GameFileSystem::initialize(const GameConfig& config, const IO::Path& gamePath, const std::vector<IO::Path>& additionalSearchPaths, Logger& logger) {
             // delete the existing file system
-            releaseNext();
+            m_fileSystems.reset();
             m_shaderFS = nullptr;
+            m_logger = &logger;
 
             addDefaultAssetPath(config, logger);
 
@@ -47,12 +49,15 @@ namespace TrenchBroom {
                 addGameFileSystems(config, gamePath, additionalSearchPaths, logger);
                 addShaderFileSystem(config, logger);
             }
+
+            buildIndex();
         }
 
-        void GameFileSystem::reloadShaders() {
+        void GameFileSystem::reload() {
             if (m_shaderFS != nullptr) {
                 m_shaderFS->reload();
             }
+            buildIndex();
         }
 
         void GameFileSystem::addDefaultAssetPath(const GameConfig& config, Logger& logger) {
@@ -80,7 +85,7 @@ namespace TrenchBroom {
         void GameFileSystem::addFileSystemPath(const IO::Path& path, Logger& logger) {
             try {
                 logger.info() << "Adding file system path " << path;
-                m_next = std::make_shared<IO::DiskFileSystem>(m_next, path);
+                m_fileSystems = std::make_shared<IO::DiskFileSystem>(m_fileSystems, path);
             } catch (const FileSystemException& e) {
                 logger.error() << "Could not add file system search path '" << path << "': " << e.what();
             }
@@ -102,13 +107,13 @@ namespace TrenchBroom {
                     try {
                         if (StringUtils::caseInsensitiveEqual(packageFormat, "idpak")) {
                             logger.info() << "Adding file system package " << packagePath;
-                            m_next = std::make_shared<IO::IdPakFileSystem>(m_next, diskFS.makeAbsolute(packagePath));
+                            m_fileSystems = std::make_shared<IO::IdPakFileSystem>(m_fileSystems, diskFS.makeAbsolute(packagePath));
                         } else if (StringUtils::caseInsensitiveEqual(packageFormat, "dkpak")) {
                             logger.info() << "Adding file system package " << packagePath;
-                            m_next = std::make_shared<IO::DkPakFileSystem>(m_next, diskFS.makeAbsolute(packagePath));
+                            m_fileSystems = std::make_shared<IO::DkPakFileSystem>(m_fileSystems, diskFS.makeAbsolute(packagePath));
                         } else if (StringUtils::caseInsensitiveEqual(packageFormat, "zip")) {
                             logger.info() << "Adding file system package " << packagePath;
-                            m_next = std::make_shared<IO::ZipFileSystem>(m_next, diskFS.makeAbsolute(packagePath));
+                            m_fileSystems = std::make_shared<IO::ZipFileSystem>(m_fileSystems, diskFS.makeAbsolute(packagePath));
                         }
                     } catch (const std::exception& e) {
                         logger.error() << e.what();
@@ -129,26 +134,92 @@ namespace TrenchBroom {
                     textureConfig.package.rootDirectory,
                     IO::Path("models")
                 };
-                auto shaderFS = std::make_shared<IO::Quake3ShaderFileSystem>(m_next, std::move(shaderSearchPath), std::move(textureSearchPaths), logger);
+                auto shaderFS = std::make_shared<IO::Quake3ShaderFileSystem>(m_fileSystems, std::move(shaderSearchPath), std::move(textureSearchPaths), logger);
                 m_shaderFS = shaderFS.get();
-                m_next = std::move(shaderFS);
+                m_fileSystems = std::move(shaderFS);
+            }
+        }
+
+        void GameFileSystem::buildIndex() {
+            m_files.clear();
+            m_directories.clear();
+
+            // visit the file systems in order of precedence, so the first entry for a path wins
+            const IO::FileSystem* fileSystem = m_fileSystems.get();
+            while (fileSystem != nullptr) {
+                addToIndex(*fileSystem, IO::Path(""), true);
+                fileSystem->forEachLocalItem([&](const IO::Path& path, const bool directory) {
+                    addToIndex(*fileSystem, path, directory);
+                }, [&](const IO::Path& path, const Exception& e) {
+                    if (m_logger != nullptr) {
+                        m_logger->warn() << "Could not index directory '" << path << "': " << e.what();
+                    }
+                });
+                fileSystem = fileSystem->hasNext() ? &fileSystem->next() : nullptr;
+            }
+
+            for (auto& entry : m_directories) {
+                VectorUtils::sort(entry.second.contents);
+            }
+        }
+
+        void GameFileSystem::addToIndex(const IO::FileSystem& fileSystem, const IO::Path& path, const bool directory) {
+            const auto key = indexKey(path);
+            const auto known = m_files.count(key) > 0 || m_directories.count(key) > 0;
+
+            const auto inserted = directory
+                ? m_directories.try_emplace(key, DirectoryEntry{ &fileSystem, path, IO::Path::List() }).second
+                : m_files.try_emplace(key, IndexEntry{ &fileSystem, path }).second;
+
+            // directories are visited before their contents, so the parent directory is always indexed already
+            if (inserted && !known && !path.isEmpty()) {
+                auto& parent = m_directories.at(indexKey(path.deleteLastComponent()));
+                parent.contents.push_back(path.lastComponent());
             }
         }
 
+        String GameFileSystem::indexKey(const IO::Path& path) {
+            return path.makeLowerCase().makeCanonical().asString('/');
+        }
+
         bool GameFileSystem::doDirectoryExists(const IO::Path& path) const {
-            return false;
+            return m_directories.count(indexKey(path)) > 0;
         }
 
         bool GameFileSystem::doFileExists(const IO::Path& path) const {
-            return false;
+            return m_files.count(indexKey(path)) > 0;
+        }
+
+        IO::Path GameFileSystem::doMakeAbsolute(const IO::Path& path) const {
+            const auto key = indexKey(path);
+
+            const auto fileIt = m_files.find(key);
+            if (fileIt != std::end(m_files)) {
+                return fileIt->second.fileSystem->makeAbsolute(fileIt->second.path);
+            }
+
+            const auto directoryIt = m_directories.find(key);
+            if (directoryIt != std::end(m_directories)) {
+                return directoryIt->second.fileSystem->makeAbsolute(directoryIt->second.path);
+            }
+
+            throw FileSystemException("Cannot make absolute path of '" + path.asString() + "'");
         }
 
         IO::Path::List GameFileSystem::doGetDirectoryContents(const IO::Path& path) const {
-            return TrenchBroom::IO::Path::List();
+            const auto it = m_directories.find(indexKey(path));
+            if (it == std::end(m_directories)) {
+                throw FileSystemException("Directory not found: '" + path.asString() + "'");
+            }
+            return it->second.contents;
         }
 
         std::shared_ptr<IO::File> GameFileSystem::doOpenFile(const IO::Path& path) const {
-            throw FileSystemException("File not found: '" + path.asString() + "'");
+            const auto it = m_files.find(indexKey(path));
+            if (it == std::end(m_files)) {
+                throw FileSystemException("File not found: '" + path.asString() + "'");
+            }
+            return it->second.fileSystem->openFile(it->second.path);
         }
     }
 }
@@ -20,9 +20,12 @@
 #ifndef TRENCHBROOM_GAMEFILESYSTEM_H
 #define TRENCHBROOM_GAMEFILESYSTEM_H
 
+#include "StringUtils.h"
 #include "IO/FileSystem.h"
+#include "IO/Path.h"
 
 #include <memory>
+#include <unordered_map>
 #include <vector>
 
 namespace TrenchBroom {
@@ -38,22 +41,57 @@ namespace TrenchBroom {
     namespace Model {
         class GameConfig;
 
+        /**
+         * The file system of a game, which combines the game's search paths and their packages.
+         *
+         * The backing file systems form a chain in which the file systems that were added last take precedence. Rather
+         * than walking that chain for every query, this file system keeps an index that maps the normalized path of
+         * every file and directory to the file system that provides it. The index is rebuilt when the file system is
+         * initialized with a new configuration, search paths or mods, and when it is reloaded, e.g. when the user reloads
+         * the texture collections.
+         */
         class GameFileSystem : public IO::FileSystem {
         private:
+            struct IndexEntry {
+                const IO::FileSystem* fileSystem;
+                IO::Path path;
+            };
+
+            struct DirectoryEntry {
+                const IO::FileSystem* fileSystem;
+                IO::Path path;
+                IO::Path::List contents;
+            };
+
+            // the chain of backing file systems, the first one takes precedence
+            std::shared_ptr<IO::FileSystem> m_fileSystems;
             IO::Quake3ShaderFileSystem* m_shaderFS;
+            Logger* m_logger;
+
+            // the keys are the lower case canonical paths
+            std::unordered_map<String, IndexEntry> m_files;
+            std::unordered_map<String, DirectoryEntry> m_directories;
         public:
             GameFileSystem();
             void initialize(const GameConfig& config, const IO::Path& gamePath, const std::vector<IO::Path>& additionalSearchPaths, Logger& logger);
-            void reloadShaders();
+            /**
+             * Reloads the shaders, if any, and rebuilds the index to pick up files that were added or removed.
+             */
+            void reload();
         private:
             void addDefaultAssetPath(const GameConfig& config, Logger& logger);
             void addGameFileSystems(const GameConfig& config, const IO::Path& gamePath, const std::vector<IO::Path>& additionalSearchPaths, Logger& logger);
             void addShaderFileSystem(const GameConfig& config, Logger& logger);
             void addFileSystemPath(const IO::Path& path, Logger& logger);
             void addFileSystemPackages(const GameConfig& config, const IO::Path& searchPath, Logger& logger);
+
+            void buildIndex();
+            void addToIndex(const IO::FileSystem& fileSystem, const IO::Path& path, bool directory);
+            static String indexKey(const IO::Path& path);
         private:
             bool doDirectoryExists(const IO::Path& path) const override;
             bool doFileExists(const IO::Path& path) const override;
+            IO::Path doMakeAbsolute(const IO::Path& path) const override;
             IO::Path::List doGetDirectoryContents(const IO::Path& path) const override;
             std::shared_ptr<IO::File> doOpenFile(const IO::Path& path) const override;
         };
@@ -33,6 +33,7 @@
 #include "IO/FileMatcher.h"
 #include "IO/FileSystem.h"
 #include "IO/IOUtils.h"
+#include "IO/MapSnapshot.h"
 #include "IO/MapParser.h"
 #include "IO/MdlParser.h"
 #include "IO/Md2Parser.h"
@@ -138,7 +139,7 @@ namespace TrenchBroom {
             auto file = IO::Disk::openFile(IO::Disk::fixPath(path));
             auto fileReader = file->reader().buffer();
             IO::WorldReader worldReader(std::begin(fileReader), std::end(fileReader));
-            return worldReader.read(format, worldBounds, parserStatus);
+            return worldReader.readInParallel(format, worldBounds, parserStatus);
         }
 
         void GameImpl::doWriteMap(World& world, const IO::Path& path) const {
@@ -151,6 +152,15 @@ namespace TrenchBroom {
             writer.writeMap();
         }
 
+        void GameImpl::doWriteMapSnapshot(const IO::MapSnapshot& snapshot, const IO::Path& path) const {
+            const auto mapFormatName = formatName(snapshot.format());
+
+            IO::OpenFile open(path, true);
+            IO::writeGameComment(open.file, gameName(), mapFormatName);
+
+            snapshot.write(open.file);
+        }
+
         void GameImpl::doExportMap(World& world, const Model::ExportFormat format, const IO::Path& path) const {
             IO::OpenFile open(path, true);
 
@@ -268,7 +278,7 @@ namespace TrenchBroom {
         }
 
         void GameImpl::doReloadShaders() {
-            m_fs.reloadShaders();
+            m_fs.reload();
         }
 
         bool GameImpl::doIsEntityDefinitionFile(const IO::Path& path) const {
@@ -244,6 +244,7 @@ namespace TrenchBroom {
         void Group::doTransform(const vm::mat4x4& transformation, const bool lockTextures, const vm::bbox3& worldBounds) {
             TransformObjectVisitor visitor(transformation, lockTextures, worldBounds);
             iterate(visitor);
+            visitor.transformBrushes();
         }
 
         bool Group::doContains(const Node* node) const {
@@ -142,5 +142,17 @@ namespace TrenchBroom {
             }
             return false;
         }
+
+        VisibleHitFilter::VisibleHitFilter(const EditorContext& context) :
+        m_context(context) {}
+
+        HitFilter* VisibleHitFilter::doClone() const {
+            return new VisibleHitFilter(m_context);
+        }
+
+        bool VisibleHitFilter::doMatches(const Hit& hit) const {
+            const auto* node = hitToNode(hit);
+            return node == nullptr || m_context.visible(node);
+        }
     }
 }
@@ -92,6 +92,20 @@ namespace TrenchBroom {
             HitFilter* doClone() const override;
             bool doMatches(const Hit& hit) const override;
         };
+
+        /**
+         * Matches the hits of nodes that are visible in the given editor context, and hits that do not belong to a
+         * node.
+         */
+        class VisibleHitFilter : public HitFilter {
+        private:
+            const EditorContext& m_context;
+        public:
+            VisibleHitFilter(const EditorContext& context);
+        private:
+            HitFilter* doClone() const override;
+            bool doMatches(const Hit& hit) const override;
+        };
     }
 }
 
@@ -0,0 +1,182 @@
+/*
+ Copyright (C) 2010-2019 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "InternedString.h"
+
+#include <cassert>
+#include <mutex>
+#include <string_view>
+#include <unordered_map>
+
+namespace TrenchBroom {
+    namespace Model {
+        struct InternedString::Entry {
+            const String value;
+            std::atomic<size_t> refCount;
+
+            explicit Entry(const String& i_value) :
+            value(i_value),
+            refCount(1) {}
+        };
+
+        namespace {
+            class Pool {
+            private:
+                // the keys point to the strings stored in the entries
+                using EntryMap = std::unordered_map<std::string_view, InternedString::Entry*>;
+                EntryMap m_entries;
+                mutable std::mutex m_mutex;
+            public:
+                InternedString::Entry* acquire(const String& str) {
+                    std::lock_guard<std::mutex> lock(m_mutex);
+                    const auto it = m_entries.find(std::string_view(str));
+                    if (it != std::end(m_entries)) {
+                        auto* entry = it->second;
+                        ++entry->refCount;
+                        return entry;
+                    }
+
+                    auto* entry = new InternedString::Entry(str);
+                    m_entries.emplace(std::string_view(entry->value), entry);
+                    return entry;
+                }
+
+                InternedString::Entry* find(const String& str) {
+                    std::lock_guard<std::mutex> lock(m_mutex);
+                    const auto it = m_entries.find(std::string_view(str));
+                    if (it == std::end(m_entries))
+                        return nullptr;
+
+                    auto* entry = it->second;
+                    ++entry->refCount;
+                    return entry;
+                }
+
+                void release(InternedString::Entry* entry) {
+                    // Decrement without locking as long as this is not the last reference. The count only drops to
+                    // zero while the pool is locked, so a concurrent acquire cannot revive an entry that is about to
+                    // be deleted.
+                    size_t count = entry->refCount.load();
+                    while (count > 1) {
+                        if (entry->refCount.compare_exchange_weak(count, count - 1))
+                            return;
+                    }
+
+                    std::lock_guard<std::mutex> lock(m_mutex);
+                    if (--entry->refCount == 0) {
+                        m_entries.erase(std::string_view(entry->value));
+                        delete entry;
+                    }
+                }
+
+                size_t size() const {
+                    std::lock_guard<std::mutex> lock(m_mutex);
+                    return m_entries.size();
+                }
+            };
+
+            Pool& pool() {
+                // never destroyed so that handles in static objects can still be released on shutdown
+                static auto* pool = new Pool();
+                return *pool;
+            }
+        }
+
+        InternedString::InternedString() :
+        m_entry(nullptr) {}
+
+        InternedString::InternedString(const String& str) :
+        m_entry(str.empty() ? nullptr : pool().acquire(str)) {}
+
+        InternedString::InternedString(const InternedString& other) :
+        m_entry(other.m_entry) {
+            if (m_entry != nullptr)
+                m_entry->refCount.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        InternedString::InternedString(InternedString&& other) noexcept :
+        m_entry(other.m_entry) {
+            other.m_entry = nullptr;
+        }
+
+        InternedString::InternedString(Entry* entry) :
+        m_entry(entry) {}
+
+        InternedString::~InternedString() {
+            if (m_entry != nullptr)
+                pool().release(m_entry);
+        }
+
+        InternedString& InternedString::operator=(InternedString other) {
+            swap(*this, other);
+            return *this;
+        }
+
+        bool InternedString::find(const String& str, InternedString& result) {
+            if (str.empty()) {
+                result = InternedString();
+                return true;
+            }
+
+            auto* entry = pool().find(str);
+            if (entry == nullptr)
+                return false;
+
+            result = InternedString(entry);
+            return true;
+        }
+
+        size_t InternedString::poolSize() {
+            return pool().size();
+        }
+
+        const String& InternedString::str() const {
+            return m_entry != nullptr ? m_entry->value : EmptyString;
+        }
+
+        bool InternedString::empty() const {
+            return m_entry == nullptr;
+        }
+
+        size_t InternedString::hash() const {
+            return std::hash<const Entry*>()(m_entry);
+        }
+
+        bool InternedString::operator==(const InternedString& rhs) const {
+            return m_entry == rhs.m_entry;
+        }
+
+        bool InternedString::operator!=(const InternedString& rhs) const {
+            return m_entry != rhs.m_entry;
+        }
+
+        bool InternedString::operator==(const String& rhs) const {
+            return str() == rhs;
+        }
+
+        bool InternedString::operator!=(const String& rhs) const {
+            return str() != rhs;
+        }
+
+        void swap(InternedString& lhs, InternedString& rhs) noexcept {
+            using std::swap;
+            swap(lhs.m_entry, rhs.m_entry);
+        }
+    }
+}
@@ -0,0 +1,91 @@
+/*
+ Copyright (C) 2010-2019 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef TrenchBroom_InternedString
+#define TrenchBroom_InternedString
+
+#include "StringUtils.h"
+
+#include <atomic>
+#include <cstddef>
+#include <functional>
+
+namespace TrenchBroom {
+    namespace Model {
+        /**
+         * A handle to an immutable string that is stored only once in a shared pool.
+         *
+         * Entity attribute names and many attribute values repeat across thousands of entities, so every distinct
+         * string is stored once and the handles only hold a pointer to it. Two handles are equal if and only if their
+         * strings are equal, so comparing them is a pointer comparison. The pool is reference counted and releases a
+         * string when its last handle is destroyed. Handles can be created, copied and destroyed on any thread.
+         *
+         * The empty string is not stored in the pool, a default constructed handle represents it.
+         */
+        class InternedString {
+        public:
+            struct Entry;
+        private:
+            Entry* m_entry;
+        public:
+            InternedString();
+            explicit InternedString(const String& str);
+            InternedString(const InternedString& other);
+            InternedString(InternedString&& other) noexcept;
+            ~InternedString();
+
+            InternedString& operator=(InternedString other);
+
+            /**
+             * Returns the handle of the given string if it is currently interned. Returns false if it is not, and no
+             * handle with that string exists.
+             */
+            static bool find(const String& str, InternedString& result);
+
+            /**
+             * Returns the number of distinct strings currently in the pool.
+             */
+            static size_t poolSize();
+
+            const String& str() const;
+            bool empty() const;
+            size_t hash() const;
+
+            bool operator==(const InternedString& rhs) const;
+            bool operator!=(const InternedString& rhs) const;
+            bool operator==(const String& rhs) const;
+            bool operator!=(const String& rhs) const;
+
+            friend void swap(InternedString& lhs, InternedString& rhs) noexcept;
+        private:
+            explicit InternedString(Entry* entry);
+        };
+    }
+}
+
+namespace std {
+    template <>
+    struct hash<TrenchBroom::Model::InternedString> {
+        size_t operator()(const TrenchBroom::Model::InternedString& str) const {
+            return str.hash();
+        }
+    };
+}
+
+#endif /* defined(TrenchBroom_InternedString) */
@@ -25,6 +25,7 @@
 #include "Model/EditorContext.h"
 #include "Model/Node.h"
 
+#include <atomic>
 #include <cassert>
 
 namespace TrenchBroom {
@@ -88,7 +89,8 @@ namespace TrenchBroom {
         }
 
         size_t Issue::nextSeqId() {
-            static size_t seqId = 0;
+            // issues can be generated on several threads at once
+            static std::atomic<size_t> seqId(0);
             return seqId++;
         }
 
@@ -39,6 +39,7 @@ namespace TrenchBroom {
         m_lineNumber(0),
         m_lineCount(0),
         m_issuesValid(false),
+        m_issuesQueued(false),
         m_hiddenIssues(0) {}
 
         Node::~Node() {
@@ -565,6 +566,10 @@ namespace TrenchBroom {
             return m_lineNumber;
         }
 
+        size_t Node::lineCount() const {
+            return m_lineCount;
+        }
+
         void Node::setFilePosition(const size_t lineNumber, const size_t lineCount) {
             m_lineNumber = lineNumber;
             m_lineCount = lineCount;
@@ -600,9 +605,25 @@ namespace TrenchBroom {
             }
         }
 
-        void Node::invalidateIssues() const {
+        void Node::invalidateIssues() {
             clearIssues();
             m_issuesValid = false;
+
+            if (!m_issuesQueued) {
+                Node* root = this;
+                while (root->m_parent != nullptr) {
+                    root = root->m_parent;
+                }
+                m_issuesQueued = root->doQueueIssueValidation(this);
+            }
+        }
+
+        bool Node::issuesQueued() const {
+            return m_issuesQueued;
+        }
+
+        void Node::setIssuesQueued(const bool issuesQueued) {
+            m_issuesQueued = issuesQueued;
         }
 
         void Node::clearIssues() const {
@@ -617,12 +638,12 @@ namespace TrenchBroom {
             return doFindAttributableNodesWithNumberedAttribute(prefix, value, result);
         }
 
-        void Node::addToIndex(AttributableNode* attributable, const AttributeName& name, const AttributeValue& value) {
-            doAddToIndex(attributable, name, value);
+        void Node::addToIndex(AttributableNode* attributable, const EntityAttribute& attribute) {
+            doAddToIndex(attributable, attribute);
         }
 
-        void Node::removeFromIndex(AttributableNode* attributable, const AttributeName& name, const AttributeValue& value) {
-            doRemoveFromIndex(attributable, name, value);
+        void Node::removeFromIndex(AttributableNode* attributable, const EntityAttribute& attribute) {
+            doRemoveFromIndex(attributable, attribute);
         }
 
         Node* Node::doCloneRecursively(const vm::bbox3& worldBounds) const {
@@ -645,6 +666,7 @@ namespace TrenchBroom {
         void Node::doDescendantWillBeRemoved(Node* node, const size_t depth) {}
         void Node::doDescendantWasRemoved(Node* oldParent, Node* node, const size_t depth) {}
         bool Node::doShouldPropagateDescendantEvents() const { return true; }
+        bool Node::doQueueIssueValidation(Node* node) { return false; }
 
         void Node::doParentWillChange() {}
         void Node::doParentDidChange() {}
@@ -670,14 +692,14 @@ namespace TrenchBroom {
                 m_parent->findAttributableNodesWithNumberedAttribute(prefix, value, result);
         }
 
-        void Node::doAddToIndex(AttributableNode* attributable, const AttributeName& name, const AttributeValue& value) {
+        void Node::doAddToIndex(AttributableNode* attributable, const EntityAttribute& attribute) {
             if (m_parent != nullptr)
-                m_parent->addToIndex(attributable, name, value);
+                m_parent->addToIndex(attributable, attribute);
         }
 
-        void Node::doRemoveFromIndex(AttributableNode* attributable, const AttributeName& name, const AttributeValue& value) {
+        void Node::doRemoveFromIndex(AttributableNode* attributable, const EntityAttribute& attribute) {
             if (m_parent != nullptr)
-                m_parent->removeFromIndex(attributable, name, value);
+                m_parent->removeFromIndex(attributable, attribute);
         }
     }
 }
@@ -25,6 +25,7 @@
 
 namespace TrenchBroom {
     namespace Model {
+        class EntityAttribute;
         class IssueGeneratorRegistry;
         class PickResult;
 
@@ -46,6 +47,7 @@ namespace TrenchBroom {
 
             mutable IssueList m_issues;
             mutable bool m_issuesValid;
+            bool m_issuesQueued;
             IssueType m_hiddenIssues;
         protected:
             Node();
@@ -251,6 +253,7 @@ namespace TrenchBroom {
             FloatType intersectWithRay(const vm::ray3& ray) const;
         public: // file position
             size_t lineNumber() const;
+            size_t lineCount() const;
             void setFilePosition(size_t lineNumber, size_t lineCount);
             bool containsLine(size_t lineNumber) const;
         public: // issue management
@@ -259,9 +262,18 @@ namespace TrenchBroom {
             bool issueHidden(IssueType type) const;
             void setIssueHidden(IssueType type, bool hidden);
         public: // should only be called from this and from the world
-            void invalidateIssues() const;
-        private:
+            /**
+             * Discards the issues of this node and queues it for validation by the world that contains it, if any.
+             */
+            void invalidateIssues();
+            /**
+             * Generates the issues of this node unless they are still valid. Different nodes can be validated on
+             * different threads at the same time.
+             */
             void validateIssues(const IssueGeneratorList& issueGenerators);
+            bool issuesQueued() const;
+            void setIssuesQueued(bool issuesQueued);
+        private:
             void clearIssues() const;
         public: // visitors
             template <class V>
@@ -397,8 +409,8 @@ namespace TrenchBroom {
             void findAttributableNodesWithAttribute(const AttributeName& name, const AttributeValue& value, AttributableNodeList& result) const;
             void findAttributableNodesWithNumberedAttribute(const AttributeName& prefix, const AttributeValue& value, AttributableNodeList& result) const;
 
-            void addToIndex(AttributableNode* attributable, const AttributeName& name, const AttributeValue& value);
-            void removeFromIndex(AttributableNode* attributable, const AttributeName& name, const AttributeValue& value);
+            void addToIndex(AttributableNode* attributable, const EntityAttribute& attribute);
+            void removeFromIndex(AttributableNode* attributable, const EntityAttribute& attribute);
         private: // subclassing interface
             virtual const String& doGetName() const = 0;
             virtual const vm::bbox3& doGetBounds() const = 0;
@@ -445,6 +457,7 @@ namespace TrenchBroom {
             virtual FloatType doIntersectWithRay(const vm::ray3& ray) const = 0;
 
             virtual void doGenerateIssues(const IssueGenerator* generator, IssueList& issues) = 0;
+            virtual bool doQueueIssueValidation(Node* node);
 
             virtual void doAccept(NodeVisitor& visitor) = 0;
             virtual void doAccept(ConstNodeVisitor& visitor) const = 0;
@@ -452,8 +465,8 @@ namespace TrenchBroom {
             virtual void doFindAttributableNodesWithAttribute(const AttributeName& name, const AttributeValue& value, AttributableNodeList& result) const;
             virtual void doFindAttributableNodesWithNumberedAttribute(const AttributeName& prefix, const AttributeValue& value, AttributableNodeList& result) const;
 
-            virtual void doAddToIndex(AttributableNode* attributable, const AttributeName& name, const AttributeValue& value);
-            virtual void doRemoveFromIndex(AttributableNode* attributable, const AttributeName& name, const AttributeValue& value);
+            virtual void doAddToIndex(AttributableNode* attributable, const EntityAttribute& attribute);
+            virtual void doRemoveFromIndex(AttributableNode* attributable, const EntityAttribute& attribute);
         };
     }
 }
@@ -0,0 +1,93 @@
+/*
+ Copyright (C) 2010-2019 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "NodeMemorySizeVisitor.h"
+
+#include "Model/Brush.h"
+#include "Model/BrushFace.h"
+#include "Model/BrushGeometry.h"
+#include "Model/Entity.h"
+#include "Model/Group.h"
+#include "Model/Layer.h"
+#include "Model/World.h"
+
+namespace TrenchBroom {
+    namespace Model {
+        NodeMemorySizeVisitor::NodeMemorySizeVisitor() :
+        m_memorySize(0) {}
+
+        size_t NodeMemorySizeVisitor::memorySize() const {
+            return m_memorySize;
+        }
+
+        void NodeMemorySizeVisitor::doVisit(const World* world) {
+            m_memorySize += sizeof(World);
+            addChildren(world);
+        }
+
+        void NodeMemorySizeVisitor::doVisit(const Layer* layer) {
+            m_memorySize += sizeof(Layer);
+            addChildren(layer);
+        }
+
+        void NodeMemorySizeVisitor::doVisit(const Group* group) {
+            m_memorySize += sizeof(Group);
+            addChildren(group);
+        }
+
+        void NodeMemorySizeVisitor::doVisit(const Entity* entity) {
+            m_memorySize += sizeof(Entity);
+            m_memorySize += entity->attributes().size() * sizeof(EntityAttribute);
+            addChildren(entity);
+        }
+
+        void NodeMemorySizeVisitor::doVisit(const Brush* brush) {
+            m_memorySize += sizeof(Brush);
+            m_memorySize += brush->faceCount() * (sizeof(BrushFace*) + sizeof(BrushFace));
+            m_memorySize += brush->vertexCount() * sizeof(BrushVertex);
+            m_memorySize += brush->edgeCount() * (sizeof(BrushEdge) + 2 * sizeof(BrushHalfEdge));
+            m_memorySize += brush->faceCount() * sizeof(BrushFaceGeometry);
+        }
+
+        void NodeMemorySizeVisitor::addChildren(const Node* node) {
+            m_memorySize += node->childCount() * sizeof(Node*);
+        }
+
+        size_t memorySize(const Model::NodeList& nodes) {
+            return memorySize(std::begin(nodes), std::end(nodes));
+        }
+
+        size_t memorySize(const Model::ParentChildrenMap& nodes) {
+            size_t result = 0;
+            for (const auto& entry : nodes) {
+                result += memorySize(entry.second);
+            }
+            return result;
+        }
+
+        size_t referencesMemorySize(const Model::ParentChildrenMap& nodes) {
+            size_t result = 0;
+            for (const auto& entry : nodes) {
+                result += sizeof(entry) + entry.second.capacity() * sizeof(Node*);
+            }
+            return result;
+        }
+    }
+}
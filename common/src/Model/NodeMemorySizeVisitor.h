@@ -0,0 +1,68 @@
+/*
+ Copyright (C) 2010-2019 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef TrenchBroom_NodeMemorySizeVisitor
+#define TrenchBroom_NodeMemorySizeVisitor
+
+#include "Model/ModelTypes.h"
+#include "Model/Node.h"
+#include "Model/NodeVisitor.h"
+
+#include <cstddef>
+
+namespace TrenchBroom {
+    namespace Model {
+        /**
+         * Estimates the number of bytes of memory that the visited nodes occupy, including their brush faces and
+         * brush geometry. Interned strings are shared between nodes and are not counted.
+         */
+        class NodeMemorySizeVisitor : public ConstNodeVisitor {
+        private:
+            size_t m_memorySize;
+        public:
+            NodeMemorySizeVisitor();
+            size_t memorySize() const;
+        private:
+            void doVisit(const World* world) override;
+            void doVisit(const Layer* layer) override;
+            void doVisit(const Group* group) override;
+            void doVisit(const Entity* entity) override;
+            void doVisit(const Brush* brush) override;
+            void addChildren(const Node* node);
+        };
+
+        size_t memorySize(const Model::NodeList& nodes);
+        size_t memorySize(const Model::ParentChildrenMap& nodes);
+
+        /**
+         * Estimates the number of bytes of memory that the given map occupies without the nodes that it refers to.
+         */
+        size_t referencesMemorySize(const Model::ParentChildrenMap& nodes);
+
+        template <typename I>
+        size_t memorySize(I cur, I end) {
+            NodeMemorySizeVisitor visitor;
+            Node::acceptAndRecurse(cur, end, visitor);
+            return visitor.memorySize();
+        }
+    }
+}
+
+#endif /* defined(TrenchBroom_NodeMemorySizeVisitor) */
@@ -20,9 +20,13 @@
 #include "PickResult.h"
 
 #include "Model/CompareHits.h"
+#include "Model/HitFilter.h"
 
 #include <vecmath/util.h>
 
+#include <cassert>
+#include <limits>
+
 namespace TrenchBroom {
     namespace Model {
         class PickResult::CompareWrapper {
@@ -35,7 +39,8 @@ namespace TrenchBroom {
 
         PickResult::PickResult() :
         m_editorContext(nullptr),
-        m_compare(new CompareHitsByDistance()) {}
+        m_compare(new CompareHitsByDistance()),
+        m_maxHits(0) {}
 
         PickResult PickResult::byDistance(const EditorContext& editorContext) {
             CompareHits* compare = new CombineCompareHits(new CompareHitsByDistance(),
@@ -43,6 +48,14 @@ namespace TrenchBroom {
             return PickResult(editorContext, compare);
         }
 
+        PickResult PickResult::byDistance(const EditorContext& editorContext, const size_t maxHits, HitFilter* filter) {
+            assert(maxHits > 0);
+            PickResult result = byDistance(editorContext);
+            result.m_filter = FilterPtr(filter);
+            result.m_maxHits = maxHits;
+            return result;
+        }
+
         PickResult PickResult::bySize(const EditorContext& editorContext, const vm::axis::type axis) {
             return PickResult(editorContext, new CompareHitsBySize(axis));
         }
@@ -55,10 +68,33 @@ namespace TrenchBroom {
             return m_hits.size();
         }
 
+        size_t PickResult::maxHits() const {
+            return m_maxHits;
+        }
+
+        FloatType PickResult::maxHitDistance() const {
+            if (m_maxHits == 0 || m_hits.size() < m_maxHits) {
+                return std::numeric_limits<FloatType>::max();
+            }
+            return m_hits.back().distance();
+        }
+
         void PickResult::addHit(const Hit& hit) {
             ensure(m_compare.get() != nullptr, "compare is null");
+            if (m_filter != nullptr && !m_filter->matches(hit)) {
+                return;
+            }
+
             Hit::List::iterator pos = std::upper_bound(std::begin(m_hits), std::end(m_hits), hit, CompareWrapper(m_compare.get()));
-            m_hits.insert(pos, hit);
+            if (m_maxHits > 0 && m_hits.size() == m_maxHits) {
+                if (pos == std::end(m_hits)) {
+                    return;
+                }
+                m_hits.insert(pos, hit);
+                m_hits.pop_back();
+            } else {
+                m_hits.insert(pos, hit);
+            }
         }
 
         const Hit::List& PickResult::all() const {
@@ -26,6 +26,8 @@
 
 #include <vecmath/util.h>
 
+#include <memory>
+
 namespace TrenchBroom {
     namespace Model {
         class CompareHits;
@@ -36,23 +38,55 @@ namespace TrenchBroom {
         public:
             using ComparePtr = std::shared_ptr<CompareHits>;
         private:
+            using FilterPtr = std::shared_ptr<HitFilter>;
+
             const EditorContext* m_editorContext;
             Hit::List m_hits;
             ComparePtr m_compare;
+            FilterPtr m_filter;
+            size_t m_maxHits;
             class CompareWrapper;
         public:
             PickResult(const EditorContext& editorContext, CompareHits* compare) :
             m_editorContext(&editorContext),
-            m_compare(compare) {}
+            m_compare(compare),
+            m_maxHits(0) {}
 
             PickResult();
 
             static PickResult byDistance(const EditorContext& editorContext);
+
+            /**
+             * Returns a pick result that only keeps the given number of nearest hits which match the given filter. All
+             * other hits are discarded when they are added. Once the result is full, nodes that cannot yield a nearer
+             * hit need not be picked at all, see maxHitDistance().
+             *
+             * Use this if only the first few hits of a query are needed, and pass a filter that accepts every hit that
+             * the query could return.
+             *
+             * @param editorContext the editor context
+             * @param maxHits the number of hits to keep, must not be 0
+             * @param filter the filter that the hits must match, this pick result takes ownership of it
+             * @return the pick result
+             */
+            static PickResult byDistance(const EditorContext& editorContext, size_t maxHits, HitFilter* filter);
             static PickResult bySize(const EditorContext& editorContext, vm::axis::type axis);
 
             bool empty() const;
             size_t size() const;
 
+            /**
+             * Returns the number of hits that this pick result keeps, or 0 if it keeps all hits.
+             */
+            size_t maxHits() const;
+
+            /**
+             * Returns the distance beyond which no hit can be added to this pick result anymore. This is the distance
+             * of the farthest hit if this result only keeps a limited number of hits and is full, and the maximum
+             * value otherwise.
+             */
+            FloatType maxHitDistance() const;
+
             void addHit(const Hit& hit);
 
             const Hit::List& all() const;
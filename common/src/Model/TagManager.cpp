@@ -19,10 +19,19 @@
 
 #include "TagManager.h"
 
+#include "Model/AttributableNode.h"
+#include "Model/Brush.h"
+#include "Model/BrushFace.h"
 #include "Model/Tag.h"
+#include "Model/TagVisitor.h"
 
 #include <algorithm>
+#include <deque>
+#include <functional>
+#include <mutex>
 #include <stdexcept>
+#include <string_view>
+#include <unordered_map>
 
 namespace TrenchBroom {
     namespace Model {
@@ -45,8 +54,125 @@ namespace TrenchBroom {
             }
         };
 
+        /**
+         * Maps the properties that the smart tags of brush faces and brushes depend on to the matching tags.
+         */
+        class TagManager::TagCache {
+        private:
+            struct FaceKey {
+                std::string_view textureName;
+                const Assets::Texture* texture;
+                int surfaceContents;
+                int surfaceFlags;
+
+                explicit FaceKey(const BrushFace& face) :
+                textureName(face.textureName()),
+                texture(face.texture()),
+                surfaceContents(face.surfaceContents()),
+                surfaceFlags(face.surfaceFlags()) {}
+
+                bool operator==(const FaceKey& other) const {
+                    return (textureName == other.textureName &&
+                            texture == other.texture &&
+                            surfaceContents == other.surfaceContents &&
+                            surfaceFlags == other.surfaceFlags);
+                }
+            };
+
+            struct FaceKeyHash {
+                size_t operator()(const FaceKey& key) const {
+                    size_t result = std::hash<std::string_view>()(key.textureName);
+                    result = result * 31 + std::hash<const Assets::Texture*>()(key.texture);
+                    result = result * 31 + std::hash<int>()(key.surfaceContents);
+                    result = result * 31 + std::hash<int>()(key.surfaceFlags);
+                    return result;
+                }
+            };
+
+            struct BrushKey {
+                bool hasEntity;
+                std::string_view classname;
+
+                explicit BrushKey(const Brush& brush) :
+                hasEntity(brush.entity() != nullptr),
+                classname(hasEntity ? std::string_view(brush.entity()->classname()) : std::string_view()) {}
+
+                bool operator==(const BrushKey& other) const {
+                    return hasEntity == other.hasEntity && classname == other.classname;
+                }
+            };
+
+            struct BrushKeyHash {
+                size_t operator()(const BrushKey& key) const {
+                    return std::hash<std::string_view>()(key.classname) * 31 + std::hash<bool>()(key.hasEntity);
+                }
+            };
+
+            std::unordered_map<FaceKey, Tag::TagType, FaceKeyHash> m_faceTags;
+            std::unordered_map<BrushKey, Tag::TagType, BrushKeyHash> m_brushTags;
+
+            // the keys refer to these strings, which must therefore not move in memory
+            std::deque<String> m_strings;
+
+            // std::shared_mutex is not available on all supported platforms
+            mutable std::mutex m_mutex;
+        public:
+            template <typename M>
+            Tag::TagType faceTags(const BrushFace& face, const M& matchTags) {
+                FaceKey key(face);
+                return findOrInsert(m_faceTags, key, key.textureName, matchTags);
+            }
+
+            template <typename M>
+            Tag::TagType brushTags(const Brush& brush, const M& matchTags) {
+                BrushKey key(brush);
+                return findOrInsert(m_brushTags, key, key.classname, matchTags);
+            }
+
+            void clear() {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                m_faceTags.clear();
+                m_brushTags.clear();
+                m_strings.clear();
+            }
+        private:
+            template <typename Map, typename K, typename M>
+            Tag::TagType findOrInsert(Map& map, K& key, std::string_view& keyString, const M& matchTags) {
+                {
+                    std::lock_guard<std::mutex> lock(m_mutex);
+                    const auto it = map.find(key);
+                    if (it != std::end(map)) {
+                        return it->second;
+                    }
+                }
+
+                // match without holding the lock, another thread may insert the same key in the meantime
+                const auto tags = matchTags();
+
+                std::lock_guard<std::mutex> lock(m_mutex);
+                if (map.count(key) == 0) {
+                    m_strings.emplace_back(keyString);
+                    keyString = m_strings.back();
+                    map.emplace(key, tags);
+                }
+                return tags;
+            }
+        };
+
+        class TagManager::TagCacheVisitor : public ConstTagVisitor {
+        public:
+            const BrushFace* face = nullptr;
+            const Brush* brush = nullptr;
+
+            void visit(const BrushFace& i_face) override { face = &i_face; }
+            void visit(const Brush& i_brush) override { brush = &i_brush; }
+        };
+
         TagManager::TagManager() :
-        m_currentTagTypeIndex(0) {}
+        m_currentTagTypeIndex(0),
+        m_tagCache(std::make_unique<TagCache>()) {}
+
+        TagManager::~TagManager() = default;
 
         const std::list<SmartTag>& TagManager::smartTags() const {
             return m_smartTags;
@@ -94,16 +220,49 @@ namespace TrenchBroom {
             } else {
                 throw std::logic_error("Smart tag already registered");
             }
+            clearTagCache();
         }
 
         void TagManager::clearSmartTags() {
             m_smartTags.clear();
+            clearTagCache();
         }
 
         void TagManager::updateTags(Taggable& taggable) const {
+            TagCacheVisitor visitor;
+            taggable.accept(visitor);
+
+            const auto matchTags = [&]() { return matchSmartTags(taggable); };
+            Tag::TagType tags;
+            if (visitor.face != nullptr) {
+                tags = m_tagCache->faceTags(*visitor.face, matchTags);
+            } else if (visitor.brush != nullptr) {
+                tags = m_tagCache->brushTags(*visitor.brush, matchTags);
+            } else {
+                tags = matchTags();
+            }
+
             for (const auto& tag : m_smartTags) {
-                tag.update(taggable);
+                if ((tags & tag.type()) != 0) {
+                    taggable.addTag(tag);
+                } else {
+                    taggable.removeTag(tag);
+                }
+            }
+        }
+
+        void TagManager::clearTagCache() {
+            m_tagCache->clear();
+        }
+
+        Tag::TagType TagManager::matchSmartTags(const Taggable& taggable) const {
+            Tag::TagType result = 0;
+            for (const auto& tag : m_smartTags) {
+                if (tag.matches(taggable)) {
+                    result |= tag.type();
+                }
             }
+            return result;
         }
 
         size_t TagManager::freeTagIndex() {
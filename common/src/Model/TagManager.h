@@ -24,6 +24,7 @@
 #include "Model/Tag.h"
 
 #include <list>
+#include <memory>
 
 namespace TrenchBroom {
     namespace Model {
@@ -35,11 +36,15 @@ namespace TrenchBroom {
             size_t m_currentTagTypeIndex;
             std::list<SmartTag> m_smartTags;
             class TagCmp;
+            class TagCache;
+            class TagCacheVisitor;
+            std::unique_ptr<TagCache> m_tagCache;
         public:
             /**
              * Creates a new instance.
              */
             TagManager();
+            ~TagManager();
 
             /**
              * Returns a vector containing all smart tags registered with this manager.
@@ -99,10 +104,22 @@ namespace TrenchBroom {
             /**
              * Update the smart tags of the given taggable object.
              *
+             * The smart tags of a brush face only depend on its texture and its content and surface flags, and the
+             * smart tags of a brush only depend on the classname of its entity. The matching tags are therefore
+             * cached for every distinct combination of these, so that the tag matchers are only evaluated once for
+             * each of them. This function may be called for different objects on several threads at once.
+             *
              * @param taggable the object to update
              */
             void updateTags(Taggable& taggable) const;
+
+            /**
+             * Discards the cached smart tags. This must be called when the textures change since the cache refers to
+             * the textures of the brush faces.
+             */
+            void clearTagCache();
         private:
+            Tag::TagType matchSmartTags(const Taggable& taggable) const;
             size_t freeTagIndex();
         };
     }
@@ -21,17 +21,28 @@
 #define TrenchBroom_TransformObjectVisitor
 
 #include "TrenchBroom.h"
+#include "Model/ModelTypes.h"
 #include "Model/NodeVisitor.h"
 
 namespace TrenchBroom {
     namespace Model {
+        /**
+         * Transforms the visited groups, entities and brushes. The visited brushes are only collected, they are
+         * transformed together by transformBrushes so that their geometries can be rebuilt in parallel.
+         */
         class TransformObjectVisitor : public NodeVisitor {
         private:
             const vm::mat4x4& m_transformation;
             bool m_lockTextures;
             const vm::bbox3& m_worldBounds;
+            BrushList m_brushes;
         public:
             TransformObjectVisitor(const vm::mat4x4& transformation, bool lockTextures, const vm::bbox3& worldBounds);
+
+            /**
+             * Transforms the brushes that were visited since the last call.
+             */
+            void transformBrushes();
         private:
             void doVisit(World* world) override;
             void doVisit(Layer* layer) override;
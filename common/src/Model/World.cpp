@@ -24,16 +24,25 @@
 #include "Model/BrushFace.h"
 #include "Model/CollectNodesWithDescendantSelectionCountVisitor.h"
 #include "Model/IssueGenerator.h"
+#include "Model/PickResult.h"
 #include "Model/TagVisitor.h"
+#include "ParallelUtils.h"
+
+#include <algorithm>
 
 namespace TrenchBroom {
     namespace Model {
         World::World(MapFormat mapFormat, const vm::bbox3& worldBounds) :
         m_factory(mapFormat),
         m_defaultLayer(nullptr),
-        m_updateNodeTree(true) {
+        m_updateNodeTree(true),
+        m_flatNodeTreeValid(false),
+        m_nodeTreeQueried(false) {
             addOrUpdateAttribute(AttributeNames::Classname, AttributeValues::WorldspawnClassname);
             createDefaultLayer(worldBounds);
+
+            // moved nodes are refitted in place, so rebuild the tree from time to time to restore its quality
+            m_nodeTree.setRebuildRatio(8.0);
         }
 
         Layer* World::defaultLayer() const {
@@ -81,6 +90,32 @@ namespace TrenchBroom {
             invalidateAllIssues();
         }
 
+        NodeList World::validateQueuedIssues() {
+            NodeList nodes;
+            nodes.reserve(m_issueValidationQueue.size());
+            for (Node* node : m_issueValidationQueue) {
+                node->setIssuesQueued(false);
+                nodes.push_back(node);
+            }
+            m_issueValidationQueue.clear();
+
+            const auto& issueGenerators = registeredIssueGenerators();
+
+            // some generators for the world query the game, so the world must be validated on this thread
+            const auto worldIt = std::find(std::begin(nodes), std::end(nodes), this);
+            if (worldIt != std::end(nodes)) {
+                validateIssues(issueGenerators);
+            }
+
+            ParallelUtils::parallelFor(nodes.size(), [&](const size_t i) {
+                if (nodes[i] != this) {
+                    nodes[i]->validateIssues(issueGenerators);
+                }
+            });
+
+            return nodes;
+        }
+
         class World::AddNodeToNodeTree : public NodeVisitor {
         private:
             NodeTree& m_nodeTree;
@@ -119,18 +154,18 @@ namespace TrenchBroom {
 
         class World::UpdateNodeInNodeTree : public NodeVisitor {
         private:
-            NodeTree& m_nodeTree;
+            NodeTree::UpdateList& m_updates;
             const vm::bbox3 m_oldBounds;
         public:
-            UpdateNodeInNodeTree(NodeTree& nodeTree, const vm::bbox3& oldBounds) :
-            m_nodeTree(nodeTree),
+            UpdateNodeInNodeTree(NodeTree::UpdateList& updates, const vm::bbox3& oldBounds) :
+            m_updates(updates),
             m_oldBounds(oldBounds) {}
         private:
             void doVisit(World* world) override   {}
             void doVisit(Layer* layer) override   {}
-            void doVisit(Group* group) override   { m_nodeTree.update(m_oldBounds, group->bounds(), group); }
-            void doVisit(Entity* entity) override { m_nodeTree.update(m_oldBounds, entity->totalBounds(), entity); }
-            void doVisit(Brush* brush) override   { m_nodeTree.update(m_oldBounds, brush->bounds(), brush); }
+            void doVisit(Group* group) override   { m_updates.push_back(NodeTree::Update{ m_oldBounds, group->bounds(), group }); }
+            void doVisit(Entity* entity) override { m_updates.push_back(NodeTree::Update{ m_oldBounds, entity->totalBounds(), entity }); }
+            void doVisit(Brush* brush) override   { m_updates.push_back(NodeTree::Update{ m_oldBounds, brush->bounds(), brush }); }
         };
 
         class World::MatchTreeNodes {
@@ -139,6 +174,8 @@ namespace TrenchBroom {
         };
 
         void World::disableNodeTreeUpdates() {
+            // the nodes with pending updates may be removed and deleted while the updates are disabled
+            updateNodeTree();
             m_updateNodeTree = false;
         }
 
@@ -152,7 +189,46 @@ namespace TrenchBroom {
             CollectTreeNodes collect;
             acceptAndRecurse(collect);
 
+            m_nodeTreeUpdates.clear();
+            m_nodeTreeUpdateNodes.clear();
             m_nodeTree.clearAndBuild(collect.nodes(), [](const auto* node){ return node->bounds(); });
+            invalidateFlatNodeTree();
+        }
+
+        void World::updateNodeTree() const {
+            if (m_nodeTreeUpdates.empty()) {
+                return;
+            }
+
+            NodeTree::UpdateList updates;
+            updates.reserve(m_nodeTreeUpdates.size());
+            for (const auto& [node, oldBounds] : m_nodeTreeUpdates) {
+                UpdateNodeInNodeTree visitor(updates, oldBounds);
+                node->accept(visitor);
+            }
+
+            m_nodeTreeUpdates.clear();
+            m_nodeTreeUpdateNodes.clear();
+            m_nodeTree.update(updates);
+        }
+
+        void World::invalidateFlatNodeTree() {
+            m_flatNodeTreeValid = false;
+            m_nodeTreeQueried = false;
+        }
+
+        const World::FlatNodeTree* World::flatNodeTree() const {
+            updateNodeTree();
+            if (!m_flatNodeTreeValid) {
+                if (!m_nodeTreeQueried) {
+                    m_nodeTreeQueried = true;
+                    return nullptr;
+                }
+
+                m_nodeTree.flatten(m_flatNodeTree);
+                m_flatNodeTreeValid = true;
+            }
+            return &m_flatNodeTree;
         }
 
         class World::InvalidateAllIssuesVisitor : public NodeVisitor {
@@ -166,6 +242,27 @@ namespace TrenchBroom {
             void invalidateIssues(Node* node) { node->invalidateIssues(); }
         };
 
+        class World::DequeueIssueValidationVisitor : public NodeVisitor {
+        private:
+            NodeSet& m_queue;
+        public:
+            explicit DequeueIssueValidationVisitor(NodeSet& queue) :
+            m_queue(queue) {}
+        private:
+            void doVisit(World* world) override   { dequeue(world);  }
+            void doVisit(Layer* layer) override   { dequeue(layer);  }
+            void doVisit(Group* group) override   { dequeue(group);  }
+            void doVisit(Entity* entity) override { dequeue(entity); }
+            void doVisit(Brush* brush) override   { dequeue(brush);  }
+
+            void dequeue(Node* node) {
+                if (node->issuesQueued()) {
+                    m_queue.erase(node);
+                    node->setIssuesQueued(false);
+                }
+            }
+        };
+
         void World::invalidateAllIssues() {
             InvalidateAllIssuesVisitor visitor;
             acceptAndRecurse(visitor);
@@ -249,20 +346,34 @@ namespace TrenchBroom {
             if (m_updateNodeTree && node->shouldAddToSpacialIndex()) {
                 AddNodeToNodeTree visitor(m_nodeTree);
                 node->acceptAndRecurse(visitor);
+                invalidateFlatNodeTree();
             }
         }
 
         void World::doDescendantWillBeRemoved(Node* node, const size_t depth) {
             if (m_updateNodeTree && node->shouldAddToSpacialIndex()) {
+                // the removed nodes must be found with the bounds they have in the node tree
+                updateNodeTree();
                 RemoveNodeFromNodeTree visitor(m_nodeTree);
                 node->acceptAndRecurse(visitor);
+                invalidateFlatNodeTree();
             }
         }
 
+        void World::doDescendantWasRemoved(Node* oldParent, Node* node, const size_t depth) {
+            // the removed nodes are no longer part of this world, and they may be deleted before the queue is
+            // validated again
+            DequeueIssueValidationVisitor visitor(m_issueValidationQueue);
+            node->acceptAndRecurse(visitor);
+        }
+
         void World::doDescendantBoundsDidChange(Node* node, const vm::bbox3& oldBounds, const size_t depth) {
             if (m_updateNodeTree && node->shouldAddToSpacialIndex()) {
-                UpdateNodeInNodeTree visitor(m_nodeTree, oldBounds);
-                node->accept(visitor);
+                // only the first change is recorded because its old bounds are the bounds in the node tree
+                if (m_nodeTreeUpdateNodes.insert(node).second) {
+                    m_nodeTreeUpdates.emplace_back(node, oldBounds);
+                }
+                invalidateFlatNodeTree();
             }
         }
 
@@ -271,13 +382,32 @@ namespace TrenchBroom {
         }
 
         void World::doPick(const vm::ray3& ray, PickResult& pickResult) const {
-            for (const auto* node : m_nodeTree.findIntersectors(ray)) {
+            const auto* flatTree = flatNodeTree();
+            if (pickResult.maxHits() > 0) {
+                // Every hit of a node lies within its bounds, so once the result is full, the nodes whose bounds the
+                // ray enters beyond the farthest kept hit cannot contribute anymore.
+                const auto visitor = [&](const Node* node, const FloatType /* distance */) {
+                    node->pick(ray, pickResult);
+                    return pickResult.maxHitDistance();
+                };
+                if (flatTree != nullptr) {
+                    flatTree->findIntersectorsNearestFirst(ray, visitor);
+                } else {
+                    m_nodeTree.findIntersectorsNearestFirst(ray, visitor);
+                }
+                return;
+            }
+
+            const auto nodes = flatTree != nullptr ? flatTree->findIntersectors(ray) : m_nodeTree.findIntersectors(ray);
+            for (const auto* node : nodes) {
                 node->pick(ray, pickResult);
             }
         }
 
         void World::doFindNodesContaining(const vm::vec3& point, NodeList& result) {
-            for (auto* node : m_nodeTree.findContainers(point)) {
+            const auto* flatTree = flatNodeTree();
+            const auto nodes = flatTree != nullptr ? flatTree->findContainers(point) : m_nodeTree.findContainers(point);
+            for (auto* node : nodes) {
                 node->findNodesContaining(point, result);
             }
         }
@@ -290,6 +420,11 @@ namespace TrenchBroom {
             generator->generate(this, issues);
         }
 
+        bool World::doQueueIssueValidation(Node* node) {
+            m_issueValidationQueue.insert(node);
+            return true;
+        }
+
         void World::doAccept(NodeVisitor& visitor) {
             visitor.visit(this);
         }
@@ -299,19 +434,31 @@ namespace TrenchBroom {
         }
 
         void World::doFindAttributableNodesWithAttribute(const AttributeName& name, const AttributeValue& value, AttributableNodeList& result) const {
-            VectorUtils::append(result, m_attributableIndex.findAttributableNodes(AttributableNodeIndexQuery::exact(name), value));
+            if (name == AttributeNames::Targetname) {
+                m_linkIndex.findLinkTargets(value, result);
+            } else {
+                VectorUtils::append(result, m_attributableIndex.findAttributableNodes(AttributableNodeIndexQuery::exact(name), value));
+            }
         }
 
         void World::doFindAttributableNodesWithNumberedAttribute(const AttributeName& prefix, const AttributeValue& value, AttributableNodeList& result) const {
-            VectorUtils::append(result, m_attributableIndex.findAttributableNodes(AttributableNodeIndexQuery::numbered(prefix), value));
+            if (prefix == AttributeNames::Target) {
+                m_linkIndex.findLinkSources(value, result);
+            } else if (prefix == AttributeNames::Killtarget) {
+                m_linkIndex.findKillSources(value, result);
+            } else {
+                VectorUtils::append(result, m_attributableIndex.findAttributableNodes(AttributableNodeIndexQuery::numbered(prefix), value));
+            }
         }
 
-        void World::doAddToIndex(AttributableNode* attributable, const AttributeName& name, const AttributeValue& value) {
-            m_attributableIndex.addAttribute(attributable, name, value);
+        void World::doAddToIndex(AttributableNode* attributable, const EntityAttribute& attribute) {
+            m_attributableIndex.addAttribute(attributable, attribute);
+            m_linkIndex.addAttribute(attributable, attribute.name(), attribute.value());
         }
 
-        void World::doRemoveFromIndex(AttributableNode* attributable, const AttributeName& name, const AttributeValue& value) {
-            m_attributableIndex.removeAttribute(attributable, name, value);
+        void World::doRemoveFromIndex(AttributableNode* attributable, const EntityAttribute& attribute) {
+            m_attributableIndex.removeAttribute(attributable, attribute);
+            m_linkIndex.removeAttribute(attributable, attribute.name(), attribute.value());
         }
 
         void World::doAttributesDidChange(const vm::bbox3& oldBounds) {}
@@ -22,6 +22,7 @@
 
 #include "TrenchBroom.h"
 #include "AABBTree.h"
+#include "Model/AttributableLinkIndex.h"
 #include "Model/AttributableNode.h"
 #include "Model/AttributableNodeIndex.h"
 #include "Model/IssueGeneratorRegistry.h"
@@ -30,6 +31,11 @@
 #include "Model/ModelFactoryImpl.h"
 #include "Model/Node.h"
 
+#include <iterator>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
 namespace TrenchBroom {
     namespace Model {
         class PickResult;
@@ -39,11 +45,34 @@ namespace TrenchBroom {
             ModelFactoryImpl m_factory;
             Layer* m_defaultLayer;
             AttributableNodeIndex m_attributableIndex;
+            AttributableLinkIndex m_linkIndex;
             IssueGeneratorRegistry m_issueGeneratorRegistry;
 
             using NodeTree = AABBTree<FloatType, 3, Node*>;
-            NodeTree m_nodeTree;
+            mutable NodeTree m_nodeTree;
             bool m_updateNodeTree;
+
+            /*
+             * The nodes whose bounds changed since the node tree was last queried, with the bounds they had in the
+             * node tree. Operations such as transforming many brushes change the bounds of many nodes in a row, so
+             * these changes are applied to the node tree in one batch before it is queried again.
+             */
+            mutable std::vector<std::pair<Node*, vm::bbox3>> m_nodeTreeUpdates;
+            mutable std::unordered_set<Node*> m_nodeTreeUpdateNodes;
+
+            /*
+             * A flattened snapshot of the node tree that is used for picking and containment queries once the
+             * node tree stops changing. The snapshot is invalidated by every change to the node tree and it is
+             * only rebuilt once the node tree has been queried twice without any changes in between, so that
+             * interactive edits which alternate with picking don't cause a rebuild for every change.
+             */
+            using FlatNodeTree = NodeTree::FlatTree;
+            mutable FlatNodeTree m_flatNodeTree;
+            mutable bool m_flatNodeTreeValid;
+            mutable bool m_nodeTreeQueried;
+
+            // the nodes whose issues were invalidated since they were last validated by validateQueuedIssues
+            NodeSet m_issueValidationQueue;
         public:
             World(MapFormat mapFormat, const vm::bbox3& worldBounds);
         public: // layer management
@@ -60,6 +89,16 @@ namespace TrenchBroom {
             IssueQuickFixList quickFixes(IssueType issueTypes) const;
             void registerIssueGenerator(IssueGenerator* issueGenerator);
             void unregisterAllIssueGenerators();
+
+            /**
+             * Validates the issues of every node whose issues were invalidated since the last call and returns these
+             * nodes. The nodes are validated in parallel, except for the world itself, which is validated on the
+             * calling thread.
+             *
+             * A returned node's issues may have been valid already if they were requested in the meantime, so callers
+             * that cache issues should replace the cached issues of every returned node.
+             */
+            NodeList validateQueuedIssues();
         private:
             class AddNodeToNodeTree;
             class RemoveNodeFromNodeTree;
@@ -69,8 +108,31 @@ namespace TrenchBroom {
             void disableNodeTreeUpdates();
             void enableNodeTreeUpdates();
             void rebuildNodeTree();
+        public: // node tree queries
+            /**
+             * Finds every node in the node tree whose bounds overlap the volume given by the given function and
+             * appends it to the given list.
+             *
+             * @tparam F the type of the function that classifies a bounding box, must return a VolumeRelation
+             * @param relation the function that classifies a bounding box
+             * @param result the list to append the nodes to
+             */
+            template <typename F>
+            void findNodesInVolume(const F& relation, NodeList& result) const {
+                const auto* flatTree = flatNodeTree();
+                if (flatTree != nullptr) {
+                    flatTree->findInVolume(relation, std::back_inserter(result));
+                } else {
+                    m_nodeTree.findInVolume(relation, std::back_inserter(result));
+                }
+            }
+        private:
+            void updateNodeTree() const;
+            void invalidateFlatNodeTree();
+            const FlatNodeTree* flatNodeTree() const;
         private:
             class InvalidateAllIssuesVisitor;
+            class DequeueIssueValidationVisitor;
             void invalidateAllIssues();
         private: // implement Node interface
             const vm::bbox3& doGetBounds() const override;
@@ -83,6 +145,7 @@ namespace TrenchBroom {
 
             void doDescendantWasAdded(Node* node, size_t depth) override;
             void doDescendantWillBeRemoved(Node* node, size_t depth) override;
+            void doDescendantWasRemoved(Node* oldParent, Node* node, size_t depth) override;
             void doDescendantBoundsDidChange(Node* node, const vm::bbox3& oldBounds, size_t depth) override;
 
             bool doSelectable() const override;
@@ -90,12 +153,13 @@ namespace TrenchBroom {
             void doFindNodesContaining(const vm::vec3& point, NodeList& result) override;
             FloatType doIntersectWithRay(const vm::ray3& ray) const override;
             void doGenerateIssues(const IssueGenerator* generator, IssueList& issues) override;
+            bool doQueueIssueValidation(Node* node) override;
             void doAccept(NodeVisitor& visitor) override;
             void doAccept(ConstNodeVisitor& visitor) const override;
             void doFindAttributableNodesWithAttribute(const AttributeName& name, const AttributeValue& value, AttributableNodeList& result) const override;
             void doFindAttributableNodesWithNumberedAttribute(const AttributeName& prefix, const AttributeValue& value, AttributableNodeList& result) const override;
-            void doAddToIndex(AttributableNode* attributable, const AttributeName& name, const AttributeValue& value) override;
-            void doRemoveFromIndex(AttributableNode* attributable, const AttributeName& name, const AttributeValue& value) override;
+            void doAddToIndex(AttributableNode* attributable, const EntityAttribute& attribute) override;
+            void doRemoveFromIndex(AttributableNode* attributable, const EntityAttribute& attribute) override;
         private: // implement AttributableNode interface
             void doAttributesDidChange(const vm::bbox3& oldBounds) override;
             bool doIsAttributeNameMutable(const AttributeName& name) const override;
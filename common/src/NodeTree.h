@@ -26,6 +26,24 @@
 #include <functional>
 #include <list>
 
+/**
+ * The relation of a bounding box to the volume of a query, see AABBTree::findInVolume and FlatAABBTree::findInVolume.
+ */
+enum class VolumeRelation {
+    /**
+     * The box does not overlap the volume.
+     */
+    Outside,
+    /**
+     * The box overlaps the volume, but it is not entirely inside of it.
+     */
+    Intersecting,
+    /**
+     * The box is entirely inside the volume.
+     */
+    Inside
+};
+
 template <typename T, size_t S, typename U, typename Cmp = std::less<U>>
 class NodeTree {
 public:
@@ -0,0 +1,174 @@
+/*
+ Copyright (C) 2010-2019 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef TrenchBroom_ParallelUtils_h
+#define TrenchBroom_ParallelUtils_h
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+namespace ParallelUtils {
+    /**
+     * Returns the number of threads that parallel operations use, which is at least 1.
+     */
+    inline size_t threadCount() {
+        const auto count = std::thread::hardware_concurrency();
+        return count > 0 ? static_cast<size_t>(count) : 1u;
+    }
+
+    namespace detail {
+        /*
+         * The state that the worker threads of one call to parallelFor share with the calling thread.
+         */
+        struct WorkerContext {
+            std::mutex mutex;
+            std::vector<std::function<void()>> deferred;
+        };
+
+        inline WorkerContext*& workerContext() {
+            thread_local WorkerContext* context = nullptr;
+            return context;
+        }
+    }
+
+    /**
+     * Indicates whether the calling thread is a worker thread that was started by parallelFor. Code that must only
+     * run on the main thread, such as sending notifications to the UI, can use this to skip or defer such work.
+     */
+    inline bool isWorkerThread() {
+        return detail::workerContext() != nullptr;
+    }
+
+    /**
+     * Calls the given function on the thread that called parallelFor. If this is called on a worker thread, the
+     * function is deferred until all calls of parallelFor have completed and is then called on the thread that called
+     * parallelFor, in the order in which the functions were deferred. Otherwise, the function is called immediately.
+     */
+    inline void runOnCallingThread(std::function<void()> func) {
+        auto* context = detail::workerContext();
+        if (context == nullptr) {
+            func();
+        } else {
+            std::lock_guard<std::mutex> lock(context->mutex);
+            context->deferred.push_back(std::move(func));
+        }
+    }
+
+    /**
+     * Calls the given function once for every index in [0, count), distributing the calls over up to threadCount()
+     * threads. The calling thread takes part in the work, and the function returns once all calls have completed.
+     *
+     * The indices are handed out in ascending order, but the calls may complete in any order. The function must
+     * therefore not depend on the order of the calls and must synchronize any access to shared state itself.
+     *
+     * If a thread cannot be started, the work is distributed over the threads that are already running.
+     *
+     * If a call throws an exception, no further calls are started and the first exception that was thrown is
+     * rethrown on the calling thread after all threads have finished.
+     *
+     * @param count the number of indices
+     * @param func the function to call, must accept a single size_t argument
+     */
+    template <typename F>
+    void parallelFor(const size_t count, F&& func) {
+        const auto threads = std::min(threadCount(), count);
+        if (threads <= 1) {
+            for (size_t i = 0; i < count; ++i) {
+                func(i);
+            }
+            return;
+        }
+
+        std::atomic<size_t> next(0);
+        std::atomic<bool> failed(false);
+        std::exception_ptr exception;
+        std::mutex exceptionMutex;
+
+        const auto work = [&]() {
+            while (!failed) {
+                const auto index = next++;
+                if (index >= count) {
+                    return;
+                }
+
+                try {
+                    func(index);
+                } catch (...) {
+                    std::lock_guard<std::mutex> lock(exceptionMutex);
+                    if (!exception) {
+                        exception = std::current_exception();
+                    }
+                    failed = true;
+                }
+            }
+        };
+
+        detail::WorkerContext context;
+        std::vector<std::thread> workers;
+        workers.reserve(threads - 1);
+        for (size_t i = 1; i < threads; ++i) {
+            try {
+                workers.emplace_back([&]() {
+                    detail::workerContext() = &context;
+                    work();
+                });
+            } catch (const std::system_error&) {
+                // no more threads can be started, so the threads that are already running share the remaining work
+                break;
+            }
+        }
+
+        work();
+
+        for (auto& worker : workers) {
+            worker.join();
+        }
+
+        // if this is a worker thread itself, the deferred functions are passed on to its calling thread
+        for (auto& func : context.deferred) {
+            runOnCallingThread(std::move(func));
+        }
+
+        if (exception) {
+            std::rethrow_exception(exception);
+        }
+    }
+
+    /**
+     * Applies the given function to every element of the given vector in parallel and returns the results in the
+     * order of the corresponding elements. See parallelFor for the threading guarantees.
+     */
+    template <typename T, typename F>
+    auto parallelTransform(const std::vector<T>& vec, F&& func) -> std::vector<decltype(func(vec.front()))> {
+        std::vector<decltype(func(vec.front()))> result(vec.size());
+        parallelFor(vec.size(), [&](const size_t i) {
+            result[i] = func(vec[i]);
+        });
+        return result;
+    }
+}
+
+#endif
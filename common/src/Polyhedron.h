@@ -326,6 +326,18 @@ public: // Constructors
     explicit Polyhedron(const std::vector<V>& positions);
     Polyhedron(const std::vector<V>& positions, Callback& callback);
 
+    /**
+     Creates a polyhedron with the given topology. The faces are given as lists of indices into the given vertex
+     positions, with each face's vertices in counter clockwise order. The faces of the resulting polyhedron are in the
+     same order as the given faces.
+
+     No geometric checks are performed, so the given topology must be that of a convex polyhedron, e.g. one that was
+     taken from an existing polyhedron.
+
+     Throws a GeometryException if the given faces do not form a closed polyhedron or if any index is out of range.
+     */
+    Polyhedron(const std::vector<V>& positions, const std::vector<std::vector<size_t>>& faces);
+
     Polyhedron(const Polyhedron<T,FP,VP>& other);
     Polyhedron(Polyhedron<T,FP,VP>&& other) noexcept;
 private: // Constructor helpers
@@ -333,6 +345,7 @@ private: // Constructor helpers
     void setBounds(const vm::bbox<T,3>& bounds, Callback& callback);
 private: // Copy helper
     class Copy;
+    class Build;
 public: // Destructor
     virtual ~Polyhedron();
 public: // operators
@@ -21,6 +21,7 @@
 #define TrenchBroom_Polyhedron_Misc_h
 
 #include "CollectionUtils.h"
+#include "Exceptions.h"
 
 #include <vecmath/vec.h>
 #include <vecmath/ray.h>
@@ -29,7 +30,8 @@
 #include <vecmath/scalar.h>
 #include <vecmath/util.h>
 
-#include <map>
+#include <algorithm>
+#include <utility>
 
 template <typename T, typename FP, typename VP>
 class Polyhedron<T,FP,VP>::VertexDistanceCmp {
@@ -172,6 +174,11 @@ Polyhedron<T,FP,VP>::Polyhedron(const std::vector<V>& positions, Callback& callb
     addPoints(std::begin(positions), std::end(positions), callback);
 }
 
+template <typename T, typename FP, typename VP>
+Polyhedron<T,FP,VP>::Polyhedron(const std::vector<V>& positions, const std::vector<std::vector<size_t>>& faces) {
+    Build build(positions, faces, *this);
+}
+
 template <typename T, typename FP, typename VP>
 Polyhedron<T,FP,VP>::Polyhedron(const Polyhedron<T,FP,VP>& other) {
     Copy copy(other.faces(), other.edges(), other.vertices(), *this);
@@ -319,11 +326,9 @@ void Polyhedron<T,FP,VP>::setBounds(const vm::bbox<T,3>& bounds, Callback& callb
 template <typename T, typename FP, typename VP>
 class Polyhedron<T,FP,VP>::Copy {
 private:
-    using VertexMap = std::map<const Vertex*, Vertex*>;
-    using VertexMapEntry = typename VertexMap::value_type;
-
-    using HalfEdgeMap = std::map<const HalfEdge*, HalfEdge*>;
-    using HalfEdgeMapEntry = typename HalfEdgeMap::value_type;
+    // maps the original elements to their copies, sorted by the original elements once all of them were copied
+    using VertexMap = std::vector<std::pair<const Vertex*, Vertex*>>;
+    using HalfEdgeMap = std::vector<std::pair<const HalfEdge*, HalfEdge*>>;
 
     VertexMap m_vertexMap;
     HalfEdgeMap m_halfEdgeMap;
@@ -342,16 +347,18 @@ public:
     }
 private:
     void copyVertices(const VertexList& originalVertices) {
+        m_vertexMap.reserve(originalVertices.size());
         if (!originalVertices.empty()) {
             const Vertex* firstVertex = originalVertices.front();
             const Vertex* currentVertex = firstVertex;
             do {
                 Vertex* copy = new Vertex(currentVertex->position());
-                assertResult(MapUtils::insertOrFail(m_vertexMap, currentVertex, copy));
+                m_vertexMap.emplace_back(currentVertex, copy);
                 m_vertices.append(copy, 1);
                 currentVertex = currentVertex->next();
             } while (currentVertex != firstVertex);
         }
+        std::sort(std::begin(m_vertexMap), std::end(m_vertexMap));
     }
 
     void copyFaces(const FaceList& originalFaces) {
@@ -363,6 +370,7 @@ private:
                 currentFace = currentFace->next();
             } while (currentFace != firstFace);
         }
+        std::sort(std::begin(m_halfEdgeMap), std::end(m_halfEdgeMap));
     }
 
     void copyFace(const Face* originalFace) {
@@ -397,13 +405,13 @@ private:
 
         Vertex* myOrigin = findVertex(originalOrigin);
         HalfEdge* copy = new HalfEdge(myOrigin);
-        m_halfEdgeMap.insert(std::make_pair(original, copy));
+        m_halfEdgeMap.emplace_back(original, copy);
         return copy;
     }
 
     Vertex* findVertex(const Vertex* original) {
-        typename VertexMap::iterator it = m_vertexMap.find(original);
-        assert(it != std::end(m_vertexMap));
+        const auto it = std::lower_bound(std::begin(m_vertexMap), std::end(m_vertexMap), original, CompareOriginal());
+        assert(it != std::end(m_vertexMap) && it->first == original);
         return it->second;
     }
 
@@ -428,18 +436,129 @@ private:
     }
 
     HalfEdge* findOrCopyHalfEdge(const HalfEdge* original) {
-        const auto insertPos = MapUtils::findInsertPos(m_halfEdgeMap, original);
-        if (!insertPos.first) {
-            const Vertex* originalOrigin = original->origin();
-            Vertex* myOrigin = findVertex(originalOrigin);
-            HalfEdge* copy = new HalfEdge(myOrigin);
-            m_halfEdgeMap.insert(insertPos.second, std::make_pair(original, copy));
-            return copy;
+        const auto it = std::lower_bound(std::begin(m_halfEdgeMap), std::end(m_halfEdgeMap), original, CompareOriginal());
+        if (it != std::end(m_halfEdgeMap) && it->first == original) {
+            return it->second;
         }
 
-        const auto it = insertPos.second;
-        assert(it != std::begin(m_halfEdgeMap));
-        return std::prev(it)->second;
+        const Vertex* originalOrigin = original->origin();
+        Vertex* myOrigin = findVertex(originalOrigin);
+        HalfEdge* copy = new HalfEdge(myOrigin);
+        m_halfEdgeMap.insert(it, std::make_pair(original, copy));
+        return copy;
+    }
+
+    struct CompareOriginal {
+        template <typename E>
+        bool operator()(const E& entry, const void* original) const {
+            return entry.first < original;
+        }
+    };
+
+    void swapContents() {
+        using std::swap;
+        swap(m_vertices, m_destination.m_vertices);
+        swap(m_edges, m_destination.m_edges);
+        swap(m_faces, m_destination.m_faces);
+        m_destination.updateBounds();
+    }
+};
+
+template <typename T, typename FP, typename VP>
+class Polyhedron<T,FP,VP>::Build {
+private:
+    // the half edges of all faces, identified by the indices of their origin and destination
+    using HalfEdgeKey = std::pair<size_t, size_t>;
+    using HalfEdgeEntry = std::pair<HalfEdgeKey, HalfEdge*>;
+
+    std::vector<Vertex*> m_vertexArray;
+    std::vector<HalfEdgeEntry> m_halfEdges;
+
+    // the faces must be deleted before the vertices if an exception is thrown
+    VertexList m_vertices;
+    EdgeList m_edges;
+    FaceList m_faces;
+    Polyhedron& m_destination;
+public:
+    Build(const std::vector<V>& positions, const std::vector<std::vector<size_t>>& faces, Polyhedron& destination) :
+    m_destination(destination) {
+        buildVertices(positions);
+        buildFaces(faces);
+        buildEdges();
+        checkVertices();
+        swapContents();
+    }
+private:
+    void buildVertices(const std::vector<V>& positions) {
+        m_vertexArray.reserve(positions.size());
+        for (const auto& position : positions) {
+            auto* vertex = new Vertex(position);
+            m_vertices.append(vertex, 1);
+            m_vertexArray.push_back(vertex);
+        }
+    }
+
+    void buildFaces(const std::vector<std::vector<size_t>>& faces) {
+        for (const auto& indices : faces) {
+            if (indices.size() < 3) {
+                throw GeometryException("Polyhedron face has fewer than three vertices");
+            }
+
+            HalfEdgeList boundary;
+            for (size_t i = 0; i < indices.size(); ++i) {
+                const auto origin = indices[i];
+                const auto destination = indices[(i + 1) % indices.size()];
+                if (origin >= m_vertexArray.size()) {
+                    throw GeometryException("Polyhedron vertex index is out of range");
+                }
+
+                auto* halfEdge = new HalfEdge(m_vertexArray[origin]);
+                boundary.append(halfEdge, 1);
+                m_halfEdges.push_back(std::make_pair(std::make_pair(origin, destination), halfEdge));
+            }
+
+            m_faces.append(new Face(boundary), 1);
+        }
+    }
+
+    void buildEdges() {
+        std::sort(std::begin(m_halfEdges), std::end(m_halfEdges), [](const HalfEdgeEntry& lhs, const HalfEdgeEntry& rhs) {
+            return lhs.first < rhs.first;
+        });
+
+        for (size_t i = 0; i < m_halfEdges.size(); ++i) {
+            const auto& key = m_halfEdges[i].first;
+            if (i > 0 && m_halfEdges[i - 1].first == key) {
+                throw GeometryException("Polyhedron has duplicate half edges");
+            }
+
+            // every half edge must have a twin, create each edge only once
+            const auto* twin = findHalfEdge(std::make_pair(key.second, key.first));
+            if (twin == nullptr) {
+                throw GeometryException("Polyhedron is not closed");
+            }
+            if (key.first < key.second) {
+                m_edges.append(new Edge(m_halfEdges[i].second, *twin), 1);
+            }
+        }
+    }
+
+    HalfEdge* const* findHalfEdge(const HalfEdgeKey& key) const {
+        const auto it = std::lower_bound(std::begin(m_halfEdges), std::end(m_halfEdges), key, [](const HalfEdgeEntry& lhs, const HalfEdgeKey& rhs) {
+            return lhs.first < rhs;
+        });
+        if (it == std::end(m_halfEdges) || it->first != key) {
+            return nullptr;
+        }
+        return &it->second;
+    }
+
+    void checkVertices() const {
+        for (const auto* vertex : m_vertexArray) {
+            if (vertex->leaving() == nullptr) {
+                throw GeometryException("Polyhedron has unused vertices");
+            }
+        }
     }
 
     void swapContents() {
@@ -124,6 +124,12 @@ namespace TrenchBroom {
         Preference<bool> TextureLock(IO::Path("Editor/Texture lock"), true);
         Preference<bool> UVLock(IO::Path("Editor/UV lock"), false);
 
+        Preference<bool> MapCache(IO::Path("Editor/Map cache"), false);
+        Preference<bool> LazyTextureLoading(IO::Path("Renderer/Lazy texture loading"), false);
+        Preference<bool> TextureCache(IO::Path("Renderer/Texture cache"), false);
+        Preference<bool> FrustumCulling(IO::Path("Renderer/Frustum culling"), true);
+        Preference<float> CullingDistance(IO::Path("Renderer/Culling distance"), 0.0f);
+
         Preference<IO::Path>& RendererFontPath() {
             static Preference<IO::Path> fontPath(IO::Path("Renderer/Font name"), IO::Path("fonts/SourceSansPro-Regular.otf"));
             return fontPath;
@@ -121,6 +121,12 @@ namespace TrenchBroom {
         extern Preference<bool> TextureLock;
         extern Preference<bool> UVLock;
 
+        extern Preference<bool> MapCache;
+        extern Preference<bool> LazyTextureLoading;
+        extern Preference<bool> TextureCache;
+        extern Preference<bool> FrustumCulling;
+        extern Preference<float> CullingDistance;
+
         Preference<IO::Path>& RendererFontPath();
         extern Preference<int> RendererFontSize;
 
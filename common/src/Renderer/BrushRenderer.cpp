@@ -33,9 +33,11 @@
 #include "Renderer/RenderUtils.h"
 #include "Renderer/TexturedIndexArrayMapBuilder.h"
 #include "Renderer/GLVertexType.h"
+#include "ParallelUtils.h"
 
 #include <algorithm>
 #include <cassert>
+#include <cstring>
 
 namespace TrenchBroom {
     namespace Renderer {
@@ -116,6 +118,8 @@ namespace TrenchBroom {
 
         BrushRenderer::BrushRenderer() :
         m_filter(std::make_unique<NoFilter>()),
+        m_cullBrushes(false),
+        m_visibleRangesValid(false),
         m_showEdges(false),
         m_grayscale(false),
         m_tint(false),
@@ -165,6 +169,9 @@ namespace TrenchBroom {
             assert(m_brushInfo.empty());
             assert(m_transparentFaces->empty());
             assert(m_opaqueFaces->empty());
+
+            m_visibleTransparentRanges->clear();
+            m_visibleOpaqueRanges->clear();
         }
 
         void BrushRenderer::invalidateBrushes(const Model::BrushList& brushes) {
@@ -187,6 +194,18 @@ namespace TrenchBroom {
             return m_invalidBrushes.empty();
         }
 
+        void BrushRenderer::setVisibleBrushes(const Model::BrushList& brushes) {
+            m_cullBrushes = true;
+            m_visibleBrushes = brushes;
+            m_visibleRangesValid = false;
+        }
+
+        void BrushRenderer::clearVisibleBrushes() {
+            m_cullBrushes = false;
+            m_visibleBrushes.clear();
+            m_visibleRangesValid = false;
+        }
+
         void BrushRenderer::clear() {
             m_brushInfo.clear();
             m_allBrushes.clear();
@@ -197,6 +216,11 @@ namespace TrenchBroom {
             m_transparentFaces = std::make_shared<TextureToBrushIndicesMap>();
             m_opaqueFaces = std::make_shared<TextureToBrushIndicesMap>();
 
+            m_visibleEdgeRanges = std::make_shared<BrushIndexRangeList>();
+            m_visibleTransparentRanges = std::make_shared<TextureToBrushIndexRangesMap>();
+            m_visibleOpaqueRanges = std::make_shared<TextureToBrushIndexRangesMap>();
+            m_visibleRangesValid = false;
+
             m_opaqueFaceRenderer = FaceRenderer(m_vertexArray, m_opaqueFaces, m_faceColor);
             m_transparentFaceRenderer = FaceRenderer(m_vertexArray, m_transparentFaces, m_faceColor);
             m_edgeRenderer = IndexedEdgeRenderer(m_vertexArray, m_edgeIndices);
@@ -259,6 +283,9 @@ namespace TrenchBroom {
                 if (!valid()) {
                     validate();
                 }
+                if (m_cullBrushes && !m_visibleRangesValid) {
+                    validateVisibleRanges();
+                }
                 if (renderContext.showFaces()) {
                     renderOpaqueFaces(renderBatch);
                 }
@@ -273,6 +300,9 @@ namespace TrenchBroom {
                 if (!valid()) {
                     validate();
                 }
+                if (m_cullBrushes && !m_visibleRangesValid) {
+                    validateVisibleRanges();
+                }
                 if (renderContext.showFaces()) {
                     renderTransparentFaces(renderBatch);
                 }
@@ -283,6 +313,7 @@ namespace TrenchBroom {
             m_opaqueFaceRenderer.setGrayscale(m_grayscale);
             m_opaqueFaceRenderer.setTint(m_tint);
             m_opaqueFaceRenderer.setTintColor(m_tintColor);
+            m_opaqueFaceRenderer.setVisibleRanges(m_cullBrushes ? m_visibleOpaqueRanges : nullptr);
             m_opaqueFaceRenderer.render(renderBatch);
         }
 
@@ -291,16 +322,58 @@ namespace TrenchBroom {
             m_transparentFaceRenderer.setTint(m_tint);
             m_transparentFaceRenderer.setTintColor(m_tintColor);
             m_transparentFaceRenderer.setAlpha(m_transparencyAlpha);
+            m_transparentFaceRenderer.setVisibleRanges(m_cullBrushes ? m_visibleTransparentRanges : nullptr);
             m_transparentFaceRenderer.render(renderBatch);
         }
 
         void BrushRenderer::renderEdges(RenderBatch& renderBatch) {
+            m_edgeRenderer.setVisibleRanges(m_cullBrushes ? m_visibleEdgeRanges : nullptr);
             if (m_showOccludedEdges) {
                 m_edgeRenderer.renderOnTop(renderBatch, m_occludedEdgeColor);
             }
             m_edgeRenderer.render(renderBatch, m_edgeColor);
         }
 
+        void BrushRenderer::validateVisibleRanges() {
+            // keep the lists to reuse their memory, the maps are cleared when the renderer is invalidated
+            m_visibleEdgeRanges->clear();
+            for (auto& [texture, ranges] : *m_visibleTransparentRanges) {
+                ranges.clear();
+            }
+            for (auto& [texture, ranges] : *m_visibleOpaqueRanges) {
+                ranges.clear();
+            }
+
+            for (const auto* brush : m_visibleBrushes) {
+                const auto it = m_brushInfo.find(brush);
+                if (it == std::end(m_brushInfo)) {
+                    // the brush is not in this renderer or it was skipped by the filter
+                    continue;
+                }
+
+                const auto& info = it->second;
+                if (info.edgeIndicesKey != nullptr) {
+                    m_visibleEdgeRanges->push_back({ info.edgeIndicesKey->pos, info.edgeIndicesKey->size });
+                }
+                for (const auto& [texture, key] : info.transparentFaceIndicesKeys) {
+                    (*m_visibleTransparentRanges)[texture].push_back({ key->pos, key->size });
+                }
+                for (const auto& [texture, key] : info.opaqueFaceIndicesKeys) {
+                    (*m_visibleOpaqueRanges)[texture].push_back({ key->pos, key->size });
+                }
+            }
+
+            mergeBrushIndexRanges(*m_visibleEdgeRanges);
+            for (auto& [texture, ranges] : *m_visibleTransparentRanges) {
+                mergeBrushIndexRanges(ranges);
+            }
+            for (auto& [texture, ranges] : *m_visibleOpaqueRanges) {
+                mergeBrushIndexRanges(ranges);
+            }
+
+            m_visibleRangesValid = true;
+        }
+
         class BrushRenderer::FilterWrapper : public BrushRenderer::Filter {
         private:
             const Filter& m_filter;
@@ -324,20 +397,6 @@ namespace TrenchBroom {
             }
         };
 
-        void BrushRenderer::validate() {
-            assert(!valid());
-
-            for (auto brush : m_invalidBrushes) {
-                validateBrush(brush);
-            }
-            m_invalidBrushes.clear();
-            assert(valid());
-
-            m_opaqueFaceRenderer = FaceRenderer(m_vertexArray, m_opaqueFaces, m_faceColor);
-            m_transparentFaceRenderer = FaceRenderer(m_vertexArray, m_transparentFaces, m_faceColor);
-            m_edgeRenderer = IndexedEdgeRenderer(m_vertexArray, m_edgeIndices);
-        }
-
         static size_t triIndicesCountForPolygon(const size_t vertexCount) {
             assert(vertexCount >= 3);
             const size_t indexCount = 3 * (vertexCount - 2);
@@ -405,134 +464,258 @@ namespace TrenchBroom {
             }
         }
 
-        void BrushRenderer::validateBrush(const Model::Brush* brush) {
-            assert(m_allBrushes.find(brush) != m_allBrushes.end());
-            assert(m_invalidBrushes.find(brush) != m_invalidBrushes.end());
-            assert(m_brushInfo.find(brush) == m_brushInfo.end());
+        /**
+         * Everything validate() needs to upload a single brush. Validation first evaluates the filter and counts the
+         * vertices and indices of every brush in parallel, then allocates room for all brushes, and finally writes the
+         * vertices and indices of every brush in parallel.
+         */
+        struct BrushRenderer::BrushUpload {
+            /**
+             * The marked faces of the brush that have the same texture.
+             */
+            struct TextureFaces {
+                const Assets::Texture* texture;
+                // the range of the brush's cached faces (sorted by texture) that have this texture
+                size_t firstFace;
+                size_t endFace;
+                size_t opaqueIndexCount;
+                size_t transparentIndexCount;
+                BrushIndexArray* opaqueIndexArray;
+                AllocationTracker::Block* opaqueKey;
+                BrushIndexArray* transparentIndexArray;
+                AllocationTracker::Block* transparentKey;
+            };
+
+            const Model::Brush* brush;
+            bool render;
+            Filter::EdgeRenderPolicy edgePolicy;
+            bool forceTransparent;
+            size_t edgeIndexCount;
+
+            // points to room for one entry per face of the brush, so that no allocation is necessary per brush
+            TextureFaces* textureFaces;
+            size_t textureFacesCount;
+
+            AllocationTracker::Block* vertexKey;
+            AllocationTracker::Block* edgeIndicesKey;
+
+            BrushUpload(const Model::Brush* i_brush, TextureFaces* i_textureFaces) :
+            brush(i_brush),
+            render(false),
+            edgePolicy(Filter::EdgeRenderPolicy::RenderNone),
+            forceTransparent(false),
+            edgeIndexCount(0),
+            textureFaces(i_textureFaces),
+            textureFacesCount(0),
+            vertexKey(nullptr),
+            edgeIndicesKey(nullptr) {}
+
+            /**
+             * Evaluates the filter and counts the vertices and indices to upload. This only modifies the brush and
+             * its faces, so it can be called for different brushes concurrently.
+             */
+            void measure(const Filter& filter, const bool forceTransparentFaces) {
+                // evaluate filter. only evaluate the filter once per brush.
+                const auto [facePolicy, brushEdgePolicy] = filter.markFaces(brush);
+
+                if (facePolicy == Filter::FaceRenderPolicy::RenderNone &&
+                    brushEdgePolicy == Filter::EdgeRenderPolicy::RenderNone) {
+                    return;
+                }
 
-            const FilterWrapper wrapper(*m_filter, m_showHiddenBrushes);
+                render = true;
+                edgePolicy = brushEdgePolicy;
 
-            // evaluate filter. only evaluate the filter once per brush.
-            const auto settings = wrapper.markFaces(brush);
-            const auto [facePolicy, edgePolicy] = settings;
+                auto& brushCache = brush->brushRendererBrushCache();
+                brushCache.validateVertexCache(brush);
+                ensure(!brushCache.cachedVertices().empty(), "Brush must have cached vertices");
 
-            if (facePolicy == Filter::FaceRenderPolicy::RenderNone &&
-                edgePolicy == Filter::EdgeRenderPolicy::RenderNone) {
-                // NOTE: this skips inserting the brush into m_brushInfo
-                return;
-            }
+                // it's possible to have no edges to render
+                // e.g. select all faces of a brush, and the unselected brush renderer
+                // will hit this case.
+                edgeIndexCount = countMarkedEdgeIndices(brush, edgePolicy);
 
-            BrushInfo& info = m_brushInfo[brush];
+                forceTransparent = forceTransparentFaces || brush->hasAttribute(Model::TagAttributes::Transparency);
 
-            // collect vertices
-            auto& brushCache = brush->brushRendererBrushCache();
-            brushCache.validateVertexCache(brush);
-            const auto& cachedVertices = brushCache.cachedVertices();
-            ensure(!cachedVertices.empty(), "Brush must have cached vertices");
+                const auto& facesSortedByTex = brushCache.cachedFacesSortedByTexture();
+                const size_t facesSortedByTexSize = facesSortedByTex.size();
+                assert(facesSortedByTexSize == brush->faceCount());
 
-            assert(m_vertexArray != nullptr);
-            auto [vertBlock, dest] = m_vertexArray->getPointerToInsertVerticesAt(cachedVertices.size());
-            std::memcpy(dest, cachedVertices.data(), cachedVertices.size() * sizeof(*dest));
-            info.vertexHolderKey = vertBlock;
+                size_t nextI;
+                for (size_t i = 0; i < facesSortedByTexSize; i = nextI) {
+                    const Assets::Texture* texture = facesSortedByTex[i].texture;
 
-            const auto brushVerticesStartIndex = static_cast<GLuint>(vertBlock->pos);
+                    size_t opaqueIndexCount = 0;
+                    size_t transparentIndexCount = 0;
 
-            // insert edge indices into VBO
-            {
-                const size_t edgeIndexCount = countMarkedEdgeIndices(brush, edgePolicy);
-                if (edgeIndexCount > 0) {
-                    auto[key, dest] = m_edgeIndices->getPointerToInsertElementsAt(edgeIndexCount);
-                    info.edgeIndicesKey = key;
-                    getMarkedEdgeIndices(brush, edgePolicy, brushVerticesStartIndex, dest);
-                } else {
-                    // it's possible to have no edges to render
-                    // e.g. select all faces of a brush, and the unselected brush renderer
-                    // will hit this branch.
-                    ensure(info.edgeIndicesKey == nullptr, "BrushInfo not initialized");
+                    // find the i value for the next texture
+                    for (nextI = i + 1; nextI < facesSortedByTexSize && facesSortedByTex[nextI].texture == texture; ++nextI) {}
+
+                    // process all faces with this texture (they'll be consecutive)
+                    for (size_t j = i; j < nextI; ++j) {
+                        const BrushRendererBrushCache::CachedFace& cache = facesSortedByTex[j];
+                        if (cache.face->isMarked()) {
+                            assert(cache.texture == texture);
+                            if (transparent(cache)) {
+                                transparentIndexCount += triIndicesCountForPolygon(cache.vertexCount);
+                            } else {
+                                opaqueIndexCount += triIndicesCountForPolygon(cache.vertexCount);
+                            }
+                        }
+                    }
+
+                    if (opaqueIndexCount > 0 || transparentIndexCount > 0) {
+                        textureFaces[textureFacesCount++] = { texture, i, nextI, opaqueIndexCount, transparentIndexCount, nullptr, nullptr, nullptr, nullptr };
+                    }
                 }
             }
 
-            // insert face indices
+            size_t vertexCount() const {
+                return brush->brushRendererBrushCache().cachedVertices().size();
+            }
 
-            auto& facesSortedByTex = brushCache.cachedFacesSortedByTexture();
-            const size_t facesSortedByTexSize = facesSortedByTex.size();
-            const auto forceTransparent = m_transparent || brush->hasAttribute(Model::TagAttributes::Transparency);
+            bool transparent(const BrushRendererBrushCache::CachedFace& cache) const {
+                return forceTransparent || cache.face->hasAttribute(Model::TagAttributes::Transparency);
+            }
 
-            size_t nextI;
-            for (size_t i = 0; i < facesSortedByTexSize; i = nextI) {
-                const Assets::Texture* texture = facesSortedByTex[i].texture;
+            /**
+             * Writes the vertices and indices to the ranges that were allocated for the brush. The ranges of different
+             * brushes don't overlap, so this can be called for different brushes concurrently.
+             */
+            void write(BrushVertexArray& vertexArray, BrushIndexArray& edgeIndices) const {
+                const auto& brushCache = brush->brushRendererBrushCache();
 
-                size_t opaqueIndexCount = 0;
-                size_t transparentIndexCount = 0;
+                const auto& cachedVertices = brushCache.cachedVertices();
+                auto* vertexDest = vertexArray.getPointerToVerticesWithKey(vertexKey);
+                std::memcpy(vertexDest, cachedVertices.data(), cachedVertices.size() * sizeof(*vertexDest));
 
-                // find the i value for the next texture
-                for (nextI = i + 1; nextI < facesSortedByTexSize && facesSortedByTex[nextI].texture == texture; ++nextI) {}
+                const auto brushVerticesStartIndex = static_cast<GLuint>(vertexKey->pos);
 
-                // process all faces with this texture (they'll be consecutive)
-                for (size_t j = i; j < nextI; ++j) {
-                    const BrushRendererBrushCache::CachedFace& cache = facesSortedByTex[j];
-                    if (cache.face->isMarked()) {
-                        assert(cache.texture == texture);
-                        if (forceTransparent || cache.face->hasAttribute(Model::TagAttributes::Transparency)) {
-                            transparentIndexCount += triIndicesCountForPolygon(cache.vertexCount);
-                        } else {
-                            opaqueIndexCount += triIndicesCountForPolygon(cache.vertexCount);
-                        }
-                    }
+                if (edgeIndicesKey != nullptr) {
+                    getMarkedEdgeIndices(brush, edgePolicy, brushVerticesStartIndex, edgeIndices.getPointerToElementsWithKey(edgeIndicesKey));
                 }
 
-                if (transparentIndexCount > 0) {
-                    TextureToBrushIndicesMap& faceVboMap = *m_transparentFaces;
-                    auto& holderPtr = faceVboMap[texture];
-                    if (holderPtr == nullptr) {
-                        // inserts into map!
-                        holderPtr = std::make_shared<BrushIndexArray>();
+                for (size_t i = 0; i < textureFacesCount; ++i) {
+                    const TextureFaces& faces = textureFaces[i];
+                    if (faces.transparentIndexCount > 0) {
+                        writeFaceIndices(faces, true, faces.transparentIndexArray->getPointerToElementsWithKey(faces.transparentKey), faces.transparentIndexCount, brushVerticesStartIndex);
+                    }
+                    if (faces.opaqueIndexCount > 0) {
+                        writeFaceIndices(faces, false, faces.opaqueIndexArray->getPointerToElementsWithKey(faces.opaqueKey), faces.opaqueIndexCount, brushVerticesStartIndex);
                     }
+                }
+            }
 
-                    auto [key, dest] = holderPtr->getPointerToInsertElementsAt(transparentIndexCount);
-                    info.transparentFaceIndicesKeys.push_back({texture, key});
+            void writeFaceIndices(const TextureFaces& faces, const bool transparentFaces, GLuint* dest, [[maybe_unused]] const size_t indexCount, const GLuint brushVerticesStartIndex) const {
+                const auto& facesSortedByTex = brush->brushRendererBrushCache().cachedFacesSortedByTexture();
 
-                    // process all faces with this texture (they'll be consecutive)
-                    GLuint *currentDest = dest;
-                    for (size_t j = i; j < nextI; ++j) {
-                        const BrushRendererBrushCache::CachedFace& cache = facesSortedByTex[j];
-                        if (cache.face->isMarked() && (forceTransparent || cache.face->hasAttribute(Model::TagAttributes::Transparency))) {
-                            addTriIndicesForPolygon(currentDest,
-                                                    static_cast<GLuint>(brushVerticesStartIndex +
-                                                                        cache.indexOfFirstVertexRelativeToBrush),
-                                                    cache.vertexCount);
+                GLuint* currentDest = dest;
+                for (size_t j = faces.firstFace; j < faces.endFace; ++j) {
+                    const BrushRendererBrushCache::CachedFace& cache = facesSortedByTex[j];
+                    if (cache.face->isMarked() && transparent(cache) == transparentFaces) {
+                        addTriIndicesForPolygon(currentDest,
+                                                static_cast<GLuint>(brushVerticesStartIndex +
+                                                                    cache.indexOfFirstVertexRelativeToBrush),
+                                                cache.vertexCount);
 
-                            currentDest += triIndicesCountForPolygon(cache.vertexCount);
-                        }
+                        currentDest += triIndicesCountForPolygon(cache.vertexCount);
                     }
-                    assert(currentDest == (dest + transparentIndexCount));
                 }
+                assert(currentDest == (dest + indexCount));
+            }
+        };
 
-                if (opaqueIndexCount > 0) {
-                    TextureToBrushIndicesMap& faceVboMap = *m_opaqueFaces;
-                    auto& holderPtr = faceVboMap[texture];
-                    if (holderPtr == nullptr) {
-                        // inserts into map!
-                        holderPtr = std::make_shared<BrushIndexArray>();
-                    }
+        void BrushRenderer::validate() {
+            assert(!valid());
 
-                    auto [key, dest] = holderPtr->getPointerToInsertElementsAt(opaqueIndexCount);
-                    info.opaqueFaceIndicesKeys.push_back({texture, key});
+            const FilterWrapper wrapper(*m_filter, m_showHiddenBrushes);
 
-                    // process all faces with this texture (they'll be consecutive)
-                    GLuint *currentDest = dest;
-                    for (size_t j = i; j < nextI; ++j) {
-                        const BrushRendererBrushCache::CachedFace& cache = facesSortedByTex[j];
-                        if (cache.face->isMarked() && !(forceTransparent || cache.face->hasAttribute(Model::TagAttributes::Transparency))) {
-                            addTriIndicesForPolygon(currentDest,
-                                                    static_cast<GLuint>(brushVerticesStartIndex +
-                                                                        cache.indexOfFirstVertexRelativeToBrush),
-                                                    cache.vertexCount);
+            // every brush gets a slice of this with one entry per face, the offsets are the prefix sums of the face counts
+            size_t totalFaceCount = 0;
+            for (const auto* brush : m_invalidBrushes) {
+                totalFaceCount += brush->faceCount();
+            }
+            std::vector<BrushUpload::TextureFaces> textureFaces(totalFaceCount);
 
-                            currentDest += triIndicesCountForPolygon(cache.vertexCount);
-                        }
+            std::vector<BrushUpload> uploads;
+            uploads.reserve(m_invalidBrushes.size());
+
+            size_t faceOffset = 0;
+            for (const auto* brush : m_invalidBrushes) {
+                assert(m_allBrushes.find(brush) != m_allBrushes.end());
+                assert(m_brushInfo.find(brush) == m_brushInfo.end());
+
+                uploads.emplace_back(brush, textureFaces.data() + faceOffset);
+                faceOffset += brush->faceCount();
+            }
+
+            ParallelUtils::parallelFor(uploads.size(), [&](const size_t i) {
+                uploads[i].measure(wrapper, m_transparent);
+            });
+
+            allocateUploads(uploads);
+
+            ParallelUtils::parallelFor(uploads.size(), [&](const size_t i) {
+                if (uploads[i].render) {
+                    uploads[i].write(*m_vertexArray, *m_edgeIndices);
+                }
+            });
+
+            m_invalidBrushes.clear();
+            m_visibleRangesValid = false;
+            assert(valid());
+
+            m_opaqueFaceRenderer = FaceRenderer(m_vertexArray, m_opaqueFaces, m_faceColor);
+            m_transparentFaceRenderer = FaceRenderer(m_vertexArray, m_transparentFaces, m_faceColor);
+            m_edgeRenderer = IndexedEdgeRenderer(m_vertexArray, m_edgeIndices);
+        }
+
+        static BrushIndexArray& findOrCreateIndexArray(TextureToBrushIndicesMap& faceVboMap, const Assets::Texture* texture) {
+            auto& holderPtr = faceVboMap[texture];
+            if (holderPtr == nullptr) {
+                // inserts into map!
+                holderPtr = std::make_shared<BrushIndexArray>();
+            }
+            return *holderPtr;
+        }
+
+        void BrushRenderer::allocateUploads(std::vector<BrushUpload>& uploads) {
+            assert(m_vertexArray != nullptr);
+
+            for (auto& upload : uploads) {
+                if (!upload.render) {
+                    // NOTE: this skips inserting the brush into m_brushInfo
+                    continue;
+                }
+
+                BrushInfo& info = m_brushInfo[upload.brush];
+
+                // The arrays may grow with every insertion, which invalidates the returned pointers. Therefore, only
+                // the keys are kept, and the pointers are obtained from them once everything has been inserted.
+                upload.vertexKey = m_vertexArray->getPointerToInsertVerticesAt(upload.vertexCount()).first;
+                info.vertexHolderKey = upload.vertexKey;
+
+                if (upload.edgeIndexCount > 0) {
+                    upload.edgeIndicesKey = m_edgeIndices->getPointerToInsertElementsAt(upload.edgeIndexCount).first;
+                    info.edgeIndicesKey = upload.edgeIndicesKey;
+                } else {
+                    ensure(info.edgeIndicesKey == nullptr, "BrushInfo not initialized");
+                }
+
+                for (size_t i = 0; i < upload.textureFacesCount; ++i) {
+                    auto& faces = upload.textureFaces[i];
+                    if (faces.transparentIndexCount > 0) {
+                        auto& indexArray = findOrCreateIndexArray(*m_transparentFaces, faces.texture);
+                        faces.transparentIndexArray = &indexArray;
+                        faces.transparentKey = indexArray.getPointerToInsertElementsAt(faces.transparentIndexCount).first;
+                        info.transparentFaceIndicesKeys.push_back({faces.texture, faces.transparentKey});
+                    }
+                    if (faces.opaqueIndexCount > 0) {
+                        auto& indexArray = findOrCreateIndexArray(*m_opaqueFaces, faces.texture);
+                        faces.opaqueIndexArray = &indexArray;
+                        faces.opaqueKey = indexArray.getPointerToInsertElementsAt(faces.opaqueIndexCount).first;
+                        info.opaqueFaceIndicesKeys.push_back({faces.texture, faces.opaqueKey});
                     }
-                    assert(currentDest == (dest + opaqueIndexCount));
                 }
             }
         }
@@ -606,6 +789,7 @@ namespace TrenchBroom {
             }
 
             m_brushInfo.erase(it);
+            m_visibleRangesValid = false;
         }
     }
 }
@@ -31,6 +31,7 @@
 #include <memory>
 #include <tuple>
 #include <unordered_map>
+#include <vector>
 
 namespace TrenchBroom {
     namespace Model {
@@ -117,6 +118,7 @@ namespace TrenchBroom {
             };
         private:
             class FilterWrapper;
+            struct BrushUpload;
         private:
             std::unique_ptr<Filter> m_filter;
 
@@ -148,6 +150,17 @@ namespace TrenchBroom {
             FaceRenderer m_transparentFaceRenderer;
             IndexedEdgeRenderer m_edgeRenderer;
 
+            /**
+             * If culling is enabled, only the index ranges of the visible brushes are rendered. The ranges are
+             * collected from m_brushInfo when the renderer is validated or the visible brushes change.
+             */
+            bool m_cullBrushes;
+            Model::BrushList m_visibleBrushes;
+            bool m_visibleRangesValid;
+            std::shared_ptr<BrushIndexRangeList> m_visibleEdgeRanges;
+            std::shared_ptr<TextureToBrushIndexRangesMap> m_visibleTransparentRanges;
+            std::shared_ptr<TextureToBrushIndexRangesMap> m_visibleOpaqueRanges;
+
             Color m_faceColor;
             bool m_showEdges;
             Color m_edgeColor;
@@ -164,6 +177,8 @@ namespace TrenchBroom {
             template <typename FilterT>
             explicit BrushRenderer(const FilterT& filter) :
             m_filter(std::make_unique<FilterT>(filter)),
+            m_cullBrushes(false),
+            m_visibleRangesValid(false),
             m_showEdges(false),
             m_grayscale(false),
             m_tint(false),
@@ -200,6 +215,20 @@ namespace TrenchBroom {
             void invalidateBrushes(const Model::BrushList& brushes);
             bool valid() const;
 
+            /**
+             * Restricts rendering to the given brushes until this function is called again or until
+             * clearVisibleBrushes() is called. Brushes that are not in this renderer are ignored.
+             *
+             * Only the index ranges of the given brushes are rendered, so the cost of rendering depends on the number
+             * of visible brushes rather than on the number of brushes in this renderer.
+             */
+            void setVisibleBrushes(const Model::BrushList& brushes);
+
+            /**
+             * Renders all brushes again after a call to setVisibleBrushes().
+             */
+            void clearVisibleBrushes();
+
             /**
              * Sets the color to render untextured faces with.
              */
@@ -267,6 +296,7 @@ namespace TrenchBroom {
             void renderOpaqueFaces(RenderBatch& renderBatch);
             void renderTransparentFaces(RenderBatch& renderBatch);
             void renderEdges(RenderBatch& renderBatch);
+            void validateVisibleRanges();
 
         public:
             /**
@@ -274,7 +304,11 @@ namespace TrenchBroom {
              */
             void validate();
         private:
-            void validateBrush(const Model::Brush* brush);
+            /**
+             * Allocates room in the vertex and index arrays for the given brushes and records the keys of the
+             * allocations in the uploads and in m_brushInfo.
+             */
+            void allocateUploads(std::vector<BrushUpload>& uploads);
             void addBrush(const Model::Brush* brush);
             void removeBrush(const Model::Brush* brush);
 
@@ -67,6 +67,28 @@ namespace TrenchBroom {
             return m_dirtySize == 0;
         }
 
+        void mergeBrushIndexRanges(BrushIndexRangeList& ranges) {
+            if (ranges.empty()) {
+                return;
+            }
+
+            std::sort(std::begin(ranges), std::end(ranges), [](const BrushIndexRange& lhs, const BrushIndexRange& rhs) {
+                return lhs.offset < rhs.offset;
+            });
+
+            size_t last = 0;
+            for (size_t i = 1; i < ranges.size(); ++i) {
+                auto& lastRange = ranges[last];
+                const auto& range = ranges[i];
+                if (lastRange.offset + lastRange.count == range.offset) {
+                    lastRange.count += range.count;
+                } else {
+                    ranges[++last] = range;
+                }
+            }
+            ranges.resize(last + 1);
+        }
+
         // IndexHolder
 
         IndexHolder::IndexHolder() : VboBlockHolder<Index>() {}
@@ -86,6 +108,24 @@ namespace TrenchBroom {
             glAssert(glDrawElements(primType, renderCount, glType<Index>(), renderOffset));
         }
 
+        void IndexHolder::render(const PrimType primType, const BrushIndexRangeList& ranges) const {
+            if (ranges.size() == 1) {
+                render(primType, ranges.front().offset, ranges.front().count);
+            } else if (!ranges.empty()) {
+                std::vector<GLsizei> counts;
+                std::vector<const GLvoid*> offsets;
+                counts.reserve(ranges.size());
+                offsets.reserve(ranges.size());
+
+                for (const auto& range : ranges) {
+                    counts.push_back(static_cast<GLsizei>(range.count));
+                    offsets.push_back(reinterpret_cast<GLvoid *>(m_block->offset() + sizeof(Index) * range.offset));
+                }
+
+                glAssert(glMultiDrawElements(primType, counts.data(), glType<Index>(), offsets.data(), static_cast<GLsizei>(ranges.size())));
+            }
+        }
+
         std::shared_ptr<IndexHolder> IndexHolder::swap(std::vector<IndexHolder::Index> &elements) {
             return std::make_shared<IndexHolder>(elements);
         }
@@ -120,6 +160,10 @@ namespace TrenchBroom {
             return {block, dest};
         }
 
+        GLuint* BrushIndexArray::getPointerToElementsWithKey(AllocationTracker::Block* key) {
+            return m_indexHolder.getPointerToDirtyElements(key->pos, key->size);
+        }
+
         void BrushIndexArray::zeroElementsWithKey(AllocationTracker::Block* key) {
             const auto pos = key->pos;
             const auto size = key->size;
@@ -133,6 +177,11 @@ namespace TrenchBroom {
             m_indexHolder.render(primType, 0, m_indexHolder.size());
         }
 
+        void BrushIndexArray::render(const PrimType primType, const BrushIndexRangeList& ranges) const {
+            assert(m_indexHolder.prepared());
+            m_indexHolder.render(primType, ranges);
+        }
+
         bool BrushIndexArray::prepared() const {
             return m_indexHolder.prepared();
         }
@@ -167,6 +216,10 @@ namespace TrenchBroom {
             return {block, dest};
         }
 
+        BrushVertexArray::Vertex* BrushVertexArray::getPointerToVerticesWithKey(AllocationTracker::Block* key) {
+            return m_vertexHolder.getPointerToDirtyElements(key->pos, key->size);
+        }
+
         void BrushVertexArray::deleteVerticesWithKey(AllocationTracker::Block* key) {
             m_allocationTracker.free(key);
 
@@ -141,6 +141,16 @@ namespace TrenchBroom {
                 return m_snapshot.data() + offsetWithinBlock;
             }
 
+            /**
+             * Returns a pointer to elements that were already marked as dirty by getPointerToWriteElementsTo(). Since
+             * this doesn't modify the holder, it can be called from multiple threads.
+             */
+            T* getPointerToDirtyElements(const size_t offsetWithinBlock, [[maybe_unused]] const size_t elementCount) {
+                assert(offsetWithinBlock + elementCount <= m_snapshot.size());
+
+                return m_snapshot.data() + offsetWithinBlock;
+            }
+
             bool prepared() const {
                 // NOTE: this returns true if the capacity is 0
                 return m_dirtyRange.clean();
@@ -197,6 +207,22 @@ namespace TrenchBroom {
             }
         };
 
+        /**
+         * A contiguous range of indices in a BrushIndexArray.
+         */
+        struct BrushIndexRange {
+            size_t offset;
+            size_t count;
+        };
+
+        using BrushIndexRangeList = std::vector<BrushIndexRange>;
+
+        /**
+         * Sorts the given ranges by their offsets and joins adjacent ranges, so that they can be rendered with as few
+         * draw calls as possible.
+         */
+        void mergeBrushIndexRanges(BrushIndexRangeList& ranges);
+
         class IndexHolder : public VboBlockHolder<GLuint> {
         public:
             using Index = GLuint;
@@ -208,6 +234,7 @@ namespace TrenchBroom {
             explicit IndexHolder(std::vector<Index>& elements);
             void zeroRange(size_t offsetWithinBlock, size_t count);
             void render(PrimType primType, size_t offset, size_t count) const;
+            void render(PrimType primType, const BrushIndexRangeList& ranges) const;
 
             static std::shared_ptr<IndexHolder> swap(std::vector<Index>& elements);
         };
@@ -238,12 +265,26 @@ namespace TrenchBroom {
              */
             std::pair<AllocationTracker::Block*, GLuint*> getPointerToInsertElementsAt(size_t elementCount);
 
+            /**
+             * Returns a pointer to the indices that were inserted with the given key.
+             *
+             * Like the pointer returned by getPointerToInsertElementsAt(), this is invalidated by the next insertion.
+             * It can be used to write the indices of several insertions after all of them have been made, and since it
+             * doesn't modify the array, from multiple threads.
+             */
+            GLuint* getPointerToElementsWithKey(AllocationTracker::Block* key);
+
             /**
              * Deletes indices for the given brush and marks the allocation as free.
              */
             void zeroElementsWithKey(AllocationTracker::Block* key);
 
             void render(const PrimType primType) const;
+
+            /**
+             * Renders only the given ranges of indices, which must have been merged by mergeBrushIndexRanges().
+             */
+            void render(PrimType primType, const BrushIndexRangeList& ranges) const;
             bool prepared() const;
             void prepare(Vbo& vbo);
         };
@@ -311,6 +352,15 @@ namespace TrenchBroom {
              */
             std::pair<AllocationTracker::Block*, Vertex*> getPointerToInsertVerticesAt(size_t vertexCount);
 
+            /**
+             * Returns a pointer to the vertices that were inserted with the given key.
+             *
+             * Like the pointer returned by getPointerToInsertVerticesAt(), this is invalidated by the next insertion.
+             * It can be used to write the vertices of several insertions after all of them have been made, and since
+             * it doesn't modify the array, from multiple threads.
+             */
+            Vertex* getPointerToVerticesWithKey(AllocationTracker::Block* key);
+
             void deleteVerticesWithKey(AllocationTracker::Block* key);
 
             // setting up GL attributes
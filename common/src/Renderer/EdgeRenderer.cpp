@@ -163,10 +163,11 @@ namespace TrenchBroom {
 
         // IndexedEdgeRenderer::Render
 
-        IndexedEdgeRenderer::Render::Render(const EdgeRenderer::Params& params, BrushVertexArrayPtr vertexArray, BrushIndexArrayPtr indexArray) :
+        IndexedEdgeRenderer::Render::Render(const EdgeRenderer::Params& params, BrushVertexArrayPtr vertexArray, BrushIndexArrayPtr indexArray, BrushIndexRangeListPtr visibleRanges) :
         RenderBase(params),
         m_vertexArray(vertexArray),
-        m_indexArray(indexArray) {}
+        m_indexArray(indexArray),
+        m_visibleRanges(visibleRanges) {}
 
         void IndexedEdgeRenderer::Render::prepareVerticesAndIndices(Vbo& vertexVbo, Vbo& indexVbo) {
             m_vertexArray->prepare(vertexVbo);
@@ -177,12 +178,19 @@ namespace TrenchBroom {
             if (!m_indexArray->hasValidIndices()) {
                 return;
             }
+            if (m_visibleRanges != nullptr && m_visibleRanges->empty()) {
+                return;
+            }
             renderEdges(renderContext);
         }
 
         void IndexedEdgeRenderer::Render::doRenderVertices(RenderContext& renderContext) {
             m_vertexArray->setupVertices();
-            m_indexArray->render(GL_LINES);
+            if (m_visibleRanges != nullptr) {
+                m_indexArray->render(GL_LINES, *m_visibleRanges);
+            } else {
+                m_indexArray->render(GL_LINES);
+            }
             m_vertexArray->cleanupVertices();
         }
 
@@ -196,7 +204,8 @@ namespace TrenchBroom {
 
         IndexedEdgeRenderer::IndexedEdgeRenderer(const IndexedEdgeRenderer& other) :
         m_vertexArray(other.m_vertexArray),
-        m_indexArray(other.m_indexArray) {}
+        m_indexArray(other.m_indexArray),
+        m_visibleRanges(other.m_visibleRanges) {}
 
         IndexedEdgeRenderer& IndexedEdgeRenderer::operator=(IndexedEdgeRenderer other) {
             using std::swap;
@@ -208,10 +217,15 @@ namespace TrenchBroom {
             using std::swap;
             swap(left.m_vertexArray, right.m_vertexArray);
             swap(left.m_indexArray, right.m_indexArray);
+            swap(left.m_visibleRanges, right.m_visibleRanges);
+        }
+
+        void IndexedEdgeRenderer::setVisibleRanges(BrushIndexRangeListPtr visibleRanges) {
+            m_visibleRanges = std::move(visibleRanges);
         }
 
         void IndexedEdgeRenderer::doRender(RenderBatch& renderBatch, const EdgeRenderer::Params& params) {
-            renderBatch.addOneShot(new Render(params, m_vertexArray, m_indexArray));
+            renderBatch.addOneShot(new Render(params, m_vertexArray, m_indexArray, m_visibleRanges));
         }
     }
 }
@@ -37,9 +37,12 @@ namespace TrenchBroom {
         class Vbo;
         class BrushVertexArray;
         class BrushIndexArray;
+        struct BrushIndexRange;
 
         using BrushVertexArrayPtr = std::shared_ptr<BrushVertexArray>;
         using BrushIndexArrayPtr = std::shared_ptr<BrushIndexArray>;
+        using BrushIndexRangeList = std::vector<BrushIndexRange>;
+        using BrushIndexRangeListPtr = std::shared_ptr<const BrushIndexRangeList>;
 
         class EdgeRenderer {
         public:
@@ -114,8 +117,9 @@ namespace TrenchBroom {
             private:
                 BrushVertexArrayPtr m_vertexArray;
                 BrushIndexArrayPtr m_indexArray;
+                BrushIndexRangeListPtr m_visibleRanges;
             public:
-                Render(const Params& params, BrushVertexArrayPtr vertexArray, BrushIndexArrayPtr indexArray);
+                Render(const Params& params, BrushVertexArrayPtr vertexArray, BrushIndexArrayPtr indexArray, BrushIndexRangeListPtr visibleRanges);
             private:
                 void prepareVerticesAndIndices(Vbo& vertexVbo, Vbo& indexVbo) override;
                 void doRender(RenderContext& renderContext) override;
@@ -124,6 +128,7 @@ namespace TrenchBroom {
         private:
             BrushVertexArrayPtr m_vertexArray;
             BrushIndexArrayPtr m_indexArray;
+            BrushIndexRangeListPtr m_visibleRanges;
         public:
             IndexedEdgeRenderer();
             IndexedEdgeRenderer(BrushVertexArrayPtr vertexArray, BrushIndexArrayPtr indexArray);
@@ -132,6 +137,12 @@ namespace TrenchBroom {
             IndexedEdgeRenderer& operator=(IndexedEdgeRenderer other);
 
             friend void swap(IndexedEdgeRenderer& left, IndexedEdgeRenderer& right);
+
+            /**
+             * Restricts rendering to the given ranges of the index array. If the given pointer is null, all indices
+             * are rendered.
+             */
+            void setVisibleRanges(BrushIndexRangeListPtr visibleRanges);
         private:
             void doRender(RenderBatch& renderBatch, const EdgeRenderer::Params& params) override;
         };
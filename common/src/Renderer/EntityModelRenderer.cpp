@@ -41,6 +41,7 @@ namespace TrenchBroom {
         EntityModelRenderer::EntityModelRenderer(Assets::EntityModelManager& entityModelManager, const Model::EditorContext& editorContext) :
         m_entityModelManager(entityModelManager),
         m_editorContext(editorContext),
+        m_cullEntities(false),
         m_applyTinting(false),
         m_showHiddenEntities(false) {}
 
@@ -79,6 +80,16 @@ namespace TrenchBroom {
             m_entities.clear();
         }
 
+        void EntityModelRenderer::setVisibleEntities(const Model::EntityList& entities) {
+            m_cullEntities = true;
+            m_visibleEntities = entities;
+        }
+
+        void EntityModelRenderer::clearVisibleEntities() {
+            m_cullEntities = false;
+            m_visibleEntities.clear();
+        }
+
         bool EntityModelRenderer::applyTinting() const {
             return m_applyTinting;
         }
@@ -124,18 +135,28 @@ namespace TrenchBroom {
             glAssert(glEnable(GL_TEXTURE_2D));
             glAssert(glActiveTexture(GL_TEXTURE0));
 
-            for (const auto& entry : m_entities) {
-                auto* entity = entry.first;
+            const auto renderModel = [&](const Model::Entity* entity, TexturedRenderer* renderer) {
                 if (!m_showHiddenEntities && !m_editorContext.visible(entity)) {
-                    continue;
+                    return;
                 }
 
-                auto* renderer = entry.second;
-
                 const auto transformation = entity->modelTransformation();
                 MultiplyModelMatrix multMatrix(renderContext.transformation(), vm::mat4x4f(transformation));
 
                 renderer->render();
+            };
+
+            if (m_cullEntities) {
+                for (auto* entity : m_visibleEntities) {
+                    const auto it = m_entities.find(entity);
+                    if (it != std::end(m_entities)) {
+                        renderModel(it->first, it->second);
+                    }
+                }
+            } else {
+                for (const auto& entry : m_entities) {
+                    renderModel(entry.first, entry.second);
+                }
             }
         }
     }
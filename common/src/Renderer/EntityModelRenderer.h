@@ -53,6 +53,9 @@ namespace TrenchBroom {
 
             EntityMap m_entities;
 
+            bool m_cullEntities;
+            Model::EntityList m_visibleEntities;
+
             bool m_applyTinting;
             Color m_tintColor;
 
@@ -87,6 +90,17 @@ namespace TrenchBroom {
             void updateEntity(Model::Entity* entity);
             void clear();
 
+            /**
+             * Restricts rendering to the models of the given entities until this function is called again or until
+             * clearVisibleEntities() is called. Entities that are not in this renderer are ignored.
+             */
+            void setVisibleEntities(const Model::EntityList& entities);
+
+            /**
+             * Renders the models of all entities again after a call to setVisibleEntities().
+             */
+            void clearVisibleEntities();
+
             bool applyTinting() const;
             void setApplyTinting(const bool applyTinting);
             const Color& tintColor() const;
@@ -70,6 +70,7 @@ namespace TrenchBroom {
         EntityRenderer::EntityRenderer(Assets::EntityModelManager& entityModelManager, const Model::EditorContext& editorContext) :
         m_entityModelManager(entityModelManager),
         m_editorContext(editorContext),
+        m_cullEntities(false),
         m_modelRenderer(m_entityModelManager, m_editorContext),
         m_boundsValid(false),
         m_showOverlays(true),
@@ -103,6 +104,18 @@ namespace TrenchBroom {
             m_modelRenderer.updateEntities(std::begin(m_entities), std::end(m_entities));
         }
 
+        void EntityRenderer::setVisibleEntities(const Model::EntityList& entities) {
+            m_cullEntities = true;
+            m_visibleEntities = entities;
+            m_modelRenderer.setVisibleEntities(entities);
+        }
+
+        void EntityRenderer::clearVisibleEntities() {
+            m_cullEntities = false;
+            m_visibleEntities.clear();
+            m_modelRenderer.clearVisibleEntities();
+        }
+
         void EntityRenderer::setShowOverlays(const bool showOverlays) {
             m_showOverlays = showOverlays;
         }
@@ -215,7 +228,7 @@ namespace TrenchBroom {
                 renderService.setForegroundColor(m_overlayTextColor);
                 renderService.setBackgroundColor(m_overlayBackgroundColor);
 
-                for (const Model::Entity* entity : m_entities) {
+                for (const Model::Entity* entity : visibleEntities()) {
                     if (m_showHiddenEntities || m_editorContext.visible(entity)) {
                         if (entity->group() == nullptr || entity->group() == m_editorContext.currentGroup()) {
                             if (m_showOccludedOverlays)
@@ -242,7 +255,7 @@ namespace TrenchBroom {
             renderService.setForegroundColor(m_angleColor);
 
             std::vector<vm::vec3f> vertices(3);
-            for (const auto* entity : m_entities) {
+            for (const auto* entity : visibleEntities()) {
                 if (!m_showHiddenEntities && !m_editorContext.visible(entity)) {
                     continue;
                 }
@@ -275,6 +288,10 @@ namespace TrenchBroom {
             }
         }
 
+        const Model::EntityList& EntityRenderer::visibleEntities() const {
+            return m_cullEntities ? m_visibleEntities : m_entities;
+        }
+
         std::vector<vm::vec3f> EntityRenderer::arrowHead(const float length, const float width) const {
             // clockwise winding
             std::vector<vm::vec3f> result(3);
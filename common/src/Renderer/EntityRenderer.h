@@ -56,6 +56,9 @@ namespace TrenchBroom {
             const Model::EditorContext& m_editorContext;
             Model::EntityList m_entities;
 
+            bool m_cullEntities;
+            Model::EntityList m_visibleEntities;
+
             DirectEdgeRenderer m_pointEntityWireframeBoundsRenderer;
             DirectEdgeRenderer m_brushEntityWireframeBoundsRenderer;
 
@@ -84,6 +87,19 @@ namespace TrenchBroom {
             void clear();
             void reloadModels();
 
+            /**
+             * Restricts the rendering of models, classnames and angles to the given entities until this function is
+             * called again or until clearVisibleEntities() is called. The given entities must be in this renderer.
+             *
+             * The bounds of all entities are still rendered since they are stored in shared vertex arrays.
+             */
+            void setVisibleEntities(const Model::EntityList& entities);
+
+            /**
+             * Renders all entities again after a call to setVisibleEntities().
+             */
+            void clearVisibleEntities();
+
             void setShowOverlays(bool showOverlays);
             void setOverlayTextColor(const Color& overlayTextColor);
             void setOverlayBackgroundColor(const Color& overlayBackgroundColor);
@@ -112,6 +128,7 @@ namespace TrenchBroom {
             void renderModels(RenderContext& renderContext, RenderBatch& renderBatch);
             void renderClassnames(RenderContext& renderContext, RenderBatch& renderBatch);
             void renderAngles(RenderContext& renderContext, RenderBatch& renderBatch);
+            const Model::EntityList& visibleEntities() const;
             std::vector<vm::vec3f> arrowHead(float length, float width) const;
 
             struct BuildColoredSolidBoundsVertices;
@@ -75,6 +75,7 @@ namespace TrenchBroom {
         IndexedRenderable(other),
         m_vertexArray(other.m_vertexArray),
         m_indexArrayMap(other.m_indexArrayMap),
+        m_visibleRanges(other.m_visibleRanges),
         m_faceColor(other.m_faceColor),
         m_grayscale(other.m_grayscale),
         m_tint(other.m_tint),
@@ -91,6 +92,7 @@ namespace TrenchBroom {
             using std::swap;
             swap(left.m_vertexArray, right.m_vertexArray);
             swap(left.m_indexArrayMap, right.m_indexArrayMap);
+            swap(left.m_visibleRanges, right.m_visibleRanges);
             swap(left.m_faceColor, right.m_faceColor);
             swap(left.m_grayscale, right.m_grayscale);
             swap(left.m_tint, right.m_tint);
@@ -114,6 +116,10 @@ namespace TrenchBroom {
             m_alpha = alpha;
         }
 
+        void FaceRenderer::setVisibleRanges(TextureToBrushIndexRangesMapPtr visibleRanges) {
+            m_visibleRanges = std::move(visibleRanges);
+        }
+
         void FaceRenderer::render(RenderBatch& renderBatch) {
             renderBatch.add(this);
         }
@@ -165,9 +171,19 @@ namespace TrenchBroom {
                     if (!brushIndexHolderPtr->hasValidIndices()) {
                         continue;
                     }
-                    func.before(texture);
-                    brushIndexHolderPtr->render(GL_TRIANGLES);
-                    func.after(texture);
+                    if (m_visibleRanges != nullptr) {
+                        const auto it = m_visibleRanges->find(texture);
+                        if (it == std::end(*m_visibleRanges) || it->second.empty()) {
+                            continue;
+                        }
+                        func.before(texture);
+                        brushIndexHolderPtr->render(GL_TRIANGLES, it->second);
+                        func.after(texture);
+                    } else {
+                        func.before(texture);
+                        brushIndexHolderPtr->render(GL_TRIANGLES);
+                        func.after(texture);
+                    }
                 }
                 if (m_alpha < 1.0f) {
                     glAssert(glDepthMask(GL_TRUE));
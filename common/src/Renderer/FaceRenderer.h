@@ -29,11 +29,13 @@
 #include <map>
 #include <memory>
 #include <unordered_map>
+#include <vector>
 
 namespace TrenchBroom {
     namespace Renderer {
         class ActiveShader;
         class BrushIndexArray;
+        struct BrushIndexRange;
         class BrushVertexArray;
         class RenderBatch;
         class RenderContext;
@@ -42,6 +44,9 @@ namespace TrenchBroom {
         using BrushVertexArrayPtr = std::shared_ptr<BrushVertexArray>;
         using TextureToBrushIndicesMap = std::unordered_map<const Assets::Texture*, std::shared_ptr<BrushIndexArray>>;
         using TextureToBrushIndicesMapPtr = std::shared_ptr<const TextureToBrushIndicesMap>;
+        using BrushIndexRangeList = std::vector<BrushIndexRange>;
+        using TextureToBrushIndexRangesMap = std::unordered_map<const Assets::Texture*, BrushIndexRangeList>;
+        using TextureToBrushIndexRangesMapPtr = std::shared_ptr<const TextureToBrushIndexRangesMap>;
 
         class FaceRenderer : public IndexedRenderable {
         private:
@@ -49,6 +54,7 @@ namespace TrenchBroom {
 
             BrushVertexArrayPtr m_vertexArray;
             TextureToBrushIndicesMapPtr m_indexArrayMap;
+            TextureToBrushIndexRangesMapPtr m_visibleRanges;
             Color m_faceColor;
             bool m_grayscale;
             bool m_tint;
@@ -67,6 +73,12 @@ namespace TrenchBroom {
             void setTintColor(const Color& color);
             void setAlpha(float alpha);
 
+            /**
+             * Restricts rendering to the given ranges of the index arrays. Textures without ranges are not rendered.
+             * If the given pointer is null, all indices are rendered.
+             */
+            void setVisibleRanges(TextureToBrushIndexRangesMapPtr visibleRanges);
+
             void render(RenderBatch& renderBatch);
         private:
             void prepareVerticesAndIndices(Vbo& vertexVbo, Vbo& indexVbo) override;
@@ -0,0 +1,97 @@
+/*
+ Copyright (C) 2010-2019 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "FrustumCuller.h"
+
+#include "Model/World.h"
+#include "Renderer/Camera.h"
+
+#include <vecmath/bbox.h>
+
+#include <algorithm>
+#include <cmath>
+
+namespace TrenchBroom {
+    namespace Renderer {
+        FrustumCuller::FrustumCuller(const Camera& camera, const FloatType maxDistance) :
+        m_position(camera.position()),
+        m_maxDistance(maxDistance) {
+            vm::plane3f top, right, bottom, left;
+            camera.frustumPlanes(top, right, bottom, left);
+
+            // the normals of the frustum planes point out of the frustum
+            m_planes[0] = vm::plane3(top);
+            m_planes[1] = vm::plane3(right);
+            m_planes[2] = vm::plane3(bottom);
+            m_planes[3] = vm::plane3(left);
+            m_planes[4] = vm::plane3(vm::plane3f(camera.defaultPoint(camera.farPlane()), camera.direction()));
+        }
+
+        VolumeRelation FrustumCuller::relation(const vm::bbox3& bounds) const {
+            auto result = VolumeRelation::Inside;
+
+            for (const auto& plane : m_planes) {
+                // the corners of the bounds that are the farthest along and against the plane normal
+                vm::vec3 front, back;
+                for (size_t i = 0; i < 3; ++i) {
+                    if (plane.normal[i] >= 0.0) {
+                        front[i] = bounds.max[i];
+                        back[i] = bounds.min[i];
+                    } else {
+                        front[i] = bounds.min[i];
+                        back[i] = bounds.max[i];
+                    }
+                }
+
+                if (plane.pointDistance(back) > 0.0) {
+                    return VolumeRelation::Outside;
+                } else if (plane.pointDistance(front) > 0.0) {
+                    result = VolumeRelation::Intersecting;
+                }
+            }
+
+            if (m_maxDistance > 0.0) {
+                // the squared distances to the closest and to the farthest point of the bounds
+                FloatType closest = 0.0;
+                FloatType farthest = 0.0;
+                for (size_t i = 0; i < 3; ++i) {
+                    const auto toMin = bounds.min[i] - m_position[i];
+                    const auto toMax = m_position[i] - bounds.max[i];
+                    const auto outside = std::max(FloatType(0.0), std::max(toMin, toMax));
+                    const auto across = std::max(std::abs(toMin), std::abs(toMax));
+                    closest += outside * outside;
+                    farthest += across * across;
+                }
+
+                const auto maxDistance2 = m_maxDistance * m_maxDistance;
+                if (closest > maxDistance2) {
+                    return VolumeRelation::Outside;
+                } else if (farthest > maxDistance2) {
+                    result = VolumeRelation::Intersecting;
+                }
+            }
+
+            return result;
+        }
+
+        void FrustumCuller::findVisibleNodes(const Model::World& world, Model::NodeList& result) const {
+            world.findNodesInVolume([this](const vm::bbox3& bounds) { return relation(bounds); }, result);
+        }
+    }
+}
@@ -0,0 +1,79 @@
+/*
+ Copyright (C) 2010-2019 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef TrenchBroom_FrustumCuller
+#define TrenchBroom_FrustumCuller
+
+#include "TrenchBroom.h"
+#include "NodeTree.h"
+#include "Model/ModelTypes.h"
+
+#include <vecmath/forward.h>
+#include <vecmath/plane.h>
+#include <vecmath/vec.h>
+
+#include <array>
+
+namespace TrenchBroom {
+    namespace Model {
+        class World;
+    }
+
+    namespace Renderer {
+        class Camera;
+
+        /**
+         * Determines which nodes of a world may be visible to a camera by testing the bounds in the world's node tree
+         * against the camera's view frustum. Whole subtrees of the node tree are skipped if their bounds are outside of
+         * the frustum, so the cost of culling depends on the number of visible nodes rather than on the size of the map.
+         *
+         * The frustum is bounded by the side planes and the far plane of the camera. Optionally, a maximum distance can be
+         * given, and nodes whose bounds are farther away from the camera position are culled, too. The culling is
+         * conservative, that is, a node is considered visible if its bounds overlap the frustum.
+         */
+        class FrustumCuller {
+        private:
+            std::array<vm::plane3, 5> m_planes;
+            vm::vec3 m_position;
+            FloatType m_maxDistance;
+        public:
+            /**
+             * Creates a culler for the current view frustum of the given camera.
+             *
+             * @param camera the camera
+             * @param maxDistance the maximum distance of visible bounds from the camera position, or 0 to disable
+             * distance culling
+             */
+            explicit FrustumCuller(const Camera& camera, FloatType maxDistance = 0.0);
+
+            /**
+             * Classifies the given bounds with respect to the culling volume.
+             */
+            VolumeRelation relation(const vm::bbox3& bounds) const;
+
+            /**
+             * Appends every node in the node tree of the given world whose bounds overlap the culling volume to the
+             * given list. Layers and the world itself are never returned.
+             */
+            void findVisibleNodes(const Model::World& world, Model::NodeList& result) const;
+        };
+    }
+}
+
+#endif /* defined(TrenchBroom_FrustumCuller) */
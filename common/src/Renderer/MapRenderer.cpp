@@ -38,6 +38,7 @@
 #include "Renderer/BrushRenderer.h"
 #include "Renderer/Camera.h"
 #include "Renderer/EntityLinkRenderer.h"
+#include "Renderer/FrustumCuller.h"
 #include "Renderer/ObjectRenderer.h"
 #include "Renderer/RenderBatch.h"
 #include "Renderer/RenderContext.h"
@@ -183,6 +184,7 @@ namespace TrenchBroom {
 
         void MapRenderer::render(RenderContext& renderContext, RenderBatch& renderBatch) {
             commitPendingChanges();
+            cullRenderers(renderContext);
             setupGL(renderBatch);
             renderDefaultOpaque(renderContext, renderBatch);
             renderLockedOpaque(renderContext, renderBatch);
@@ -398,6 +400,34 @@ namespace TrenchBroom {
             invalidateEntityLinkRenderer();
         }
 
+        void MapRenderer::cullRenderers(const RenderContext& renderContext) {
+            if (!pref(Preferences::FrustumCulling)) {
+                m_defaultRenderer->clearVisibleObjects();
+                m_selectionRenderer->clearVisibleObjects();
+                m_lockedRenderer->clearVisibleObjects();
+                return;
+            }
+
+            View::MapDocumentSPtr document = lock(m_document);
+            const Model::World* world = document->world();
+
+            // the distance cutoff is only useful in the 3D view, the 2D views look at the entire map from afar
+            const auto& camera = renderContext.camera();
+            const auto maxDistance = camera.perspectiveProjection() ? static_cast<FloatType>(pref(Preferences::CullingDistance)) : 0.0;
+            const FrustumCuller culler(camera, maxDistance);
+
+            Model::NodeList visibleNodes;
+            culler.findVisibleNodes(*world, visibleNodes);
+
+            // sort the visible nodes into the renderers in the same way as updateRenderers does
+            CollectRenderableNodes collect(Renderer_All);
+            Model::Node::accept(std::begin(visibleNodes), std::end(visibleNodes), collect);
+
+            m_defaultRenderer->setVisibleObjects(collect.defaultNodes().entities(), collect.defaultNodes().brushes());
+            m_selectionRenderer->setVisibleObjects(collect.selectedNodes().entities(), collect.selectedNodes().brushes());
+            m_lockedRenderer->setVisibleObjects(collect.lockedNodes().entities(), collect.lockedNodes().brushes());
+        }
+
         void MapRenderer::invalidateRenderers(Renderer renderers) {
             if ((renderers & Renderer_Default) != 0)
                 m_defaultRenderer->invalidate();
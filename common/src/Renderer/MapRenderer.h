@@ -71,6 +71,12 @@ namespace TrenchBroom {
             void render(RenderContext& renderContext, RenderBatch& renderBatch);
         private:
             void commitPendingChanges();
+
+            /**
+             * Restricts the default, selection and locked renderers to the objects that may be visible to the camera
+             * of the given render context.
+             */
+            void cullRenderers(const RenderContext& renderContext);
             void setupGL(RenderBatch& renderBatch);
             void renderDefaultOpaque(RenderContext& renderContext, RenderBatch& renderBatch);
             void renderDefaultTransparent(RenderContext& renderContext, RenderBatch& renderBatch);
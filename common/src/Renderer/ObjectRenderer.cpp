@@ -51,6 +51,16 @@ namespace TrenchBroom {
             m_entityRenderer.reloadModels();
         }
 
+        void ObjectRenderer::setVisibleObjects(const Model::EntityList& entities, const Model::BrushList& brushes) {
+            m_entityRenderer.setVisibleEntities(entities);
+            m_brushRenderer.setVisibleBrushes(brushes);
+        }
+
+        void ObjectRenderer::clearVisibleObjects() {
+            m_entityRenderer.clearVisibleEntities();
+            m_brushRenderer.clearVisibleBrushes();
+        }
+
         void ObjectRenderer::setShowOverlays(const bool showOverlays) {
             m_groupRenderer.setShowOverlays(showOverlays);
             m_entityRenderer.setShowOverlays(showOverlays);
@@ -52,6 +52,13 @@ namespace TrenchBroom {
             void invalidateBrushes(const Model::BrushList& brushes);
             void clear();
             void reloadModels();
+
+            /**
+             * Restricts rendering to the given entities and brushes, see EntityRenderer::setVisibleEntities and
+             * BrushRenderer::setVisibleBrushes.
+             */
+            void setVisibleObjects(const Model::EntityList& entities, const Model::BrushList& brushes);
+            void clearVisibleObjects();
         public: // configuration
             void setShowOverlays(bool showOverlays);
             void setEntityOverlayTextColor(const Color& overlayTextColor);
@@ -20,6 +20,9 @@
 #include "StringUtils.h"
 
 #include <algorithm>
+#include <charconv>
+#include <clocale>
+#include <cmath>
 #include <cstdarg>
 #include <cstdio>
 
@@ -47,6 +50,43 @@ namespace StringUtils {
         return String(buffer, static_cast<size_t>(count));
     }
 
+    void appendFloat(String& str, const double value, const int precision) {
+        static const double Limits[] = { 1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11, 1e12, 1e13, 1e14, 1e15, 1e16, 1e17 };
+        assert(precision > 0 && precision <= 17);
+
+        // Integral values are most common in map files. If such a value has at most precision digits, %g prints it
+        // without a fraction or an exponent, so it can be printed as an integer.
+        if (std::abs(value) < Limits[precision] && std::trunc(value) == value) {
+            if (value == 0.0 && std::signbit(value)) {
+                str += "-0";
+            } else {
+                appendInt(str, static_cast<long long>(value));
+            }
+            return;
+        }
+
+        char buffer[32];
+#ifdef __cpp_lib_to_chars
+        const auto result = std::to_chars(buffer, buffer + sizeof(buffer), value, std::chars_format::general, precision);
+        assert(result.ec == std::errc());
+        str.append(buffer, result.ptr);
+#else
+        const auto count = std::snprintf(buffer, sizeof(buffer), "%.*g", precision, value);
+        assert(count > 0 && static_cast<size_t>(count) < sizeof(buffer));
+
+        // snprintf uses the decimal point of the current locale
+        std::replace(buffer, buffer + count, *std::localeconv()->decimal_point, '.');
+        str.append(buffer, static_cast<size_t>(count));
+#endif
+    }
+
+    void appendInt(String& str, const long long value) {
+        char buffer[24];
+        const auto result = std::to_chars(buffer, buffer + sizeof(buffer), value);
+        assert(result.ec == std::errc());
+        str.append(buffer, result.ptr);
+    }
+
     String trim(const String& str, const String& chars) {
         if (str.length() == 0)
             return str;
@@ -145,6 +145,17 @@ namespace StringUtils {
         return str.erase(end + 1);
     }
 
+    /**
+     * Appends the given value to the given string, formatted like std::printf formats it with the "%.*g" conversion
+     * and the given precision in the "C" locale.
+     */
+    void appendFloat(String& str, double value, int precision);
+
+    /**
+     * Appends the given value to the given string in decimal notation.
+     */
+    void appendInt(String& str, long long value);
+
     String formatString(const char* format, ...);
     String formatStringV(const char* format, va_list arguments);
     String trim(const String& str, const String& chars = " \n\t\r");
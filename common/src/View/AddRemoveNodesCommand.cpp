@@ -22,6 +22,7 @@
 #include "CollectionUtils.h"
 #include "Macros.h"
 #include "Model/Node.h"
+#include "Model/NodeMemorySizeVisitor.h"
 #include "View/MapDocumentCommandFacade.h"
 
 #include <cassert>
@@ -113,5 +114,12 @@ namespace TrenchBroom {
         bool AddRemoveNodesCommand::doCollateWith(UndoableCommand::Ptr command) {
             return false;
         }
+
+        size_t AddRemoveNodesCommand::doGetMemoryUsage() const {
+            // the nodes to add are not part of the document and belong to this command
+            return Model::memorySize(m_nodesToAdd) +
+                   Model::referencesMemorySize(m_nodesToAdd) +
+                   Model::referencesMemorySize(m_nodesToRemove);
+        }
     }
 }
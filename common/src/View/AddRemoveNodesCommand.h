@@ -54,6 +54,8 @@ namespace TrenchBroom {
             bool doIsRepeatable(MapDocumentCommandFacade* document) const override;
 
             bool doCollateWith(UndoableCommand::Ptr command) override;
+
+            size_t doGetMemoryUsage() const override;
         };
     }
 }
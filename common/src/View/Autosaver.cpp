@@ -21,10 +21,13 @@
 
 #include "StringUtils.h"
 #include "IO/DiskFileSystem.h"
+#include "IO/MapSnapshot.h"
+#include "Model/Game.h"
 #include "View/MapDocument.h"
 
 #include <algorithm>
 #include <cassert>
+#include <chrono>
 
 namespace TrenchBroom {
     namespace View {
@@ -69,10 +72,19 @@ namespace TrenchBroom {
         Autosaver::~Autosaver() {
             unbindObservers();
             NullLogger logger;
+            waitForAutosave(logger);
             triggerAutosave(logger);
+            waitForAutosave(logger);
         }
 
         void Autosaver::triggerAutosave(Logger& logger) {
+            if (backgroundSaveRunning()) {
+                return;
+            }
+            if (m_backgroundSave.valid()) {
+                finishBackgroundSave(logger);
+            }
+
             const auto currentTime = std::time(nullptr);
 
             auto document = lock(m_document);
@@ -100,10 +112,47 @@ namespace TrenchBroom {
             autosave(logger, document);
         }
 
+        void Autosaver::waitForAutosave(Logger& logger) {
+            if (m_backgroundSave.valid()) {
+                finishBackgroundSave(logger);
+            }
+        }
+
+        bool Autosaver::backgroundSaveRunning() const {
+            return m_backgroundSave.valid() && m_backgroundSave.wait_for(std::chrono::seconds(0)) != std::future_status::ready;
+        }
+
+        void Autosaver::finishBackgroundSave(Logger& logger) {
+            assert(m_backgroundSave.valid());
+            m_backgroundSave.wait();
+
+            // report the cached messages and continue caching for the next background save
+            m_backgroundLogger.setParentLogger(&logger);
+            m_backgroundLogger.setParentLogger(nullptr);
+
+            // rethrows any unexpected exception thrown by the background save
+            m_backgroundSave.get();
+        }
+
         void Autosaver::autosave(Logger& logger, MapDocumentSPtr document) {
             const auto& mapPath = document->path();
             assert(IO::Disk::fileExists(IO::Disk::fixPath(mapPath)));
 
+            const auto startTime = std::chrono::steady_clock::now();
+            auto snapshot = std::make_shared<const IO::MapSnapshot>(*document->world());
+            const auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - startTime);
+            logger.debug() << "Took autosave snapshot in " << duration.count() << "ms";
+
+            m_lastSaveTime = std::time(nullptr);
+            m_lastModificationCount = document->modificationCount();
+
+            auto game = document->game();
+            m_backgroundSave = std::async(std::launch::async, [this, game, snapshot, mapPath]() {
+                saveSnapshot(m_backgroundLogger, *game, *snapshot, mapPath);
+            });
+        }
+
+        void Autosaver::saveSnapshot(Logger& logger, const Model::Game& game, const IO::MapSnapshot& snapshot, const IO::Path& mapPath) const {
             const auto mapFilename = mapPath.lastComponent();
             const auto mapBasename = mapFilename.deleteExtension();
 
@@ -118,10 +167,7 @@ namespace TrenchBroom {
                 const auto backupNo = backups.size() + 1;
 
                 const auto backupFilePath = fs.makeAbsolute(makeBackupName(mapBasename, backupNo));
-
-                m_lastSaveTime = std::time(nullptr);
-                m_lastModificationCount = document->modificationCount();
-                document->saveDocumentTo(backupFilePath);
+                game.writeMapSnapshot(snapshot, backupFilePath);
 
                 logger.info() << "Created autosave backup at " << backupFilePath;
             } catch (const FileSystemException& e) {
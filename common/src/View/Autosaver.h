@@ -21,20 +21,30 @@
 #define TrenchBroom_Autosaver
 
 #include "IO/Path.h"
+#include "Model/ModelTypes.h"
+#include "View/CachingLogger.h"
 #include "View/ViewTypes.h"
 
 #include <ctime>
+#include <future>
+#include <memory>
 
 namespace TrenchBroom {
     class Logger;
 
     namespace IO {
+        class MapSnapshot;
         class WritableDiskFileSystem;
     }
 
     namespace View {
         class Command;
 
+        /**
+         * Periodically saves backups of the map. Only a snapshot of the map is taken on the calling thread, the
+         * snapshot is written and the backups are rotated on a background thread. The messages logged by the
+         * background save are reported when the next autosave is triggered after the save has finished.
+         */
         class Autosaver {
         public:
             class BackupFileMatcher {
@@ -77,13 +87,32 @@ namespace TrenchBroom {
              * The modification count that was last recorded.
              */
             size_t m_lastModificationCount;
+
+            /**
+             * The autosave that is running in the background, if any.
+             */
+            std::future<void> m_backgroundSave;
+
+            /**
+             * Collects the messages of the background save until they can be reported on the calling thread.
+             */
+            CachingLogger m_backgroundLogger;
         public:
             explicit Autosaver(View::MapDocumentWPtr document, std::time_t saveInterval = 10 * 60, std::time_t idleInterval = 3, size_t maxBackups = 50);
             ~Autosaver();
 
             void triggerAutosave(Logger& logger);
+
+            /**
+             * Waits until a running background save has finished and reports its messages to the given logger.
+             */
+            void waitForAutosave(Logger& logger);
         private:
+            bool backgroundSaveRunning() const;
+            void finishBackgroundSave(Logger& logger);
+
             void autosave(Logger& logger, View::MapDocumentSPtr document);
+            void saveSnapshot(Logger& logger, const Model::Game& game, const IO::MapSnapshot& snapshot, const IO::Path& mapPath) const;
             IO::WritableDiskFileSystem createBackupFileSystem(Logger& logger, const IO::Path& mapPath) const;
             IO::Path::List collectBackups(const IO::WritableDiskFileSystem& fs, const IO::Path& mapBasename) const;
             void thinBackups(Logger& logger, IO::WritableDiskFileSystem& fs, IO::Path::List& backups) const;
@@ -26,6 +26,7 @@
 #include <wx/time.h>
 
 #include <algorithm>
+#include <iterator>
 
 namespace TrenchBroom {
     namespace View {
@@ -98,7 +99,15 @@ namespace TrenchBroom {
             return false;
         }
 
+        size_t CommandGroup::doGetMemoryUsage() const {
+            size_t result = 0;
+            for (const auto& command : m_commands)
+                result += command->memoryUsage();
+            return result;
+        }
+
         const wxLongLong CommandProcessor::CollationInterval(1000);
+        const size_t CommandProcessor::DefaultMemoryBudget = 256 * 1024 * 1024;
 
         struct CommandProcessor::SubmitAndStoreResult {
             bool submitted;
@@ -113,7 +122,9 @@ namespace TrenchBroom {
         m_document(document),
         m_clearRepeatableCommandStack(false),
         m_lastCommandTimestamp(0),
-        m_groupLevel(0) {
+        m_groupLevel(0),
+        m_memoryBudget(DefaultMemoryBudget),
+        m_memoryUsage(0) {
             ensure(m_document != nullptr, "document is null");
         }
 
@@ -170,7 +181,7 @@ namespace TrenchBroom {
             if (!success) {
                 return false;
             } else {
-                m_lastCommandStack.clear();
+                clearLastCommands();
                 m_nextCommandStack.clear();
                 return true;
             }
@@ -248,11 +259,24 @@ namespace TrenchBroom {
             assert(m_groupLevel == 0);
 
             clearRepeatableCommands();
-            m_lastCommandStack.clear();
+            clearLastCommands();
             m_nextCommandStack.clear();
             m_lastCommandTimestamp = 0;
         }
 
+        void CommandProcessor::setMemoryBudget(const size_t memoryBudget) {
+            m_memoryBudget = memoryBudget;
+            trimLastCommands();
+        }
+
+        size_t CommandProcessor::memoryBudget() const {
+            return m_memoryBudget;
+        }
+
+        size_t CommandProcessor::memoryUsage() const {
+            return m_memoryUsage;
+        }
+
         CommandProcessor::SubmitAndStoreResult CommandProcessor::submitAndStoreCommand(UndoableCommand::Ptr command, const bool collate) {
             SubmitAndStoreResult result;
             result.submitted = doCommand(command);
@@ -352,17 +376,56 @@ namespace TrenchBroom {
             if (collatable(collate, timestamp)) {
                 auto lastCommand = m_lastCommandStack.back();
                 if (lastCommand->collateWith(command)) {
+                    // only the collated command may have changed its memory usage
+                    auto& lastMemoryUsage = m_lastCommandMemoryUsage.back();
+                    m_memoryUsage -= lastMemoryUsage;
+                    lastMemoryUsage = lastCommand->memoryUsage();
+                    m_memoryUsage += lastMemoryUsage;
+
+                    trimLastCommands();
                     return false;
                 }
             }
+
+            const auto memoryUsage = command->memoryUsage();
             m_lastCommandStack.push_back(command);
+            m_lastCommandMemoryUsage.push_back(memoryUsage);
+            m_memoryUsage += memoryUsage;
+
+            trimLastCommands();
             return true;
         }
 
+        void CommandProcessor::clearLastCommands() {
+            m_lastCommandStack.clear();
+            m_lastCommandMemoryUsage.clear();
+            m_memoryUsage = 0;
+        }
+
         bool CommandProcessor::collatable(const bool collate, const wxLongLong& timestamp) const {
             return collate && !m_lastCommandStack.empty() && timestamp - m_lastCommandTimestamp <= CollationInterval;
         }
 
+        void CommandProcessor::trimLastCommands() {
+            if (m_memoryUsage <= m_memoryBudget)
+                return;
+
+            // discard the oldest commands, but always keep the most recent one so that it can be undone
+            size_t count = 0;
+            while (count + 1 < m_lastCommandStack.size() && m_memoryUsage > m_memoryBudget) {
+                m_memoryUsage -= m_lastCommandMemoryUsage[count];
+                ++count;
+            }
+
+            const auto offset = static_cast<CommandStack::difference_type>(count);
+            m_lastCommandStack.erase(std::begin(m_lastCommandStack), std::next(std::begin(m_lastCommandStack), offset));
+            m_lastCommandMemoryUsage.erase(std::begin(m_lastCommandMemoryUsage), std::next(std::begin(m_lastCommandMemoryUsage), offset));
+
+            if (count > 0) {
+                m_document->info() << "Discarded " << count << " undo step(s), undo history now uses " << (m_memoryUsage / 1024) << " KB of " << (m_memoryBudget / 1024) << " KB";
+            }
+        }
+
         void CommandProcessor::pushNextCommand(UndoableCommand::Ptr command) {
             assert(m_groupLevel == 0);
             m_nextCommandStack.push_back(command);
@@ -387,6 +450,8 @@ namespace TrenchBroom {
             } else {
                 auto lastCommand = m_lastCommandStack.back();
                 m_lastCommandStack.pop_back();
+                m_memoryUsage -= m_lastCommandMemoryUsage.back();
+                m_lastCommandMemoryUsage.pop_back();
                 return lastCommand;
             }
         }
@@ -62,12 +62,16 @@ namespace TrenchBroom {
             UndoableCommand::Ptr doRepeat(MapDocumentCommandFacade* document) const override;
 
             bool doCollateWith(UndoableCommand::Ptr command) override;
+
+            size_t doGetMemoryUsage() const override;
         };
 
         class CommandProcessor {
         private:
             static const wxLongLong CollationInterval;
-
+        public:
+            static const size_t DefaultMemoryBudget;
+        private:
             MapDocumentCommandFacade* m_document;
 
             using CommandStack = CommandList;
@@ -81,6 +85,11 @@ namespace TrenchBroom {
             CommandStack m_groupedCommands;
             size_t m_groupLevel;
 
+            size_t m_memoryBudget;
+            // the memory usage of each command on the undo stack when it was pushed, and their sum
+            std::vector<size_t> m_lastCommandMemoryUsage;
+            size_t m_memoryUsage;
+
             struct SubmitAndStoreResult;
         public:
             CommandProcessor(MapDocumentCommandFacade* document);
@@ -111,6 +120,19 @@ namespace TrenchBroom {
             void clearRepeatableCommands();
 
             void clear();
+
+            /**
+             * Limits the memory that the undoable commands may hold on to. If the commands on the undo stack use more
+             * memory than this, the oldest commands are discarded until they fit, but the most recent command is
+             * always kept.
+             */
+            void setMemoryBudget(size_t memoryBudget);
+            size_t memoryBudget() const;
+
+            /**
+             * Returns the approximate number of bytes of memory used by the commands on the undo stack.
+             */
+            size_t memoryUsage() const;
         private:
             SubmitAndStoreResult submitAndStoreCommand(UndoableCommand::Ptr command, bool collate);
             bool doCommand(Command::Ptr command);
@@ -124,7 +146,9 @@ namespace TrenchBroom {
             UndoableCommand::Ptr createCommandGroup(const String& name, const CommandList& commands);
 
             bool pushLastCommand(UndoableCommand::Ptr command, bool collate);
+            void clearLastCommands();
             bool collatable(bool collate, const wxLongLong& timestamp) const;
+            void trimLastCommands();
 
             void pushNextCommand(UndoableCommand::Ptr command);
             void pushRepeatableCommand(UndoableCommand::Ptr command);
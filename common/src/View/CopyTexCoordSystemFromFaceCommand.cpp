@@ -76,5 +76,9 @@ namespace TrenchBroom {
         bool CopyTexCoordSystemFromFaceCommand::doCollateWith(UndoableCommand::Ptr command) {
             return false;
         }
+
+        size_t CopyTexCoordSystemFromFaceCommand::doGetMemoryUsage() const {
+            return m_snapshot != nullptr ? m_snapshot->memorySize() : 0;
+        }
     }
 }
@@ -20,6 +20,7 @@
 #include "DuplicateNodesCommand.h"
 
 #include "Model/Node.h"
+#include "Model/NodeMemorySizeVisitor.h"
 #include "Model/NodeVisitor.h"
 #include "View/MapDocumentCommandFacade.h"
 
@@ -115,5 +116,16 @@ namespace TrenchBroom {
         bool DuplicateNodesCommand::doCollateWith(UndoableCommand::Ptr command) {
             return false;
         }
+
+        size_t DuplicateNodesCommand::doGetMemoryUsage() const {
+            size_t result = (m_previouslySelectedNodes.capacity() + m_nodesToSelect.capacity()) * sizeof(Model::Node*);
+            result += Model::referencesMemorySize(m_addedNodes);
+
+            // the duplicates belong to this command while they are not part of the document, see the destructor
+            if (state() == CommandState_Default) {
+                result += Model::memorySize(m_addedNodes);
+            }
+            return result;
+        }
     }
 }
@@ -123,7 +123,7 @@ namespace TrenchBroom {
         }
 
         void IssueBrowser::nodesWereAdded(const Model::NodeList& nodes) {
-            m_view->reload();
+            m_view->update();
         }
 
         void IssueBrowser::nodesWereRemoved(const Model::NodeList& nodes) {
@@ -131,11 +131,11 @@ namespace TrenchBroom {
         }
 
         void IssueBrowser::nodesDidChange(const Model::NodeList& nodes) {
-            m_view->reload();
+            m_view->update();
         }
 
         void IssueBrowser::brushFacesDidChange(const Model::BrushFaceList& faces) {
-            m_view->reload();
+            m_view->update();
         }
 
         void IssueBrowser::issueIgnoreChanged(Model::Issue* issue) {
@@ -36,7 +36,8 @@ namespace TrenchBroom {
         m_document(document),
         m_hiddenGenerators(0),
         m_showHiddenIssues(false),
-        m_valid(false) {
+        m_valid(false),
+        m_reloadAll(true) {
             AppendColumn("Line");
             AppendColumn("Description");
 
@@ -51,15 +52,20 @@ namespace TrenchBroom {
             if (hiddenGenerators == m_hiddenGenerators)
                 return;
             m_hiddenGenerators = hiddenGenerators;
-            invalidate();
+            reload();
         }
 
         void IssueBrowserView::setShowHiddenIssues(const bool show) {
             m_showHiddenIssues = show;
-            invalidate();
+            reload();
         }
 
         void IssueBrowserView::reload() {
+            m_reloadAll = true;
+            invalidate();
+        }
+
+        void IssueBrowserView::update() {
             invalidate();
         }
 
@@ -172,12 +178,49 @@ namespace TrenchBroom {
 
             MapDocumentSPtr document = lock(m_document);
             Model::World* world = document->world();
-            if (world != nullptr) {
-                const Model::IssueGeneratorList& issueGenerators = world->registeredIssueGenerators();
-                Model::CollectMatchingIssuesVisitor<IssueVisible> visitor(issueGenerators, IssueVisible(m_hiddenGenerators, m_showHiddenIssues));
+            if (world == nullptr) {
+                m_issuesByNode.clear();
+                return;
+            }
+
+            // generates the issues of all invalidated nodes in parallel, so collecting them below is cheap
+            const Model::NodeList changedNodes = world->validateQueuedIssues();
+
+            const Model::IssueGeneratorList& issueGenerators = world->registeredIssueGenerators();
+            const IssueVisible issueVisible(m_hiddenGenerators, m_showHiddenIssues);
+
+            if (m_reloadAll) {
+                m_reloadAll = false;
+                m_issuesByNode.clear();
+
+                Model::CollectMatchingIssuesVisitor<IssueVisible> visitor(issueGenerators, issueVisible);
                 world->acceptAndRecurse(visitor);
-                m_issues = visitor.issues();
-                VectorUtils::sort(m_issues, IssueCmp());
+                for (Model::Issue* issue : visitor.issues()) {
+                    m_issuesByNode[issue->node()].push_back(issue);
+                }
+            } else {
+                for (Model::Node* node : changedNodes) {
+                    Model::IssueList issues;
+                    for (Model::Issue* issue : node->issues(issueGenerators)) {
+                        if (issueVisible(issue)) {
+                            issues.push_back(issue);
+                        }
+                    }
+                    updateNodeIssues(node, issues);
+                }
+            }
+
+            for (const auto& entry : m_issuesByNode) {
+                VectorUtils::append(m_issues, entry.second);
+            }
+            VectorUtils::sort(m_issues, IssueCmp());
+        }
+
+        void IssueBrowserView::updateNodeIssues(Model::Node* node, const Model::IssueList& issues) {
+            if (issues.empty()) {
+                m_issuesByNode.erase(node);
+            } else {
+                m_issuesByNode[node] = issues;
             }
         }
 
@@ -236,7 +279,7 @@ namespace TrenchBroom {
                 document->setIssueHidden(issue, !show);
             }
 
-            invalidate();
+            reload();
         }
 
         IssueBrowserView::IndexList IssueBrowserView::getSelection() const {
@@ -27,6 +27,7 @@
 
 #include <wx/listctrl.h>
 
+#include <map>
 #include <vector>
 
 class wxWindow;
@@ -43,18 +44,29 @@ namespace TrenchBroom {
 
             MapDocumentWPtr m_document;
             Model::IssueList m_issues;
+            // the visible issues of every node that has any
+            std::map<Model::Node*, Model::IssueList> m_issuesByNode;
 
             Model::IssueType m_hiddenGenerators;
             bool m_showHiddenIssues;
 
             bool m_valid;
+            bool m_reloadAll;
         public:
             IssueBrowserView(wxWindow* parent, MapDocumentWPtr document);
 
             int hiddenGenerators() const;
             void setHiddenGenerators(int hiddenGenerators);
             void setShowHiddenIssues(bool show);
+            /**
+             * Collects the issues of all nodes again.
+             */
             void reload();
+            /**
+             * Only collects the issues of the nodes that were invalidated since the last update. Nodes that were
+             * removed from the world require a reload.
+             */
+            void update();
             void deselectAll();
 
             void OnSize(wxSizeEvent& event);
@@ -69,6 +81,7 @@ namespace TrenchBroom {
             class IssueCmp;
 
             void updateIssues();
+            void updateNodeIssues(Model::Node* node, const Model::IssueList& issues);
 
             Model::IssueList collectIssues(const IndexList& indices) const;
             Model::IssueQuickFixList collectQuickFixes(const IndexList& indices) const;
@@ -27,6 +27,7 @@
 #include "Assets/Texture.h"
 #include "Assets/TextureManager.h"
 #include "IO/DiskFileSystem.h"
+#include "IO/MapCache.h"
 #include "IO/SimpleParserStatus.h"
 #include "IO/SystemPaths.h"
 #include "Model/AttributeNameWithDoubleQuotationMarksIssueGenerator.h"
@@ -149,6 +150,8 @@ namespace TrenchBroom {
         m_lastSelectionBounds(0.0, 32.0),
         m_selectionBoundsValid(true),
         m_viewEffectsService(nullptr) {
+                m_textureManager->setLazyLoading(pref(Preferences::LazyTextureLoading));
+                m_textureManager->setCacheDirectory(textureCacheDirectory());
                 bindObservers();
         }
 
@@ -292,11 +295,22 @@ namespace TrenchBroom {
 
         void MapDocument::doSaveDocument(const IO::Path& path) {
             saveDocumentTo(path);
+            writeMapCache(path);
             setLastSaveModificationCount();
             setPath(path);
             documentWasSavedNotifier(this);
         }
 
+        void MapDocument::writeMapCache(const IO::Path& path) {
+            if (pref(Preferences::MapCache)) {
+                try {
+                    IO::MapCache::write(*m_world, m_worldBounds, path);
+                } catch (const Exception& e) {
+                    warn("Could not write map cache: %s", e.what());
+                }
+            }
+        }
+
         void MapDocument::clearDocument() {
             if (m_world != nullptr) {
                 documentWillBeClearedNotifier(this);
@@ -1514,7 +1528,12 @@ namespace TrenchBroom {
         void MapDocument::loadWorld(const Model::MapFormat mapFormat, const vm::bbox3& worldBounds, Model::GameSPtr game, const IO::Path& path) {
             m_worldBounds = worldBounds;
             m_game = game;
-            m_world = m_game->loadMap(mapFormat, m_worldBounds, path, logger());
+            if (pref(Preferences::MapCache)) {
+                m_world = IO::MapCache::read(mapFormat, m_worldBounds, path, logger());
+            }
+            if (m_world == nullptr) {
+                m_world = m_game->loadMap(mapFormat, m_worldBounds, path, logger());
+            }
             setCurrentLayer(m_world->defaultLayer());
 
             updateGameSearchPaths();
@@ -1635,6 +1654,14 @@ namespace TrenchBroom {
             m_textureManager->clear();
         }
 
+        IO::Path MapDocument::textureCacheDirectory() {
+            if (pref(Preferences::TextureCache)) {
+                return IO::SystemPaths::userDataDirectory() + IO::Path("TextureCache");
+            } else {
+                return IO::Path();
+            }
+        }
+
         class MapDocument::SetTextures : public Model::NodeVisitor {
         private:
             Assets::TextureManager& m_manager;
@@ -1949,23 +1976,26 @@ namespace TrenchBroom {
         }
 
 
-        class MapDocument::InitializeFaceTagsVisitor : public Model::NodeVisitor {
+        class MapDocument::CollectBrushesVisitor : public Model::NodeVisitor {
         private:
-            Model::TagManager& m_tagManager;
+            Model::BrushList m_brushes;
         public:
-            explicit InitializeFaceTagsVisitor(Model::TagManager& tagManager) :
-                m_tagManager(tagManager) {}
+            const Model::BrushList& brushes() const { return m_brushes; }
         private:
             void doVisit(Model::World* world)   override {}
             void doVisit(Model::Layer* layer)   override {}
             void doVisit(Model::Group* group)   override {}
             void doVisit(Model::Entity* entity) override {}
-            void doVisit(Model::Brush* brush)   override { brush->initializeTags(m_tagManager); }
+            void doVisit(Model::Brush* brush)   override { m_brushes.push_back(brush); }
         };
 
         void MapDocument::updateAllFaceTags() {
-            InitializeFaceTagsVisitor visitor(*m_tagManager);
+            // the textures have changed, so the cached tags may refer to textures that no longer exist
+            m_tagManager->clearTagCache();
+
+            CollectBrushesVisitor visitor;
             m_world->acceptAndRecurse(visitor);
+            Model::Brush::initializeTags(visitor.brushes(), *m_tagManager);
         }
 
         bool MapDocument::persistent() const {
@@ -2059,6 +2089,14 @@ namespace TrenchBroom {
                        path == Preferences::TextureMagFilter.path()) {
                 m_entityModelManager->setTextureMode(pref(Preferences::TextureMinFilter), pref(Preferences::TextureMagFilter));
                 m_textureManager->setTextureMode(pref(Preferences::TextureMinFilter), pref(Preferences::TextureMagFilter));
+            } else if (path == Preferences::LazyTextureLoading.path()) {
+                m_textureManager->setLazyLoading(pref(Preferences::LazyTextureLoading));
+
+                unloadTextures();
+                loadTextures();
+                setTextures();
+            } else if (path == Preferences::TextureCache.path()) {
+                m_textureManager->setCacheDirectory(textureCacheDirectory());
             }
         }
 
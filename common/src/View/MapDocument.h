@@ -197,6 +197,7 @@ namespace TrenchBroom {
             void exportDocumentAs(Model::ExportFormat format, const IO::Path& path);
         private:
             void doSaveDocument(const IO::Path& path);
+            void writeMapCache(const IO::Path& path);
             void clearDocument();
         public: // copy and paste
             String serializeSelectedNodes();
@@ -428,6 +429,7 @@ namespace TrenchBroom {
             void reloadTextures();
             void loadTextures();
             void unloadTextures();
+            static IO::Path textureCacheDirectory();
 
             class SetTextures;
             class UnsetTextures;
@@ -481,7 +483,7 @@ namespace TrenchBroom {
             void clearNodeTags(const Model::NodeList& nodes);
             void updateNodeTags(const Model::NodeList& nodes);
 
-            class InitializeFaceTagsVisitor;
+            class CollectBrushesVisitor;
             void updateFaceTags(const Model::BrushFaceList& faces);
             void updateAllFaceTags();
         public: // document path
@@ -24,6 +24,7 @@
 #include "PreferenceManager.h"
 #include "Assets/EntityDefinitionFileSpec.h"
 #include "Assets/TextureManager.h"
+#include "Model/AssortNodesVisitor.h"
 #include "Model/Brush.h"
 #include "Model/BrushFace.h"
 #include "Model/ChangeBrushFaceAttributesRequest.h"
@@ -448,32 +449,11 @@ namespace TrenchBroom {
             groupWasClosedNotifier(previousGroup);
         }
 
-        class CanTransformVisitor : public Model::ConstNodeVisitor, public Model::NodeQuery<bool> {
-        private:
-            vm::mat4x4 m_transform;
-            vm::bbox3 m_worldBounds;
-        public:
-            CanTransformVisitor(const vm::mat4x4& transform, const vm::bbox3& worldBounds) :
-                m_transform(transform),
-                m_worldBounds(worldBounds) {}
-        private:
-            void doVisit(const Model::World* world) override { setResult(true); }
-            void doVisit(const Model::Layer* layer) override { setResult(true); }
-            void doVisit(const Model::Group* group) override { setResult(true); }
-            void doVisit(const Model::Entity* entity) override { setResult(true); }
-            void doVisit(const Model::Brush* brush) override { setResult(brush->canTransform(m_transform, m_worldBounds)); }
-            bool doCombineResults(bool oldResult, bool newResult) const override {
-                return newResult && oldResult;
-            }
-        };
-
         bool MapDocumentCommandFacade::performTransform(const vm::mat4x4 &transform, const bool lockTextures) {
           // Test whether all brushes can be transformed; abort if any fail.
-          CanTransformVisitor canTransform(transform, m_worldBounds);
-          for (const auto* node : m_selectedNodes.nodes()) {
-              node->acceptAndRecurse(canTransform);
-          }
-          if (canTransform.hasResult() && !canTransform.result()) {
+          Model::CollectBrushesVisitor collectBrushes;
+          Model::Node::acceptAndRecurse(std::begin(m_selectedNodes.nodes()), std::end(m_selectedNodes.nodes()), collectBrushes);
+          if (!Model::Brush::canTransform(collectBrushes.brushes(), transform, m_worldBounds)) {
               return false;
           }
 
@@ -489,6 +469,7 @@ namespace TrenchBroom {
           Model::TransformObjectVisitor visitor(transform, lockTextures,
                                                 m_worldBounds);
           Model::Node::accept(std::begin(nodes), std::end(nodes), visitor);
+          visitor.transformBrushes();
 
           invalidateSelectionBounds();
           return true;
@@ -872,8 +853,7 @@ namespace TrenchBroom {
             Notifier<const Model::NodeList&>::NotifyBeforeAndAfter notifyParents(nodesWillChangeNotifier, nodesDidChangeNotifier, parents);
             Notifier<const Model::NodeList&>::NotifyBeforeAndAfter notifyNodes(nodesWillChangeNotifier, nodesDidChangeNotifier, nodes);
 
-            for (Model::Brush* brush : brushes)
-                brush->rebuildGeometry(m_worldBounds);
+            Model::Brush::rebuildGeometry(brushes, m_worldBounds);
 
             invalidateSelectionBounds();
         }
@@ -28,6 +28,7 @@
 #include "Model/BrushGeometry.h"
 #include "Model/Entity.h"
 #include "Model/HitAdapter.h"
+#include "Model/HitFilter.h"
 #include "Model/HitQuery.h"
 #include "Model/PickResult.h"
 #include "Model/PointFile.h"
@@ -331,7 +332,11 @@ namespace TrenchBroom {
                 const auto pickRay = vm::ray3(m_camera.pickRay(clientCoords.x, clientCoords.y));
 
                 const auto& editorContext = document->editorContext();
-                auto pickResult = Model::PickResult::byDistance(editorContext);
+                // only the nearest hit that matches the query below is needed, so the filter must match the query
+                auto* filter = new Model::HitFilterChain(new Model::VisibleHitFilter(editorContext),
+                                                         new Model::HitFilterChain(new Model::ContextHitFilter(editorContext),
+                                                                                   new Model::TypedHitFilter(Model::Brush::BrushHit)));
+                auto pickResult = Model::PickResult::byDistance(editorContext, 1, filter);
 
                 document->pick(pickRay, pickResult);
                 const auto& hit = pickResult.query().pickable().type(Model::Brush::BrushHit).first();
@@ -21,6 +21,7 @@
 
 #include "CollectionUtils.h"
 #include "Model/ModelUtils.h"
+#include "Model/NodeMemorySizeVisitor.h"
 #include "View/MapDocumentCommandFacade.h"
 
 #include <cassert>
@@ -57,5 +58,11 @@ namespace TrenchBroom {
         bool ReparentNodesCommand::doCollateWith(UndoableCommand::Ptr command) {
             return false;
         }
+
+        size_t ReparentNodesCommand::doGetMemoryUsage() const {
+            // the reparented nodes are part of the document
+            return Model::referencesMemorySize(m_nodesToAdd) +
+                   Model::referencesMemorySize(m_nodesToRemove);
+        }
     }
 }
@@ -66,6 +66,10 @@ namespace TrenchBroom {
             m_snapshot = nullptr;
         }
 
+        size_t SnapshotCommand::doGetMemoryUsage() const {
+            return m_snapshot != nullptr ? m_snapshot->memorySize() : 0;
+        }
+
         Model::Snapshot *SnapshotCommand::doTakeSnapshot(MapDocumentCommandFacade *document) const {
             const auto& nodes = document->selectedNodes().nodes();
             return new Model::Snapshot(std::begin(nodes), std::end(nodes));
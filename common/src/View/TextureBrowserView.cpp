@@ -240,6 +240,7 @@ namespace TrenchBroom {
 
         void TextureBrowserView::doRender(Layout& layout, const float y, const float height) {
             m_textureManager.commitChanges();
+            decodeVisibleTextures(layout, y, height);
 
             const float viewLeft      = static_cast<float>(GetClientRect().GetLeft());
             const float viewTop       = static_cast<float>(GetClientRect().GetBottom());
@@ -264,6 +265,27 @@ namespace TrenchBroom {
             return false;
         }
 
+        void TextureBrowserView::decodeVisibleTextures(Layout& layout, const float y, const float height) {
+            Assets::TextureList textures;
+
+            for (size_t i = 0; i < layout.size(); ++i) {
+                const Layout::Group& group = layout[i];
+                if (group.intersectsY(y, height)) {
+                    for (size_t j = 0; j < group.size(); ++j) {
+                        const Layout::Group::Row& row = group[j];
+                        if (row.intersectsY(y, height)) {
+                            for (size_t k = 0; k < row.size(); ++k) {
+                                textures.push_back(row[k].item().texture);
+                            }
+                        }
+                    }
+                }
+            }
+
+            // lazily loaded textures are decoded in parallel here instead of one by one when they are activated
+            m_textureManager.decodeTextures(textures);
+        }
+
         void TextureBrowserView::renderBounds(Layout& layout, const float y, const float height) {
             using BoundsVertex = Renderer::GLVertexTypes::P2C4::Vertex;
             BoundsVertex::List vertices;
@@ -105,6 +105,7 @@ namespace TrenchBroom {
             void doRender(Layout& layout, float y, float height) override;
             bool doShouldRenderFocusIndicator() const override;
 
+            void decodeVisibleTextures(Layout& layout, float y, float height);
             void renderBounds(Layout& layout, float y, float height);
             const Color& textureColor(const Assets::Texture& texture) const;
             void renderTextures(Layout& layout, float y, float height);
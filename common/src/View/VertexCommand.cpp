@@ -162,6 +162,10 @@ namespace TrenchBroom {
             m_snapshot.reset();
         }
 
+        size_t VertexCommand::doGetMemoryUsage() const {
+            return m_snapshot != nullptr ? m_snapshot->memorySize() : 0;
+        }
+
         bool VertexCommand::canCollateWith(const VertexCommand& other) const {
             return VectorUtils::equals(m_brushes, other.m_brushes);
         }
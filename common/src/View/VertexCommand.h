@@ -77,6 +77,8 @@ namespace TrenchBroom {
         private:
             void takeSnapshot();
             void deleteSnapshot();
+
+            size_t doGetMemoryUsage() const override;
         protected:
             bool canCollateWith(const VertexCommand& other) const;
         private:
@@ -23,27 +23,68 @@
 #include "Preferences.h"
 #include "View/Grid.h"
 
+#include <vecmath/bbox.h>
 #include <vecmath/vec.h>
 #include <vecmath/ray.h>
 #include <vecmath/plane.h>
 #include <vecmath/intersection.h>
 
+#include <cmath>
+
 namespace TrenchBroom {
     namespace View {
+        /**
+         * Computes an upper bound of the radius with which a camera picks a point handle anywhere in a bounding box.
+         *
+         * The perspective scaling factor of a camera is an affine function of the position. It is sampled once near
+         * the given origin, and the bound for a box is then computed from its center and extents without calling into
+         * the camera again. The scaling factor is computed with float precision, so the bound is enlarged slightly.
+         */
+        class PointHandleRadius {
+        private:
+            static constexpr FloatType SampleDistance = 1024.0;
+            static constexpr FloatType Tolerance = 1.01;
+
+            FloatType m_handleRadius;
+            vm::vec3 m_origin;
+            FloatType m_scaling;
+            vm::vec3 m_gradient;
+        public:
+            PointHandleRadius(const Renderer::Camera& camera, const vm::vec3& origin, const FloatType handleRadius) :
+            m_handleRadius(handleRadius),
+            m_origin(origin),
+            m_scaling(scalingAt(camera, origin)) {
+                for (size_t i = 0; i < 3; ++i) {
+                    auto sample = origin;
+                    sample[i] += SampleDistance;
+                    m_gradient[i] = (scalingAt(camera, sample) - m_scaling) / SampleDistance;
+                }
+            }
+
+            FloatType operator()(const vm::bbox3& bounds) const {
+                const auto scaling = std::abs(m_scaling + vm::dot(m_gradient, bounds.center() - m_origin)) + vm::dot(vm::abs(m_gradient), bounds.size() / 2.0);
+                return 2.0 * m_handleRadius * scaling * Tolerance;
+            }
+        private:
+            static FloatType scalingAt(const Renderer::Camera& camera, const vm::vec3& position) {
+                return static_cast<FloatType>(camera.perspectiveScalingFactor(vm::vec3f(position)));
+            }
+        };
+
         VertexHandleManagerBase::~VertexHandleManagerBase() {}
 
         const Model::Hit::HitType VertexHandleManager::HandleHit = Model::Hit::freeHitType();
 
         void VertexHandleManager::pick(const vm::ray3& pickRay, const Renderer::Camera& camera, Model::PickResult& pickResult) const {
-            for (const auto& entry : m_handles) {
-                const auto& position = entry.first;
-                const auto distance = camera.pickPointHandle(pickRay, position, pref(Preferences::HandleRadius));
+            const FloatType handleRadius = pref(Preferences::HandleRadius);
+            forEachHandleNearRay(pickRay, PointHandleRadius(camera, pickRay.origin, handleRadius), [&](const vm::vec3& position) {
+                const auto distance = camera.pickPointHandle(pickRay, position, handleRadius);
                 if (!vm::isnan(distance)) {
                     const auto hitPoint = pickRay.pointAtDistance(distance);
                     const auto error = vm::squaredDistance(pickRay, position).distance;
                     pickResult.addHit(Model::Hit::hit(HandleHit, distance, hitPoint, position, error));
                 }
-            }
+            });
         }
 
         void VertexHandleManager::addHandles(const Model::Brush* brush) {
@@ -69,31 +110,32 @@ namespace TrenchBroom {
         const Model::Hit::HitType EdgeHandleManager::HandleHit = Model::Hit::freeHitType();
 
         void EdgeHandleManager::pickGridHandle(const vm::ray3& pickRay, const Renderer::Camera& camera, const Grid& grid, Model::PickResult& pickResult) const {
-            for (const HandleEntry& entry : m_handles) {
-                const vm::segment3& position = entry.first;
-                const FloatType edgeDist = camera.pickLineSegmentHandle(pickRay, position, pref(Preferences::HandleRadius));
+            // an edge can only be hit near one of its points, so its bounds are expanded by the point handle radius
+            const FloatType handleRadius = pref(Preferences::HandleRadius);
+            forEachHandleNearRay(pickRay, PointHandleRadius(camera, pickRay.origin, handleRadius), [&](const vm::segment3& position) {
+                const FloatType edgeDist = camera.pickLineSegmentHandle(pickRay, position, handleRadius);
                 if (!vm::isnan(edgeDist)) {
                     const vm::vec3 pointHandle = grid.snap(pickRay.pointAtDistance(edgeDist), position);
-                    const FloatType pointDist = camera.pickPointHandle(pickRay, pointHandle, pref(Preferences::HandleRadius));
+                    const FloatType pointDist = camera.pickPointHandle(pickRay, pointHandle, handleRadius);
                     if (!vm::isnan(pointDist)) {
                         const vm::vec3 hitPoint = pickRay.pointAtDistance(pointDist);
                         pickResult.addHit(Model::Hit::hit(HandleHit, pointDist, hitPoint, HitType(position, pointHandle)));
                     }
                 }
-            }
+            });
         }
 
         void EdgeHandleManager::pickCenterHandle(const vm::ray3& pickRay, const Renderer::Camera& camera, Model::PickResult& pickResult) const {
-            for (const HandleEntry& entry : m_handles) {
-                const vm::segment3& position = entry.first;
+            const FloatType handleRadius = pref(Preferences::HandleRadius);
+            forEachHandleNearRay(pickRay, PointHandleRadius(camera, pickRay.origin, handleRadius), [&](const vm::segment3& position) {
                 const vm::vec3 pointHandle = position.center();
 
-                const FloatType pointDist = camera.pickPointHandle(pickRay, pointHandle, pref(Preferences::HandleRadius));
+                const FloatType pointDist = camera.pickPointHandle(pickRay, pointHandle, handleRadius);
                 if (!vm::isnan(pointDist)) {
                     const vm::vec3 hitPoint = pickRay.pointAtDistance(pointDist);
                     pickResult.addHit(Model::Hit::hit(HandleHit, pointDist, hitPoint, position));
                 }
-            }
+            });
         }
 
         void EdgeHandleManager::addHandles(const Model::Brush* brush) {
@@ -119,38 +161,39 @@ namespace TrenchBroom {
         const Model::Hit::HitType FaceHandleManager::HandleHit = Model::Hit::freeHitType();
 
         void FaceHandleManager::pickGridHandle(const vm::ray3& pickRay, const Renderer::Camera& camera, const Grid& grid, Model::PickResult& pickResult) const {
-            for (const auto& entry : m_handles) {
-                const auto& position = entry.first;
-
+            // the ray must hit the face itself, so the bounds of the faces need not be expanded
+            const FloatType handleRadius = pref(Preferences::HandleRadius);
+            const auto noRadius = [](const vm::bbox3& /* bounds */) { return 0.0; };
+            forEachHandleNearRay(pickRay, noRadius, [&](const vm::polygon3& position) {
                 const auto [valid, plane] = vm::fromPoints(std::begin(position), std::end(position));
                 if (!valid) {
-                    continue;
+                    return;
                 }
 
                 const auto distance = vm::intersect(pickRay, plane, std::begin(position), std::end(position));
                 if (!vm::isnan(distance)) {
                     const auto pointHandle = grid.snap(pickRay.pointAtDistance(distance), plane);
 
-                    const auto pointDist = camera.pickPointHandle(pickRay, pointHandle, pref(Preferences::HandleRadius));
+                    const auto pointDist = camera.pickPointHandle(pickRay, pointHandle, handleRadius);
                     if (!vm::isnan(pointDist)) {
                         const auto hitPoint = pickRay.pointAtDistance(pointDist);
                         pickResult.addHit(Model::Hit::hit(HandleHit, pointDist, hitPoint, HitType(position, pointHandle)));
                     }
                 }
-            }
+            });
         }
 
         void FaceHandleManager::pickCenterHandle(const vm::ray3& pickRay, const Renderer::Camera& camera, Model::PickResult& pickResult) const {
-            for (const HandleEntry& entry : m_handles) {
-                const auto& position = entry.first;
+            const FloatType handleRadius = pref(Preferences::HandleRadius);
+            forEachHandleNearRay(pickRay, PointHandleRadius(camera, pickRay.origin, handleRadius), [&](const vm::polygon3& position) {
                 const auto pointHandle = position.center();
 
-                const auto pointDist = camera.pickPointHandle(pickRay, pointHandle, pref(Preferences::HandleRadius));
+                const auto pointDist = camera.pickPointHandle(pickRay, pointHandle, handleRadius);
                 if (!vm::isnan(pointDist)) {
                     const auto hitPoint = pickRay.pointAtDistance(pointDist);
                     pickResult.addHit(Model::Hit::hit(HandleHit, pointDist, hitPoint, position));
                 }
-            }
+            });
         }
 
         void FaceHandleManager::addHandles(const Model::Brush* brush) {
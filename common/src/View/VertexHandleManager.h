@@ -21,6 +21,8 @@
 #define VertexHandleManager_h
 
 #include "TrenchBroom.h"
+#include "AABBTree.h"
+#include "Macros.h"
 #include "Model/Brush.h"
 #include "Model/BrushFace.h"
 #include "Model/Hit.h"
@@ -28,12 +30,19 @@
 #include "Renderer/Camera.h"
 #include "View/ViewTypes.h"
 
+#include <vecmath/bbox.h>
 #include <vecmath/distance.h>
+#include <vecmath/intersection.h>
+#include <vecmath/polygon.h>
+#include <vecmath/ray.h>
+#include <vecmath/segment.h>
+#include <vecmath/vec.h>
 
 #include <algorithm>
 #include <functional>
 #include <iterator>
 #include <map>
+#include <vector>
 
 namespace TrenchBroom {
     namespace Model {
@@ -159,12 +168,20 @@ namespace TrenchBroom {
 
             using HandleMap = std::map<H, HandleInfo>;
             using HandleEntry = typename HandleMap::value_type;
+            using HandleTree = AABBTree<FloatType, 3, HandleEntry*>;
 
             /**
              * Maps a handle position to its info.
              */
             HandleMap m_handles;
 
+            /**
+             * Spatial index of the entries of m_handles, used to find the handles near a picking ray or near another
+             * handle without looking at every handle. The entries of a map are never moved, so they can be referenced
+             * until they are erased.
+             */
+            HandleTree m_handleTree;
+
             /**
              * The total number of selected handles, not counting duplicates.
              */
@@ -174,6 +191,8 @@ namespace TrenchBroom {
             m_selectedHandleCount(0) {}
 
             virtual ~VertexHandleManagerBaseT() {}
+
+            deleteCopyAndMove(VertexHandleManagerBaseT)
         public:
             /**
              * Returns the hit type value of the picking hits reported by this manager.
@@ -301,7 +320,12 @@ namespace TrenchBroom {
              * @param handle the handle to add
              */
             void add(const Handle& handle) {
-                MapUtils::findOrInsert(m_handles, handle, HandleInfo())->second.inc();
+                const auto it = MapUtils::findOrInsert(m_handles, handle, HandleInfo());
+                HandleInfo& info = it->second;
+                if (info.count == 0) {
+                    m_handleTree.insert(handleBounds(it->first), &*it);
+                }
+                info.inc();
             }
 
             /**
@@ -318,6 +342,7 @@ namespace TrenchBroom {
 
                     if (info.count == 0) {
                         deselect(info);
+                        assertResult(m_handleTree.remove(handleBounds(it->first), &*it));
                         m_handles.erase(it);
                     }
                     return true;
@@ -331,6 +356,7 @@ namespace TrenchBroom {
              */
             void clear() {
                 m_handles.clear();
+                m_handleTree.clear();
                 m_selectedHandleCount = 0;
             }
 
@@ -411,9 +437,17 @@ namespace TrenchBroom {
         private:
             void forEachCloseHandle(const H& handle, std::function<void(HandleInfo&)> fun) {
                 static const auto epsilon = 0.001 * 0.001;
-                for (auto& entry : m_handles) {
-                    if (compare(handle, entry.first, epsilon) == 0) {
-                        fun(entry.second);
+
+                // the bounds of the handles are padded by more than epsilon, so close handles have overlapping bounds
+                const auto bounds = handleBounds(handle);
+                std::vector<HandleEntry*> candidates;
+                m_handleTree.findInVolume([&bounds](const vm::bbox3& candidateBounds) {
+                    return bounds.intersects(candidateBounds) ? VolumeRelation::Intersecting : VolumeRelation::Outside;
+                }, std::back_inserter(candidates));
+
+                for (auto* entry : candidates) {
+                    if (compare(handle, entry->first, epsilon) == 0) {
+                        fun(entry->second);
                     }
                 }
             }
@@ -458,6 +492,61 @@ namespace TrenchBroom {
                         pickResult.addHit(hit);
                 });
             }
+        protected:
+            /**
+             * Passes every handle that may be hit by the given picking ray to the given function. A handle may be hit
+             * if the ray intersects its bounds after they were expanded by the picking radius, and the spatial index
+             * allows to skip all other handles without testing them.
+             *
+             * @tparam R the type of the picking radius function
+             * @tparam F the type of the function to apply
+             * @param pickRay the picking ray
+             * @param pickRadius a function that returns the largest picking radius of any point in the given bounds
+             * @param fun the function to apply to the handles
+             */
+            template <typename R, typename F>
+            void forEachHandleNearRay(const vm::ray3& pickRay, const R& pickRadius, const F& fun) const {
+                std::vector<HandleEntry*> candidates;
+                m_handleTree.findInVolume([&](const vm::bbox3& bounds) {
+                    const auto radius = pickRadius(bounds);
+                    const auto expanded = vm::bbox3(bounds.min - vm::vec3(radius, radius, radius), bounds.max + vm::vec3(radius, radius, radius));
+                    return vm::isnan(vm::intersect(pickRay, expanded)) ? VolumeRelation::Outside : VolumeRelation::Intersecting;
+                }, std::back_inserter(candidates));
+
+                for (const auto* entry : candidates) {
+                    fun(entry->first);
+                }
+            }
+        private:
+            /**
+             * The padding that is added to the bounds of each handle in the spatial index. Without it, the bounds of
+             * vertex handles would be empty and the tree could not tell good and bad insertion positions apart.
+             */
+            static constexpr FloatType BoundsPadding = 1.0;
+
+            static vm::bbox3 handleBounds(const vm::vec3& handle) {
+                return padBounds(vm::bbox3(handle, handle));
+            }
+
+            static vm::bbox3 handleBounds(const vm::segment3& handle) {
+                return padBounds(vm::bbox3(vm::min(handle.start(), handle.end()), vm::max(handle.start(), handle.end())));
+            }
+
+            static vm::bbox3 handleBounds(const vm::polygon3& handle) {
+                const auto& vertices = handle.vertices();
+                assert(!vertices.empty());
+
+                auto bounds = vm::bbox3(vertices.front(), vertices.front());
+                for (const auto& vertex : vertices) {
+                    bounds = vm::merge(bounds, vertex);
+                }
+                return padBounds(bounds);
+            }
+
+            static vm::bbox3 padBounds(const vm::bbox3& bounds) {
+                const auto padding = vm::vec3(BoundsPadding, BoundsPadding, BoundsPadding);
+                return vm::bbox3(bounds.min - padding, bounds.max + padding);
+            }
         public:
             /**
              * Finds and returns all brushes in the given range which are incident to the given handle.
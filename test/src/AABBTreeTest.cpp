@@ -23,6 +23,8 @@
 #include <vecmath/ray.h>
 #include "AABBTree.h"
 
+#include <vector>
+
 using AABB = AABBTree<double, 3, size_t>;
 using BOX = AABB::Box;
 using RAY = vm::ray<AABB::FloatType, AABB::Components>;
@@ -468,6 +470,181 @@ TEST(AABBTreeTest, findIntersectorsFromInsideRootBBox) {
     assertIntersectors(tree, RAY(VEC(0.0,  0.0,  0.0), VEC::pos_x), { 2u });
 }
 
+TEST(AABBTreeTest, clearAndBuildFourNodes) {
+    const std::vector<size_t> items({ 1u, 2u, 3u, 4u });
+    const auto getBounds = [](const size_t i) {
+        switch (i) {
+            case 1u: return makeBounds(0, 1);
+            case 2u: return makeBounds(2, 3);
+            case 3u: return makeBounds(10, 11);
+            default: return makeBounds(12, 13);
+        }
+    };
+
+    AABB tree;
+    tree.clearAndBuild(items, getBounds);
+
+    assertTree(R"(
+O [ ( 0 -1 -1 ) ( 13 1 1 ) ]
+  O [ ( 0 -1 -1 ) ( 3 1 1 ) ]
+    L [ ( 0 -1 -1 ) ( 1 1 1 ) ]: 1
+    L [ ( 2 -1 -1 ) ( 3 1 1 ) ]: 2
+  O [ ( 10 -1 -1 ) ( 13 1 1 ) ]
+    L [ ( 10 -1 -1 ) ( 11 1 1 ) ]: 3
+    L [ ( 12 -1 -1 ) ( 13 1 1 ) ]: 4
+)" , tree);
+}
+
+TEST(AABBTreeTest, clearAndBuildContainedNodes) {
+    const std::vector<size_t> items({ 1u, 2u, 3u, 4u });
+    const auto getBounds = [](const size_t i) {
+        const auto d = static_cast<double>(i);
+        return BOX(VEC(-d, -d, -d), VEC(d, d, d));
+    };
+
+    AABB tree;
+    tree.clearAndBuild(items, getBounds);
+
+    // all centers are equal, so the nodes are split at the median
+    ASSERT_EQ(3u, tree.height());
+    for (const auto i : items) {
+        ASSERT_TRUE(tree.contains(getBounds(i), i));
+    }
+}
+
+TEST(AABBTreeTest, clearAndBuildFindsSameIntersectorsAsInsert) {
+    std::vector<size_t> items;
+    for (size_t i = 0; i < 1000u; ++i) {
+        items.push_back(i);
+    }
+
+    const auto getBounds = [](const size_t i) {
+        const auto x = static_cast<double>((i * 7u) % 100u);
+        const auto y = static_cast<double>((i * 13u) % 10u);
+        return BOX(VEC(x, y, 0.0), VEC(x + 1.0 + static_cast<double>(i % 3u), y + 1.0, 1.0));
+    };
+
+    AABB inserted;
+    for (const auto i : items) {
+        inserted.insert(getBounds(i), i);
+    }
+
+    AABB built;
+    built.clearAndBuild(items, getBounds);
+
+    ASSERT_EQ(inserted.bounds(), built.bounds());
+    ASSERT_LE(built.height(), 21u);
+
+    for (const auto i : items) {
+        ASSERT_TRUE(built.contains(getBounds(i), i));
+    }
+
+    for (size_t i = 0; i < 10u; ++i) {
+        const auto ray = RAY(VEC(-1.0, static_cast<double>(i) + 0.5, 0.5), VEC::pos_x);
+
+        std::set<size_t> expected;
+        inserted.findIntersectors(ray, std::inserter(expected, std::end(expected)));
+
+        std::set<size_t> actual;
+        built.findIntersectors(ray, std::inserter(actual, std::end(actual)));
+
+        ASSERT_EQ(expected, actual);
+    }
+}
+
+TEST(AABBTreeTest, updateRefitsOverlappingBounds) {
+    AABB tree;
+    tree.insert(makeBounds(0, 2), 1u);
+    tree.insert(makeBounds(4, 6), 2u);
+    tree.insert(makeBounds(8, 10), 3u);
+
+    tree.update(makeBounds(0, 2), makeBounds(1, 3), 1u);
+
+    // the structure of the tree is unchanged
+    assertTree(R"(
+O [ ( 1 -1 -1 ) ( 10 1 1 ) ]
+  L [ ( 1 -1 -1 ) ( 3 1 1 ) ]: 1
+  O [ ( 4 -1 -1 ) ( 10 1 1 ) ]
+    L [ ( 4 -1 -1 ) ( 6 1 1 ) ]: 2
+    L [ ( 8 -1 -1 ) ( 10 1 1 ) ]: 3
+)" , tree);
+
+    ASSERT_FALSE(tree.contains(makeBounds(0, 2), 1u));
+    ASSERT_TRUE(tree.contains(makeBounds(1, 3), 1u));
+}
+
+TEST(AABBTreeTest, updateReinsertsDisjointBounds) {
+    AABB tree;
+    tree.insert(makeBounds(0, 2), 1u);
+    tree.insert(makeBounds(4, 6), 2u);
+    tree.insert(makeBounds(8, 10), 3u);
+
+    tree.update(makeBounds(0, 2), makeBounds(12, 14), 1u);
+
+    ASSERT_EQ(makeBounds(4, 14), tree.bounds());
+    ASSERT_FALSE(tree.contains(makeBounds(0, 2), 1u));
+    ASSERT_TRUE(tree.contains(makeBounds(12, 14), 1u));
+    ASSERT_TRUE(tree.contains(makeBounds(4, 6), 2u));
+    ASSERT_TRUE(tree.contains(makeBounds(8, 10), 3u));
+}
+
+TEST(AABBTreeTest, updateUnknownNode) {
+    AABB tree;
+    tree.insert(makeBounds(0, 2), 1u);
+
+    ASSERT_THROW(tree.update(makeBounds(0, 2), makeBounds(1, 3), 2u), NodeTreeException);
+    ASSERT_THROW(tree.update(makeBounds(0, 2), makeBounds(5, 6), 2u), NodeTreeException);
+}
+
+TEST(AABBTreeTest, updateBatch) {
+    AABB tree;
+    tree.insert(makeBounds(0, 2), 1u);
+    tree.insert(makeBounds(4, 6), 2u);
+    tree.insert(makeBounds(8, 10), 3u);
+
+    tree.update({
+        AABB::Update{ makeBounds(0, 2), makeBounds(-1, 1), 1u },
+        AABB::Update{ makeBounds(4, 6), makeBounds(20, 22), 2u },
+        AABB::Update{ makeBounds(8, 10), makeBounds(9, 11), 3u }
+    });
+
+    ASSERT_EQ(makeBounds(-1, 22), tree.bounds());
+    ASSERT_TRUE(tree.contains(makeBounds(-1, 1), 1u));
+    ASSERT_TRUE(tree.contains(makeBounds(20, 22), 2u));
+    ASSERT_TRUE(tree.contains(makeBounds(9, 11), 3u));
+
+    assertIntersectors(tree, RAY(VEC(-2.0, 0.0, 0.0), VEC::pos_x), { 1u, 2u, 3u });
+    assertIntersectors(tree, RAY(VEC(15.0, 0.0, 0.0), VEC::pos_x), { 2u });
+}
+
+TEST(AABBTreeTest, rebuildAfterUpdates) {
+    const BOX bounds1(VEC(-1.0, -1.0, -1.0), VEC(1.0, 1.0, 1.0));
+    const BOX bounds2(VEC(-2.0, -2.0, -2.0), VEC(2.0, 2.0, 2.0));
+    const BOX bounds3(VEC(-3.0, -3.0, -3.0), VEC(3.0, 3.0, 3.0));
+    const BOX bounds4(VEC(-4.0, -4.0, -4.0), VEC(4.0, 4.0, 4.0));
+
+    AABB tree;
+    tree.insert(bounds1, 1u);
+    tree.insert(bounds2, 2u);
+    tree.insert(bounds3, 3u);
+    tree.insert(bounds4, 4u);
+    ASSERT_EQ(4u, tree.height());
+
+    tree.setRebuildRatio(1.0);
+    for (size_t i = 0; i < 4u; ++i) {
+        tree.update(bounds1, bounds1, 1u);
+        ASSERT_EQ(4u, tree.height());
+    }
+
+    tree.update(bounds1, bounds1, 1u);
+    ASSERT_EQ(3u, tree.height());
+
+    ASSERT_TRUE(tree.contains(bounds1, 1u));
+    ASSERT_TRUE(tree.contains(bounds2, 2u));
+    ASSERT_TRUE(tree.contains(bounds3, 3u));
+    ASSERT_TRUE(tree.contains(bounds4, 4u));
+}
+
 void assertTree(const std::string& exp, const AABB& actual) {
     std::stringstream str;
     actual.print(str);
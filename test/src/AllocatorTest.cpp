@@ -0,0 +1,88 @@
+/*
+ Copyright (C) 2010-2019 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+
+#include "Allocator.h"
+
+#include <thread>
+#include <vector>
+
+namespace TrenchBroom {
+    class AllocatorTestObject : public Allocator<AllocatorTestObject, 4> {
+    public:
+        size_t value;
+
+        explicit AllocatorTestObject(const size_t i_value) :
+        value(i_value) {}
+    };
+
+    static std::vector<AllocatorTestObject*> createObjects(const size_t count) {
+        std::vector<AllocatorTestObject*> result;
+        for (size_t i = 0; i < count; ++i) {
+            result.push_back(new AllocatorTestObject(i));
+        }
+        return result;
+    }
+
+    static void deleteObjects(const std::vector<AllocatorTestObject*>& objects) {
+        for (auto* object : objects) {
+            delete object;
+        }
+    }
+
+    TEST(AllocatorTest, releaseChunksWhenThreadExits) {
+        std::thread thread([]() {
+            const auto objects = createObjects(64);
+            for (size_t i = 0; i < objects.size(); ++i) {
+                ASSERT_EQ(i, objects[i]->value);
+            }
+            ASSERT_LT(1u, AllocatorTestObject::chunkCount());
+
+            deleteObjects(objects);
+        });
+        thread.join();
+
+        // only one empty chunk is kept
+        ASSERT_EQ(1u, AllocatorTestObject::chunkCount());
+    }
+
+    TEST(AllocatorTest, deleteOnOtherThread) {
+        std::vector<AllocatorTestObject*> objects;
+        std::thread creator([&]() {
+            objects = createObjects(64);
+        });
+        creator.join();
+
+        // the creating thread has exited, its pool is gone
+        std::thread deleter([&]() {
+            deleteObjects(objects);
+        });
+        deleter.join();
+
+        ASSERT_EQ(1u, AllocatorTestObject::chunkCount());
+
+        // the kept chunk is reused
+        std::thread thread([]() {
+            deleteObjects(createObjects(4));
+        });
+        thread.join();
+        ASSERT_EQ(1u, AllocatorTestObject::chunkCount());
+    }
+}
@@ -0,0 +1,120 @@
+/*
+ Copyright (C) 2010-2019 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+
+#include "Color.h"
+#include "Assets/Palette.h"
+#include "IO/Reader.h"
+
+#include <memory>
+#include <random>
+#include <vector>
+
+namespace TrenchBroom {
+    namespace Assets {
+        // converts the pixels one at a time, as the palette used to do
+        static bool referenceIndexedToRgba(const unsigned char* paletteData, const std::vector<unsigned char>& indices, std::vector<unsigned char>& rgba, const PaletteTransparency transparency, Color& averageColor) {
+            double avg[3] = { 0.0, 0.0, 0.0 };
+            bool hasTransparency = false;
+            for (size_t i = 0; i < indices.size(); ++i) {
+                const size_t index = indices[i];
+                for (size_t j = 0; j < 3; ++j) {
+                    const unsigned char c = paletteData[index * 3 + j];
+                    rgba[i * 4 + j] = c;
+                    avg[j] += static_cast<double>(c);
+                }
+                if (transparency == PaletteTransparency::Opaque) {
+                    rgba[i * 4 + 3] = 0xFF;
+                } else {
+                    rgba[i * 4 + 3] = (index == 255) ? 0x00 : 0xFF;
+                    hasTransparency |= (index == 255);
+                }
+            }
+
+            for (size_t i = 0; i < 3; ++i) {
+                averageColor[i] = static_cast<float>(avg[i] / indices.size() / 0xFF);
+            }
+            averageColor[3] = 1.0f;
+            return hasTransparency;
+        }
+
+        static void assertIndexedToRgba(const Palette& palette, const unsigned char* paletteData, const std::vector<unsigned char>& indices, const PaletteTransparency transparency) {
+            const auto pixelCount = indices.size();
+
+            std::vector<unsigned char> expectedRgba(4 * pixelCount);
+            Color expectedAverageColor;
+            const auto expectedTransparency = referenceIndexedToRgba(paletteData, indices, expectedRgba, transparency, expectedAverageColor);
+
+            Buffer<unsigned char> indexedImage(pixelCount);
+            std::copy(std::begin(indices), std::end(indices), indexedImage.ptr());
+
+            Buffer<unsigned char> rgbaImage(4 * pixelCount);
+            Color averageColor;
+            ASSERT_EQ(expectedTransparency, palette.indexedToRgba(indexedImage, pixelCount, rgbaImage, transparency, averageColor));
+            ASSERT_TRUE(std::equal(std::begin(expectedRgba), std::end(expectedRgba), std::begin(rgbaImage), std::end(rgbaImage)));
+            for (size_t i = 0; i < 4; ++i) {
+                ASSERT_EQ(expectedAverageColor[i], averageColor[i]);
+            }
+
+            auto reader = IO::Reader::from(reinterpret_cast<const char*>(indices.data()), reinterpret_cast<const char*>(indices.data() + pixelCount));
+            Buffer<unsigned char> rgbaImageFromReader(4 * pixelCount);
+            Color averageColorFromReader;
+            ASSERT_EQ(expectedTransparency, palette.indexedToRgba(reader, pixelCount, rgbaImageFromReader, transparency, averageColorFromReader));
+            ASSERT_TRUE(reader.eof());
+            ASSERT_TRUE(std::equal(std::begin(expectedRgba), std::end(expectedRgba), std::begin(rgbaImageFromReader), std::end(rgbaImageFromReader)));
+            for (size_t i = 0; i < 4; ++i) {
+                ASSERT_EQ(expectedAverageColor[i], averageColorFromReader[i]);
+            }
+        }
+
+        TEST(PaletteTest, indexedToRgbaMatchesPerPixelConversion) {
+            std::mt19937 random(42);
+            std::uniform_int_distribution<int> byte(0, 255);
+
+            auto paletteData = std::make_unique<unsigned char[]>(768);
+            for (size_t i = 0; i < 768; ++i) {
+                paletteData[i] = static_cast<unsigned char>(byte(random));
+            }
+            const auto* rawPaletteData = paletteData.get();
+            const Palette palette(768, std::move(paletteData));
+
+            for (const size_t pixelCount : { 1u, 3u, 4u, 5u, 17u, 256u, 4099u, 128u * 128u }) {
+                std::vector<unsigned char> indices(pixelCount);
+                for (auto& index : indices) {
+                    index = static_cast<unsigned char>(byte(random));
+                }
+
+                assertIndexedToRgba(palette, rawPaletteData, indices, PaletteTransparency::Opaque);
+                assertIndexedToRgba(palette, rawPaletteData, indices, PaletteTransparency::Index255Transparent);
+
+                // without any transparent pixels
+                for (auto& index : indices) {
+                    index = static_cast<unsigned char>(index % 255);
+                }
+                assertIndexedToRgba(palette, rawPaletteData, indices, PaletteTransparency::Index255Transparent);
+
+                // a single run of the same index
+                std::fill(std::begin(indices), std::end(indices), static_cast<unsigned char>(255));
+                assertIndexedToRgba(palette, rawPaletteData, indices, PaletteTransparency::Opaque);
+                assertIndexedToRgba(palette, rawPaletteData, indices, PaletteTransparency::Index255Transparent);
+            }
+        }
+    }
+}
@@ -0,0 +1,326 @@
+/*
+ Copyright (C) 2010-2019 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+
+#include <vecmath/vec.h>
+#include <vecmath/ray.h>
+#include "AABBTree.h"
+#include "FlatAABBTree.h"
+
+#include <limits>
+#include <set>
+#include <vector>
+
+using AABB = AABBTree<double, 3, size_t>;
+using FLAT = AABB::FlatTree;
+using BOX = AABB::Box;
+using RAY = vm::ray<AABB::FloatType, AABB::Components>;
+using VEC = vm::vec<AABB::FloatType, AABB::Components>;
+
+static FLAT flatten(const AABB& tree) {
+    FLAT result;
+    tree.flatten(result);
+    return result;
+}
+
+static void assertIntersectors(const FLAT& tree, const RAY& ray, std::initializer_list<FLAT::DataType> items) {
+    const std::set<FLAT::DataType> expected(items);
+    std::set<FLAT::DataType> actual;
+
+    tree.findIntersectors(ray, std::inserter(actual, std::end(actual)));
+
+    ASSERT_EQ(expected, actual);
+}
+
+static void assertContainers(const FLAT& tree, const VEC& point, std::initializer_list<FLAT::DataType> items) {
+    const std::set<FLAT::DataType> expected(items);
+    std::set<FLAT::DataType> actual;
+
+    tree.findContainers(point, std::inserter(actual, std::end(actual)));
+
+    ASSERT_EQ(expected, actual);
+}
+
+TEST(FlatAABBTreeTest, flattenEmptyTree) {
+    AABB tree;
+    const auto flat = flatten(tree);
+
+    ASSERT_TRUE(flat.empty());
+    ASSERT_EQ(0u, flat.size());
+    assertIntersectors(flat, RAY(VEC::zero, VEC::pos_x), {});
+    assertContainers(flat, VEC::zero, {});
+}
+
+TEST(FlatAABBTreeTest, flattenTreeWithOneNode) {
+    AABB tree;
+    tree.insert(BOX(VEC(-1.0, -1.0, -1.0), VEC(1.0, 1.0, 1.0)), 1u);
+
+    const auto flat = flatten(tree);
+    ASSERT_EQ(1u, flat.size());
+
+    assertIntersectors(flat, RAY(VEC(-2.0, 0.0, 0.0), VEC::neg_x), {});
+    assertIntersectors(flat, RAY(VEC(-2.0, 0.0, 0.0), VEC::pos_x), { 1u });
+    assertContainers(flat, VEC(0.5, 0.5, 0.5), { 1u });
+    assertContainers(flat, VEC(1.5, 0.5, 0.5), {});
+}
+
+TEST(FlatAABBTreeTest, flattenTreeWithTwoNodes) {
+    AABB tree;
+    tree.insert(BOX(VEC(-2.0, -1.0, -1.0), VEC(-1.0, +1.0, +1.0)), 1u);
+    tree.insert(BOX(VEC(+1.0, -1.0, -1.0), VEC(+2.0, +1.0, +1.0)), 2u);
+
+    const auto flat = flatten(tree);
+    ASSERT_EQ(3u, flat.size());
+
+    assertIntersectors(flat, RAY(VEC(+3.0,  0.0,  0.0), VEC::pos_x), {});
+    assertIntersectors(flat, RAY(VEC(-3.0,  0.0,  0.0), VEC::neg_x), {});
+    assertIntersectors(flat, RAY(VEC( 0.0,  0.0,  0.0), VEC::pos_z), {});
+    assertIntersectors(flat, RAY(VEC( 0.0,  0.0,  0.0), VEC::pos_x), { 2u });
+    assertIntersectors(flat, RAY(VEC( 0.0,  0.0,  0.0), VEC::neg_x), { 1u });
+    assertIntersectors(flat, RAY(VEC(-3.0,  0.0,  0.0), VEC::pos_x), { 1u, 2u });
+    assertIntersectors(flat, RAY(VEC(+3.0,  0.0,  0.0), VEC::neg_x), { 1u, 2u });
+    assertIntersectors(flat, RAY(VEC(-1.5, -2.0,  0.0), VEC::pos_y), { 1u });
+    assertIntersectors(flat, RAY(VEC(+1.5, -2.0,  0.0), VEC::pos_y), { 2u });
+
+    assertContainers(flat, VEC(-1.5, 0.0, 0.0), { 1u });
+    assertContainers(flat, VEC(+1.5, 0.0, 0.0), { 2u });
+    assertContainers(flat, VEC( 0.0, 0.0, 0.0), {});
+}
+
+TEST(FlatAABBTreeTest, findIntersectorsFromInside) {
+    AABB tree;
+    tree.insert(BOX(VEC(-4.0, -1.0, -1.0), VEC(-2.0, +1.0, +1.0)), 1u);
+    tree.insert(BOX(VEC(+2.0, -1.0, -1.0), VEC(+4.0, +1.0, +1.0)), 2u);
+    tree.insert(BOX(VEC(-8.0, -1.0, -1.0), VEC(+8.0, +1.0, +1.0)), 3u);
+
+    const auto flat = flatten(tree);
+    assertIntersectors(flat, RAY(VEC(0.0,  0.0,  0.0), VEC::pos_x), { 2u, 3u });
+}
+
+TEST(FlatAABBTreeTest, boundsAreRoundedOutwards) {
+    // 0.1 cannot be represented exactly as a float, the stored bounds must still contain the original bounds
+    AABB tree;
+    tree.insert(BOX(VEC(0.1, 0.1, 0.1), VEC(0.3, 0.3, 0.3)), 1u);
+
+    const auto flat = flatten(tree);
+    assertContainers(flat, VEC(0.1, 0.1, 0.1), { 1u });
+    assertContainers(flat, VEC(0.3, 0.3, 0.3), { 1u });
+    assertIntersectors(flat, RAY(VEC(0.1, 0.1, -1.0), VEC::pos_z), { 1u });
+    assertIntersectors(flat, RAY(VEC(0.3, 0.3, -1.0), VEC::pos_z), { 1u });
+}
+
+TEST(FlatAABBTreeTest, findsSameItemsAsTree) {
+    std::vector<size_t> items;
+    for (size_t i = 0; i < 1000u; ++i) {
+        items.push_back(i);
+    }
+
+    const auto getBounds = [](const size_t i) {
+        const auto x = static_cast<double>((i * 7u) % 100u);
+        const auto y = static_cast<double>((i * 13u) % 10u);
+        const auto z = static_cast<double>((i * 17u) % 10u);
+        return BOX(VEC(x, y, z), VEC(x + 1.0 + static_cast<double>(i % 3u), y + 1.0, z + 1.0));
+    };
+
+    AABB tree;
+    tree.clearAndBuild(items, getBounds);
+
+    const auto flat = flatten(tree);
+    ASSERT_EQ(2u * items.size() - 1u, flat.size());
+
+    for (size_t i = 0; i < 100u; ++i) {
+        const auto origin = VEC(-1.0, static_cast<double>(i % 10u) + 0.5, static_cast<double>(i / 10u) + 0.5);
+        const auto direction = vm::normalize(VEC(1.0, static_cast<double>(i % 7u) / 20.0, -static_cast<double>(i % 5u) / 20.0));
+        const auto ray = RAY(origin, direction);
+
+        std::set<size_t> expected;
+        tree.findIntersectors(ray, std::inserter(expected, std::end(expected)));
+
+        std::set<size_t> actual;
+        flat.findIntersectors(ray, std::inserter(actual, std::end(actual)));
+
+        ASSERT_EQ(expected, actual);
+
+        const auto point = VEC(static_cast<double>(i) + 0.5, static_cast<double>(i % 10u) + 0.25, static_cast<double>(i % 9u) + 0.75);
+
+        expected.clear();
+        tree.findContainers(point, std::inserter(expected, std::end(expected)));
+
+        actual.clear();
+        flat.findContainers(point, std::inserter(actual, std::end(actual)));
+
+        ASSERT_EQ(expected, actual);
+    }
+}
+
+TEST(FlatAABBTreeTest, findInVolumeFindsSameItemsAsTree) {
+    std::vector<size_t> items;
+    for (size_t i = 0; i < 1000u; ++i) {
+        items.push_back(i);
+    }
+
+    const auto getBounds = [](const size_t i) {
+        const auto x = static_cast<double>((i * 7u) % 100u);
+        const auto y = static_cast<double>((i * 13u) % 100u);
+        const auto z = static_cast<double>((i * 17u) % 10u);
+        return BOX(VEC(x, y, z), VEC(x + 1.0, y + 1.0, z + 1.0));
+    };
+
+    AABB tree;
+    tree.clearAndBuild(items, getBounds);
+    const auto flat = flatten(tree);
+
+    for (size_t i = 0; i < 20u; ++i) {
+        const auto min = static_cast<double>(i * 4u);
+        const BOX volume(VEC(min, min, 0.0), VEC(min + 20.0, min + 30.0, 5.0));
+        const auto relation = [&](const BOX& bounds) {
+            if (!volume.intersects(bounds)) {
+                return VolumeRelation::Outside;
+            } else if (volume.contains(bounds)) {
+                return VolumeRelation::Inside;
+            } else {
+                return VolumeRelation::Intersecting;
+            }
+        };
+
+        std::set<size_t> expected;
+        tree.findInVolume(relation, std::inserter(expected, std::end(expected)));
+
+        std::set<size_t> actual;
+        flat.findInVolume(relation, std::inserter(actual, std::end(actual)));
+
+        ASSERT_FALSE(expected.empty());
+        ASSERT_EQ(expected, actual);
+
+        for (const auto item : items) {
+            ASSERT_EQ(volume.intersects(getBounds(item)), expected.count(item) == 1u);
+        }
+    }
+}
+
+TEST(FlatAABBTreeTest, findIntersectorsNearestFirst) {
+    // a row of unit boxes along the x axis, inserted in reverse order
+    AABB tree;
+    for (size_t i = 0; i < 10u; ++i) {
+        const auto x = static_cast<double>(9u - i) * 2.0;
+        tree.insert(BOX(VEC(x, -1.0, -1.0), VEC(x + 1.0, 1.0, 1.0)), 9u - i);
+    }
+    const auto flat = flatten(tree);
+    const auto ray = RAY(VEC(-1.0, 0.0, 0.0), VEC::pos_x);
+
+    const auto assertNearestFirst = [&](const auto& t) {
+        std::vector<size_t> visited;
+        std::vector<double> distances;
+        t.findIntersectorsNearestFirst(ray, [&](const size_t item, const double distance) {
+            visited.push_back(item);
+            distances.push_back(distance);
+            return std::numeric_limits<double>::max();
+        });
+
+        ASSERT_EQ(std::vector<size_t>({ 0u, 1u, 2u, 3u, 4u, 5u, 6u, 7u, 8u, 9u }), visited);
+        for (size_t i = 0; i < distances.size(); ++i) {
+            ASSERT_DOUBLE_EQ(static_cast<double>(i) * 2.0 + 1.0, distances[i]);
+        }
+
+        // stop once the remaining boxes are entered beyond the returned distance
+        visited.clear();
+        t.findIntersectorsNearestFirst(ray, [&](const size_t item, const double distance) {
+            visited.push_back(item);
+            return item == 2u ? 5.5 : std::numeric_limits<double>::max();
+        });
+        ASSERT_EQ(std::vector<size_t>({ 0u, 1u, 2u }), visited);
+
+        // a missing ray visits nothing
+        visited.clear();
+        t.findIntersectorsNearestFirst(RAY(VEC(-1.0, 0.0, 0.0), VEC::neg_x), [&](const size_t item, const double distance) {
+            visited.push_back(item);
+            return std::numeric_limits<double>::max();
+        });
+        ASSERT_TRUE(visited.empty());
+    };
+
+    assertNearestFirst(tree);
+    assertNearestFirst(flat);
+}
+
+TEST(FlatAABBTreeTest, findIntersectorsNearestFirstFindsSameItemsAsTree) {
+    std::vector<size_t> items;
+    for (size_t i = 0; i < 1000u; ++i) {
+        items.push_back(i);
+    }
+
+    const auto getBounds = [](const size_t i) {
+        const auto x = static_cast<double>((i * 7u) % 100u);
+        const auto y = static_cast<double>((i * 13u) % 10u);
+        const auto z = static_cast<double>((i * 17u) % 10u);
+        return BOX(VEC(x, y, z), VEC(x + 1.0 + static_cast<double>(i % 3u), y + 1.0, z + 1.0));
+    };
+
+    AABB tree;
+    tree.clearAndBuild(items, getBounds);
+    const auto flat = flatten(tree);
+
+    for (size_t i = 0; i < 100u; ++i) {
+        const auto origin = VEC(-1.0, static_cast<double>(i % 10u) + 0.5, static_cast<double>(i / 10u) + 0.5);
+        const auto direction = vm::normalize(VEC(1.0, static_cast<double>(i % 7u) / 20.0, -static_cast<double>(i % 5u) / 20.0));
+        const auto ray = RAY(origin, direction);
+
+        std::set<size_t> expected;
+        flat.findIntersectors(ray, std::inserter(expected, std::end(expected)));
+
+        std::set<size_t> actual;
+        auto previousDistance = 0.0;
+        flat.findIntersectorsNearestFirst(ray, [&](const size_t item, const double distance) {
+            EXPECT_LE(previousDistance, distance);
+            previousDistance = distance;
+            actual.insert(item);
+            return std::numeric_limits<double>::max();
+        });
+
+        ASSERT_EQ(expected, actual);
+
+        actual.clear();
+        tree.findIntersectorsNearestFirst(ray, [&](const size_t item, const double distance) {
+            actual.insert(item);
+            return std::numeric_limits<double>::max();
+        });
+
+        std::set<size_t> expectedByTree;
+        tree.findIntersectors(ray, std::inserter(expectedByTree, std::end(expectedByTree)));
+        ASSERT_EQ(expectedByTree, actual);
+    }
+}
+
+TEST(FlatAABBTreeTest, flattenReplacesPreviousContents) {
+    AABB tree;
+    tree.insert(BOX(VEC(-1.0, -1.0, -1.0), VEC(1.0, 1.0, 1.0)), 1u);
+
+    FLAT flat;
+    tree.flatten(flat);
+    assertContainers(flat, VEC::zero, { 1u });
+
+    tree.remove(BOX(VEC(-1.0, -1.0, -1.0), VEC(1.0, 1.0, 1.0)), 1u);
+    tree.insert(BOX(VEC(2.0, 2.0, 2.0), VEC(3.0, 3.0, 3.0)), 2u);
+
+    tree.flatten(flat);
+    ASSERT_EQ(1u, flat.size());
+    assertContainers(flat, VEC::zero, {});
+    assertContainers(flat, VEC(2.5, 2.5, 2.5), { 2u });
+}
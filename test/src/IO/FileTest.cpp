@@ -0,0 +1,78 @@
+/*
+ Copyright (C) 2010-2019 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+
+#include "Exceptions.h"
+#include "IO/DiskIO.h"
+#include "IO/File.h"
+#include "IO/Path.h"
+#include "IO/Reader.h"
+
+#include <memory>
+
+namespace TrenchBroom {
+    namespace IO {
+        TEST(FileTest, mappedFileHasSameContentsAsCFile) {
+            const auto path = Disk::getCurrentWorkingDir() + Path("fixture/test/IO/Md3/armor/models/armor_red.txt");
+
+            const CFile cFile(path);
+            const MappedFile mappedFile(path);
+            ASSERT_EQ(cFile.size(), mappedFile.size());
+
+            const auto expected = cFile.reader().buffer();
+            const auto actual = mappedFile.reader().buffer();
+            ASSERT_EQ(String(expected.begin(), expected.end()), String(actual.begin(), actual.end()));
+        }
+
+        TEST(FileTest, mappedFileReaderDoesNotCopy) {
+            const auto path = Disk::getCurrentWorkingDir() + Path("fixture/test/IO/Md3/armor/models/armor_red.txt");
+            const auto mappedFile = std::make_shared<MappedFile>(path);
+
+            const auto buffer = mappedFile->reader().buffer();
+            ASSERT_EQ(mappedFile->begin(), buffer.begin());
+            ASSERT_EQ(mappedFile->end(), buffer.end());
+
+            const auto view = FileView(Path("view"), mappedFile, 2u, 3u);
+            ASSERT_EQ(3u, view.size());
+
+            const auto viewBuffer = view.reader().buffer();
+            ASSERT_EQ(mappedFile->begin() + 2, viewBuffer.begin());
+            ASSERT_EQ(mappedFile->begin() + 5, viewBuffer.end());
+        }
+
+        TEST(FileTest, cFileViewReadsItsOwnRange) {
+            const auto path = Disk::getCurrentWorkingDir() + Path("fixture/test/IO/Md3/armor/models/armor_red.txt");
+            const auto cFile = std::make_shared<CFile>(path);
+
+            auto reader = cFile->reader();
+            const auto contents = reader.readString(cFile->size());
+
+            const auto view = FileView(Path("view"), cFile, 2u, 3u);
+            auto viewReader = view.reader();
+            ASSERT_EQ(0u, viewReader.position());
+            ASSERT_EQ(contents.substr(2u, 3u), viewReader.readString(3u));
+        }
+
+        TEST(FileTest, mappedFileThrowsIfFileDoesNotExist) {
+            const auto path = Disk::getCurrentWorkingDir() + Path("fixture/test/IO/does_not_exist.txt");
+            ASSERT_THROW(MappedFile{path}, FileSystemException);
+        }
+    }
+}
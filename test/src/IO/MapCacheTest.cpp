@@ -0,0 +1,251 @@
+/*
+ Copyright (C) 2010-2019 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+
+#include "Logger.h"
+#include "IO/DiskIO.h"
+#include "IO/MapCache.h"
+#include "IO/TestEnvironment.h"
+#include "IO/TestParserStatus.h"
+#include "IO/WorldReader.h"
+#include "Model/AttributableNode.h"
+#include "Model/Brush.h"
+#include "Model/BrushFace.h"
+#include "Model/Layer.h"
+#include "Model/World.h"
+
+#include <vecmath/bbox.h>
+
+#include <algorithm>
+#include <fstream>
+#include <iterator>
+
+namespace TrenchBroom {
+    namespace IO {
+        static const String MapData(R"(
+{
+"classname" "worldspawn"
+"message" "yay"
+{
+( -64 -64 -16 ) ( -64 -63 -16 ) ( -64 -64 -15 ) __TB_empty 0 0 0 1 1
+( -64 -64 -16 ) ( -64 -64 -15 ) ( -63 -64 -16 ) __TB_empty 0 0 0 1 1
+( -64 -64 -16 ) ( -63 -64 -16 ) ( -64 -63 -16 ) __TB_empty 0 0 0 1 1
+( 64 64 16 ) ( 64 65 16 ) ( 65 64 16 ) __TB_empty 0 0 0 1 1
+( 64 64 16 ) ( 65 64 16 ) ( 64 64 17 ) __TB_empty 0 0 0 1 1
+( 64 64 16 ) ( 64 64 17 ) ( 64 65 16 ) __TB_empty 0 0 0 1 1
+}
+}
+{
+"classname" "func_group"
+"_tb_type" "_tb_layer"
+"_tb_name" "My Layer"
+"_tb_id" "1"
+{
+( 0 0 0 ) ( 0 1 0 ) ( 0 0 1 ) rock 1.5 2 45 0.5 0.25
+( 0 0 0 ) ( 0 0 1 ) ( 1 0 0 ) rock 0 0 0 1 1
+( 0 0 0 ) ( 1 0 0 ) ( 0 1 0 ) rock 0 0 0 1 1
+( 32 32 32 ) ( 32 33 32 ) ( 33 32 32 ) rock 0 0 0 1 1
+( 32 32 32 ) ( 33 32 32 ) ( 32 32 33 ) rock 0 0 0 1 1
+( 32 32 32 ) ( 32 32 33 ) ( 32 33 32 ) rock 0 0 0 1 1
+}
+}
+{
+"classname" "func_door"
+"_tb_layer" "1"
+{
+( 0 0 0 ) ( 0 1 0 ) ( 0 0 1 ) door 0 0 0 1 1
+( 0 0 0 ) ( 0 0 1 ) ( 1 0 0 ) door 0 0 0 1 1
+( 0 0 0 ) ( 1 0 0 ) ( 0 1 0 ) door 0 0 0 1 1
+( 16 16 64 ) ( 16 17 64 ) ( 17 16 64 ) door 0 0 0 1 1
+( 16 16 64 ) ( 17 16 64 ) ( 16 16 65 ) door 0 0 0 1 1
+( 16 16 64 ) ( 16 16 65 ) ( 16 17 64 ) door 0 0 0 1 1
+}
+}
+)");
+
+        static const vm::bbox3 WorldBounds(8192.0);
+
+        static void writeFile(const Path& path, const String& contents) {
+            std::ofstream stream(path.asString(), std::ios::out | std::ios::binary | std::ios::trunc);
+            stream << contents;
+        }
+
+        static std::unique_ptr<Model::World> readWorld(const String& data) {
+            TestParserStatus status;
+            WorldReader reader(data);
+            return reader.read(Model::MapFormat::Standard, WorldBounds, status);
+        }
+
+        static void assertSameNodes(const Model::Node* expected, const Model::Node* actual) {
+            ASSERT_EQ(expected->name(), actual->name());
+            ASSERT_EQ(expected->lineNumber(), actual->lineNumber());
+            ASSERT_EQ(expected->lineCount(), actual->lineCount());
+            ASSERT_EQ(expected->childCount(), actual->childCount());
+
+            const auto* expectedEntity = dynamic_cast<const Model::AttributableNode*>(expected);
+            const auto* actualEntity = dynamic_cast<const Model::AttributableNode*>(actual);
+            ASSERT_EQ(expectedEntity == nullptr, actualEntity == nullptr);
+            if (expectedEntity != nullptr) {
+                const auto& expectedAttributes = expectedEntity->attributes();
+                const auto& actualAttributes = actualEntity->attributes();
+                ASSERT_EQ(expectedAttributes.size(), actualAttributes.size());
+
+                auto expectedIt = std::begin(expectedAttributes);
+                auto actualIt = std::begin(actualAttributes);
+                while (expectedIt != std::end(expectedAttributes)) {
+                    ASSERT_EQ(expectedIt->name(), actualIt->name());
+                    ASSERT_EQ(expectedIt->value(), actualIt->value());
+                    ++expectedIt;
+                    ++actualIt;
+                }
+            }
+
+            const auto* expectedBrush = dynamic_cast<const Model::Brush*>(expected);
+            const auto* actualBrush = dynamic_cast<const Model::Brush*>(actual);
+            ASSERT_EQ(expectedBrush == nullptr, actualBrush == nullptr);
+            if (expectedBrush != nullptr) {
+                ASSERT_TRUE(actualBrush->fullySpecified());
+                ASSERT_EQ(expectedBrush->bounds(), actualBrush->bounds());
+                ASSERT_EQ(expectedBrush->vertexCount(), actualBrush->vertexCount());
+                ASSERT_EQ(expectedBrush->edgeCount(), actualBrush->edgeCount());
+
+                const auto& expectedFaces = expectedBrush->faces();
+                const auto& actualFaces = actualBrush->faces();
+                ASSERT_EQ(expectedFaces.size(), actualFaces.size());
+                for (size_t i = 0; i < expectedFaces.size(); ++i) {
+                    const auto* expectedFace = expectedFaces[i];
+                    const auto* actualFace = actualFaces[i];
+                    ASSERT_EQ(actualBrush, actualFace->brush());
+                    ASSERT_EQ(expectedFace->lineNumber(), actualFace->lineNumber());
+                    ASSERT_EQ(expectedFace->boundary(), actualFace->boundary());
+                    ASSERT_EQ(expectedFace->textureName(), actualFace->textureName());
+                    ASSERT_EQ(expectedFace->offset(), actualFace->offset());
+                    ASSERT_EQ(expectedFace->scale(), actualFace->scale());
+                    ASSERT_EQ(expectedFace->rotation(), actualFace->rotation());
+                    ASSERT_EQ(expectedFace->vertexPositions(), actualFace->vertexPositions());
+                }
+            }
+
+            for (size_t i = 0; i < expected->childCount(); ++i) {
+                assertSameNodes(expected->children()[i], actual->children()[i]);
+            }
+        }
+
+        TEST(MapCacheTest, writeAndReadCache) {
+            TestEnvironment env("map_cache_test");
+            const auto mapPath = env.dir() + Path("test.map");
+            env.createFile(Path("test.map"), MapData);
+
+            auto expected = readWorld(MapData);
+            MapCache::write(*expected, WorldBounds, mapPath);
+            ASSERT_TRUE(env.fileExists(Path("test.map.tbcache")));
+
+            NullLogger logger;
+            auto actual = MapCache::read(Model::MapFormat::Standard, WorldBounds, mapPath, logger);
+            ASSERT_TRUE(actual != nullptr);
+
+            assertSameNodes(expected.get(), actual.get());
+        }
+
+        TEST(MapCacheTest, ignoreMissingCache) {
+            TestEnvironment env("map_cache_test");
+            const auto mapPath = env.dir() + Path("test.map");
+            env.createFile(Path("test.map"), MapData);
+
+            NullLogger logger;
+            ASSERT_TRUE(MapCache::read(Model::MapFormat::Standard, WorldBounds, mapPath, logger) == nullptr);
+        }
+
+        TEST(MapCacheTest, ignoreOutdatedCache) {
+            TestEnvironment env("map_cache_test");
+            const auto mapPath = env.dir() + Path("test.map");
+            env.createFile(Path("test.map"), MapData);
+
+            auto world = readWorld(MapData);
+            MapCache::write(*world, WorldBounds, mapPath);
+
+            NullLogger logger;
+            ASSERT_TRUE(MapCache::read(Model::MapFormat::Valve, WorldBounds, mapPath, logger) == nullptr);
+            ASSERT_TRUE(MapCache::read(Model::MapFormat::Standard, vm::bbox3(4096.0), mapPath, logger) == nullptr);
+
+            // change the map file without changing its size
+            String changed = MapData;
+            changed[changed.find("yay")] = 'n';
+            writeFile(mapPath, changed);
+            ASSERT_TRUE(MapCache::read(Model::MapFormat::Standard, WorldBounds, mapPath, logger) == nullptr);
+        }
+
+        TEST(MapCacheTest, ignoreTruncatedCache) {
+            TestEnvironment env("map_cache_test");
+            const auto mapPath = env.dir() + Path("test.map");
+            env.createFile(Path("test.map"), MapData);
+
+            auto world = readWorld(MapData);
+            MapCache::write(*world, WorldBounds, mapPath);
+
+            const auto cachePath = MapCache::cachePath(mapPath);
+            std::ifstream stream(cachePath.asString(), std::ios::in | std::ios::binary);
+            const String contents((std::istreambuf_iterator<char>(stream)), std::istreambuf_iterator<char>());
+            stream.close();
+
+            writeFile(cachePath, contents.substr(0, contents.size() / 2));
+
+            NullLogger logger;
+            ASSERT_TRUE(MapCache::read(Model::MapFormat::Standard, WorldBounds, mapPath, logger) == nullptr);
+        }
+
+        TEST(MapCacheTest, replaceCache) {
+            TestEnvironment env("map_cache_test");
+            const auto mapPath = env.dir() + Path("test.map");
+            env.createFile(Path("test.map"), MapData);
+
+            auto world = readWorld(MapData);
+            MapCache::write(*world, WorldBounds, mapPath);
+            MapCache::write(*world, WorldBounds, mapPath);
+
+            // no temporary files are left behind
+            ASSERT_EQ(2u, Disk::getDirectoryContents(env.dir()).size());
+
+            NullLogger logger;
+            ASSERT_TRUE(MapCache::read(Model::MapFormat::Standard, WorldBounds, mapPath, logger) != nullptr);
+        }
+
+        TEST(MapCacheTest, ignoreCacheWithOtherByteOrder) {
+            TestEnvironment env("map_cache_test");
+            const auto mapPath = env.dir() + Path("test.map");
+            env.createFile(Path("test.map"), MapData);
+
+            auto world = readWorld(MapData);
+            MapCache::write(*world, WorldBounds, mapPath);
+
+            const auto cachePath = MapCache::cachePath(mapPath);
+            std::ifstream stream(cachePath.asString(), std::ios::in | std::ios::binary);
+            String contents((std::istreambuf_iterator<char>(stream)), std::istreambuf_iterator<char>());
+            stream.close();
+
+            // the byte order mark follows the magic number
+            std::reverse(std::next(std::begin(contents), 4), std::next(std::begin(contents), 8));
+            writeFile(cachePath, contents);
+
+            NullLogger logger;
+            ASSERT_TRUE(MapCache::read(Model::MapFormat::Standard, WorldBounds, mapPath, logger) == nullptr);
+        }
+    }
+}
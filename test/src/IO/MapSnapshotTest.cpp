@@ -0,0 +1,186 @@
+/*
+ Copyright (C) 2010-2019 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+
+#include "StringUtils.h"
+#include "IO/MapSnapshot.h"
+#include "IO/NodeWriter.h"
+#include "Model/Brush.h"
+#include "Model/BrushBuilder.h"
+#include "Model/BrushFace.h"
+#include "Model/Entity.h"
+#include "Model/Group.h"
+#include "Model/Layer.h"
+#include "Model/MapFormat.h"
+#include "Model/World.h"
+
+#include <vecmath/mat.h>
+#include <vecmath/mat_ext.h>
+
+#include <cstdio>
+
+namespace TrenchBroom {
+    namespace IO {
+        static String readFile(FILE* stream) {
+            std::rewind(stream);
+            String result;
+            char buffer[4096];
+            size_t count;
+            while ((count = std::fread(buffer, 1, sizeof(buffer), stream)) > 0) {
+                result.append(buffer, count);
+            }
+            std::fclose(stream);
+            return result;
+        }
+
+        static String writeMapToFile(Model::World& map) {
+            auto* stream = std::tmpfile();
+            {
+                NodeWriter writer(map, stream);
+                writer.writeMap();
+            }
+            return readFile(stream);
+        }
+
+        static String writeSnapshotToFile(const MapSnapshot& snapshot) {
+            auto* stream = std::tmpfile();
+            snapshot.write(stream);
+            return readFile(stream);
+        }
+
+        static void createMap(Model::World& map, const vm::bbox3& worldBounds) {
+            map.addOrUpdateAttribute("classname", "worldspawn");
+            map.addOrUpdateAttribute("message", "\"quoted\" message");
+
+            Model::BrushBuilder builder(&map, worldBounds);
+            Model::Brush* worldBrush = builder.createCube(64.0, "world");
+            worldBrush->transform(vm::rotationMatrix(vm::vec3::pos_z, vm::toRadians(15.0)), true, worldBounds);
+            map.defaultLayer()->addChild(worldBrush);
+
+            Model::BrushFace* face = worldBrush->faces().front();
+            face->setXOffset(0.3f);
+            face->setRotation(22.5f);
+            face->setSurfaceContents(1);
+            face->setSurfaceFlags(2);
+            face->setSurfaceValue(3.75f);
+
+            Model::Entity* entity = map.createEntity();
+            entity->addOrUpdateAttribute("classname", "func_door");
+            map.defaultLayer()->addChild(entity);
+
+            for (size_t i = 0; i < 3; ++i) {
+                Model::Brush* brush = builder.createCube(32.0, "door" + std::to_string(i));
+                brush->transform(vm::translationMatrix(vm::vec3(static_cast<FloatType>(i) * 32.0, 0.0, 0.0)), true, worldBounds);
+                entity->addChild(brush);
+            }
+
+            Model::Entity* light = map.createEntity();
+            light->addOrUpdateAttribute("classname", "light");
+            map.defaultLayer()->addChild(light);
+        }
+
+        TEST(MapSnapshotTest, writeSnapshotLikeNodeWriter) {
+            const vm::bbox3 worldBounds(8192.0);
+
+            for (const auto format : { Model::MapFormat::Standard, Model::MapFormat::Quake2, Model::MapFormat::Valve, Model::MapFormat::Hexen2, Model::MapFormat::Daikatana }) {
+                Model::World map(format, worldBounds);
+                createMap(map, worldBounds);
+
+                const MapSnapshot snapshot(map);
+                ASSERT_EQ(format, snapshot.format());
+                ASSERT_EQ(writeMapToFile(map), writeSnapshotToFile(snapshot));
+            }
+        }
+
+        TEST(MapSnapshotTest, writeSnapshotWithGroupInCustomLayer) {
+            const vm::bbox3 worldBounds(8192.0);
+
+            Model::World map(Model::MapFormat::Standard, worldBounds);
+            map.addOrUpdateAttribute("classname", "worldspawn");
+
+            Model::Layer* layer = map.createLayer("Custom Layer", worldBounds);
+            map.addChild(layer);
+
+            Model::Group* group = map.createGroup("Group");
+            layer->addChild(group);
+
+            Model::BrushBuilder builder(&map, worldBounds);
+            Model::Brush* brush = builder.createCube(64.0, "none");
+            group->addChild(brush);
+
+            const MapSnapshot snapshot(map);
+
+            const String expected =
+R"(// entity 0
+{
+"classname" "worldspawn"
+}
+// entity 1
+{
+"classname" "func_group"
+"_tb_type" "_tb_layer"
+"_tb_name" "Custom Layer"
+"_tb_id" "*"
+}
+// entity 2
+{
+"classname" "func_group"
+"_tb_type" "_tb_group"
+"_tb_name" "Group"
+"_tb_id" "*"
+"_tb_layer" "*"
+// brush 0
+{
+( -32 -32 -32 ) ( -32 -31 -32 ) ( -32 -32 -31 ) none 0 0 0 1 1
+( -32 -32 -32 ) ( -32 -32 -31 ) ( -31 -32 -32 ) none 0 0 0 1 1
+( -32 -32 -32 ) ( -31 -32 -32 ) ( -32 -31 -32 ) none 0 0 0 1 1
+( 32 32 32 ) ( 32 33 32 ) ( 33 32 32 ) none 0 0 0 1 1
+( 32 32 32 ) ( 33 32 32 ) ( 32 32 33 ) none 0 0 0 1 1
+( 32 32 32 ) ( 32 32 33 ) ( 32 33 32 ) none 0 0 0 1 1
+}
+}
+)";
+            const String actual = writeSnapshotToFile(snapshot);
+            ASSERT_TRUE(StringUtils::caseSensitiveMatchesPattern(actual, expected));
+        }
+
+        TEST(MapSnapshotTest, snapshotIsUnaffectedByChanges) {
+            const vm::bbox3 worldBounds(8192.0);
+
+            Model::World map(Model::MapFormat::Valve, worldBounds);
+            createMap(map, worldBounds);
+
+            const String expected = writeMapToFile(map);
+            const MapSnapshot snapshot(map);
+
+            map.addOrUpdateAttribute("message", "changed");
+
+            Model::BrushBuilder builder(&map, worldBounds);
+            map.defaultLayer()->addChild(builder.createCube(16.0, "added"));
+
+            auto* brush = dynamic_cast<Model::Brush*>(map.defaultLayer()->children().front());
+            ASSERT_TRUE(brush != nullptr);
+            brush->faces().front()->setXOffset(5.0f);
+            brush->transform(vm::translationMatrix(vm::vec3(16.0, 0.0, 0.0)), true, worldBounds);
+
+            ASSERT_EQ(expected, writeSnapshotToFile(snapshot));
+        }
+    }
+}
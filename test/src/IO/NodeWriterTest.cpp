@@ -30,6 +30,11 @@
 #include "Model/MapFormat.h"
 #include "Model/World.h"
 
+#include <vecmath/mat.h>
+#include <vecmath/mat_ext.h>
+
+#include <cstdio>
+
 namespace TrenchBroom {
     namespace IO {
         TEST(NodeWriterTest, writeEmptyMap) {
@@ -525,5 +530,125 @@ R"(( -32 -32 -32 ) ( -32 -31 -32 ) ( -32 -32 -31 ) none 0 0 0 1 1
                          "\"message3\" \"holy damn\\\\\"\n"
                          "}\n", result.c_str());
         }
+
+        static String writeMapToFile(Model::World& map) {
+            auto* stream = std::tmpfile();
+            {
+                NodeWriter writer(map, stream);
+                writer.writeMap();
+            }
+
+            std::rewind(stream);
+            String result;
+            char buffer[4096];
+            size_t count;
+            while ((count = std::fread(buffer, 1, sizeof(buffer), stream)) > 0) {
+                result.append(buffer, count);
+            }
+            std::fclose(stream);
+            return result;
+        }
+
+        TEST(NodeWriterTest, writeValveMapToFile) {
+            const vm::bbox3 worldBounds(8192.0);
+
+            Model::World map(Model::MapFormat::Valve, worldBounds);
+            map.addOrUpdateAttribute("classname", "worldspawn");
+
+            Model::BrushBuilder builder(&map, worldBounds);
+            Model::Brush* brush = builder.createCube(64.0, "none");
+            brush->transform(vm::rotationMatrix(vm::vec3::pos_z, vm::toRadians(15.0)), true, worldBounds);
+            map.defaultLayer()->addChild(brush);
+
+            Model::BrushFace* face = brush->faces().front();
+            face->setXOffset(0.3f);
+            face->setRotation(22.5f);
+            face->setYScale(0.1f);
+
+            const String expected =
+R"(// entity 0
+{
+"classname" "worldspawn"
+// brush 0
+{
+( -22.627416997969522 -39.191835884530846 -32 ) ( -22.886236043072042 -38.22591005824178 -32 ) ( -22.627416997969522 -39.191835884530846 -31 ) none [ 0.239118 -0.892399 -0.382683 0.3 ] [ -0.0990458 0.369644 -0.92388 -0 ] 22.5 1 0.1
+( 22.627416997969522 39.191835884530846 32 ) ( 23.593342824258592 39.450654929633373 32 ) ( 22.627416997969522 39.191835884530846 33 ) none [ -0.965926 -0.258819 0 -0 ] [ 0 0 -1 -0 ] -0 1 1
+( -22.627416997969522 -39.191835884530846 -32 ) ( -21.661491171680453 -38.933016839428333 -32 ) ( -22.886236043072042 -38.22591005824178 -32 ) none [ -0.965926 -0.258819 0 -0 ] [ 0.258819 -0.965926 0 -0 ] 15 1 1
+( 22.627416997969522 39.191835884530846 32 ) ( 22.368597952867002 40.157761710819919 32 ) ( 23.593342824258592 39.450654929633373 32 ) none [ 0.965926 0.258819 0 -0 ] [ 0.258819 -0.965926 0 -0 ] 345 1 1
+( -22.627416997969522 -39.191835884530846 -32 ) ( -22.627416997969522 -39.191835884530846 -31 ) ( -21.661491171680453 -38.933016839428333 -32 ) none [ 0.965926 0.258819 0 -0 ] [ 0 0 -1 -0 ] -0 1 1
+( 22.627416997969522 39.191835884530846 32 ) ( 22.627416997969522 39.191835884530846 33 ) ( 22.368597952867002 40.157761710819919 32 ) none [ -0.258819 0.965926 0 -0 ] [ 0 0 -1 -0 ] -0 1 1
+}
+}
+)";
+            ASSERT_EQ(expected, writeMapToFile(map));
+        }
+
+        TEST(NodeWriterTest, writeQuake2MapToFile) {
+            const vm::bbox3 worldBounds(8192.0);
+
+            Model::World map(Model::MapFormat::Quake2, worldBounds);
+            map.addOrUpdateAttribute("classname", "worldspawn");
+
+            Model::BrushBuilder builder(&map, worldBounds);
+            Model::Brush* brush = builder.createCube(64.0, "none");
+            brush->transform(vm::translationMatrix(vm::vec3(0.125, -1.0 / 3.0, 0.0)), false, worldBounds);
+            map.defaultLayer()->addChild(brush);
+
+            Model::BrushFace* face = brush->faces().front();
+            face->setSurfaceContents(1);
+            face->setSurfaceFlags(-2);
+            face->setSurfaceValue(3.75f);
+
+            const String expected =
+R"(// entity 0
+{
+"classname" "worldspawn"
+// brush 0
+{
+( -31.875 -32.333333333333336 -32 ) ( -31.875 -31.333333333333332 -32 ) ( -31.875 -32.333333333333336 -31 ) none 0 0 0 1 1 1 -2 3.75
+( -31.875 -32.333333333333336 -32 ) ( -31.875 -32.333333333333336 -31 ) ( -30.875 -32.333333333333336 -32 ) none 0 0 0 1 1
+( -31.875 -32.333333333333336 -32 ) ( -30.875 -32.333333333333336 -32 ) ( -31.875 -31.333333333333332 -32 ) none 0 0 0 1 1
+( 32.125 31.666666666666668 32 ) ( 32.125 32.666666666666664 32 ) ( 33.125 31.666666666666668 32 ) none 0 0 0 1 1
+( 32.125 31.666666666666668 32 ) ( 33.125 31.666666666666668 32 ) ( 32.125 31.666666666666668 33 ) none 0 0 0 1 1
+( 32.125 31.666666666666668 32 ) ( 32.125 31.666666666666668 33 ) ( 32.125 32.666666666666664 32 ) none 0 0 0 1 1
+}
+}
+)";
+            ASSERT_EQ(expected, writeMapToFile(map));
+        }
+
+        TEST(NodeWriterTest, writeManyBrushesToFile) {
+            const vm::bbox3 worldBounds(8192.0);
+
+            Model::World map(Model::MapFormat::Standard, worldBounds);
+            map.addOrUpdateAttribute("classname", "worldspawn");
+
+            Model::BrushBuilder builder(&map, worldBounds);
+            Model::BrushList brushes;
+            for (size_t i = 0; i < 1000; ++i) {
+                Model::Brush* brush = builder.createCube(64.0, "brush" + std::to_string(i));
+                map.defaultLayer()->addChild(brush);
+                brushes.push_back(brush);
+            }
+
+            const String actual = writeMapToFile(map);
+
+            StringStream str;
+            NodeWriter writer(map, str);
+            writer.writeMap();
+            ASSERT_EQ(str.str(), actual);
+
+            // the entity header takes three lines, and every brush takes nine lines
+            for (size_t i = 0; i < brushes.size(); ++i) {
+                const Model::Brush* brush = brushes[i];
+                ASSERT_EQ(5u + 9u * i, brush->lineNumber());
+                ASSERT_EQ(8u, brush->lineCount());
+
+                const Model::BrushFaceList& faces = brush->faces();
+                for (size_t j = 0; j < faces.size(); ++j) {
+                    ASSERT_EQ(brush->lineNumber() + 1u + j, faces[j]->lineNumber());
+                }
+            }
+        }
     }
 }
@@ -0,0 +1,202 @@
+/*
+ Copyright (C) 2010-2019 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+
+#include "Logger.h"
+#include "Assets/Texture.h"
+#include "Assets/TextureCollection.h"
+#include "IO/DiskFileSystem.h"
+#include "IO/DiskIO.h"
+#include "IO/Path.h"
+#include "IO/TestEnvironment.h"
+#include "IO/TextureCache.h"
+#include "IO/TextureLoader.h"
+#include "IO/WadFileSystem.h"
+#include "Model/GameConfig.h"
+
+#include <algorithm>
+#include <fstream>
+
+namespace TrenchBroom {
+    namespace IO {
+        static Model::GameConfig::TextureConfig idMipTextureConfig() {
+            using Model::GameConfig;
+            return GameConfig::TextureConfig(GameConfig::TexturePackageConfig(GameConfig::PackageFormatConfig("wad", "idmip")),
+                                             GameConfig::PackageFormatConfig("D", "idmip"),
+                                             Path("fixture/test/palette.lmp"),
+                                             "wad",
+                                             Path());
+        }
+
+        static void assertSameTexture(const Assets::Texture* expected, const Assets::Texture* actual) {
+            ASSERT_EQ(expected->name(), actual->name());
+            ASSERT_EQ(expected->width(), actual->width());
+            ASSERT_EQ(expected->height(), actual->height());
+            ASSERT_EQ(expected->averageColor(), actual->averageColor());
+            ASSERT_EQ(expected->format(), actual->format());
+            ASSERT_EQ(expected->type(), actual->type());
+
+            const auto& expectedBuffers = expected->buffersIfUnprepared();
+            const auto& actualBuffers = actual->buffersIfUnprepared();
+            ASSERT_EQ(expectedBuffers.size(), actualBuffers.size());
+            for (size_t i = 0; i < expectedBuffers.size(); ++i) {
+                ASSERT_TRUE(std::equal(std::begin(expectedBuffers[i]), std::end(expectedBuffers[i]), std::begin(actualBuffers[i]), std::end(actualBuffers[i])));
+            }
+        }
+
+        static void assertSameCollection(const Assets::TextureCollection* expected, const Assets::TextureCollection* actual) {
+            ASSERT_TRUE(expected != nullptr);
+            ASSERT_TRUE(actual != nullptr);
+            ASSERT_EQ(expected->textureCount(), actual->textureCount());
+            for (size_t i = 0; i < expected->textureCount(); ++i) {
+                actual->textures()[i]->decode();
+                assertSameTexture(expected->textures()[i], actual->textures()[i]);
+            }
+        }
+
+        TEST(TextureCacheTest, writeAndReadCacheFile) {
+            TestEnvironment env("texture_cache_test");
+
+            const auto root = Disk::getCurrentWorkingDir();
+            const DiskFileSystem fs(root);
+            NullLogger logger;
+
+            TextureLoader loader(fs, Path::List{ root }, idMipTextureConfig(), logger);
+            const auto wadPath = Path("fixture/test/IO/Wad/cr8_czg.wad");
+            const auto results = loader.loadTextureCollections(Path::List{ wadPath }, false);
+            const auto& textures = results[0].collection->textures();
+
+            WadFileSystem wadFS(root + wadPath);
+            std::vector<TextureCacheKey> keys;
+            for (const auto& path : wadFS.findItems(Path(""))) {
+                keys.push_back(TextureCacheKey::compute(*wadFS.openFile(path)));
+            }
+            ASSERT_EQ(textures.size(), keys.size());
+
+            const TextureCache cache(env.dir(), "idmip");
+            ASSERT_TRUE(cache.read(wadPath) == nullptr);
+
+            cache.write(wadPath, keys, std::vector<const Assets::Texture*>(std::begin(textures), std::end(textures)));
+            ASSERT_TRUE(env.fileExists(cache.cacheFilePath(wadPath).lastComponent()));
+
+            const auto cacheFile = cache.read(wadPath);
+            ASSERT_TRUE(cacheFile != nullptr);
+            for (size_t i = 0; i < keys.size(); ++i) {
+                const auto* record = cacheFile->find(keys[i]);
+                ASSERT_TRUE(record != nullptr);
+
+                std::unique_ptr<Assets::Texture> texture(cacheFile->readTexture(*record));
+                assertSameTexture(textures[i], texture.get());
+
+                auto changedKey = keys[i];
+                changedKey.hash += 1;
+                ASSERT_TRUE(cacheFile->find(changedKey) == nullptr);
+            }
+
+            // the signature and the collection path must match
+            ASSERT_TRUE(TextureCache(env.dir(), "wal").cacheFilePath(wadPath) != cache.cacheFilePath(wadPath));
+            ASSERT_TRUE(TextureCache(env.dir(), "wal").read(wadPath) == nullptr);
+            ASSERT_TRUE(cache.read(Path("other.wad")) == nullptr);
+
+            // a truncated cache file is rejected
+            const auto cacheFilePath = cache.cacheFilePath(wadPath);
+            std::ofstream(cacheFilePath.asString(), std::ios::out | std::ios::binary | std::ios::trunc).write("TBTC\1\0\0\0", 8);
+            ASSERT_THROW(cache.read(wadPath), FileSystemException);
+        }
+
+        TEST(TextureCacheTest, loadTextureCollectionsFromCache) {
+            TestEnvironment env("texture_cache_test");
+
+            const auto root = Disk::getCurrentWorkingDir();
+            const DiskFileSystem fs(root);
+            NullLogger logger;
+
+            TextureLoader loader(fs, Path::List{ root }, idMipTextureConfig(), logger);
+            const auto paths = Path::List{ Path("fixture/test/IO/Wad/cr8_czg.wad") };
+            const auto cacheDirectory = env.dir() + Path("cache");
+
+            const auto expected = loader.loadTextureCollections(paths, false);
+
+            // a collection that is not cached yet is still decoded lazily, but then it is not written to the cache
+            const auto coldLazy = loader.loadTextureCollections(paths, true, cacheDirectory);
+            for (const auto* texture : coldLazy[0].collection->textures()) {
+                ASSERT_TRUE(texture->needsDecoding());
+            }
+            assertSameCollection(expected[0].collection.get(), coldLazy[0].collection.get());
+            ASSERT_FALSE(Disk::directoryExists(cacheDirectory));
+
+            // a collection that is decoded eagerly is written to the cache
+            const auto cold = loader.loadTextureCollections(paths, false, cacheDirectory);
+            assertSameCollection(expected[0].collection.get(), cold[0].collection.get());
+            ASSERT_EQ(1u, Disk::getDirectoryContents(cacheDirectory).size());
+
+            // when read lazily from the cache, textures are copied out of the cache file on demand
+            const auto warmLazy = loader.loadTextureCollections(paths, true, cacheDirectory);
+            for (const auto* texture : warmLazy[0].collection->textures()) {
+                ASSERT_TRUE(texture->needsDecoding());
+            }
+            assertSameCollection(expected[0].collection.get(), warmLazy[0].collection.get());
+
+            const auto warm = loader.loadTextureCollections(paths, false, cacheDirectory);
+            assertSameCollection(expected[0].collection.get(), warm[0].collection.get());
+
+            // an invalid cache file is replaced
+            const auto cacheFilePath = cacheDirectory + Disk::getDirectoryContents(cacheDirectory).front();
+            std::ofstream(cacheFilePath.asString(), std::ios::out | std::ios::binary | std::ios::trunc).write("TBTC", 4);
+
+            const auto recovered = loader.loadTextureCollections(paths, false, cacheDirectory);
+            assertSameCollection(expected[0].collection.get(), recovered[0].collection.get());
+            ASSERT_EQ(1u, Disk::getDirectoryContents(cacheDirectory).size());
+
+            const auto warmAgain = loader.loadTextureCollections(paths, true, cacheDirectory);
+            ASSERT_TRUE(warmAgain[0].collection->textures().front()->needsDecoding());
+        }
+
+        TEST(TextureCacheTest, ignoreTextureWithWrongSize) {
+            TestEnvironment env("texture_cache_test");
+
+            // the pixels of a 2x2 RGBA texture occupy 16 bytes
+            const Assets::Texture texture("test", 2, 2, Color(), Assets::TextureBuffer(20), GL_RGBA, Assets::TextureType::Opaque);
+            const auto keys = std::vector<TextureCacheKey>{ TextureCacheKey("test", 20, 1) };
+
+            const TextureCache cache(env.dir(), "idmip");
+            cache.write(Path("test.wad"), keys, std::vector<const Assets::Texture*>{ &texture });
+            ASSERT_TRUE(cache.read(Path("test.wad")) == nullptr);
+        }
+
+        TEST(TextureCacheTest, deleteOldCacheFiles) {
+            TestEnvironment env("texture_cache_test");
+
+            const Assets::Texture texture("test", 2, 2, Color(), Assets::TextureBuffer(16), GL_RGBA, Assets::TextureType::Opaque);
+            const auto keys = std::vector<TextureCacheKey>{ TextureCacheKey("test", 16, 1) };
+            const auto textures = std::vector<const Assets::Texture*>{ &texture };
+
+            // the cache file that was written last is always kept
+            const TextureCache cache(env.dir(), "idmip", 1u);
+            cache.write(Path("first.wad"), keys, textures);
+            ASSERT_TRUE(cache.read(Path("first.wad")) != nullptr);
+
+            cache.write(Path("second.wad"), keys, textures);
+            ASSERT_TRUE(cache.read(Path("first.wad")) == nullptr);
+            ASSERT_TRUE(cache.read(Path("second.wad")) != nullptr);
+            ASSERT_EQ(1u, Disk::getDirectoryContents(env.dir()).size());
+        }
+    }
+}
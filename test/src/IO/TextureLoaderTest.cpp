@@ -0,0 +1,230 @@
+/*
+ Copyright (C) 2010-2017 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+
+#include "Logger.h"
+#include "Assets/Texture.h"
+#include "Assets/TextureCollection.h"
+#include "Assets/TextureManager.h"
+#include "IO/DiskFileSystem.h"
+#include "IO/DiskIO.h"
+#include "IO/Path.h"
+#include "IO/TextureLoader.h"
+#include "Model/GameConfig.h"
+
+#include <algorithm>
+
+namespace TrenchBroom {
+    namespace IO {
+        static Model::GameConfig::TextureConfig idMipTextureConfig() {
+            using Model::GameConfig;
+            return GameConfig::TextureConfig(GameConfig::TexturePackageConfig(GameConfig::PackageFormatConfig("wad", "idmip")),
+                                             GameConfig::PackageFormatConfig("D", "idmip"),
+                                             Path("fixture/test/palette.lmp"),
+                                             "wad",
+                                             Path());
+        }
+
+        TEST(TextureLoaderTest, loadTextureCollections) {
+            const auto root = Disk::getCurrentWorkingDir();
+            const DiskFileSystem fs(root);
+            NullLogger logger;
+
+            TextureLoader loader(fs, Path::List{ root }, idMipTextureConfig(), logger);
+
+            const auto wadPath = Path("fixture/test/IO/Wad/cr8_czg.wad");
+            const auto missingPath = Path("fixture/test/IO/Wad/does_not_exist.wad");
+            const auto results = loader.loadTextureCollections(Path::List{ wadPath, missingPath, wadPath }, false);
+            ASSERT_EQ(3u, results.size());
+
+            ASSERT_TRUE(results[0].collection != nullptr);
+            ASSERT_TRUE(results[0].error.empty());
+            ASSERT_EQ(wadPath, results[0].collection->path());
+            ASSERT_EQ(21u, results[0].collection->textureCount());
+
+            ASSERT_TRUE(results[1].collection == nullptr);
+            ASSERT_FALSE(results[1].error.empty());
+
+            ASSERT_TRUE(results[2].collection != nullptr);
+            ASSERT_TRUE(results[2].error.empty());
+
+            // the textures are in the same order no matter in which order they were decoded
+            const auto& textures = results[0].collection->textures();
+            const auto& otherTextures = results[2].collection->textures();
+            ASSERT_EQ(textures.size(), otherTextures.size());
+            for (size_t i = 0; i < textures.size(); ++i) {
+                ASSERT_EQ(textures[i]->name(), otherTextures[i]->name());
+                ASSERT_EQ(textures[i]->width(), otherTextures[i]->width());
+                ASSERT_EQ(textures[i]->height(), otherTextures[i]->height());
+            }
+
+            const auto coffin = std::find_if(std::begin(textures), std::end(textures), [](const auto* t) { return t->name() == "coffin1"; });
+            ASSERT_NE(std::end(textures), coffin);
+            ASSERT_EQ(128u, (*coffin)->width());
+            ASSERT_EQ(128u, (*coffin)->height());
+        }
+
+        TEST(TextureLoaderTest, loadTexturesIntoManager) {
+            const auto root = Disk::getCurrentWorkingDir();
+            const DiskFileSystem fs(root);
+            NullLogger logger;
+
+            TextureLoader loader(fs, Path::List{ root }, idMipTextureConfig(), logger);
+
+            const auto wadPath = Path("fixture/test/IO/Wad/cr8_czg.wad");
+            const auto missingPath = Path("fixture/test/IO/Wad/does_not_exist.wad");
+
+            Assets::TextureManager textureManager(0, 0, logger);
+            loader.loadTextures(Path::List{ missingPath, wadPath }, textureManager);
+
+            const auto& collections = textureManager.collections();
+            ASSERT_EQ(2u, collections.size());
+            ASSERT_EQ(missingPath, collections[0]->path());
+            ASSERT_FALSE(collections[0]->loaded());
+            ASSERT_EQ(wadPath, collections[1]->path());
+            ASSERT_TRUE(collections[1]->loaded());
+
+            ASSERT_EQ(21u, textureManager.textures().size());
+            ASSERT_TRUE(textureManager.texture("cr8_czg_1") != nullptr);
+
+            // reloading keeps the loaded collection and retries the missing one
+            auto* loadedCollection = collections[1];
+            loader.loadTextures(Path::List{ wadPath, missingPath }, textureManager);
+            ASSERT_EQ(2u, textureManager.collections().size());
+            ASSERT_EQ(loadedCollection, textureManager.collections()[0]);
+            ASSERT_EQ(missingPath, textureManager.collections()[1]->path());
+            ASSERT_FALSE(textureManager.collections()[1]->loaded());
+        }
+
+        TEST(TextureLoaderTest, loadTextureCollectionsLazily) {
+            const auto root = Disk::getCurrentWorkingDir();
+            const DiskFileSystem fs(root);
+            NullLogger logger;
+
+            TextureLoader loader(fs, Path::List{ root }, idMipTextureConfig(), logger);
+
+            const auto wadPath = Path("fixture/test/IO/Wad/cr8_czg.wad");
+            const auto eager = loader.loadTextureCollections(Path::List{ wadPath }, false);
+            const auto lazy = loader.loadTextureCollections(Path::List{ wadPath }, true);
+            ASSERT_TRUE(eager[0].collection != nullptr);
+            ASSERT_TRUE(lazy[0].collection != nullptr);
+
+            const auto& eagerTextures = eager[0].collection->textures();
+            const auto& lazyTextures = lazy[0].collection->textures();
+            ASSERT_EQ(eagerTextures.size(), lazyTextures.size());
+
+            for (size_t i = 0; i < eagerTextures.size(); ++i) {
+                const auto* eagerTexture = eagerTextures[i];
+                const auto* lazyTexture = lazyTextures[i];
+
+                ASSERT_FALSE(eagerTexture->needsDecoding());
+                ASSERT_TRUE(lazyTexture->needsDecoding());
+                ASSERT_TRUE(lazyTexture->buffersIfUnprepared().empty());
+
+                ASSERT_EQ(eagerTexture->name(), lazyTexture->name());
+                ASSERT_EQ(eagerTexture->width(), lazyTexture->width());
+                ASSERT_EQ(eagerTexture->height(), lazyTexture->height());
+
+                lazyTexture->decode();
+                ASSERT_FALSE(lazyTexture->needsDecoding());
+                ASSERT_EQ(eagerTexture->type(), lazyTexture->type());
+                ASSERT_EQ(eagerTexture->format(), lazyTexture->format());
+
+                const auto& eagerBuffers = eagerTexture->buffersIfUnprepared();
+                const auto& lazyBuffers = lazyTexture->buffersIfUnprepared();
+                ASSERT_EQ(eagerBuffers.size(), lazyBuffers.size());
+                for (size_t j = 0; j < eagerBuffers.size(); ++j) {
+                    ASSERT_TRUE(std::equal(std::begin(eagerBuffers[j]), std::end(eagerBuffers[j]), std::begin(lazyBuffers[j]), std::end(lazyBuffers[j])));
+                }
+            }
+        }
+
+        TEST(TextureLoaderTest, decodeTexturesWithinBudget) {
+            const auto root = Disk::getCurrentWorkingDir();
+            const DiskFileSystem fs(root);
+            NullLogger logger;
+
+            TextureLoader loader(fs, Path::List{ root }, idMipTextureConfig(), logger);
+
+            Assets::TextureManager textureManager(0, 0, logger);
+            textureManager.setLazyLoading(true);
+            loader.loadTextures(Path::List{ Path("fixture/test/IO/Wad/cr8_czg.wad") }, textureManager);
+
+            const auto& textures = textureManager.textures();
+            ASSERT_EQ(21u, textures.size());
+            for (const auto* texture : textures) {
+                ASSERT_TRUE(texture->needsDecoding());
+            }
+
+            // a 64x64 texture occupies 21760 bytes, a 128x128 texture occupies 87040 bytes
+            const size_t budget = 200000;
+            textureManager.setDecodedBufferBudget(budget);
+            textureManager.decodeTextures(textures);
+            ASSERT_GT(textureManager.decodedBufferSize(), 0u);
+            ASSERT_LE(textureManager.decodedBufferSize(), budget);
+
+            size_t decodedSize = 0;
+            for (const auto* texture : textures) {
+                decodedSize += texture->bufferSize();
+            }
+            ASSERT_EQ(textureManager.decodedBufferSize(), decodedSize);
+
+            // decoding more textures releases the ones that were decoded first
+            const auto* firstDecoded = *std::find_if(std::begin(textures), std::end(textures), [](const auto* t) { return !t->needsDecoding(); });
+            const auto firstUndecoded = std::find_if(std::begin(textures), std::end(textures), [](const auto* t) { return t->needsDecoding(); });
+            ASSERT_NE(std::end(textures), firstUndecoded);
+
+            textureManager.decodeTextures(Assets::TextureList(firstUndecoded, std::end(textures)));
+            ASSERT_LE(textureManager.decodedBufferSize(), budget);
+            ASSERT_TRUE(firstDecoded->needsDecoding());
+
+            textureManager.clear();
+            ASSERT_EQ(0u, textureManager.decodedBufferSize());
+        }
+
+        TEST(TextureLoaderTest, keepRecentlyUsedDecodedTextures) {
+            const auto root = Disk::getCurrentWorkingDir();
+            const DiskFileSystem fs(root);
+            NullLogger logger;
+
+            TextureLoader loader(fs, Path::List{ root }, idMipTextureConfig(), logger);
+
+            Assets::TextureManager textureManager(0, 0, logger);
+            textureManager.setLazyLoading(true);
+            loader.loadTextures(Path::List{ Path("fixture/test/IO/Wad/cr8_czg.wad") }, textureManager);
+
+            const auto& textures = textureManager.textures();
+            const size_t budget = 200000;
+            textureManager.setDecodedBufferBudget(budget);
+            textureManager.decodeTextures(textures);
+
+            // using a decoded texture again keeps it when other textures are decoded
+            auto* firstDecoded = *std::find_if(std::begin(textures), std::end(textures), [](const auto* t) { return !t->needsDecoding(); });
+            const auto firstUndecoded = std::find_if(std::begin(textures), std::end(textures), [](const auto* t) { return t->needsDecoding(); });
+            ASSERT_NE(std::end(textures), firstUndecoded);
+
+            Assets::TextureList used{ firstDecoded };
+            used.insert(std::end(used), firstUndecoded, std::end(textures));
+            textureManager.decodeTextures(used);
+            ASSERT_LE(textureManager.decodedBufferSize(), budget);
+            ASSERT_FALSE(firstDecoded->needsDecoding());
+        }
+    }
+}
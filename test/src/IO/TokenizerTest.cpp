@@ -17,11 +17,16 @@
  along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include "IO/StandardMapParser.h"
 #include "IO/Token.h"
 #include "IO/Tokenizer.h"
 
 #include <gtest/gtest.h>
 
+#include <cstdlib>
+#include <tuple>
+#include <vector>
+
 namespace TrenchBroom {
     namespace IO {
         namespace SimpleToken {
@@ -238,5 +243,90 @@ namespace TrenchBroom {
             ASSERT_EQ(SimpleToken::CBrace, (token = tokenizer.nextToken()).type());
             ASSERT_EQ(SimpleToken::Eof, tokenizer.nextToken().type());
         }
+    
+        TEST(TokenizerTest, tokenToNumber) {
+            using Token = TokenTemplate<unsigned int>;
+            const std::vector<String> numbers({
+                "0", "1", "+1", "-1", "12328", "-12328", "2147483647", "99999999999",
+                "0.5", ".5", "-.5", "+.5", "1.", "1e3", "-1.5e-3", "1e", "5e-", "1e400", "-", "+", "+-1",
+                "0x10", "12abc", "0.1000000000000000055511151231257827", "-22.627416997969522"
+            });
+
+            for (const auto& number : numbers) {
+                const Token token(0, number.data(), number.data() + number.size(), 0, 1, 1);
+                ASSERT_EQ(std::atof(number.c_str()), token.toFloat<double>()) << number;
+                ASSERT_EQ(static_cast<float>(std::atof(number.c_str())), token.toFloat<float>()) << number;
+                if (number != "99999999999") { // atoi is undefined for numbers that exceed the range of int
+                    ASSERT_EQ(std::atoi(number.c_str()), token.toInteger<int>()) << number;
+                }
+            }
+        }
+
+        TEST(TokenizerTest, quakeMapTokens) {
+            const String testString("// entity 0\r\n"
+                                    "{\r\n"
+                                    "\"classname\" \"worldspawn\"\n"
+                                    "// brush 0\n"
+                                    "( -64 +1.5\t1e3 ) tex\\name -.5 - 5e- 1e2x [ ]\n"
+                                    "/// 1\n"
+                                    "  \t\r\n"
+                                    "}");
+
+            using Expected = std::tuple<QuakeMapToken::Type, String, size_t, size_t>;
+            const std::vector<Expected> expected({
+                Expected(QuakeMapToken::OBrace, "{", 2, 1),
+                Expected(QuakeMapToken::String, "classname", 3, 1),
+                Expected(QuakeMapToken::String, "worldspawn", 3, 13),
+                Expected(QuakeMapToken::OParenthesis, "(", 5, 1),
+                Expected(QuakeMapToken::Integer, "-64", 5, 3),
+                Expected(QuakeMapToken::Decimal, "+1.5", 5, 7),
+                Expected(QuakeMapToken::Decimal, "1e3", 5, 12),
+                Expected(QuakeMapToken::CParenthesis, ")", 5, 16),
+                Expected(QuakeMapToken::String, "tex\\name", 5, 18),
+                Expected(QuakeMapToken::Decimal, "-.5", 5, 27),
+                Expected(QuakeMapToken::Integer, "-", 5, 31),
+                Expected(QuakeMapToken::Decimal, "5e-", 5, 33),
+                Expected(QuakeMapToken::String, "1e2x", 5, 37),
+                Expected(QuakeMapToken::OBracket, "[", 5, 42),
+                Expected(QuakeMapToken::CBracket, "]", 5, 44),
+                Expected(QuakeMapToken::Comment, "///", 6, 1),
+                Expected(QuakeMapToken::Integer, "1", 6, 5),
+                Expected(QuakeMapToken::CBrace, "}", 8, 1),
+            });
+
+            QuakeMapTokenizer tokenizer(testString);
+            for (const auto& [type, data, line, column] : expected) {
+                const auto token = tokenizer.nextToken();
+                ASSERT_EQ(type, token.type()) << data;
+                ASSERT_EQ(data, token.data());
+                ASSERT_EQ(line, token.line()) << data;
+                ASSERT_EQ(column, token.column()) << data;
+            }
+            ASSERT_EQ(QuakeMapToken::Eof, tokenizer.nextToken().type());
+        }
+
+        TEST(TokenizerTest, quakeMapTokensWithEol) {
+            const String testString("1 2 \n"
+                                    "3\r\n"
+                                    "\n"
+                                    "4");
+
+            QuakeMapTokenizer tokenizer(testString);
+            tokenizer.setSkipEol(false);
+
+            QuakeMapTokenizer::Token token;
+            ASSERT_EQ(QuakeMapToken::Integer, (token = tokenizer.nextToken()).type());
+            ASSERT_EQ(QuakeMapToken::Integer, (token = tokenizer.nextToken()).type());
+            // blanks swallow the following line breaks
+            ASSERT_EQ(QuakeMapToken::Integer, (token = tokenizer.nextToken()).type());
+            ASSERT_EQ("3", token.data());
+            ASSERT_EQ(2u, token.line());
+            ASSERT_EQ(QuakeMapToken::Eol, (token = tokenizer.nextToken()).type());
+            ASSERT_EQ(QuakeMapToken::Eol, (token = tokenizer.nextToken()).type());
+            ASSERT_EQ(QuakeMapToken::Integer, (token = tokenizer.nextToken()).type());
+            ASSERT_EQ(4u, token.line());
+            ASSERT_EQ(1u, token.column());
+            ASSERT_EQ(QuakeMapToken::Eof, tokenizer.nextToken().type());
+        }
     }
 }
@@ -19,6 +19,7 @@
 
 #include <gtest/gtest.h>
 
+#include "Exceptions.h"
 #include "IO/TestParserStatus.h"
 #include "IO/WorldReader.h"
 #include "Model/Brush.h"
@@ -43,6 +44,35 @@ namespace TrenchBroom {
             return nullptr;
         }
 
+        static void assertSameNodes(const Model::Node* expected, const Model::Node* actual) {
+            ASSERT_EQ(expected->name(), actual->name());
+            ASSERT_EQ(expected->lineNumber(), actual->lineNumber());
+            ASSERT_EQ(expected->childCount(), actual->childCount());
+
+            const auto& expectedChildren = expected->children();
+            const auto& actualChildren = actual->children();
+            for (size_t i = 0; i < expectedChildren.size(); ++i) {
+                assertSameNodes(expectedChildren[i], actualChildren[i]);
+            }
+        }
+
+        static void assertParallelReadMatchesRead(const String& data, const Model::MapFormat format, const size_t chunkSize) {
+            const vm::bbox3 worldBounds(8192);
+
+            IO::TestParserStatus expectedStatus;
+            WorldReader expectedReader(data);
+            auto expected = expectedReader.read(format, worldBounds, expectedStatus);
+
+            IO::TestParserStatus actualStatus;
+            WorldReader actualReader(data);
+            auto actual = actualReader.readInParallel(format, worldBounds, actualStatus, chunkSize);
+
+            ASSERT_TRUE(actual != nullptr);
+            assertSameNodes(expected.get(), actual.get());
+            ASSERT_EQ(expectedStatus.countStatus(Logger::LogLevel_Warn), actualStatus.countStatus(Logger::LogLevel_Warn));
+            ASSERT_EQ(expectedStatus.countStatus(Logger::LogLevel_Error), actualStatus.countStatus(Logger::LogLevel_Error));
+        }
+
         TEST(WorldReaderTest, parseFailure_1424) {
             const String data(R"(
 {
@@ -929,6 +959,133 @@ common/caulk
             ASSERT_STREQ("vm::line1\\nvm::line2", world->attribute("message").c_str());
         }
 
+        TEST(WorldReaderTest, readInParallelSplitsWorldspawn) {
+            const String data(R"(
+{
+"classname" "worldspawn"
+"message" "yay"
+// a comment
+{
+( -0 -0 -16 ) ( -0 -0  -0 ) ( 64 -0 -16 ) none 0 0 0 1 1
+( -0 -0 -16 ) ( -0 64 -16 ) ( -0 -0  -0 ) none 0 0 0 1 1
+( -0 -0 -16 ) ( 64 -0 -16 ) ( -0 64 -16 ) none 0 0 0 1 1
+( 64 64  -0 ) ( -0 64  -0 ) ( 64 64 -16 ) none 0 0 0 1 1
+( 64 64  -0 ) ( 64 64 -16 ) ( 64 -0  -0 ) none 0 0 0 1 1
+( 64 64  -0 ) ( 64 -0  -0 ) ( -0 64  -0 ) none 0 0 0 1 1
+}
+{
+( 0 0 0 ) ( 0 0 0 ) ( 0 0 0 ) none 0 0 0 1 1
+( 0 0 0 ) ( 0 0 0 ) ( 0 0 0 ) none 0 0 0 1 1
+( 0 0 0 ) ( 0 0 0 ) ( 0 0 0 ) none 0 0 0 1 1
+}
+// another comment
+{
+( -712 1280 -448 ) ( -904 1280 -448 ) ( -904 992 -448 ) {fence 56 -32 0 1 1
+( -904 992 -416 ) ( -904 1280 -416 ) ( -712 1280 -416 ) rtz/b_rc_v16w 32 32 0 1 1
+( -832 968 -416 ) ( -832 1256 -416 ) ( -832 1256 -448 ) rtz/c_mf_v3c 16 96 0 1 1
+( -920 1088 -448 ) ( -920 1088 -416 ) ( -680 1088 -416 ) rtz/c_mf_v3c 56 96 0 1 1
+( -968 1152 -448 ) ( -920 1152 -448 ) ( -944 1152 -416 ) rtz/c_mf_v3c 56 96 0 1 1
+( -896 1056 -416 ) ( -896 1056 -448 ) ( -896 1344 -448 ) rtz/c_mf_v3c 16 96 0 1 1
+}
+}
+{
+"classname" "func_group"
+"_tb_type" "_tb_layer"
+"_tb_name" "My Layer"
+"_tb_id" "1"
+{
+( -800 288 1024 ) ( -736 288 1024 ) ( -736 224 1024 ) rtz/c_mf_v3c 56 -32 0 1 1
+( -800 288 1024 ) ( -800 224 1024 ) ( -800 224 576 ) rtz/c_mf_v3c 56 -32 0 1 1
+( -736 224 1024 ) ( -736 288 1024 ) ( -736 288 576 ) rtz/c_mf_v3c 56 -32 0 1 1
+( -736 288 1024 ) ( -800 288 1024 ) ( -800 288 576 ) rtz/c_mf_v3c 56 -32 0 1 1
+( -800 224 1024 ) ( -736 224 1024 ) ( -736 224 576 ) rtz/c_mf_v3c 56 -32 0 1 1
+( -800 224 576 ) ( -736 224 576 ) ( -736 288 576 ) rtz/c_mf_v3c 56 -32 0 1 1
+}
+}
+{
+"classname" "func_door"
+"_tb_layer" "1"
+{
+( -800 288 1024 ) ( -736 288 1024 ) ( -736 224 1024 ) rtz/c_mf_v3c 56 -32 0 1 1
+( -800 288 1024 ) ( -800 224 1024 ) ( -800 224 576 ) rtz/c_mf_v3c 56 -32 0 1 1
+( -736 224 1024 ) ( -736 288 1024 ) ( -736 288 576 ) rtz/c_mf_v3c 56 -32 0 1 1
+( -736 288 1024 ) ( -800 288 1024 ) ( -800 288 576 ) rtz/c_mf_v3c 56 -32 0 1 1
+( -800 224 1024 ) ( -736 224 1024 ) ( -736 224 576 ) rtz/c_mf_v3c 56 -32 0 1 1
+( -800 224 576 ) ( -736 224 576 ) ( -736 288 576 ) rtz/c_mf_v3c 56 -32 0 1 1
+}
+}
+{
+"classname" "info_player_start"
+"origin" "1 22 -3"
+}
+)");
+
+            assertParallelReadMatchesRead(data, Model::MapFormat::Quake2, 1);
+            assertParallelReadMatchesRead(data, Model::MapFormat::Quake2, 512);
+            assertParallelReadMatchesRead(data, Model::MapFormat::Quake2, WorldReader::DefaultChunkSize);
+        }
+
+        TEST(WorldReaderTest, readInParallelWithExtraAttributes) {
+            const String data(R"(
+{
+"classname" "worldspawn"
+{
+( -0 -0 -16 ) ( -0 -0  -0 ) ( 64 -0 -16 ) none 0 0 0 1 1
+( -0 -0 -16 ) ( -0 64 -16 ) ( -0 -0  -0 ) none 0 0 0 1 1
+( -0 -0 -16 ) ( 64 -0 -16 ) ( -0 64 -16 ) none 0 0 0 1 1
+( 64 64  -0 ) ( -0 64  -0 ) ( 64 64 -16 ) none 0 0 0 1 1
+( 64 64  -0 ) ( 64 64 -16 ) ( 64 -0  -0 ) none 0 0 0 1 1
+( 64 64  -0 ) ( 64 -0  -0 ) ( -0 64  -0 ) none 0 0 0 1 1
+}
+/// hideIssues 2
+{
+( -0 -0 -16 ) ( -0 -0  -0 ) ( 64 -0 -16 ) none 0 0 0 1 1
+( -0 -0 -16 ) ( -0 64 -16 ) ( -0 -0  -0 ) none 0 0 0 1 1
+( -0 -0 -16 ) ( 64 -0 -16 ) ( -0 64 -16 ) none 0 0 0 1 1
+( 64 64  -0 ) ( -0 64  -0 ) ( 64 64 -16 ) none 0 0 0 1 1
+( 64 64  -0 ) ( 64 64 -16 ) ( 64 -0  -0 ) none 0 0 0 1 1
+( 64 64  -0 ) ( 64 -0  -0 ) ( -0 64  -0 ) none 0 0 0 1 1
+}
+}
+{
+/// hideIssues 3
+"classname" "info_player_deathmatch"
+"origin" "1 22 -3"
+}
+)");
+
+            assertParallelReadMatchesRead(data, Model::MapFormat::Standard, 1);
+        }
+
+        TEST(WorldReaderTest, readInParallelFallsBackOnParserError) {
+            const String data(R"(
+{
+"classname" "worldspawn"
+{
+( -0 -0 -16 ) ( -0 -0  -0 ) ( 64 -0 -16 ) none 0 0 0 1 1
+( -0 -0 -16 ) ( -0 64 -16 ) ( -0 -0  -0 ) none 0 0 0 1 1
+( -0 -0 -16 ) ( 64 -0 -16 ) ( -0 64 -16 ) none 0 0 0 1 1
+( 64 64  -0 ) ( -0 64  -0 ) ( 64 64 -16 ) none 0 0 0 1 1
+( 64 64  -0 ) ( 64 64 -16 ) ( 64 -0  -0 ) none 0 0 0 1 1
+( 64 64  -0 ) ( 64 -0  -0 ) ( -0 64  -0 ) none 0 0 0 1 1
+}
+}
+{
+"classname" "info_player_start"
+"origin" "1 22 -3"
+{
+( -0 -0 -16 ) ( -0 -0  -0 ) ( 64 -0 -16 ) none 0 0 0
+}
+}
+)");
+
+            const vm::bbox3 worldBounds(8192);
+
+            IO::TestParserStatus status;
+            WorldReader reader(data);
+            ASSERT_THROW(reader.readInParallel(Model::MapFormat::Standard, worldBounds, status, 1), ParserException);
+        }
+
         /*
         TEST(WorldReaderTest, parseIssueIgnoreFlags) {
             const String data("{"
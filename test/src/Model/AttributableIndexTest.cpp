@@ -31,6 +31,10 @@ namespace TrenchBroom {
             return index.findAttributableNodes(AttributableNodeIndexQuery::exact(name), value);
         }
 
+        static AttributableNodeList findPrefixExact(const AttributableNodeIndex& index, const AttributeName& name, const AttributeValue& value) {
+            return index.findAttributableNodes(AttributableNodeIndexQuery::prefix(name), value);
+        }
+
         static AttributableNodeList findNumberedExact(const AttributableNodeIndex& index, const AttributeName& name, const AttributeValue& value) {
             return index.findAttributableNodes(AttributableNodeIndexQuery::numbered(name), value);
         }
@@ -209,5 +213,38 @@ namespace TrenchBroom {
 
             ASSERT_EQ((StringSet{"somevalue", "somevalue2"}), SetUtils::makeSet(index.allValuesForNames(AttributableNodeIndexQuery::exact("test"))));
         }
+    
+        TEST(EntityAttributeIndexTest, findWithPrefix) {
+            AttributableNodeIndex index;
+
+            Entity* entity1 = new Entity();
+            entity1->addOrUpdateAttribute("test", "somevalue");
+            entity1->addOrUpdateAttribute("testing", "somevalue");
+
+            Entity* entity2 = new Entity();
+            entity2->addOrUpdateAttribute("test2", "somevalue");
+            entity2->addOrUpdateAttribute("other", "somevalue");
+
+            index.addAttributableNode(entity1);
+            index.addAttributableNode(entity2);
+
+            AttributableNodeList attributables = findPrefixExact(index, "test", "somevalue");
+            ASSERT_EQ(2u, attributables.size());
+            ASSERT_TRUE(VectorUtils::contains(attributables, entity1));
+            ASSERT_TRUE(VectorUtils::contains(attributables, entity2));
+
+            ASSERT_EQ(AttributableNodeList({ entity1 }), findPrefixExact(index, "testi", "somevalue"));
+            ASSERT_TRUE(findPrefixExact(index, "test", "othervalue").empty());
+
+            // only the numbered attributes count for numbered queries
+            ASSERT_EQ(AttributableNodeList({ entity2 }), findNumberedExact(index, "test2", "somevalue"));
+
+            index.removeAttribute(entity1, "testing", "somevalue");
+            attributables = findPrefixExact(index, "testi", "somevalue");
+            ASSERT_TRUE(attributables.empty());
+
+            delete entity1;
+            delete entity2;
+        }
     }
 }
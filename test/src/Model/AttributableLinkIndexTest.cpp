@@ -0,0 +1,123 @@
+/*
+ Copyright (C) 2010-2019 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+
+#include "CollectionUtils.h"
+#include "Model/AttributableLinkIndex.h"
+#include "Model/Entity.h"
+#include "Model/EntityAttributes.h"
+
+namespace TrenchBroom {
+    namespace Model {
+        static AttributableNodeList findLinkTargets(const AttributableLinkIndex& index, const AttributeValue& targetname) {
+            AttributableNodeList result;
+            index.findLinkTargets(targetname, result);
+            return result;
+        }
+
+        static AttributableNodeList findLinkSources(const AttributableLinkIndex& index, const AttributeValue& targetname) {
+            AttributableNodeList result;
+            index.findLinkSources(targetname, result);
+            return result;
+        }
+
+        static AttributableNodeList findKillSources(const AttributableLinkIndex& index, const AttributeValue& targetname) {
+            AttributableNodeList result;
+            index.findKillSources(targetname, result);
+            return result;
+        }
+
+        TEST(AttributableLinkIndexTest, isLinkAttribute) {
+            ASSERT_TRUE(AttributableLinkIndex::isLinkAttribute("targetname"));
+            ASSERT_TRUE(AttributableLinkIndex::isLinkAttribute("target"));
+            ASSERT_TRUE(AttributableLinkIndex::isLinkAttribute("target2"));
+            ASSERT_TRUE(AttributableLinkIndex::isLinkAttribute("killtarget"));
+            ASSERT_TRUE(AttributableLinkIndex::isLinkAttribute("killtarget12"));
+            ASSERT_FALSE(AttributableLinkIndex::isLinkAttribute("targetname2"));
+            ASSERT_FALSE(AttributableLinkIndex::isLinkAttribute("targets"));
+            ASSERT_FALSE(AttributableLinkIndex::isLinkAttribute("classname"));
+        }
+
+        TEST(AttributableLinkIndexTest, addAttribute) {
+            AttributableLinkIndex index;
+
+            Entity source;
+            Entity killer;
+            Entity target;
+
+            index.addAttribute(&source, "target", "door");
+            index.addAttribute(&killer, "killtarget", "door");
+            index.addAttribute(&target, "targetname", "door");
+            index.addAttribute(&target, "classname", "func_door");
+
+            ASSERT_EQ(AttributableNodeList({ &target }), findLinkTargets(index, "door"));
+            ASSERT_EQ(AttributableNodeList({ &source }), findLinkSources(index, "door"));
+            ASSERT_EQ(AttributableNodeList({ &killer }), findKillSources(index, "door"));
+
+            ASSERT_TRUE(findLinkTargets(index, "func_door").empty());
+            ASSERT_TRUE(findLinkSources(index, "func_door").empty());
+            ASSERT_TRUE(findLinkTargets(index, "light").empty());
+        }
+
+        TEST(AttributableLinkIndexTest, addNumberedAttributesWithSameValue) {
+            AttributableLinkIndex index;
+
+            Entity source;
+            index.addAttribute(&source, "target", "door");
+            index.addAttribute(&source, "target2", "door");
+
+            // every node is only found once
+            ASSERT_EQ(AttributableNodeList({ &source }), findLinkSources(index, "door"));
+
+            // the node is still found as long as one of its attributes has the value
+            index.removeAttribute(&source, "target", "door");
+            ASSERT_EQ(AttributableNodeList({ &source }), findLinkSources(index, "door"));
+
+            index.removeAttribute(&source, "target2", "door");
+            ASSERT_TRUE(findLinkSources(index, "door").empty());
+        }
+
+        TEST(AttributableLinkIndexTest, removeAttribute) {
+            AttributableLinkIndex index;
+
+            Entity target1;
+            Entity target2;
+            index.addAttribute(&target1, "targetname", "door");
+            index.addAttribute(&target2, "targetname", "door");
+
+            AttributableNodeList targets = findLinkTargets(index, "door");
+            VectorUtils::sort(targets);
+            AttributableNodeList expected({ &target1, &target2 });
+            VectorUtils::sort(expected);
+            ASSERT_EQ(expected, targets);
+
+            index.removeAttribute(&target1, "targetname", "door");
+            ASSERT_EQ(AttributableNodeList({ &target2 }), findLinkTargets(index, "door"));
+
+            // removing an attribute that is not indexed does nothing
+            index.removeAttribute(&target1, "targetname", "door");
+            index.removeAttribute(&target1, "targetname", "light");
+            ASSERT_EQ(AttributableNodeList({ &target2 }), findLinkTargets(index, "door"));
+
+            index.removeAttribute(&target2, "targetname", "door");
+            ASSERT_TRUE(findLinkTargets(index, "door").empty());
+        }
+    }
+}
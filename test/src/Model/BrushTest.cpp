@@ -29,6 +29,7 @@
 #include "Model/BrushFace.h"
 #include "Model/BrushSnapshot.h"
 #include "Model/Hit.h"
+#include "Model/Layer.h"
 #include "Model/MapFormat.h"
 #include "Model/ModelFactoryImpl.h"
 #include "Model/PickResult.h"
@@ -3380,6 +3381,82 @@ namespace TrenchBroom {
             delete cube;
         }
 
+        static void assertSnapshotRestoresFaces(const MapFormat format) {
+            const vm::bbox3 worldBounds(8192.0);
+            World world(format, worldBounds);
+            const BrushBuilder builder(&world, worldBounds);
+
+            Brush* cube = builder.createCube(128.0, "texture");
+            BrushFace* top = cube->findFace(vm::vec3::pos_z);
+            top->setXOffset(12.0f);
+            top->setRotation(30.0f);
+            top->setSurfaceFlags(4);
+            top->select();
+            top->setFilePosition(7, 3);
+
+            struct FaceState {
+                vm::vec3 points[3];
+                BrushFaceAttributes attribs;
+                vm::vec3 xAxis;
+                vm::vec3 yAxis;
+                bool selected;
+                size_t lineNumber;
+                size_t lineCount;
+            };
+
+            std::vector<FaceState> expected;
+            for (const BrushFace* face : cube->faces()) {
+                const BrushFace::Points& points = face->points();
+                expected.push_back(FaceState{
+                    { points[0], points[1], points[2] },
+                    face->attribs(),
+                    face->textureXAxis(),
+                    face->textureYAxis(),
+                    face->selected(),
+                    face->lineNumber(),
+                    face->lineCount()
+                });
+            }
+
+            std::unique_ptr<NodeSnapshot> snapshot(cube->takeSnapshot());
+            ASSERT_NE(nullptr, snapshot);
+            ASSERT_LT(0u, snapshot->memorySize());
+
+            cube->transform(vm::rotationMatrix(vm::vec3::pos_z, vm::toRadians(15.0)) * vm::translationMatrix(vm::vec3(32, 16, 8)), true, worldBounds);
+            ASSERT_NE(expected[0].points[0], cube->faces()[0]->points()[0]);
+
+            snapshot->restore(worldBounds);
+
+            const BrushFaceList& faces = cube->faces();
+            ASSERT_EQ(expected.size(), faces.size());
+            for (size_t i = 0; i < faces.size(); ++i) {
+                const BrushFace* face = faces[i];
+                const FaceState& state = expected[i];
+                for (size_t j = 0; j < 3; ++j)
+                    ASSERT_EQ(state.points[j], face->points()[j]);
+                ASSERT_EQ(state.attribs.textureName(), face->attribs().textureName());
+                ASSERT_EQ(state.attribs.offset(), face->attribs().offset());
+                ASSERT_EQ(state.attribs.scale(), face->attribs().scale());
+                ASSERT_FLOAT_EQ(state.attribs.rotation(), face->attribs().rotation());
+                ASSERT_EQ(state.attribs.surfaceFlags(), face->attribs().surfaceFlags());
+                ASSERT_VEC_EQ(state.xAxis, face->textureXAxis());
+                ASSERT_VEC_EQ(state.yAxis, face->textureYAxis());
+                ASSERT_EQ(state.selected, face->selected());
+                ASSERT_EQ(state.lineNumber, face->lineNumber());
+                ASSERT_EQ(state.lineCount, face->lineCount());
+            }
+
+            delete cube;
+        }
+
+        TEST(BrushTest, snapshotRestoresParaxialFaces) {
+            assertSnapshotRestoresFaces(MapFormat::Standard);
+        }
+
+        TEST(BrushTest, snapshotRestoresParallelFaces) {
+            assertSnapshotRestoresFaces(MapFormat::Valve);
+        }
+
         TEST(BrushTest, resizePastWorldBounds) {
             const vm::bbox3 worldBounds(8192.0);
             World world(MapFormat::Standard, worldBounds);
@@ -3872,6 +3949,87 @@ namespace TrenchBroom {
             ASSERT_NO_THROW(reader.read(worldBounds, status));
         }
 
+        TEST(BrushTest, transformBrushes) {
+            const vm::bbox3 worldBounds(8192.0);
+            World world(MapFormat::Standard, worldBounds);
+            const BrushBuilder builder(&world, worldBounds);
+
+            BrushList brushes;
+            BrushList expected;
+            for (size_t i = 0; i < 16; ++i) {
+                const auto min = vm::vec3(static_cast<FloatType>(i) * 64.0, 0.0, 0.0);
+                auto* brush = builder.createCuboid(vm::bbox3(min, min + vm::vec3(32.0, 32.0, 32.0)), "texture");
+                world.defaultLayer()->addChild(brush);
+                brushes.push_back(brush);
+                expected.push_back(brush->clone(worldBounds));
+            }
+
+            const auto transformation = vm::translationMatrix(vm::vec3(16.0, 8.0, 0.0)) * vm::rotationMatrix(vm::vec3::pos_z, vm::toRadians(30.0));
+            for (auto* brush : expected) {
+                brush->transform(transformation, true, worldBounds);
+            }
+
+            ASSERT_TRUE(Brush::canTransform(brushes, transformation, worldBounds));
+            Brush::transform(brushes, transformation, true, worldBounds);
+
+            for (size_t i = 0; i < brushes.size(); ++i) {
+                ASSERT_EQ(expected[i]->bounds(), brushes[i]->bounds());
+                ASSERT_EQ(expected[i]->vertexPositions(), brushes[i]->vertexPositions());
+                for (size_t j = 0; j < brushes[i]->faceCount(); ++j) {
+                    const auto* expectedFace = expected[i]->faces()[j];
+                    const auto* actualFace = brushes[i]->faces()[j];
+                    ASSERT_EQ(expectedFace->boundary(), actualFace->boundary());
+                    ASSERT_EQ(expectedFace->offset(), actualFace->offset());
+                    ASSERT_EQ(expectedFace->rotation(), actualFace->rotation());
+                }
+
+                // the node tree must have been updated with the new bounds
+                PickResult hits;
+                world.pick(vm::ray3(brushes[i]->bounds().center() + vm::vec3(0.0, 0.0, 128.0), vm::vec3::neg_z), hits);
+                ASSERT_EQ(1u, hits.size());
+                ASSERT_EQ(brushes[i], hits.all().front().target<BrushFace*>()->brush());
+            }
+
+            VectorUtils::clearAndDelete(expected);
+        }
+
+        TEST(BrushTest, rebuildBrushGeometries) {
+            const vm::bbox3 worldBounds(8192.0);
+            World world(MapFormat::Standard, worldBounds);
+            const BrushBuilder builder(&world, worldBounds);
+
+            BrushList brushes;
+            for (size_t i = 0; i < 8; ++i) {
+                const auto min = vm::vec3(static_cast<FloatType>(i) * 64.0, 0.0, 0.0);
+                auto* brush = builder.createCuboid(vm::bbox3(min, min + vm::vec3(32.0, 32.0, 32.0)), "texture");
+                world.defaultLayer()->addChild(brush);
+                brushes.push_back(brush);
+            }
+
+            const auto expectedBounds = brushes.front()->bounds();
+            Brush::rebuildGeometry(brushes, worldBounds);
+            ASSERT_EQ(expectedBounds, brushes.front()->bounds());
+            for (const auto* brush : brushes) {
+                ASSERT_TRUE(brush->fullySpecified());
+                ASSERT_EQ(8u, brush->vertexCount());
+            }
+        }
+
+        TEST(BrushTest, cannotTransformBrushesToDegenerateBrushes) {
+            const vm::bbox3 worldBounds(8192.0);
+            World world(MapFormat::Standard, worldBounds);
+            const BrushBuilder builder(&world, worldBounds);
+
+            BrushList brushes;
+            brushes.push_back(builder.createCube(32.0, "texture"));
+            brushes.push_back(builder.createCube(64.0, "texture"));
+
+            ASSERT_TRUE(Brush::canTransform(brushes, vm::scalingMatrix(vm::vec3(2.0, 2.0, 2.0)), worldBounds));
+            ASSERT_FALSE(Brush::canTransform(brushes, vm::scalingMatrix(vm::vec3(1.0, 1.0, 0.0)), worldBounds));
+
+            VectorUtils::clearAndDelete(brushes);
+        }
+
         std::vector<vm::vec3> asVertexList(const std::vector<vm::segment3>& edges) {
             std::vector<vm::vec3> result;
             vm::segment3::getVertices(std::begin(edges), std::end(edges), std::back_inserter(result));
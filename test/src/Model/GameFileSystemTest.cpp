@@ -0,0 +1,280 @@
+/*
+ Copyright (C) 2010-2019 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+
+#include "Logger.h"
+#include "IO/DiskIO.h"
+#include "IO/File.h"
+#include "IO/FileMatcher.h"
+#include "IO/Path.h"
+#include "IO/Reader.h"
+#include "IO/TestEnvironment.h"
+#include "Model/GameConfig.h"
+#include "Model/GameFileSystem.h"
+
+#include <algorithm>
+#include <fstream>
+
+#ifndef _WIN32
+#include <unistd.h>
+#endif
+#include <utility>
+#include <vector>
+
+namespace TrenchBroom {
+    namespace Model {
+        using PakEntries = std::vector<std::pair<String, String>>;
+
+        class GameFSTestEnvironment : public IO::TestEnvironment {
+        public:
+            explicit GameFSTestEnvironment(const String& dir = "gamefstest") :
+            TestEnvironment(dir) {
+                createTestEnvironment();
+            }
+        private:
+            void doCreateTestEnvironment() override {
+                createDirectory(IO::Path("id1"));
+                createDirectory(IO::Path("id1/gfx"));
+                createFile(IO::Path("id1/loose.txt"), "id1");
+                createFile(IO::Path("id1/gfx/palette.lmp"), "id1");
+                createPak(IO::Path("id1/pak0.pak"), {
+                    { "gfx/palette.lmp", "id1/pak0" },
+                    { "maps/start.bsp", "id1/pak0" },
+                    { "progs/player.mdl", "id1/pak0" }
+                });
+                createPak(IO::Path("id1/pak1.pak"), {
+                    { "maps/start.bsp", "id1/pak1" },
+                    { "sound/misc.wav", "id1/pak1" }
+                });
+
+                createDirectory(IO::Path("mod"));
+                createDirectory(IO::Path("mod/progs"));
+                createFile(IO::Path("mod/progs/player.mdl"), "mod");
+                createPak(IO::Path("mod/pak0.pak"), {
+                    { "maps/e1m1.bsp", "mod/pak0" }
+                });
+            }
+
+            void createPak(const IO::Path& path, const PakEntries& entries) {
+                // header, followed by the file contents and the directory
+                String data = "PACK" + String(8, '\0');
+                String directory;
+                for (const auto& [name, contents] : entries) {
+                    auto entry = name;
+                    entry.resize(56, '\0');
+                    appendInt(entry, data.size());
+                    appendInt(entry, contents.size());
+                    directory += entry;
+                    data += contents;
+                }
+
+                const auto directoryAddress = data.size();
+                data += directory;
+                data.replace(4, 4, intBytes(directoryAddress));
+                data.replace(8, 4, intBytes(directory.size()));
+
+                std::ofstream stream((dir() + path).asString(), std::ios::binary);
+                stream << data;
+            }
+
+            static void appendInt(String& str, const size_t value) {
+                str += intBytes(value);
+            }
+
+            static String intBytes(const size_t value) {
+                String result;
+                for (size_t i = 0; i < 4; ++i) {
+                    result.push_back(static_cast<char>((value >> (8 * i)) & 0xFF));
+                }
+                return result;
+            }
+        };
+
+        static GameConfig makeGameConfig() {
+            return GameConfig(
+                "Test",
+                IO::Path(),
+                IO::Path(),
+                false,
+                GameConfig::MapFormatConfig::List(),
+                GameConfig::FileSystemConfig(IO::Path("id1"), GameConfig::PackageFormatConfig("pak", "idpak")),
+                GameConfig::TextureConfig(),
+                GameConfig::EntityConfig(),
+                GameConfig::FaceAttribsConfig(),
+                std::vector<SmartTag>());
+        }
+
+        static String readFile(const GameFileSystem& fs, const IO::Path& path) {
+            const auto file = fs.openFile(path);
+            auto reader = file->reader();
+            return reader.readString(reader.size());
+        }
+
+        TEST(GameFileSystemTest, filesFollowPrecedence) {
+            GameFSTestEnvironment env;
+            NullLogger logger;
+
+            GameFileSystem fs;
+            fs.initialize(makeGameConfig(), env.dir(), { IO::Path("mod") }, logger);
+
+            // packages override loose files, later packages override earlier ones, and mods override the game
+            ASSERT_EQ("id1", readFile(fs, IO::Path("loose.txt")));
+            ASSERT_EQ("id1/pak0", readFile(fs, IO::Path("gfx/palette.lmp")));
+            ASSERT_EQ("id1/pak1", readFile(fs, IO::Path("maps/start.bsp")));
+            ASSERT_EQ("id1/pak1", readFile(fs, IO::Path("sound/misc.wav")));
+            ASSERT_EQ("mod", readFile(fs, IO::Path("progs/player.mdl")));
+            ASSERT_EQ("mod/pak0", readFile(fs, IO::Path("maps/e1m1.bsp")));
+
+            // lookups ignore the case
+            ASSERT_TRUE(fs.fileExists(IO::Path("MAPS/Start.bsp")));
+            ASSERT_EQ("id1/pak1", readFile(fs, IO::Path("MAPS/Start.bsp")));
+            ASSERT_TRUE(fs.directoryExists(IO::Path("Sound")));
+
+            ASSERT_FALSE(fs.fileExists(IO::Path("maps/e1m2.bsp")));
+            ASSERT_FALSE(fs.fileExists(IO::Path("maps")));
+            ASSERT_FALSE(fs.directoryExists(IO::Path("maps/start.bsp")));
+            ASSERT_THROW(fs.openFile(IO::Path("maps/e1m2.bsp")), FileSystemException);
+
+            ASSERT_EQ(env.dir() + IO::Path("id1/loose.txt"), fs.makeAbsolute(IO::Path("loose.txt")));
+            ASSERT_EQ(env.dir() + IO::Path("mod/progs/player.mdl"), fs.makeAbsolute(IO::Path("progs/player.mdl")));
+        }
+
+        TEST(GameFileSystemTest, findItems) {
+            GameFSTestEnvironment env;
+            NullLogger logger;
+
+            GameFileSystem fs;
+            fs.initialize(makeGameConfig(), env.dir(), { IO::Path("mod") }, logger);
+
+            ASSERT_EQ(IO::Path::List({ IO::Path("maps/e1m1.bsp"), IO::Path("maps/start.bsp") }), fs.findItems(IO::Path("maps")));
+            ASSERT_EQ(IO::Path::List({ IO::Path("gfx/palette.lmp") }), fs.findItems(IO::Path("gfx")));
+            ASSERT_EQ(IO::Path::List({ IO::Path("maps/e1m1.bsp"), IO::Path("maps/start.bsp") }), fs.findItemsRecursively(IO::Path(""), IO::FileExtensionMatcher("bsp")));
+
+            // every directory is listed once, even if several file systems contain it
+            const auto contents = fs.getDirectoryContents(IO::Path(""));
+            ASSERT_EQ(1, std::count(std::begin(contents), std::end(contents), IO::Path("maps")));
+            ASSERT_EQ(1, std::count(std::begin(contents), std::end(contents), IO::Path("progs")));
+            ASSERT_EQ(1, std::count(std::begin(contents), std::end(contents), IO::Path("pak0.pak")));
+        }
+
+        TEST(GameFileSystemTest, indexQuake3Shaders) {
+            const auto config = GameConfig(
+                "Quake3",
+                IO::Path(),
+                IO::Path(),
+                false,
+                GameConfig::MapFormatConfig::List(),
+                GameConfig::FileSystemConfig(IO::Path("baseq3"), GameConfig::PackageFormatConfig("pk3", "zip")),
+                GameConfig::TextureConfig(
+                    GameConfig::TexturePackageConfig(IO::Path("textures")),
+                    GameConfig::PackageFormatConfig("", "q3shader"),
+                    IO::Path(),
+                    "_tb_textures",
+                    IO::Path("scripts")),
+                GameConfig::EntityConfig(),
+                GameConfig::FaceAttribsConfig(),
+                std::vector<SmartTag>());
+
+            const auto gamePath = IO::Disk::getCurrentWorkingDir() + IO::Path("fixture/test/Model/Game/Quake3");
+            NullLogger logger;
+
+            GameFileSystem fs;
+            fs.initialize(config, gamePath, {}, logger);
+
+            // the shaders are virtual files without an extension
+            ASSERT_TRUE(fs.fileExists(IO::Path("textures/test/not_existing")));
+            ASSERT_TRUE(fs.fileExists(IO::Path("textures/test/test.tga")));
+
+            const auto items = fs.findItems(IO::Path("textures/test"));
+            ASSERT_EQ(1, std::count(std::begin(items), std::end(items), IO::Path("textures/test/not_existing")));
+            ASSERT_EQ(1, std::count(std::begin(items), std::end(items), IO::Path("textures/test/editor_image.jpg")));
+
+            fs.reload();
+            ASSERT_TRUE(fs.fileExists(IO::Path("textures/test/not_existing")));
+            ASSERT_EQ(items, fs.findItems(IO::Path("textures/test")));
+        }
+
+        TEST(GameFileSystemTest, rebuildIndexOnInitialize) {
+            GameFSTestEnvironment env;
+            NullLogger logger;
+
+            GameFileSystem fs;
+            fs.initialize(makeGameConfig(), env.dir(), { IO::Path("mod") }, logger);
+            ASSERT_TRUE(fs.fileExists(IO::Path("maps/e1m1.bsp")));
+
+            fs.initialize(makeGameConfig(), env.dir(), {}, logger);
+            ASSERT_FALSE(fs.fileExists(IO::Path("maps/e1m1.bsp")));
+            ASSERT_EQ("id1/pak0", readFile(fs, IO::Path("progs/player.mdl")));
+
+            fs.initialize(makeGameConfig(), IO::Path(), {}, logger);
+            ASSERT_FALSE(fs.fileExists(IO::Path("maps/start.bsp")));
+            ASSERT_FALSE(fs.directoryExists(IO::Path("")));
+        }
+
+        TEST(GameFileSystemTest, rebuildIndexOnReload) {
+            GameFSTestEnvironment env;
+            NullLogger logger;
+
+            GameFileSystem fs;
+            fs.initialize(makeGameConfig(), env.dir(), {}, logger);
+            ASSERT_FALSE(fs.fileExists(IO::Path("gfx/colormap.lmp")));
+
+            std::ofstream((env.dir() + IO::Path("id1/gfx/colormap.lmp")).asString()) << "id1";
+            ASSERT_FALSE(fs.fileExists(IO::Path("gfx/colormap.lmp")));
+
+            fs.reload();
+            ASSERT_TRUE(fs.fileExists(IO::Path("gfx/colormap.lmp")));
+            ASSERT_EQ("id1", readFile(fs, IO::Path("gfx/colormap.lmp")));
+        }
+
+#ifndef _WIN32
+        // removes the link before the test environment is deleted, which would otherwise follow it
+        class SymbolicLink {
+        private:
+            String m_path;
+        public:
+            SymbolicLink(const String& target, const IO::Path& path) :
+            m_path(path.asString()) {
+                assertResult(::symlink(target.c_str(), m_path.c_str()) == 0);
+            }
+
+            ~SymbolicLink() {
+                ::unlink(m_path.c_str());
+            }
+        };
+
+        TEST(GameFileSystemTest, skipSymbolicLinkCycles) {
+            GameFSTestEnvironment env;
+            SymbolicLink link("..", env.dir() + IO::Path("id1/gfx/loop"));
+            NullLogger logger;
+
+            GameFileSystem fs;
+            fs.initialize(makeGameConfig(), env.dir(), {}, logger);
+
+            // the link is indexed, but the walk does not follow it back into its ancestor
+            ASSERT_TRUE(fs.directoryExists(IO::Path("gfx/loop")));
+            ASSERT_TRUE(fs.getDirectoryContents(IO::Path("gfx/loop")).empty());
+            ASSERT_FALSE(fs.fileExists(IO::Path("gfx/loop/loose.txt")));
+            ASSERT_EQ("id1", readFile(fs, IO::Path("loose.txt")));
+            ASSERT_EQ("id1/pak1", readFile(fs, IO::Path("sound/misc.wav")));
+        }
+#endif
+    }
+}
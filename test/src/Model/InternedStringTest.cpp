@@ -0,0 +1,97 @@
+/*
+ Copyright (C) 2010-2019 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+
+#include "Model/EntityAttributes.h"
+#include "Model/InternedString.h"
+
+namespace TrenchBroom {
+    namespace Model {
+        TEST(InternedStringTest, equalStringsShareEntry) {
+            const InternedString a("interned_test_classname");
+            const InternedString b(String("interned_test_") + "classname");
+            const InternedString c("interned_test_other");
+
+            ASSERT_EQ(a, b);
+            ASSERT_EQ(&a.str(), &b.str());
+            ASSERT_EQ(a.hash(), b.hash());
+            ASSERT_NE(a, c);
+            ASSERT_EQ(String("interned_test_classname"), a.str());
+            ASSERT_TRUE(a == String("interned_test_classname"));
+            ASSERT_TRUE(a != String("interned_test_other"));
+        }
+
+        TEST(InternedStringTest, emptyString) {
+            const InternedString a;
+            const InternedString b("");
+
+            ASSERT_TRUE(a.empty());
+            ASSERT_EQ(a, b);
+            ASSERT_EQ(EmptyString, a.str());
+
+            InternedString found("dummy");
+            ASSERT_TRUE(InternedString::find("", found));
+            ASSERT_TRUE(found.empty());
+        }
+
+        TEST(InternedStringTest, releaseLastHandle) {
+            const size_t poolSize = InternedString::poolSize();
+
+            InternedString found;
+            ASSERT_FALSE(InternedString::find("interned_test_release", found));
+
+            {
+                const InternedString a("interned_test_release");
+                InternedString b = a;
+                ASSERT_EQ(poolSize + 1, InternedString::poolSize());
+
+                ASSERT_TRUE(InternedString::find("interned_test_release", found));
+                ASSERT_EQ(a, found);
+
+                const InternedString c(std::move(b));
+                ASSERT_TRUE(b.empty());
+                ASSERT_EQ(a, c);
+            }
+
+            // the found handle keeps the string alive
+            ASSERT_EQ(poolSize + 1, InternedString::poolSize());
+            ASSERT_EQ(String("interned_test_release"), found.str());
+
+            found = InternedString();
+            ASSERT_EQ(poolSize, InternedString::poolSize());
+            ASSERT_FALSE(InternedString::find("interned_test_release", found));
+        }
+
+        TEST(InternedStringTest, attributesShareNamesAndValues) {
+            const EntityAttribute a("interned_test_name", "interned_test_value");
+            const EntityAttribute b("interned_test_name", "interned_test_value");
+
+            ASSERT_EQ(&a.name(), &b.name());
+            ASSERT_EQ(&a.value(), &b.value());
+            ASSERT_EQ(0, a.compare(b));
+
+            EntityAttribute c = a;
+            c.setValue("interned_test_other_value");
+            ASSERT_EQ(&a.name(), &c.name());
+            ASSERT_NE(a.internedValue(), c.internedValue());
+            ASSERT_TRUE(c < a);
+        }
+    }
+}
@@ -19,10 +19,15 @@
 
 #include <gtest/gtest.h>
 
+#include "Assets/Texture.h"
 #include "Model/Tag.h"
 #include "Model/TagManager.h"
+#include "Model/TagMatcher.h"
 #include "Model/Brush.h"
 #include "Model/BrushBuilder.h"
+#include "Model/BrushFace.h"
+#include "Model/Entity.h"
+#include "Model/EntityAttributes.h"
 #include "Model/Layer.h"
 #include "Model/MapFormat.h"
 #include "Model/World.h"
@@ -59,5 +64,83 @@ namespace TrenchBroom {
             ASSERT_FALSE(brush->hasTag(tag1));
             ASSERT_FALSE(brush->hasTag(tag2));
         }
+
+        TEST(TaggingTest, updateSmartTags) {
+            const vm::bbox3 worldBounds{4096.0};
+            World world{MapFormat::Quake2, worldBounds};
+
+            TagManager tagManager;
+            tagManager.registerSmartTag(SmartTag{"clip", {}, std::make_unique<TextureNameTagMatcher>("clip")});
+            tagManager.registerSmartTag(SmartTag{"detail", {}, std::make_unique<ContentFlagsTagMatcher>(1 << 27)});
+            tagManager.registerSmartTag(SmartTag{"trigger", {}, std::make_unique<EntityClassNameTagMatcher>("trigger*", "")});
+
+            const auto& clipTag = tagManager.smartTag("clip");
+            const auto& detailTag = tagManager.smartTag("detail");
+            const auto& triggerTag = tagManager.smartTag("trigger");
+
+            BrushBuilder builder{&world, worldBounds};
+            Brush* brush1 = builder.createCube(64.0, "clip", "clip", "other", "other", "common/clip", "other");
+            Brush* brush2 = builder.createCube(64.0, "clip", "clip", "other", "other", "common/clip", "other");
+
+            auto* entity = world.createEntity();
+            entity->addOrUpdateAttribute(AttributeNames::Classname, "trigger_once");
+            world.defaultLayer()->addChild(entity);
+            entity->addChild(brush1);
+            world.defaultLayer()->addChild(brush2);
+
+            Brush::initializeTags(BrushList{ brush1, brush2 }, tagManager);
+
+            ASSERT_TRUE(brush1->hasTag(triggerTag));
+            ASSERT_FALSE(brush2->hasTag(triggerTag));
+
+            for (const auto* brush : { brush1, brush2 }) {
+                for (const auto* face : brush->faces()) {
+                    ASSERT_EQ(face->textureName() != "other", face->hasTag(clipTag));
+                    ASSERT_FALSE(face->hasTag(detailTag));
+                }
+            }
+
+            // faces with the same properties share the cached tags, but a change must still be picked up
+            auto* face = brush2->faces().front();
+            face->setSurfaceContents(1 << 27);
+            face->updateTags(tagManager);
+            ASSERT_TRUE(face->hasTag(detailTag));
+
+            face->setSurfaceContents(0);
+            face->updateTags(tagManager);
+            ASSERT_FALSE(face->hasTag(detailTag));
+
+            entity->addOrUpdateAttribute(AttributeNames::Classname, "func_wall");
+            brush1->updateTags(tagManager);
+            ASSERT_FALSE(brush1->hasTag(triggerTag));
+        }
+
+        TEST(TaggingTest, clearTagCacheWhenTexturesChange) {
+            const vm::bbox3 worldBounds{4096.0};
+            World world{MapFormat::Quake3, worldBounds};
+
+            TagManager tagManager;
+            tagManager.registerSmartTag(SmartTag{"sky", {}, std::make_unique<SurfaceParmTagMatcher>("sky")});
+            const auto& skyTag = tagManager.smartTag("sky");
+
+            Assets::Texture texture{"sky1", 64, 64};
+            texture.setSurfaceParms({ "sky" });
+
+            BrushBuilder builder{&world, worldBounds};
+            Brush* brush = builder.createCube(64.0, "sky1");
+            world.defaultLayer()->addChild(brush);
+
+            auto* face = brush->faces().front();
+            face->setTexture(&texture);
+            face->updateTags(tagManager);
+            ASSERT_TRUE(face->hasTag(skyTag));
+
+            texture.setSurfaceParms({});
+            tagManager.clearTagCache();
+            face->updateTags(tagManager);
+            ASSERT_FALSE(face->hasTag(skyTag));
+
+            face->unsetTexture();
+        }
     }
 }
@@ -23,6 +23,7 @@
 #include "IO/BrushFaceReader.h"
 #include "IO/DiskFileSystem.h"
 #include "IO/IOUtils.h"
+#include "IO/MapSnapshot.h"
 #include "IO/NodeReader.h"
 #include "IO/NodeWriter.h"
 #include "IO/TestParserStatus.h"
@@ -84,6 +85,15 @@ namespace TrenchBroom {
             writer.writeMap();
         }
 
+        void TestGame::doWriteMapSnapshot(const IO::MapSnapshot& snapshot, const IO::Path& path) const {
+            const auto mapFormatName = formatName(snapshot.format());
+
+            IO::OpenFile open(path, true);
+            IO::writeGameComment(open.file, gameName(), mapFormatName);
+
+            snapshot.write(open.file);
+        }
+
         void TestGame::doExportMap(World& world, Model::ExportFormat format, const IO::Path& path) const {}
 
         NodeList TestGame::doParseNodes(const String& str, World& world, const vm::bbox3& worldBounds, Logger& logger) const {
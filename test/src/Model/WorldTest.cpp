@@ -0,0 +1,239 @@
+/*
+ Copyright (C) 2010-2019 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+
+#include "CollectionUtils.h"
+#include "Model/Brush.h"
+#include "Model/Layer.h"
+#include "Model/BrushBuilder.h"
+#include "Model/EditorContext.h"
+#include "Model/Entity.h"
+#include "Model/EmptyAttributeValueIssueGenerator.h"
+#include "Model/HitAdapter.h"
+#include "Model/HitFilter.h"
+#include "Model/HitQuery.h"
+#include "Model/Issue.h"
+#include "Model/MapFormat.h"
+#include "Model/NonIntegerVerticesIssueGenerator.h"
+#include "Model/PickResult.h"
+#include "Model/World.h"
+
+#include <vecmath/mat_ext.h>
+#include <vecmath/ray.h>
+#include <vecmath/vec.h>
+
+#include <limits>
+
+namespace TrenchBroom {
+    namespace Model {
+        static size_t pickCount(const World& world, const vm::ray3& ray) {
+            PickResult result;
+            world.pick(ray, result);
+            return result.size();
+        }
+
+        static size_t containingCount(World& world, const vm::vec3& point) {
+            NodeList result;
+            world.findNodesContaining(point, result);
+            return result.size();
+        }
+
+        TEST(WorldTest, pickAfterChanges) {
+            const vm::bbox3 worldBounds(4096.0);
+            World world(MapFormat::Standard, worldBounds);
+
+            BrushBuilder builder(&world, worldBounds);
+            Brush* brush = builder.createCube(64.0, "texture");
+            world.defaultLayer()->addChild(brush);
+
+            const vm::ray3 ray1(vm::vec3(0.0, -128.0, 0.0), vm::vec3::pos_y);
+            const vm::ray3 ray2(vm::vec3(256.0, -128.0, 0.0), vm::vec3::pos_y);
+
+            // repeated queries without changes in between use a flattened copy of the node tree
+            for (size_t i = 0; i < 3; ++i) {
+                ASSERT_EQ(1u, pickCount(world, ray1));
+                ASSERT_EQ(0u, pickCount(world, ray2));
+                ASSERT_EQ(1u, containingCount(world, vm::vec3::zero));
+            }
+
+            brush->transform(vm::translationMatrix(vm::vec3(256.0, 0.0, 0.0)), false, worldBounds);
+            for (size_t i = 0; i < 3; ++i) {
+                ASSERT_EQ(0u, pickCount(world, ray1));
+                ASSERT_EQ(1u, pickCount(world, ray2));
+                ASSERT_EQ(0u, containingCount(world, vm::vec3::zero));
+                ASSERT_EQ(1u, containingCount(world, vm::vec3(256.0, 0.0, 0.0)));
+            }
+
+            world.defaultLayer()->removeChild(brush);
+            delete brush;
+
+            for (size_t i = 0; i < 3; ++i) {
+                ASSERT_EQ(0u, pickCount(world, ray1));
+                ASSERT_EQ(0u, pickCount(world, ray2));
+            }
+        }
+    
+        TEST(WorldTest, pickAfterBatchedChanges) {
+            const vm::bbox3 worldBounds(4096.0);
+            World world(MapFormat::Standard, worldBounds);
+
+            BrushBuilder builder(&world, worldBounds);
+            Brush* brush1 = builder.createCube(64.0, "texture");
+            Brush* brush2 = builder.createCube(64.0, "texture");
+            world.defaultLayer()->addChild(brush1);
+            world.defaultLayer()->addChild(brush2);
+
+            const vm::ray3 ray1(vm::vec3(0.0, -128.0, 0.0), vm::vec3::pos_y);
+            const vm::ray3 ray2(vm::vec3(512.0, -128.0, 0.0), vm::vec3::pos_y);
+            ASSERT_EQ(2u, pickCount(world, ray1));
+
+            // the bounds of the brushes change several times before the node tree is queried again
+            for (size_t i = 0; i < 4; ++i) {
+                brush1->transform(vm::translationMatrix(vm::vec3(128.0, 0.0, 0.0)), false, worldBounds);
+                brush2->transform(vm::translationMatrix(vm::vec3(4.0, 0.0, 0.0)), false, worldBounds);
+            }
+            ASSERT_EQ(1u, pickCount(world, ray1));
+            ASSERT_EQ(1u, pickCount(world, ray2));
+            ASSERT_EQ(1u, containingCount(world, vm::vec3(512.0, 0.0, 0.0)));
+
+            // a node with a pending change can be removed
+            brush1->transform(vm::translationMatrix(vm::vec3(-512.0, 0.0, 0.0)), false, worldBounds);
+            world.defaultLayer()->removeChild(brush1);
+            delete brush1;
+
+            ASSERT_EQ(1u, pickCount(world, ray1));
+            ASSERT_EQ(0u, pickCount(world, ray2));
+        }
+
+        static HitFilter* nearestBrushFilter(const EditorContext& editorContext) {
+            // the same as a pickable brush hit query, which also skips hidden nodes
+            return new HitFilterChain(new VisibleHitFilter(editorContext),
+                                      new HitFilterChain(new ContextHitFilter(editorContext), new TypedHitFilter(Brush::BrushHit)));
+        }
+
+        TEST(WorldTest, pickNearestHits) {
+            const vm::bbox3 worldBounds(4096.0);
+            World world(MapFormat::Standard, worldBounds);
+            const EditorContext editorContext;
+
+            // a row of cubes along the y axis
+            BrushBuilder builder(&world, worldBounds);
+            BrushList brushes;
+            for (size_t i = 0; i < 16; ++i) {
+                Brush* brush = builder.createCube(64.0, "texture");
+                brush->transform(vm::translationMatrix(vm::vec3(0.0, static_cast<FloatType>(i) * 128.0, 0.0)), false, worldBounds);
+                world.defaultLayer()->addChild(brush);
+                brushes.push_back(brush);
+            }
+
+            const vm::ray3 ray(vm::vec3(0.0, -128.0, 0.0), vm::vec3::pos_y);
+
+            // repeated queries without changes in between use a flattened copy of the node tree
+            for (size_t i = 0; i < 3; ++i) {
+                auto allHits = PickResult::byDistance(editorContext);
+                world.pick(ray, allHits);
+                ASSERT_EQ(brushes.size(), allHits.size());
+                ASSERT_EQ(std::numeric_limits<FloatType>::max(), allHits.maxHitDistance());
+
+                auto nearestHits = PickResult::byDistance(editorContext, 2, new TypedHitFilter(Brush::BrushHit));
+                world.pick(ray, nearestHits);
+                ASSERT_EQ(2u, nearestHits.size());
+                ASSERT_EQ(2u, nearestHits.maxHits());
+                ASSERT_EQ(brushes[0], hitToBrush(nearestHits.all().front()));
+                ASSERT_EQ(brushes[1], hitToBrush(nearestHits.all().back()));
+                ASSERT_DOUBLE_EQ(224.0, nearestHits.maxHitDistance());
+
+                const auto& expected = allHits.query().pickable().type(Brush::BrushHit).first();
+                auto nearestHit = PickResult::byDistance(editorContext, 1, nearestBrushFilter(editorContext));
+                world.pick(ray, nearestHit);
+                const auto& actual = nearestHit.query().pickable().type(Brush::BrushHit).first();
+                ASSERT_TRUE(actual.isMatch());
+                ASSERT_EQ(hitToFace(expected), hitToFace(actual));
+                ASSERT_DOUBLE_EQ(expected.distance(), actual.distance());
+            }
+
+            // hits of other types do not take the place of the nearest brush hit
+            auto* entity = new Entity();
+            entity->addOrUpdateAttribute("origin", "0 -96 0");
+            world.defaultLayer()->addChild(entity);
+
+            auto nearestBrushHit = PickResult::byDistance(editorContext, 1, nearestBrushFilter(editorContext));
+            world.pick(ray, nearestBrushHit);
+            ASSERT_EQ(1u, nearestBrushHit.size());
+            ASSERT_EQ(brushes[0], hitToBrush(nearestBrushHit.query().pickable().type(Brush::BrushHit).first()));
+
+            // hidden brushes are skipped
+            brushes[0]->setVisibilityState(Visibility_Hidden);
+            auto nearestHit = PickResult::byDistance(editorContext, 1, nearestBrushFilter(editorContext));
+            world.pick(ray, nearestHit);
+            ASSERT_EQ(1u, nearestHit.size());
+            ASSERT_EQ(brushes[1], hitToBrush(nearestHit.query().pickable().type(Brush::BrushHit).first()));
+        }
+
+        TEST(WorldTest, validateQueuedIssues) {
+            const vm::bbox3 worldBounds(4096.0);
+            World world(MapFormat::Standard, worldBounds);
+            world.registerIssueGenerator(new NonIntegerVerticesIssueGenerator());
+            world.registerIssueGenerator(new EmptyAttributeValueIssueGenerator());
+            const auto& issueGenerators = world.registeredIssueGenerators();
+
+            BrushBuilder builder(&world, worldBounds);
+            Brush* brush1 = builder.createCube(64.0, "texture");
+            Brush* brush2 = builder.createCube(32.0, "texture");
+            world.defaultLayer()->addChild(brush1);
+            world.defaultLayer()->addChild(brush2);
+
+            Entity* entity = world.createEntity();
+            entity->addOrUpdateAttribute("classname", "info_null");
+            entity->addOrUpdateAttribute("target", "");
+            world.defaultLayer()->addChild(entity);
+
+            // every node is validated once
+            ASSERT_EQ(world.familySize(), world.validateQueuedIssues().size());
+            ASSERT_TRUE(world.validateQueuedIssues().empty());
+            ASSERT_TRUE(brush1->issues(issueGenerators).empty());
+            ASSERT_EQ(1u, entity->issues(issueGenerators).size());
+
+            // changing a brush only revalidates the brush and its ancestors
+            brush1->transform(vm::translationMatrix(vm::vec3(0.5, 0.0, 0.0)), false, worldBounds);
+            const NodeList changed = world.validateQueuedIssues();
+            ASSERT_EQ(3u, changed.size());
+            ASSERT_TRUE(VectorUtils::contains(changed, brush1));
+            ASSERT_TRUE(VectorUtils::contains(changed, world.defaultLayer()));
+            ASSERT_TRUE(VectorUtils::contains(changed, &world));
+            ASSERT_EQ(1u, brush1->issues(issueGenerators).size());
+            ASSERT_TRUE(brush2->issues(issueGenerators).empty());
+
+            // removed nodes are no longer validated
+            brush2->transform(vm::translationMatrix(vm::vec3(0.5, 0.0, 0.0)), false, worldBounds);
+            world.defaultLayer()->removeChild(brush2);
+            const NodeList changedAfterRemoval = world.validateQueuedIssues();
+            ASSERT_FALSE(VectorUtils::contains(changedAfterRemoval, brush2));
+            delete brush2;
+
+            // nodes that are added again are validated again
+            world.defaultLayer()->removeChild(entity);
+            world.defaultLayer()->addChild(entity);
+            const NodeList changedAfterAdding = world.validateQueuedIssues();
+            ASSERT_TRUE(VectorUtils::contains(changedAfterAdding, entity));
+            ASSERT_EQ(1u, entity->issues(issueGenerators).size());
+        }
+    }
+}
@@ -20,6 +20,7 @@
 #include <gtest/gtest.h>
 
 #include "CollectionUtils.h"
+#include "Exceptions.h"
 
 #include "Polyhedron.h"
 #include "Polyhedron_DefaultPayload.h"
@@ -29,6 +30,7 @@
 #include <vecmath/scalar.h>
 
 #include <iterator>
+#include <map>
 #include <tuple>
 
 using Polyhedron3d = Polyhedron<double, DefaultPolyhedronPayload, DefaultPolyhedronPayload>;
@@ -148,6 +150,51 @@ TEST(PolyhedronTest, swap) {
     ASSERT_EQ(original.bounds(), rhs.bounds());
 }
 
+TEST(PolyhedronTest, initWithTopology) {
+    const Polyhedron3d original(vm::bbox3d(-8.0, 8.0));
+
+    std::vector<vm::vec3d> positions;
+    std::map<const PVertex*, size_t> indices;
+    for (const auto* vertex : original.vertices()) {
+        indices[vertex] = positions.size();
+        positions.push_back(vertex->position());
+    }
+
+    std::vector<std::vector<size_t>> faces;
+    for (const auto* face : original.faces()) {
+        std::vector<size_t> faceIndices;
+        for (const auto* halfEdge : face->boundary()) {
+            faceIndices.push_back(indices[halfEdge->origin()]);
+        }
+        faces.push_back(faceIndices);
+    }
+
+    const Polyhedron3d copy(positions, faces);
+    ASSERT_EQ(original, copy);
+    ASSERT_EQ(original.bounds(), copy.bounds());
+    ASSERT_TRUE(copy.closed());
+    ASSERT_EQ(original.faceCount(), copy.faceCount());
+    ASSERT_EQ(original.edgeCount(), copy.edgeCount());
+}
+
+TEST(PolyhedronTest, initWithInvalidTopology) {
+    const std::vector<vm::vec3d> positions {
+        vm::vec3d( 0.0, 0.0, 8.0),
+        vm::vec3d( 8.0, 0.0, 0.0),
+        vm::vec3d(-8.0, 0.0, 0.0),
+        vm::vec3d( 0.0, 8.0, 0.0)
+    };
+
+    // a tetrahedron with one missing face
+    ASSERT_THROW(Polyhedron3d(positions, { { 0, 1, 3 }, { 0, 3, 2 }, { 0, 2, 1 } }), GeometryException);
+
+    // an index out of range
+    ASSERT_THROW(Polyhedron3d(positions, { { 0, 1, 4 } }), GeometryException);
+
+    // a degenerate face
+    ASSERT_THROW(Polyhedron3d(positions, { { 0, 1 } }), GeometryException);
+}
+
 TEST(PolyhedronTest, convexHullWithFailingPoints) {
     const vm::vec3d p1(-64.0,    -45.5049, -34.4752);
     const vm::vec3d p2(-64.0,    -43.6929, -48.0);
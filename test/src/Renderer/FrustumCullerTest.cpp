@@ -0,0 +1,114 @@
+/*
+ Copyright (C) 2010-2019 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+
+#include "CollectionUtils.h"
+#include "Model/Brush.h"
+#include "Model/BrushBuilder.h"
+#include "Model/Layer.h"
+#include "Model/MapFormat.h"
+#include "Model/World.h"
+#include "Renderer/FrustumCuller.h"
+#include "Renderer/PerspectiveCamera.h"
+
+#include <vecmath/bbox.h>
+#include <vecmath/vec.h>
+
+namespace TrenchBroom {
+    namespace Renderer {
+        static PerspectiveCamera createCamera(const vm::vec3f& position) {
+            return PerspectiveCamera(90.0f, 1.0f, 1000.0f, Camera::Viewport(0, 0, 800, 600), position, vm::vec3f::pos_x, vm::vec3f::pos_z);
+        }
+
+        static vm::bbox3 box(const FloatType minX, const FloatType maxX) {
+            return vm::bbox3(vm::vec3(minX, -5.0, -5.0), vm::vec3(maxX, 5.0, 5.0));
+        }
+
+        TEST(FrustumCullerTest, relation) {
+            const auto camera = createCamera(vm::vec3f::zero);
+            const FrustumCuller culler(camera);
+
+            ASSERT_EQ(VolumeRelation::Inside, culler.relation(box(95.0, 105.0)));
+            ASSERT_EQ(VolumeRelation::Outside, culler.relation(box(-105.0, -95.0)));
+            ASSERT_EQ(VolumeRelation::Intersecting, culler.relation(box(-5.0, 5.0)));
+
+            // crosses the side planes
+            ASSERT_EQ(VolumeRelation::Intersecting, culler.relation(vm::bbox3(vm::vec3(100.0, -1000.0, -5.0), vm::vec3(110.0, 1000.0, 5.0))));
+
+            // beyond and across the far plane
+            ASSERT_EQ(VolumeRelation::Outside, culler.relation(box(1100.0, 1110.0)));
+            ASSERT_EQ(VolumeRelation::Intersecting, culler.relation(box(990.0, 1010.0)));
+        }
+
+        TEST(FrustumCullerTest, relationWithMaxDistance) {
+            const auto camera = createCamera(vm::vec3f::zero);
+            const FrustumCuller culler(camera, 500.0);
+
+            ASSERT_EQ(VolumeRelation::Inside, culler.relation(box(95.0, 105.0)));
+            ASSERT_EQ(VolumeRelation::Intersecting, culler.relation(box(490.0, 510.0)));
+            ASSERT_EQ(VolumeRelation::Outside, culler.relation(box(600.0, 610.0)));
+            ASSERT_EQ(VolumeRelation::Outside, culler.relation(box(-105.0, -95.0)));
+        }
+
+        TEST(FrustumCullerTest, findVisibleNodes) {
+            const vm::bbox3 worldBounds(8192.0);
+            Model::World world(Model::MapFormat::Standard, worldBounds);
+
+            Model::BrushBuilder builder(&world, worldBounds);
+            Model::BrushList brushes;
+            for (size_t x = 0; x < 20u; ++x) {
+                for (size_t y = 0; y < 20u; ++y) {
+                    for (size_t z = 0; z < 3u; ++z) {
+                        const vm::vec3 min(static_cast<FloatType>(x) * 128.0 - 1280.0, static_cast<FloatType>(y) * 128.0 - 1280.0, static_cast<FloatType>(z) * 128.0 - 192.0);
+                        auto* brush = builder.createCuboid(vm::bbox3(min, min + vm::vec3(32.0, 32.0, 32.0)), "texture");
+                        world.defaultLayer()->addChild(brush);
+                        brushes.push_back(brush);
+                    }
+                }
+            }
+
+            const vm::vec3f positions[] = { vm::vec3f(-1500.0f, 0.0f, 0.0f), vm::vec3f::zero, vm::vec3f(500.0f, 300.0f, 64.0f) };
+            for (const auto& position : positions) {
+                const auto camera = createCamera(position);
+                for (const FloatType maxDistance : { 0.0, 600.0 }) {
+                    const FrustumCuller culler(camera, maxDistance);
+
+                    Model::NodeList expected;
+                    for (auto* brush : brushes) {
+                        if (culler.relation(brush->bounds()) != VolumeRelation::Outside) {
+                            expected.push_back(brush);
+                        }
+                    }
+                    VectorUtils::sort(expected);
+                    ASSERT_FALSE(expected.empty());
+                    ASSERT_LT(expected.size(), brushes.size());
+
+                    // repeated queries switch from the dynamic tree to the flattened tree
+                    for (size_t i = 0; i < 3u; ++i) {
+                        Model::NodeList actual;
+                        culler.findVisibleNodes(world, actual);
+                        VectorUtils::sort(actual);
+                        ASSERT_EQ(expected, actual);
+                    }
+                }
+            }
+        }
+    }
+}
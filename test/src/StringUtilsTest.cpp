@@ -21,6 +21,10 @@
 
 #include "StringUtils.h"
 
+#include <cstdio>
+#include <limits>
+#include <random>
+
 namespace StringUtils {
     TEST(StringUtilsTest, trim) {
         String result;
@@ -293,4 +297,56 @@ namespace StringUtils {
         ASSERT_EQ(String("asdf\\"), StringUtils::unescape("asdf\\\\", ""));
         ASSERT_EQ(String("asdf\\\\"), StringUtils::unescape("asdf\\\\\\\\", ""));
     }
+
+    static String printfFloat(const double value, const int precision) {
+        char buffer[64];
+        const int count = std::snprintf(buffer, sizeof(buffer), "%.*g", precision, value);
+        return String(buffer, static_cast<size_t>(count));
+    }
+
+    static void assertAppendFloat(const double value) {
+        for (const int precision : { 6, 17 }) {
+            String actual("x");
+            appendFloat(actual, value, precision);
+            ASSERT_EQ("x" + printfFloat(value, precision), actual) << "value " << printfFloat(value, 17) << ", precision " << precision;
+        }
+    }
+
+    TEST(StringUtilsTest, appendFloat) {
+        assertAppendFloat(0.0);
+        assertAppendFloat(-0.0);
+        assertAppendFloat(1.0);
+        assertAppendFloat(-1.0);
+        assertAppendFloat(0.5);
+        assertAppendFloat(0.1);
+        assertAppendFloat(-32.000000000000007);
+        assertAppendFloat(1.0 / 3.0);
+        assertAppendFloat(1e-5);
+        assertAppendFloat(123456.0);
+        assertAppendFloat(999999.0);
+        assertAppendFloat(1000000.0);
+        assertAppendFloat(-1234567.0);
+        assertAppendFloat(99999999999999999.0);
+        assertAppendFloat(1e17);
+        assertAppendFloat(1e100);
+        assertAppendFloat(std::numeric_limits<double>::min());
+        assertAppendFloat(std::numeric_limits<double>::max());
+
+        std::mt19937 random(1234);
+        std::uniform_real_distribution<double> distribution(-8192.0, 8192.0);
+        for (size_t i = 0; i < 10000; ++i) {
+            const auto value = distribution(random);
+            assertAppendFloat(value);
+            assertAppendFloat(static_cast<double>(static_cast<float>(value)));
+            assertAppendFloat(static_cast<double>(static_cast<int>(value)));
+        }
+    }
+
+    TEST(StringUtilsTest, appendInt) {
+        String result;
+        appendInt(result, 0);
+        appendInt(result, -12);
+        appendInt(result, 345);
+        ASSERT_EQ(String("0-12345"), result);
+    }
 }
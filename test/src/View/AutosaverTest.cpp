@@ -29,6 +29,8 @@
 #include "View/MapDocumentTest.h"
 
 #include <chrono>
+#include <fstream>
+#include <iterator>
 #include <thread>
 
 namespace TrenchBroom {
@@ -58,6 +60,7 @@ namespace TrenchBroom {
             document->addNode(createBrush("some_texture"), document->currentLayer());
 
             autosaver.triggerAutosave(logger);
+            autosaver.waitForAutosave(logger);
 
             ASSERT_FALSE(env.fileExists(IO::Path("autosave/test.1.map")));
             ASSERT_FALSE(env.directoryExists(IO::Path("autosave")));
@@ -72,6 +75,7 @@ namespace TrenchBroom {
 
             Autosaver autosaver(document, 0, 0);
             autosaver.triggerAutosave(logger);
+            autosaver.waitForAutosave(logger);
 
             ASSERT_FALSE(env.fileExists(IO::Path("autosave/test.1.map")));
             ASSERT_FALSE(env.directoryExists(IO::Path("autosave")));
@@ -94,6 +98,7 @@ namespace TrenchBroom {
             std::this_thread::sleep_for(2s);
 
             autosaver.triggerAutosave(logger);
+            autosaver.waitForAutosave(logger);
 
             ASSERT_TRUE(env.fileExists(IO::Path("autosave/test.1.map")));
             ASSERT_TRUE(env.directoryExists(IO::Path("autosave")));
@@ -112,6 +117,7 @@ namespace TrenchBroom {
             document->addNode(createBrush("some_texture"), document->currentLayer());
 
             autosaver.triggerAutosave(logger);
+            autosaver.waitForAutosave(logger);
 
             ASSERT_FALSE(env.fileExists(IO::Path("autosave/test.1.map")));
             ASSERT_FALSE(env.directoryExists(IO::Path("autosave")));
@@ -135,6 +141,7 @@ namespace TrenchBroom {
             std::this_thread::sleep_for(2s);
 
             autosaver.triggerAutosave(logger);
+            autosaver.waitForAutosave(logger);
 
             ASSERT_TRUE(env.fileExists(IO::Path("autosave/test.1.map")));
             ASSERT_TRUE(env.directoryExists(IO::Path("autosave")));
@@ -157,6 +164,7 @@ namespace TrenchBroom {
             std::this_thread::sleep_for(2s);
 
             autosaver.triggerAutosave(logger);
+            autosaver.waitForAutosave(logger);
 
             ASSERT_TRUE(env.fileExists(IO::Path("autosave/test.1.map")));
             ASSERT_TRUE(env.directoryExists(IO::Path("autosave")));
@@ -166,12 +174,14 @@ namespace TrenchBroom {
             std::this_thread::sleep_for(2s);
 
             autosaver.triggerAutosave(logger);
+            autosaver.waitForAutosave(logger);
             ASSERT_FALSE(env.fileExists(IO::Path("autosave/test.2.map")));
 
             // modify the map
             document->addNode(createBrush("some_texture"), document->currentLayer());
 
             autosaver.triggerAutosave(logger);
+            autosaver.waitForAutosave(logger);
             ASSERT_TRUE(env.fileExists(IO::Path("autosave/test.2.map")));
         }
 
@@ -194,8 +204,35 @@ namespace TrenchBroom {
             document->addNode(createBrush("some_texture"), document->currentLayer());
 
             autosaver.triggerAutosave(logger);
+            autosaver.waitForAutosave(logger);
 
             ASSERT_TRUE(env.fileExists(IO::Path("autosave/test.2.map")));
         }
+
+        TEST_F(MapDocumentTest, autosaverSavesSnapshotInBackground) {
+            IO::TestEnvironment env("autosaver_test");
+            NullLogger logger;
+
+            document->saveDocumentAs(env.dir() + IO::Path("test.map"));
+            assert(env.fileExists(IO::Path("test.map")));
+
+            Autosaver autosaver(document, 0, 0);
+
+            // modify the map
+            document->addNode(createBrush("some_texture"), document->currentLayer());
+
+            autosaver.triggerAutosave(logger);
+
+            // modify the map while the backup is being written, the backup must not contain this change
+            document->addNode(createBrush("other_texture"), document->currentLayer());
+
+            autosaver.waitForAutosave(logger);
+            ASSERT_TRUE(env.fileExists(IO::Path("autosave/test.1.map")));
+
+            std::ifstream stream((env.dir() + IO::Path("autosave/test.1.map")).asString());
+            const String backup((std::istreambuf_iterator<char>(stream)), std::istreambuf_iterator<char>());
+            ASSERT_NE(String::npos, backup.find("some_texture"));
+            ASSERT_EQ(String::npos, backup.find("other_texture"));
+        }
     }
 }
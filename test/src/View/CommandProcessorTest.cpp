@@ -0,0 +1,130 @@
+/*
+ Copyright (C) 2010-2019 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include <gtest/gtest.h>
+
+#include "View/CommandProcessor.h"
+#include "View/MapDocumentCommandFacade.h"
+#include "View/MapDocumentTest.h"
+#include "View/UndoableCommand.h"
+
+#include <memory>
+
+namespace TrenchBroom {
+    namespace View {
+        class CommandProcessorTest : public MapDocumentTest {};
+
+        // adds a value to a counter and claims a fixed amount of memory for its undo information
+        class AddValueCommand : public UndoableCommand {
+        public:
+            static const CommandType Type;
+        private:
+            int& m_counter;
+            int m_value;
+            size_t m_memoryUsage;
+        public:
+            AddValueCommand(int& counter, const int value, const size_t memoryUsage) :
+            UndoableCommand(Type, "Add value"),
+            m_counter(counter),
+            m_value(value),
+            m_memoryUsage(memoryUsage) {}
+        private:
+            bool doPerformDo(MapDocumentCommandFacade*) override {
+                m_counter += m_value;
+                return true;
+            }
+
+            bool doPerformUndo(MapDocumentCommandFacade*) override {
+                m_counter -= m_value;
+                return true;
+            }
+
+            bool doIsRepeatable(MapDocumentCommandFacade*) const override {
+                return false;
+            }
+
+            bool doCollateWith(UndoableCommand::Ptr) override {
+                return false;
+            }
+
+            size_t doGetMemoryUsage() const override {
+                return m_memoryUsage;
+            }
+        };
+
+        const Command::CommandType AddValueCommand::Type = Command::freeType();
+
+        TEST_F(CommandProcessorTest, discardOldestCommandsOverMemoryBudget) {
+            CommandProcessor processor(static_cast<MapDocumentCommandFacade*>(document.get()));
+            processor.setMemoryBudget(250u);
+
+            int counter = 0;
+            for (int i = 1; i <= 5; ++i) {
+                processor.submitAndStoreCommand(std::make_shared<AddValueCommand>(counter, i, 100u));
+                ASSERT_LE(processor.memoryUsage(), processor.memoryBudget());
+            }
+            ASSERT_EQ(15, counter);
+            ASSERT_EQ(200u, processor.memoryUsage());
+
+            // only the two most recent commands are left to undo
+            ASSERT_TRUE(processor.undoLastCommand());
+            ASSERT_EQ(10, counter);
+            ASSERT_TRUE(processor.undoLastCommand());
+            ASSERT_EQ(6, counter);
+            ASSERT_FALSE(processor.hasLastCommand());
+            ASSERT_EQ(0u, processor.memoryUsage());
+
+            ASSERT_TRUE(processor.redoNextCommand());
+            ASSERT_EQ(10, counter);
+            ASSERT_EQ(100u, processor.memoryUsage());
+        }
+
+        TEST_F(CommandProcessorTest, keepMostRecentCommandOverMemoryBudget) {
+            CommandProcessor processor(static_cast<MapDocumentCommandFacade*>(document.get()));
+            processor.setMemoryBudget(250u);
+
+            int counter = 0;
+            processor.submitAndStoreCommand(std::make_shared<AddValueCommand>(counter, 1, 100u));
+            processor.submitAndStoreCommand(std::make_shared<AddValueCommand>(counter, 2, 1000u));
+            ASSERT_EQ(1000u, processor.memoryUsage());
+
+            ASSERT_TRUE(processor.undoLastCommand());
+            ASSERT_EQ(1, counter);
+            ASSERT_FALSE(processor.hasLastCommand());
+        }
+
+        TEST_F(CommandProcessorTest, lowerMemoryBudget) {
+            CommandProcessor processor(static_cast<MapDocumentCommandFacade*>(document.get()));
+
+            int counter = 0;
+            for (int i = 1; i <= 4; ++i) {
+                processor.submitAndStoreCommand(std::make_shared<AddValueCommand>(counter, i, 100u));
+            }
+            ASSERT_EQ(400u, processor.memoryUsage());
+
+            processor.setMemoryBudget(100u);
+            ASSERT_EQ(100u, processor.memoryUsage());
+
+            ASSERT_TRUE(processor.undoLastCommand());
+            ASSERT_EQ(6, counter);
+            ASSERT_FALSE(processor.hasLastCommand());
+        }
+    }
+}
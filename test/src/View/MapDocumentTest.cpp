@@ -19,9 +19,12 @@
 
 #include "MapDocumentTest.h"
 
+#include "PreferenceManager.h"
+#include "Preferences.h"
 #include "TestUtils.h"
 #include "Assets/EntityDefinition.h"
 #include "Assets/ModelDefinition.h"
+#include "IO/TestEnvironment.h"
 #include "Model/Brush.h"
 #include "Model/Entity.h"
 #include "Model/Group.h"
@@ -40,6 +43,8 @@
 #include <vecmath/bbox.h>
 #include <vecmath/scalar.h>
 
+#include <fstream>
+
 namespace TrenchBroom {
     namespace View {
         MapDocumentTest::MapDocumentTest() :
@@ -931,5 +936,39 @@ namespace TrenchBroom {
             EXPECT_EQ(nullptr, brush1->parent());
             EXPECT_EQ(nullptr, brush2->parent());
         }
+
+        TEST_F(MapDocumentTest, loadWorldIgnoresStaleMapCache) {
+            SetTemporaryPreference<bool> mapCache(Preferences::MapCache, true);
+            IO::TestEnvironment env("map_document_cache_test");
+            const auto mapPath = env.dir() + IO::Path("test.map");
+
+            document->addNode(createBrush(), document->currentLayer());
+            document->saveDocumentAs(mapPath);
+            ASSERT_TRUE(env.fileExists(IO::Path("test.map.tbcache")));
+
+            // the test game loads every map as an empty world, so any nodes must come from the cache
+            document->loadDocument(Model::MapFormat::Standard, document->worldBounds(), game, mapPath);
+            ASSERT_FALSE(document->world()->defaultLayer()->children().empty());
+
+            std::ofstream(mapPath.asString(), std::ios::out | std::ios::app) << "// changed\n";
+            document->loadDocument(Model::MapFormat::Standard, document->worldBounds(), game, mapPath);
+            ASSERT_TRUE(document->world()->defaultLayer()->children().empty());
+        }
+
+        TEST_F(MapDocumentTest, loadWorldIgnoresMismatchedMapCache) {
+            SetTemporaryPreference<bool> mapCache(Preferences::MapCache, true);
+            IO::TestEnvironment env("map_document_cache_test");
+            const auto mapPath = env.dir() + IO::Path("test.map");
+
+            document->addNode(createBrush(), document->currentLayer());
+            document->saveDocumentAs(mapPath);
+            ASSERT_TRUE(env.fileExists(IO::Path("test.map.tbcache")));
+
+            document->loadDocument(Model::MapFormat::Valve, document->worldBounds(), game, mapPath);
+            ASSERT_TRUE(document->world()->defaultLayer()->children().empty());
+
+            document->loadDocument(Model::MapFormat::Standard, vm::bbox3(4096.0), game, mapPath);
+            ASSERT_TRUE(document->world()->defaultLayer()->children().empty());
+        }
     }
 }
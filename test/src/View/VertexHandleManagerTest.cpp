@@ -0,0 +1,158 @@
+/*
+ Copyright (C) 2010-2019 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+
+#include "PreferenceManager.h"
+#include "Preferences.h"
+#include "Model/Hit.h"
+#include "Model/PickResult.h"
+#include "Renderer/PerspectiveCamera.h"
+#include "View/VertexHandleManager.h"
+
+#include <vecmath/ray.h>
+#include <vecmath/segment.h>
+#include <vecmath/vec.h>
+
+#include <set>
+
+namespace TrenchBroom {
+    namespace View {
+        template <typename T>
+        static std::set<T> hitTargets(const Model::PickResult& pickResult) {
+            std::set<T> result;
+            for (const auto& hit : pickResult.all()) {
+                result.insert(hit.target<T>());
+            }
+            return result;
+        }
+
+        static void addGrid(VertexHandleManager& manager, const size_t size, const FloatType spacing) {
+            for (size_t x = 0; x < size; ++x) {
+                for (size_t y = 0; y < size; ++y) {
+                    for (size_t z = 0; z < size; ++z) {
+                        manager.add(vm::vec3(static_cast<FloatType>(x), static_cast<FloatType>(y), static_cast<FloatType>(z)) * spacing);
+                    }
+                }
+            }
+        }
+
+        TEST(VertexHandleManagerTest, addAndRemoveHandles) {
+            VertexHandleManager manager;
+            manager.add(vm::vec3(1.0, 2.0, 3.0));
+            manager.add(vm::vec3(1.0, 2.0, 3.0));
+            manager.add(vm::vec3(4.0, 5.0, 6.0));
+            ASSERT_EQ(2u, manager.totalHandleCount());
+
+            ASSERT_TRUE(manager.remove(vm::vec3(1.0, 2.0, 3.0)));
+            ASSERT_TRUE(manager.contains(vm::vec3(1.0, 2.0, 3.0)));
+            ASSERT_TRUE(manager.remove(vm::vec3(1.0, 2.0, 3.0)));
+            ASSERT_FALSE(manager.contains(vm::vec3(1.0, 2.0, 3.0)));
+            ASSERT_FALSE(manager.remove(vm::vec3(1.0, 2.0, 3.0)));
+            ASSERT_EQ(1u, manager.totalHandleCount());
+
+            manager.clear();
+            ASSERT_EQ(0u, manager.totalHandleCount());
+            manager.add(vm::vec3(1.0, 2.0, 3.0));
+            ASSERT_EQ(1u, manager.totalHandleCount());
+        }
+
+        TEST(VertexHandleManagerTest, selectCloseHandles) {
+            VertexHandleManager manager;
+            addGrid(manager, 10u, 16.0);
+            manager.add(vm::vec3(16.0, 16.0, 16.0001));
+
+            manager.select(vm::vec3(16.0, 16.0000001, 16.0));
+            ASSERT_EQ(1u, manager.selectedHandleCount());
+            ASSERT_TRUE(manager.selected(vm::vec3(16.0, 16.0, 16.0)));
+            ASSERT_FALSE(manager.selected(vm::vec3(16.0, 16.0, 16.0001)));
+
+            manager.select(vm::vec3(16.0, 16.0, 16.0001));
+            ASSERT_EQ(2u, manager.selectedHandleCount());
+
+            manager.deselect(vm::vec3(16.0, 16.0, 16.0));
+            ASSERT_EQ(1u, manager.selectedHandleCount());
+
+            // removing a selected handle deselects it
+            ASSERT_TRUE(manager.remove(vm::vec3(16.0, 16.0, 16.0001)));
+            ASSERT_EQ(0u, manager.selectedHandleCount());
+
+            // handles that are not contained in the manager cannot be selected
+            manager.select(vm::vec3(8.0, 8.0, 8.0));
+            ASSERT_EQ(0u, manager.selectedHandleCount());
+        }
+
+        TEST(VertexHandleManagerTest, pickFindsSameHandlesAsLinearSearch) {
+            VertexHandleManager manager;
+            addGrid(manager, 20u, 32.0);
+
+            // remove some handles so that the index has seen removals, too
+            for (size_t i = 0; i < 20u; ++i) {
+                ASSERT_TRUE(manager.remove(vm::vec3(static_cast<FloatType>(i), static_cast<FloatType>(i), 0.0) * 32.0));
+            }
+
+            const Renderer::PerspectiveCamera camera(90.0f, 1.0f, 8000.0f, Renderer::Camera::Viewport(0, 0, 800, 600), vm::vec3f(-200.0f, 300.0f, 250.0f), vm::vec3f::pos_x, vm::vec3f::pos_z);
+            const FloatType handleRadius = pref(Preferences::HandleRadius);
+
+            size_t hitCount = 0;
+            for (int x = 0; x < 800; x += 40) {
+                for (int y = 0; y < 600; y += 40) {
+                    const auto pickRay = vm::ray3(camera.pickRay(x, y));
+
+                    Model::PickResult actual;
+                    manager.pick(pickRay, camera, actual);
+
+                    Model::PickResult expected;
+                    manager.VertexHandleManagerBaseT<vm::vec3>::pick([&](const vm::vec3& position) {
+                        const auto distance = camera.pickPointHandle(pickRay, position, handleRadius);
+                        if (vm::isnan(distance)) {
+                            return Model::Hit::NoHit;
+                        }
+                        return Model::Hit::hit(VertexHandleManager::HandleHit, distance, pickRay.pointAtDistance(distance), position);
+                    }, expected);
+
+                    ASSERT_EQ(hitTargets<vm::vec3>(expected), hitTargets<vm::vec3>(actual));
+                    hitCount += actual.size();
+                }
+            }
+
+            ASSERT_GT(hitCount, 0u);
+        }
+
+        TEST(VertexHandleManagerTest, pickEdgeCenterHandles) {
+            EdgeHandleManager manager;
+            for (size_t i = 0; i < 100u; ++i) {
+                const auto start = vm::vec3(static_cast<FloatType>(i % 10u) * 64.0, static_cast<FloatType>(i / 10u) * 64.0, 0.0);
+                manager.add(vm::segment3(start, start + vm::vec3(0.0, 0.0, 128.0)));
+            }
+
+            const Renderer::PerspectiveCamera camera(90.0f, 1.0f, 8000.0f, Renderer::Camera::Viewport(0, 0, 800, 600), vm::vec3f(-200.0f, 0.0f, 64.0f), vm::vec3f::pos_x, vm::vec3f::pos_z);
+
+            // aim at the center of an edge
+            const auto target = vm::vec3(128.0, 64.0, 64.0);
+            const auto pickRay = vm::ray3(vm::vec3(camera.position()), vm::normalize(target - vm::vec3(camera.position())));
+
+            Model::PickResult pickResult;
+            manager.pickCenterHandle(pickRay, camera, pickResult);
+
+            const auto targets = hitTargets<vm::segment3>(pickResult);
+            ASSERT_EQ(1u, targets.count(vm::segment3(vm::vec3(128.0, 64.0, 0.0), vm::vec3(128.0, 64.0, 128.0))));
+        }
+    }
+}